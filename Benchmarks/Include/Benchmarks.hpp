@@ -0,0 +1,40 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_BENCHMARKS_HPP
+#define DGE_BENCHMARKS_HPP
+
+#include <algorithm>
+#include <chrono>
+
+namespace def::benchmarks
+{
+	// Each benchmark prints its own table of timings
+	void Particles();
+	void SpatialHash();
+	void ImageProcessing();
+	void BlitSprite();
+
+	// Runs func several times and returns the fastest run in milliseconds
+	template <class Func>
+	double Measure(Func&& func, int runs = 5)
+	{
+		double best = 1e30;
+
+		for (int i = 0; i < runs; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		return best;
+	}
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Benchmarks.hpp"
+#include "defGameEngine.hpp"
+
+#include "../../Engine/Extensions/DGE_AffineTransforms.hpp"
+
+#include <cstdio>
+
+namespace def::benchmarks
+{
+	// AffineTransforms::DrawSprite with both kernels across zoom factors against
+	// the Sample and Draw per pixel that it replaced
+	class BlitSpriteBenchmark : public GameEngine
+	{
+	public:
+		bool OnUserCreate() override
+		{
+			m_Sprite.Create({ 512, 512 });
+
+			for (int y = 0; y < 512; y++)
+				for (int x = 0; x < 512; x++)
+					m_Sprite.SetPixel(x, y, Pixel(uint8_t(x / 2), uint8_t(y / 2), ((x / 8 + y / 8) & 1) ? 255 : 0));
+
+			m_Sprite.GenerateMipmaps();
+
+			return true;
+		}
+
+		bool OnUserUpdate(float) override
+		{
+			const Vector2i& screenSize = Window().GetScreenSize();
+			AffineTransforms transforms(screenSize, { 1.0f, 1.0f });
+
+			printf("512x512 sprite on a %dx%d screen, milliseconds per draw\n", screenSize.x, screenSize.y);
+			printf("%8s %12s %10s %10s %10s %10s\n", "zoom", "pixels", "nearest", "bilinear", "naive", "naive bil");
+
+			for (float zoom : { 0.05f, 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 20.0f })
+			{
+				transforms.SetScale({ zoom, zoom });
+
+				Vector2i drawn = (Vector2f(m_Sprite.size) * zoom).Min(Vector2f(screenSize));
+				int runs = zoom < 1.0f ? 50 : 10;
+
+				transforms.SetSampleMethod(Sprite::SampleMethod::LINEAR);
+				double nearest = Measure([&]() { transforms.DrawSprite({ 0.0f, 0.0f }, &m_Sprite); }, runs);
+
+				transforms.SetSampleMethod(Sprite::SampleMethod::BILINEAR);
+				double bilinear = Measure([&]() { transforms.DrawSprite({ 0.0f, 0.0f }, &m_Sprite); }, runs);
+
+				double naive = Measure([&]() { DrawNaive(transforms, Sprite::SampleMethod::LINEAR); }, 1);
+				double naiveBilinear = Measure([&]() { DrawNaive(transforms, Sprite::SampleMethod::BILINEAR); }, 1);
+
+				printf("%7.2fx %12d %10.3f %10.3f %10.3f %10.3f\n", zoom, drawn.x * drawn.y, nearest, bilinear, naive, naiveBilinear);
+			}
+
+			return false;
+		}
+
+	private:
+		// A Sample of the full sprite and a Draw for every pixel that the sprite covers,
+		// including the ones that are off the screen
+		void DrawNaive(const AffineTransforms& transforms, Sprite::SampleMethod method)
+		{
+			Vector2f fileSize = m_Sprite.size;
+			Vector2f size = fileSize * transforms.GetScale();
+
+			Vector2f spriteStep = 1.0f / fileSize;
+			Vector2f screenStep = 1.0f / size;
+
+			Vector2i start = transforms.WorldToScreen({ 0.0f, 0.0f });
+			Vector2i end = start + size;
+
+			Vector2i p;
+
+			for (p.y = start.y; p.y < end.y; p.y++)
+				for (p.x = start.x; p.x < end.x; p.x++)
+				{
+					Vector2f sampledPos = Vector2f(p - start) * screenStep * fileSize * spriteStep;
+					Draw(p, m_Sprite.Sample(sampledPos, method, Sprite::WrapMethod::NONE));
+				}
+		}
+
+	private:
+		Sprite m_Sprite;
+
+	};
+
+	void BlitSprite()
+	{
+		BlitSpriteBenchmark benchmark;
+
+		if (benchmark.Construct(1280, 720, 1, 1))
+			benchmark.Run();
+	}
+}
@@ -0,0 +1,16 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+// The implementations of the extensions that the benchmarks use, only this file defines them
+
+#define DGE_AFFINE_TRANSFORMS
+#include "../../Engine/Extensions/DGE_AffineTransforms.hpp"
+
+#define DGE_PARTICLES
+#include "../../Engine/Extensions/DGE_Particles.hpp"
+
+#define DGE_SPATIAL_HASH
+#include "../../Engine/Extensions/DGE_SpatialHash.hpp"
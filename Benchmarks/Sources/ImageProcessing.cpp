@@ -0,0 +1,180 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Benchmarks.hpp"
+#include "defGameEngine.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace def::benchmarks
+{
+	static void PrintRow(const char* name, double serial, double parallel, double naive)
+	{
+		printf("%-34s %10.1f %10.1f %10.1f %9.1fx\n", name, serial, parallel, naive, naive / std::min(serial, parallel));
+	}
+
+	// Every operation on a 4K sprite against the loops over Sprite::Sample,
+	// GetPixel and SetPixel that it replaces
+	void ImageProcessing()
+	{
+		using Ops = def::ImageProcessing;
+
+		const Vector2i size4K(3840, 2160);
+		const Vector2i size1080p(1920, 1080);
+
+		std::mt19937 rng(2026);
+
+		Sprite image(size4K);
+
+		for (Pixel& p : image.pixels)
+			p.rgba_n = rng();
+
+		Sprite small(size1080p);
+
+		for (Pixel& p : small.pixels)
+			p.rgba_n = rng();
+
+		def::ThreadPool pool;
+		Sprite out;
+
+		printf("3840x2160 sprite, %zu threads in the pool and the calling one, milliseconds\n", pool.GetThreadsCount());
+		printf("%-34s %10s %10s %10s %10s\n", "", "serial", "parallel", "naive", "speedup");
+
+		// A Sample per destination pixel at its centre
+		auto naiveResize = [&](const Sprite& src, const Vector2i& dstSize)
+			{
+				Sprite dst(dstSize);
+				Vector2f invSize = 1.0f / Vector2f(dstSize);
+
+				for (int y = 0; y < dstSize.y; y++)
+					for (int x = 0; x < dstSize.x; x++)
+						dst.SetPixel(x, y, src.Sample(((float)x + 0.5f) * invSize.x, ((float)y + 0.5f) * invSize.y, Sprite::SampleMethod::BILINEAR, Sprite::WrapMethod::CLAMP));
+			};
+
+		// Sample has only the bilinear filter, so it's compared with all three
+		double naiveDownscale = Measure([&]() { naiveResize(image, size1080p); }, 1);
+
+		PrintRow("resize 4K to 1080p, bilinear",
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::BILINEAR); }, 3),
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::BILINEAR, &pool); }, 3),
+			naiveDownscale);
+
+		PrintRow("resize 4K to 1080p, box",
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::BOX); }, 3),
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::BOX, &pool); }, 3),
+			naiveDownscale);
+
+		PrintRow("resize 4K to 1080p, lanczos",
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::LANCZOS); }, 3),
+			Measure([&]() { Ops::Resize(image, out, size1080p, Ops::Filter::LANCZOS, &pool); }, 3),
+			naiveDownscale);
+
+		PrintRow("resize 1080p to 4K, bilinear",
+			Measure([&]() { Ops::Resize(small, out, size4K, Ops::Filter::BILINEAR); }, 3),
+			Measure([&]() { Ops::Resize(small, out, size4K, Ops::Filter::BILINEAR, &pool); }, 3),
+			Measure([&]() { naiveResize(small, size4K); }, 1));
+
+		// Two passes of a 13 tap kernel with GetPixel clamping at the edges
+		auto naiveBlur = [&]()
+			{
+				const float sigma = 2.0f;
+				const int radius = 6;
+
+				float weights[radius * 2 + 1];
+				float sum = 0.0f;
+
+				for (int i = -radius; i <= radius; i++)
+					sum += weights[i + radius] = exp(-(float)(i * i) / (2.0f * sigma * sigma));
+
+				Sprite temp(size4K);
+				Sprite dst(size4K);
+
+				for (int pass = 0; pass < 2; pass++)
+				{
+					const Sprite& src = pass == 0 ? image : temp;
+					Sprite& target = pass == 0 ? temp : dst;
+
+					for (int y = 0; y < size4K.y; y++)
+						for (int x = 0; x < size4K.x; x++)
+						{
+							float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+
+							for (int i = -radius; i <= radius; i++)
+							{
+								Pixel p = pass == 0 ? src.GetPixel(x + i, y, Sprite::WrapMethod::CLAMP) : src.GetPixel(x, y + i, Sprite::WrapMethod::CLAMP);
+								float w = weights[i + radius] / sum;
+
+								r += (float)p.r * w;
+								g += (float)p.g * w;
+								b += (float)p.b * w;
+								a += (float)p.a * w;
+							}
+
+							target.SetPixel(x, y, Pixel(uint8_t(r + 0.5f), uint8_t(g + 0.5f), uint8_t(b + 0.5f), uint8_t(a + 0.5f)));
+						}
+				}
+			};
+
+		PrintRow("gaussian blur, sigma 2",
+			Measure([&]() { Ops::Blur(image, out, 2.0f); }, 3),
+			Measure([&]() { Ops::Blur(image, out, 2.0f, &pool); }, 3),
+			Measure(naiveBlur, 1));
+
+		PrintRow("rotate by 90 degrees",
+			Measure([&]() { Ops::Rotate90(image, out, 1); }, 3),
+			Measure([&]() { Ops::Rotate90(image, out, 1, &pool); }, 3),
+			Measure([&]()
+				{
+					Sprite dst({ size4K.y, size4K.x });
+
+					for (int y = 0; y < size4K.y; y++)
+						for (int x = 0; x < size4K.x; x++)
+							dst.SetPixel(size4K.y - 1 - y, x, image.GetPixel(x, y));
+				}, 1));
+
+		Sprite flipped = image;
+
+		PrintRow("flip horizontally",
+			Measure([&]() { Ops::FlipHorizontally(flipped); }, 3),
+			Measure([&]() { Ops::FlipHorizontally(flipped, &pool); }, 3),
+			Measure([&]()
+				{
+					for (int y = 0; y < size4K.y; y++)
+						for (int x = 0; x < size4K.x / 2; x++)
+						{
+							Pixel p = flipped.GetPixel(x, y);
+							flipped.SetPixel(x, y, flipped.GetPixel(size4K.x - 1 - x, y));
+							flipped.SetPixel(size4K.x - 1 - x, y, p);
+						}
+				}, 1));
+
+		Sprite canvas(size4K);
+
+		PrintRow("copy the whole sprite",
+			Measure([&]() { Ops::Copy(image, { 0, 0 }, size4K, canvas, { 0, 0 }); }, 3),
+			Measure([&]() { Ops::Copy(image, { 0, 0 }, size4K, canvas, { 0, 0 }, &pool); }, 3),
+			Measure([&]()
+				{
+					for (int y = 0; y < size4K.y; y++)
+						for (int x = 0; x < size4K.x; x++)
+							canvas.SetPixel(x, y, image.GetPixel(x, y));
+				}, 1));
+
+		PrintRow("blend the whole sprite",
+			Measure([&]() { Ops::Blend(image, { 0, 0 }, size4K, canvas, { 0, 0 }); }, 3),
+			Measure([&]() { Ops::Blend(image, { 0, 0 }, size4K, canvas, { 0, 0 }, 255, &pool); }, 3),
+			Measure([&]()
+				{
+					for (int y = 0; y < size4K.y; y++)
+						for (int x = 0; x < size4K.x; x++)
+						{
+							Pixel src = image.GetPixel(x, y);
+							canvas.SetPixel(x, y, canvas.GetPixel(x, y).Lerp(src, (float)src.a / 255.0f));
+						}
+				}, 1));
+	}
+}
@@ -0,0 +1,64 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Benchmarks.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace def::benchmarks;
+
+struct Benchmark
+{
+	const char* name;
+	void (*run)();
+};
+
+static const Benchmark s_Benchmarks[] =
+{
+	{ "particles", Particles },
+	{ "spatialhash", SpatialHash },
+	{ "imageprocessing", ImageProcessing },
+	{ "blitsprite", BlitSprite }
+};
+
+// Runs the benchmarks named in the arguments or all of them if there are none
+int main(int argc, char** argv)
+{
+	int ran = 0;
+
+	for (const Benchmark& benchmark : s_Benchmarks)
+	{
+		bool selected = argc == 1;
+
+		for (int i = 1; i < argc; i++)
+		{
+			if (strcmp(argv[i], benchmark.name) == 0)
+				selected = true;
+		}
+
+		if (selected)
+		{
+			printf("[%s]\n", benchmark.name);
+			benchmark.run();
+			printf("\n");
+
+			ran++;
+		}
+	}
+
+	if (ran == 0)
+	{
+		printf("Usage: %s [benchmark...], the benchmarks are:\n", argv[0]);
+
+		for (const Benchmark& benchmark : s_Benchmarks)
+			printf("  %s\n", benchmark.name);
+
+		return 1;
+	}
+
+	return 0;
+}
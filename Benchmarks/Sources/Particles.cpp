@@ -0,0 +1,117 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Benchmarks.hpp"
+#include "defGameEngine.hpp"
+
+#include "../../Engine/Extensions/DGE_Particles.hpp"
+
+#include <cstdio>
+
+namespace def::benchmarks
+{
+	// Updates and draws a million particles with every kind of affector
+	// on the thread pool and then on a single thread
+	class ParticlesBenchmark : public GameEngine
+	{
+	public:
+		static constexpr size_t PARTICLES = 1000000;
+
+		static constexpr int WARMUP_FRAMES = 5;
+		static constexpr int FRAMES = 60;
+
+		bool OnUserCreate() override
+		{
+			EmitterDesc desc;
+
+			desc.position = { 320.0f, 240.0f };
+			desc.area = { 600.0f, 400.0f };
+			desc.rate = 0.0f;
+			desc.maxParticles = PARTICLES;
+
+			// Nothing dies during the benchmark
+			desc.minLife = 1000.0f;
+			desc.maxLife = 1000.0f;
+
+			m_Emitter = m_System.AddEmitter(desc);
+
+			m_Emitter->AddAffector({ Affector::Type::FORCE, { 0.0f, 10.0f }, 0.0f });
+			m_Emitter->AddAffector({ Affector::Type::DRAG, {}, 0.1f });
+			m_Emitter->AddAffector({ Affector::Type::ATTRACTOR, { 320.0f, 240.0f }, 50.0f });
+
+			m_Emitter->Burst(PARTICLES);
+
+			printf("%zu particles, %zu threads in the pool, %d frames\n", m_Emitter->GetCount(), ThreadPool().GetThreadsCount(), FRAMES);
+			printf("%-10s %10s %10s %10s %10s %10s %10s\n", "", "emit", "simulate", "compact", "build", "submit", "total");
+
+			return true;
+		}
+
+		bool OnUserUpdate(float) override
+		{
+			// A fixed step so every run does the same work
+			m_System.Update(1.0f / 60.0f);
+			m_System.Draw();
+
+			if (m_Frame++ >= WARMUP_FRAMES)
+			{
+				const ParticleStats& stats = m_Emitter->GetStats();
+
+				m_Total.emit += stats.emit;
+				m_Total.simulate += stats.simulate;
+				m_Total.compact += stats.compact;
+				m_Total.build += stats.build;
+				m_Total.submit += stats.submit;
+			}
+
+			if (m_Frame == WARMUP_FRAMES + FRAMES)
+			{
+				Print(m_Parallel ? "parallel" : "serial");
+
+				if (!m_Parallel)
+					return false;
+
+				m_Parallel = false;
+				m_Emitter->SetParallel(false);
+
+				m_Frame = 0;
+				m_Total = {};
+			}
+
+			return true;
+		}
+
+	private:
+		// Average milliseconds per frame of each phase
+		void Print(const char* mode)
+		{
+			const float ms = 1000.0f / FRAMES;
+			const ParticleStats& t = m_Total;
+
+			printf("%-10s %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n", mode,
+				t.emit * ms, t.simulate * ms, t.compact * ms, t.build * ms, t.submit * ms,
+				(t.emit + t.simulate + t.compact + t.build + t.submit) * ms);
+		}
+
+	private:
+		ParticleSystem m_System{ this };
+		ParticleEmitter* m_Emitter = nullptr;
+
+		ParticleStats m_Total;
+
+		int m_Frame = 0;
+		bool m_Parallel = true;
+
+	};
+
+	void Particles()
+	{
+		ParticlesBenchmark benchmark;
+
+		if (benchmark.Construct(640, 480, 1, 1))
+			benchmark.Run();
+	}
+}
@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Benchmarks.hpp"
+#include "defGameEngine.hpp"
+
+#include "../../Engine/Extensions/DGE_SpatialHash.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace def::benchmarks
+{
+	// 100k moving 4x4 rectangles in 8 pixel cells, and the O(n^2) checks
+	// that the hash replaces on a smaller set because they take too long on the full one
+	void SpatialHash()
+	{
+		constexpr size_t ENTITIES = 100000;
+		constexpr size_t BRUTE_FORCE_ENTITIES = 10000;
+
+		constexpr float WORLD_SIZE = 4000.0f;
+		constexpr float ENTITY_SIZE = 4.0f;
+		constexpr float CELL_SIZE = 8.0f;
+
+		std::mt19937 rng(2026);
+		std::uniform_real_distribution<float> position(0.0f, WORLD_SIZE);
+		std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+
+		std::vector<Vector2f> positions(ENTITIES);
+		std::vector<Vector2f> velocities(ENTITIES);
+
+		for (size_t i = 0; i < ENTITIES; i++)
+		{
+			positions[i] = { position(rng), position(rng) };
+			velocities[i] = { velocity(rng), velocity(rng) };
+		}
+
+		def::SpatialHash hash(CELL_SIZE, 65536);
+		std::vector<def::SpatialHash::Id> ids(ENTITIES);
+
+		auto insert = [&](size_t count)
+			{
+				hash.Clear();
+
+				for (size_t i = 0; i < count; i++)
+					ids[i] = hash.Insert(positions[i], { ENTITY_SIZE, ENTITY_SIZE });
+			};
+
+		std::vector<std::pair<def::SpatialHash::Id, def::SpatialHash::Id>> pairs;
+		std::vector<def::SpatialHash::Id> visible;
+
+		printf("%zu entities of %.0fx%.0f in a %.0fx%.0f world, %.0f pixel cells\n",
+			ENTITIES, ENTITY_SIZE, ENTITY_SIZE, WORLD_SIZE, WORLD_SIZE, CELL_SIZE);
+
+		printf("%-28s %10.3f ms\n", "insert all", Measure([&]() { insert(ENTITIES); }));
+
+		double move = Measure([&]()
+			{
+				for (size_t i = 0; i < ENTITIES; i++)
+				{
+					positions[i] += velocities[i];
+					hash.Move(ids[i], positions[i]);
+				}
+			});
+
+		printf("%-28s %10.3f ms\n", "move all", move);
+
+		double findPairs = Measure([&]()
+			{
+				pairs.clear();
+				hash.FindPairs(pairs);
+			});
+
+		printf("%-28s %10.3f ms, %zu pairs\n", "find all pairs", findPairs, pairs.size());
+
+		AffineTransforms transforms({ 1280, 720 }, { 1.0f, 1.0f });
+		transforms.SetOffset({ WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f });
+
+		double query = Measure([&]()
+			{
+				visible.clear();
+				hash.Query(transforms, { 1280.0f, 720.0f }, visible);
+			});
+
+		printf("%-28s %10.3f ms, %zu visible\n", "query a 1280x720 view", query, visible.size());
+
+		// The same pairs on the smaller set with the hash and with every rectangle against every other
+		insert(BRUTE_FORCE_ENTITIES);
+
+		double smallPairs = Measure([&]()
+			{
+				pairs.clear();
+				hash.FindPairs(pairs);
+			});
+
+		size_t hashPairs = pairs.size();
+
+		double bruteForce = Measure([&]()
+			{
+				pairs.clear();
+
+				for (def::SpatialHash::Id i = 0; i < BRUTE_FORCE_ENTITIES; i++)
+					for (def::SpatialHash::Id j = i + 1; j < BRUTE_FORCE_ENTITIES; j++)
+					{
+						const Vector2f& a = positions[i];
+						const Vector2f& b = positions[j];
+
+						if (a.x < b.x + ENTITY_SIZE && b.x < a.x + ENTITY_SIZE && a.y < b.y + ENTITY_SIZE && b.y < a.y + ENTITY_SIZE)
+							pairs.emplace_back(i, j);
+					}
+			}, 1);
+
+		printf("%-28s %10.3f ms, %zu pairs (%zu entities)\n", "find all pairs", smallPairs, hashPairs, BRUTE_FORCE_ENTITIES);
+		printf("%-28s %10.3f ms, %zu pairs (%zu entities)\n", "check every pair", bruteForce, pairs.size(), BRUTE_FORCE_ENTITIES);
+	}
+}
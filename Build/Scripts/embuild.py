@@ -37,7 +37,7 @@ def build(path, filename):
     c.add_flag('I"../../Engine/Include"')
 
     for source in get_files('../../Engine/Sources'):
-        if source != 'PlatformGLFW3.cpp':
+        if source not in ('PlatformGLFW3.cpp', 'PlatformHeadless.cpp'):
             c.add_argument(f'../../Engine/Sources/{source}')
 
     c.add_argument(f'{path}{filename}.cpp')
@@ -41,6 +41,26 @@ namespace def
 		bool IsPointVisible(const Vector2f& point);
 		bool IsRectVisible(const Vector2f& pos, const Vector2f& size);
 
+		// The model transform is applied to everything that is drawn
+		// before the view (the offset and the scale), Translate, Rotate and Scale
+		// are applied to the model before the current transform like in OpenGL
+		void PushTransform();
+		void PopTransform();
+		void ResetTransform();
+
+		void Translate(const Vector2f& offset);
+		void Rotate(float angle);
+		void Scale(const Vector2f& scale);
+
+		void SetTransform(const Matrix3& transform);
+		const Matrix3& GetTransform() const;
+
+		// From the world to the screen
+		Matrix3 GetViewMatrix() const;
+
+		// From the model to the screen, the points of all shapes go through it
+		Matrix3 GetMatrix() const;
+
 	public:
 		bool Draw(const Vector2f& pos, Pixel col = WHITE);
 		virtual bool Draw(float x, float y, Pixel col = WHITE);
@@ -84,6 +104,11 @@ namespace def
 		void FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation = 0.0f, float scale = 1.0f, const Pixel& col = WHITE);
 		virtual void FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation = 0.0f, float scale = 1.0f, const Pixel& col = WHITE);
 
+		// LINEAR takes the nearest texel of a sprite, BILINEAR and TRILINEAR both blend 4 texels
+		// of a single level, the levels aren't blended. The mipmaps of the sprites are used if they have been generated
+		void SetSampleMethod(Sprite::SampleMethod method);
+		Sprite::SampleMethod GetSampleMethod() const;
+
 		void DrawTexture(const Vector2f& pos, const Texture* tex, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
 		void DrawPartialTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
 
@@ -109,6 +134,11 @@ namespace def
 
 		void DrawTextureString(const Vector2f& pos, std::string_view text, const Pixel& col = def::WHITE, const Vector2f& scale = { 1.0f, 1.0f });
 
+	protected:
+		// Steps through the texels of each row in fixed point and writes
+		// the pixels directly into the draw target if the pixel mode is DEFAULT
+		void BlitSprite(const Vector2f& pos1, const Vector2f& pos2, const Vector2i& filePos, const Vector2i& fileSize, const Sprite* sprite);
+
 	protected:
 		Vector2f m_Offset;
 		Vector2f m_Scale = { 1.0f, 1.0f };
@@ -116,6 +146,14 @@ namespace def
 		Vector2f m_ViewArea;
 		Vector2f m_PixelStep = { 1.0f, 1.0f };
 
+		Sprite::SampleMethod m_SampleMethod = Sprite::SampleMethod::LINEAR;
+
+		Matrix3 m_Transform;
+		std::vector<Matrix3> m_TransformStack;
+
+		// Transformed points of polygons, is kept so they don't allocate on every call
+		std::vector<Vector2f> m_Points;
+
 		GameEngine* m_Engine = GameEngine::s_Engine;
 
 	};
@@ -217,9 +255,64 @@ namespace def
 		return p.x + s.x >= 0.0f && p.y + s.y >= 0.0f && p < m_ViewArea;
 	}
 
+	void AffineTransforms::PushTransform()
+	{
+		m_TransformStack.push_back(m_Transform);
+	}
+
+	void AffineTransforms::PopTransform()
+	{
+		if (m_TransformStack.empty())
+			return;
+
+		m_Transform = m_TransformStack.back();
+		m_TransformStack.pop_back();
+	}
+
+	void AffineTransforms::ResetTransform()
+	{
+		m_Transform = Matrix3();
+		m_TransformStack.clear();
+	}
+
+	void AffineTransforms::Translate(const Vector2f& offset)
+	{
+		m_Transform *= Matrix3::Translate(offset);
+	}
+
+	void AffineTransforms::Rotate(float angle)
+	{
+		m_Transform *= Matrix3::Rotate(angle);
+	}
+
+	void AffineTransforms::Scale(const Vector2f& scale)
+	{
+		m_Transform *= Matrix3::Scale(scale);
+	}
+
+	void AffineTransforms::SetTransform(const Matrix3& transform)
+	{
+		m_Transform = transform;
+	}
+
+	const Matrix3& AffineTransforms::GetTransform() const
+	{
+		return m_Transform;
+	}
+
+	Matrix3 AffineTransforms::GetViewMatrix() const
+	{
+		return Matrix3(m_Scale.x, 0.0f, -m_Offset.x * m_Scale.x, 0.0f, m_Scale.y, -m_Offset.y * m_Scale.y);
+	}
+
+	Matrix3 AffineTransforms::GetMatrix() const
+	{
+		return GetViewMatrix() * m_Transform;
+	}
+
 	bool AffineTransforms::Draw(const Vector2f& pos, Pixel col)
 	{
-		return m_Engine->Draw(WorldToScreen(pos), col);
+		return m_Engine->Draw(GetMatrix().Transform(pos), col);
 	}
 
 	bool AffineTransforms::Draw(float x, float y, Pixel col)
@@ -229,7 +322,8 @@ namespace def
 
 	void AffineTransforms::DrawLine(const Vector2f& pos1, const Vector2f& pos2, const Pixel& col)
 	{
-		m_Engine->DrawLine(WorldToScreen(pos1), WorldToScreen(pos2), col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawLine(transform.Transform(pos1), transform.Transform(pos2), col);
 	}
 
 	void AffineTransforms::DrawLine(float x1, float y1, float x2, float y2, const Pixel& col)
@@ -239,7 +333,8 @@ namespace def
 
 	void AffineTransforms::DrawTriangle(const Vector2f& pos1, const Vector2f& pos2, const Vector2f& pos3, const Pixel& col)
 	{
-		m_Engine->DrawTriangle(WorldToScreen(pos1), WorldToScreen(pos2), WorldToScreen(pos3), col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawTriangle(transform.Transform(pos1), transform.Transform(pos2), transform.Transform(pos3), col);
 	}
 
 	void AffineTransforms::DrawTriangle(float x1, float y1, float x2, float y2, float x3, float y3, const Pixel& col)
@@ -249,7 +344,8 @@ namespace def
 
 	void AffineTransforms::FillTriangle(const Vector2f& pos1, const Vector2f& pos2, const Vector2f& pos3, const Pixel& col)
 	{
-		m_Engine->FillTriangle(WorldToScreen(pos1), WorldToScreen(pos2), WorldToScreen(pos3), col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->FillTriangle(transform.Transform(pos1), transform.Transform(pos2), transform.Transform(pos3), col);
 	}
 
 	void AffineTransforms::FillTriangle(float x1, float y1, float x2, float y2, float x3, float y3, const Pixel& col)
@@ -259,7 +355,23 @@ namespace def
 
 	void AffineTransforms::DrawRectangle(const Vector2f& pos, const Vector2f& size, const Pixel& col)
 	{
-		m_Engine->DrawRectangle(WorldToScreen(pos), size * m_Scale, col);
+		Matrix3 transform = GetMatrix();
+
+		if (transform.IsAxisAligned())
+		{
+			Vector2f pos1 = transform.Transform(pos);
+			Vector2f pos2 = transform.Transform(pos + size);
+
+			m_Engine->DrawRectangle(pos1.Min(pos2), (pos2 - pos1).Abs(), col);
+			return;
+		}
+
+		// A rotated rectangle is drawn as a polygon
+		Vector2f corners[4] = { pos, { pos.x + size.x, pos.y }, pos + size, { pos.x, pos.y + size.y } };
+		transform.TransformPoints(corners, corners);
+
+		for (int i = 0; i < 4; i++)
+			m_Engine->DrawLine(corners[i], corners[(i + 1) % 4], col);
 	}
 
 	void AffineTransforms::DrawRectangle(float x, float y, float sizeX, float sizeY, const Pixel& col)
@@ -269,7 +381,22 @@ namespace def
 
 	void AffineTransforms::FillRectangle(const Vector2f& pos, const Vector2f& size, const Pixel& col)
 	{
-		m_Engine->FillRectangle(WorldToScreen(pos), size * m_Scale, col);
+		Matrix3 transform = GetMatrix();
+
+		if (transform.IsAxisAligned())
+		{
+			Vector2f pos1 = transform.Transform(pos);
+			Vector2f pos2 = transform.Transform(pos + size);
+
+			m_Engine->FillRectangle(pos1.Min(pos2), (pos2 - pos1).Abs(), col);
+			return;
+		}
+
+		Vector2f corners[4] = { pos, { pos.x + size.x, pos.y }, pos + size, { pos.x, pos.y + size.y } };
+		transform.TransformPoints(corners, corners);
+
+		m_Engine->FillTriangle(corners[0], corners[1], corners[2], col);
+		m_Engine->FillTriangle(corners[0], corners[2], corners[3], col);
 	}
 
 	void AffineTransforms::FillRectangle(float x, float y, float sizeX, float sizeY, const Pixel& col)
@@ -279,7 +406,8 @@ namespace def
 
 	void AffineTransforms::DrawCircle(const Vector2f& pos, float radius, const Pixel& col)
 	{
-		m_Engine->DrawCircle(WorldToScreen(pos), (float)radius * m_Scale.x, col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawCircle(transform.Transform(pos), radius * transform.GetScale().x, col);
 	}
 
 	void AffineTransforms::DrawCircle(float x, float y, float radius, const Pixel& col)
@@ -289,7 +417,8 @@ namespace def
 
 	void AffineTransforms::FillCircle(const Vector2f& pos, float radius, const Pixel& col)
 	{
-		m_Engine->FillCircle(WorldToScreen(pos), (float)radius * m_Scale.x, col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->FillCircle(transform.Transform(pos), radius * transform.GetScale().x, col);
 	}
 
 	void AffineTransforms::FillCircle(float x, float y, float radius, const Pixel& col)
@@ -299,7 +428,9 @@ namespace def
 
 	void AffineTransforms::DrawEllipse(const Vector2f& pos, const Vector2f& size, const Pixel& col)
 	{
-		m_Engine->DrawEllipse(WorldToScreen(pos), size * m_Scale, col);
+		// Ellipses are scaled but not rotated
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawEllipse(transform.Transform(pos), size * transform.GetScale().Abs(), col);
 	}
 
 	void AffineTransforms::DrawEllipse(float x, float y, float sizeX, float sizeY, const Pixel& col)
@@ -309,7 +440,8 @@ namespace def
 
 	void AffineTransforms::FillEllipse(const Vector2f& pos, const Vector2f& size, const Pixel& col)
 	{
-		m_Engine->FillEllipse(WorldToScreen(pos), size * m_Scale, col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->FillEllipse(transform.Transform(pos), size * transform.GetScale().Abs(), col);
 	}
 
 	void AffineTransforms::FillEllipse(float x, float y, float sizeX, float sizeY, const Pixel& col)
@@ -319,25 +451,7 @@ namespace def
 
 	void AffineTransforms::DrawSprite(const Vector2f& pos, const Sprite* sprite)
 	{
-		if (IsRectVisible(pos, sprite->size))
-		{
-			Vector2f size = sprite->size * m_Scale * m_PixelStep;
-			Vector2i spriteStart = WorldToScreen(pos);
-			Vector2i spriteEnd = WorldToScreen(pos + sprite->size);
-
-			Vector2i screenStart = spriteStart.Max({ 0, 0 });
-			Vector2i screenEnd = spriteEnd.Min(m_Engine->Window().GetScreenSize());
-
-			Vector2f step = 1.0f / size;
-
-			Vector2i pixel;
-			for (pixel.y = screenStart.y; pixel.y < screenEnd.y; pixel.y++)
-				for (pixel.x = screenStart.x; pixel.x < screenEnd.x; pixel.x++)
-				{
-					Vector2f sampled = Vector2f(pixel - spriteStart) * step;
-					m_Engine->Draw(pixel, sprite->Sample(sampled, Sprite::SampleMethod::LINEAR, Sprite::WrapMethod::NONE));
-				}
-		}
+		DrawPartialSprite(pos, { 0, 0 }, sprite->size, sprite);
 	}
 
 	void AffineTransforms::DrawSprite(float x, float y, const Sprite* sprite)
@@ -347,25 +461,13 @@ namespace def
 
 	void AffineTransforms::DrawPartialSprite(const Vector2f& pos, const Vector2i& filePos, const Vector2i& fileSize, const Sprite* sprite)
 	{
-		Vector2f flFileSize = fileSize;
-
-		if (IsRectVisible(pos, flFileSize * m_Scale))
-		{
-			Vector2f size = flFileSize * m_Scale * m_PixelStep;
-			Vector2f spriteStep = 1.0f / Vector2f(sprite->size);
-			Vector2f screenStep = 1.0f / size;
+		// Sprites are moved and scaled by the transform but not rotated
+		Matrix3 transform = GetMatrix();
 
-			Vector2i start = WorldToScreen(pos);
-			Vector2i end = start + size;
+		Vector2f pos1 = transform.Transform(pos);
+		Vector2f pos2 = transform.Transform(pos + Vector2f(fileSize) * m_PixelStep);
 
-			Vector2i p;
-			for (p.y = start.y; p.y < end.y; p.y++)
-				for (p.x = start.x; p.x < end.x; p.x++)
-				{
-					Vector2f sampledPos = (Vector2f(p - start) * screenStep * flFileSize + Vector2f(filePos)) * spriteStep;
-					m_Engine->Draw(p, sprite->Sample(sampledPos, Sprite::SampleMethod::LINEAR, Sprite::WrapMethod::NONE));
-				}
-		}
+		BlitSprite(pos1, pos2, filePos, fileSize, sprite);
 	}
 
 	void AffineTransforms::DrawPartialSprite(float x, float y, int fileX, int fileY, int fileSizeX, int fileSizeY, const Sprite* sprite)
@@ -375,12 +477,12 @@ namespace def
 
 	void AffineTransforms::DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation, float scale, const Pixel& col)
 	{
-		std::vector<Vector2f> transformed(modelCoordinates.size());
+		Matrix3 transform = GetMatrix() * Matrix3::Translate(pos) * Matrix3::Rotate(rotation) * Matrix3::Scale({ scale, scale });
 
-		std::transform(modelCoordinates.begin(), modelCoordinates.end(), transformed.begin(),
-					   [&](const Vector2f& p) { return p * m_Scale; });
+		m_Points.resize(modelCoordinates.size());
+		transform.TransformPoints(modelCoordinates, m_Points);
 
-		m_Engine->DrawWireFrameModel(transformed, WorldToScreen(pos), rotation, scale, col);
+		m_Engine->DrawWireFrameModel(m_Points, { 0.0f, 0.0f }, 0.0f, 1.0f, col);
 	}
 
 	void AffineTransforms::DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, const Pixel& col)
@@ -390,12 +492,12 @@ namespace def
 
 	void AffineTransforms::FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation, float scale, const Pixel& col)
 	{
-		std::vector<Vector2f> transformed(modelCoordinates.size());
+		Matrix3 transform = GetMatrix() * Matrix3::Translate(pos) * Matrix3::Rotate(rotation) * Matrix3::Scale({ scale, scale });
 
-		std::transform(modelCoordinates.begin(), modelCoordinates.end(), transformed.begin(),
-					   [&](const Vector2f& p) { return p * m_Scale; });
+		m_Points.resize(modelCoordinates.size());
+		transform.TransformPoints(modelCoordinates, m_Points);
 
-		m_Engine->FillWireFrameModel(transformed, WorldToScreen(pos), rotation, scale, col);
+		m_Engine->FillWireFrameModel(m_Points, { 0.0f, 0.0f }, 0.0f, 1.0f, col);
 	}
 
 	void AffineTransforms::FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, const Pixel& col)
@@ -405,42 +507,51 @@ namespace def
 
 	void AffineTransforms::DrawTexture(const Vector2f& pos, const Texture* tex, const Vector2f& scale, const Pixel& tint)
 	{
-		m_Engine->DrawTexture(WorldToScreen(pos), tex, scale * m_Scale * m_PixelStep, tint);
+		Matrix3 transform = GetMatrix();
+
+		if (transform.IsAxisAligned() && transform.m[0][0] > 0.0f && transform.m[1][1] > 0.0f)
+			m_Engine->DrawTexture(transform.Transform(pos), tex, scale * transform.GetScale() * m_PixelStep, tint);
+		else
+			m_Engine->DrawRotatedTexture(transform.Transform(pos), tex, transform.GetRotation(), { 0.0f, 0.0f }, scale * transform.GetScale() * m_PixelStep, tint);
 	}
 
 	void AffineTransforms::DrawPartialTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, const Vector2f& scale, const Pixel& tint)
 	{
-		m_Engine->DrawPartialTexture(WorldToScreen(pos), tex, filePos, fileSize, scale * m_Scale * m_PixelStep, tint);
+		Matrix3 transform = GetMatrix();
+
+		if (transform.IsAxisAligned() && transform.m[0][0] > 0.0f && transform.m[1][1] > 0.0f)
+			m_Engine->DrawPartialTexture(transform.Transform(pos), tex, filePos, fileSize, scale * transform.GetScale() * m_PixelStep, tint);
+		else
+			m_Engine->DrawPartialRotatedTexture(transform.Transform(pos), tex, filePos, fileSize, transform.GetRotation(), { 0.0f, 0.0f }, scale * transform.GetScale() * m_PixelStep, tint);
 	}
 
 	void AffineTransforms::DrawWarpedTexture(const std::vector<Vector2f>& points, const Texture* tex, const Pixel& tint)
 	{
-		std::vector<Vector2f> transformed(points.size());
-
-		std::transform(points.begin(), points.end(), transformed.begin(),
-					   [&](const Vector2f& p) { return WorldToScreen(p); });
+		m_Points.resize(points.size());
+		GetMatrix().TransformPoints(points, m_Points);
 
-		m_Engine->DrawWarpedTexture(transformed, tex, tint);
+		m_Engine->DrawWarpedTexture(m_Points, tex, tint);
 	}
 
 	void AffineTransforms::DrawRotatedTexture(const Vector2f& pos, const Texture* tex, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
 	{
-		m_Engine->DrawRotatedTexture(WorldToScreen(pos), tex, rotation, center, scale * m_Scale * m_PixelStep, tint);
+		// The scale of the transform is applied along the rotated axes of the texture
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawRotatedTexture(transform.Transform(pos), tex, rotation + transform.GetRotation(), center, scale * transform.GetScale() * m_PixelStep, tint);
 	}
 
 	void AffineTransforms::DrawPartialRotatedTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
 	{
-		m_Engine->DrawPartialRotatedTexture(WorldToScreen(pos), tex, filePos, fileSize, rotation, center, scale * m_Scale * m_PixelStep, tint);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawPartialRotatedTexture(transform.Transform(pos), tex, filePos, fileSize, rotation + transform.GetRotation(), center, scale * transform.GetScale() * m_PixelStep, tint);
 	}
 
 	void AffineTransforms::DrawTexturePolygon(const std::vector<Vector2f>& verts, const std::vector<Pixel>& cols, Texture::Structure structure)
 	{
-		std::vector<Vector2f> transformed(verts.size());
+		m_Points.resize(verts.size());
+		GetMatrix().TransformPoints(verts, m_Points);
 
-		std::transform(verts.begin(), verts.end(), transformed.begin(),
-					   [&](const Vector2f& p) { return WorldToScreen(p); });
-
-		m_Engine->DrawTexturePolygon(transformed, cols, structure);
+		m_Engine->DrawTexturePolygon(m_Points, cols, structure);
 	}
 
 	void AffineTransforms::DrawTextureLine(const Vector2f& pos1, const Vector2f& pos2, const Pixel& col)
@@ -470,30 +581,167 @@ namespace def
 
 	void AffineTransforms::DrawTextureCircle(const Vector2f& pos, float radius, const Pixel& col)
 	{
-		m_Engine->DrawTextureCircle(WorldToScreen(pos), (float)radius * m_Scale.x * m_PixelStep.x, col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawTextureCircle(transform.Transform(pos), radius * transform.GetScale().x * m_PixelStep.x, col);
 	}
 
 	void AffineTransforms::FillTextureCircle(const Vector2f& pos, float radius, const Pixel& col)
 	{
-		m_Engine->FillTextureCircle(WorldToScreen(pos), (float)radius * m_Scale.x * m_PixelStep.x, col);
+		Matrix3 transform = GetMatrix();
+		m_Engine->FillTextureCircle(transform.Transform(pos), radius * transform.GetScale().x * m_PixelStep.x, col);
 	}
 
 	void AffineTransforms::GradientTextureTriangle(const Vector2f& pos1, const Vector2f& pos2, const Vector2f& pos3, const Pixel& col1, const Pixel& col2, const Pixel& col3)
 	{
+		Matrix3 transform = GetMatrix();
+
 		m_Engine->GradientTextureTriangle(
-			WorldToScreen(pos1), WorldToScreen(pos2), WorldToScreen(pos3),
+			transform.Transform(pos1), transform.Transform(pos2), transform.Transform(pos3),
 			col1, col2, col3
 		);
 	}
 
 	void AffineTransforms::GradientTextureRectangle(const Vector2f& pos, const Vector2f& size, const Pixel& colTL, const Pixel& colTR, const Pixel& colBR, const Pixel& colBL)
 	{
-		m_Engine->GradientTextureRectangle(WorldToScreen(pos), size * m_Scale * m_PixelStep, colTL, colTR, colBR, colBL);
+		Matrix3 transform = GetMatrix();
+		m_Engine->GradientTextureRectangle(transform.Transform(pos), size * transform.GetScale() * m_PixelStep, colTL, colTR, colBR, colBL);
 	}
 
 	void AffineTransforms::DrawTextureString(const Vector2f& pos, std::string_view text, const Pixel& col, const Vector2f& scale)
 	{
-		m_Engine->DrawTextureString(WorldToScreen(pos), text, col, scale * m_Scale * m_PixelStep);
+		Matrix3 transform = GetMatrix();
+		m_Engine->DrawTextureString(transform.Transform(pos), text, col, scale * transform.GetScale() * m_PixelStep);
+	}
+
+	void AffineTransforms::SetSampleMethod(Sprite::SampleMethod method)
+	{
+		m_SampleMethod = method;
+	}
+
+	Sprite::SampleMethod AffineTransforms::GetSampleMethod() const
+	{
+		return m_SampleMethod;
+	}
+
+	void AffineTransforms::BlitSprite(const Vector2f& pos1, const Vector2f& pos2, const Vector2i& filePos, const Vector2i& fileSize, const Sprite* sprite)
+	{
+		Graphic* target = m_Engine->GetDrawTarget();
+
+		if (!target || fileSize.x <= 0 || fileSize.y <= 0 || pos1.x == pos2.x || pos1.y == pos2.y)
+			return;
+
+		Sprite* dst = target->sprite;
+
+		// Pixels whose centres are inside the rectangle, the corners can be swapped if the sprite is mirrored
+		int x0 = std::max((int)ceil(std::min(pos1.x, pos2.x) - 0.5f), 0);
+		int y0 = std::max((int)ceil(std::min(pos1.y, pos2.y) - 0.5f), 0);
+		int x1 = std::min((int)ceil(std::max(pos1.x, pos2.x) - 0.5f), dst->size.x);
+		int y1 = std::min((int)ceil(std::max(pos1.y, pos2.y) - 0.5f), dst->size.y);
+
+		if (x0 >= x1 || y0 >= y1)
+			return;
+
+		// Texels per pixel of the screen
+		Vector2f step = Vector2f(fileSize) / (pos2 - pos1);
+
+		// When zoomed out the mipmap with about one texel per pixel is used
+		const Sprite* src = sprite;
+		float texelsPerPixel = std::max(fabs(step.x), fabs(step.y));
+
+		if (texelsPerPixel > 1.0f && !sprite->mipmaps.empty())
+			src = sprite->GetMipmap((int)log2f(texelsPerPixel));
+
+		Vector2f mipScale = Vector2f(src->size) / Vector2f(sprite->size);
+
+		Vector2i regionStart = (Vector2f(filePos) * mipScale).Floor();
+		Vector2i regionEnd = (Vector2f(filePos + fileSize) * mipScale).Ceil();
+
+		regionStart = regionStart.Max({ 0, 0 }).Min(src->size - 1);
+		regionEnd = regionEnd.Max(regionStart + 1).Min(src->size);
+
+		step *= mipScale;
+
+		// Source coordinates at the centre of the first pixel
+		Vector2f start = Vector2f(filePos) * mipScale + (Vector2f(x0, y0) + 0.5f - pos1) * step;
+
+		bool isBilinear = m_SampleMethod != Sprite::SampleMethod::LINEAR;
+
+		// Bilinear weights are taken relatively to the centres of texels
+		if (isBilinear)
+			start -= 0.5f;
+
+		// 16.16 fixed point
+		int32_t u0 = int32_t(start.x * 65536.0f);
+		int32_t v = int32_t(start.y * 65536.0f);
+		int32_t du = int32_t(step.x * 65536.0f);
+		int32_t dv = int32_t(step.y * 65536.0f);
+
+		bool isDirect = m_Engine->GetPixelMode() == Pixel::Mode::DEFAULT;
+
+		// Interpolates two packed pixels with a weight from 0 to 256,
+		// red with blue and green with alpha are processed together
+		auto Lerp = [](uint32_t a, uint32_t b, uint32_t f)
+			{
+				uint32_t rb = (((a & 0x00FF00FF) * (256 - f) + (b & 0x00FF00FF) * f) >> 8) & 0x00FF00FF;
+				uint32_t ga = (((a >> 8) & 0x00FF00FF) * (256 - f) + ((b >> 8) & 0x00FF00FF) * f) & 0xFF00FF00;
+				return rb | ga;
+			};
+
+		for (int y = y0; y < y1; y++, v += dv)
+		{
+			Pixel* dstRow = dst->GetRow(y);
+
+			int iy = std::clamp(v >> 16, regionStart.y, regionEnd.y - 1);
+			const Pixel* srcRow = src->GetRow(iy);
+
+			int32_t u = u0;
+
+			if (!isBilinear)
+			{
+				for (int x = x0; x < x1; x++, u += du)
+				{
+					const Pixel& col = srcRow[std::clamp(u >> 16, regionStart.x, regionEnd.x - 1)];
+
+					if (isDirect)
+						dstRow[x] = col;
+					else
+						m_Engine->Draw(x, y, col);
+				}
+
+				continue;
+			}
+
+			// Outside of the region the coordinates stick to the edge texels, so nothing is blended there
+			int32_t vc = std::clamp(v, regionStart.y << 16, (regionEnd.y - 1) << 16);
+
+			iy = vc >> 16;
+
+			int iy1 = std::min(iy + 1, regionEnd.y - 1);
+			const Pixel* srcRow1 = src->GetRow(iy1);
+
+			uint32_t fy = (vc >> 8) & 0xFF;
+
+			for (int x = x0; x < x1; x++, u += du)
+			{
+				int32_t uc = std::clamp(u, regionStart.x << 16, (regionEnd.x - 1) << 16);
+
+				int ix = uc >> 16;
+				int ix1 = std::min(ix + 1, regionEnd.x - 1);
+
+				uint32_t fx = (uc >> 8) & 0xFF;
+
+				uint32_t top = Lerp(srcRow[ix].rgba_n, srcRow[ix1].rgba_n, fx);
+				uint32_t bottom = Lerp(srcRow1[ix].rgba_n, srcRow1[ix1].rgba_n, fx);
+
+				Pixel col;
+				col.rgba_n = Lerp(top, bottom, fy);
+
+				if (isDirect)
+					dstRow[x] = col;
+				else
+					m_Engine->Draw(x, y, col);
+			}
+		}
 	}
 
 	Vector2f AffineTransforms::ScreenToWorld(const Vector2f& pos) const
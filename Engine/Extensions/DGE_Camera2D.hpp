@@ -34,6 +34,10 @@ namespace def
 
 		Mode GetMode() const;
 		Vector2f GetPosition() const;
+		Vector2f GetViewArea() const;
+
+		// Returns the top-left corner of the view, the same as the result of Update
+		Vector2f GetOrigin() const;
 
 	private:
 		Mode m_Mode;
@@ -100,6 +104,16 @@ namespace def
 	{
 		return m_Position;
 	}
+
+	Vector2f Camera2D::GetViewArea() const
+	{
+		return m_ViewArea;
+	}
+
+	Vector2f Camera2D::GetOrigin() const
+	{
+		return m_Position - m_ViewArea * 0.5f;
+	}
 }
 
 #endif
@@ -0,0 +1,492 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#ifndef DGE_LIGHTING_HPP
+#define DGE_LIGHTING_HPP
+
+#include "../Include/defGameEngine.hpp"
+
+namespace def
+{
+	// Point lights with hard shadows of segments, rendered on the CPU into a lightmap
+	// that is smaller than the screen by the downscale factor. Each light is clipped
+	// to its visibility polygon, so the shadows cost as much as the segments near the light
+	// and not as much as the pixels. The lightmap is either multiplied onto the draw target
+	// with Apply or drawn on top of everything with Draw.
+	// Positions and radii are in pixels of the draw target
+	class Lighting
+	{
+	public:
+		struct Light
+		{
+			Vector2f pos;
+			float radius = 0.0f;
+			Pixel col = WHITE;
+		};
+
+	public:
+		Lighting() = default;
+		Lighting(const Vector2i& size, int downscale = 4);
+
+		// Removes all lights and segments
+		void Initialise(const Vector2i& size, int downscale = 4);
+
+		// The colour of the places that no light reaches
+		void SetAmbient(const Pixel& col);
+
+		void AddLight(const Vector2f& pos, float radius, const Pixel& col = WHITE);
+
+		// Segments cast shadows from both sides
+		void AddSegment(const Vector2f& start, const Vector2f& end);
+		void AddRectangle(const Vector2f& pos, const Vector2f& size);
+
+		// The last point is connected to the first one
+		void AddPolygon(const std::vector<Vector2f>& points);
+
+		void ClearLights();
+		void ClearSegments();
+
+		std::vector<Light>& GetLights();
+
+		// Builds the lightmap, the visibility polygons are computed per light
+		// and the rows of the lightmap are shaded in parallel on the thread pool of the engine
+		void Render();
+
+		// Multiplies the pixels of the draw target by the lightmap that is bilinearly upscaled to its size
+		void Apply();
+		void Apply(const SpriteView& target);
+
+		// Draws the lightmap over the screen as a texture, so it's blended by the GPU after all layers.
+		// The engine only blends with the alpha so the places are darkened by the brightest channel
+		// of the light and its colour is lost. Set the sample method to BILINEAR to smooth it out
+		void Draw();
+
+		const Sprite& GetLightmap() const;
+
+		// The visibility polygon of each light from the last Render, the first point is the light itself
+		const std::vector<Vector2f>& GetVisibility(size_t light) const;
+
+	private:
+		struct Segment
+		{
+			Vector2f start;
+			Vector2f end;
+		};
+
+		void ComputeVisibility(size_t light);
+		void ShadeRow(int y);
+
+		// Distance along dir to the segment or to the closest one, dir doesn't have to be normalised.
+		// It's INFINITY if nothing is hit
+		static float CastRay(const Vector2f& origin, const Vector2f& dir, const Segment& segment);
+		static float CastRay(const Vector2f& origin, const Vector2f& dir, const std::vector<Segment>& segments);
+
+	private:
+		Vector2i m_Size;
+		int m_Downscale = 4;
+
+		Sprite m_Lightmap;
+		Pixel m_Ambient = BLACK;
+
+		std::vector<Light> m_Lights;
+		std::vector<Segment> m_Segments;
+
+		// Triangle fans around the lights
+		std::vector<std::vector<Vector2f>> m_Visibility;
+
+		// Rows of the lightmap that are upscaled horizontally to the width of the target of Apply,
+		// the first column and the weight of the second one for each pixel of a row
+		std::vector<Pixel> m_Upscaled;
+		std::vector<int> m_Columns;
+		std::vector<uint16_t> m_Weights;
+
+		Sprite m_Overlay;
+		std::unique_ptr<Texture> m_Texture;
+
+		GameEngine* m_Engine = GameEngine::s_Engine;
+
+	};
+
+#ifdef DGE_LIGHTING
+#undef DGE_LIGHTING
+
+	Lighting::Lighting(const Vector2i& size, int downscale)
+	{
+		Initialise(size, downscale);
+	}
+
+	void Lighting::Initialise(const Vector2i& size, int downscale)
+	{
+		m_Size = size.Max({ 0, 0 });
+		m_Downscale = std::max(downscale, 1);
+
+		m_Lightmap.Create((m_Size + m_Downscale - 1) / m_Downscale);
+
+		m_Lights.clear();
+		m_Segments.clear();
+		m_Visibility.clear();
+	}
+
+	void Lighting::SetAmbient(const Pixel& col)
+	{
+		m_Ambient = col;
+	}
+
+	void Lighting::AddLight(const Vector2f& pos, float radius, const Pixel& col)
+	{
+		m_Lights.push_back({ pos, radius, col });
+	}
+
+	void Lighting::AddSegment(const Vector2f& start, const Vector2f& end)
+	{
+		m_Segments.push_back({ start, end });
+	}
+
+	void Lighting::AddRectangle(const Vector2f& pos, const Vector2f& size)
+	{
+		AddPolygon({ pos, { pos.x + size.x, pos.y }, pos + size, { pos.x, pos.y + size.y } });
+	}
+
+	void Lighting::AddPolygon(const std::vector<Vector2f>& points)
+	{
+		for (size_t i = 0; i < points.size(); i++)
+			AddSegment(points[i], points[(i + 1) % points.size()]);
+	}
+
+	void Lighting::ClearLights()
+	{
+		m_Lights.clear();
+	}
+
+	void Lighting::ClearSegments()
+	{
+		m_Segments.clear();
+	}
+
+	std::vector<Lighting::Light>& Lighting::GetLights()
+	{
+		return m_Lights;
+	}
+
+	void Lighting::Render()
+	{
+		if (m_Lightmap.pixels.empty())
+			return;
+
+		ThreadPool& pool = m_Engine->ThreadPool();
+
+		m_Visibility.resize(m_Lights.size());
+
+		// The lights don't depend on each other
+		pool.ParallelFor(0, (int)m_Lights.size(), [&](int i) { ComputeVisibility(i); });
+
+		// A row adds up all lights, so nothing is written by two threads
+		pool.ParallelFor(0, m_Lightmap.size.y, [&](int y) { ShadeRow(y); }, 4);
+	}
+
+	void Lighting::Apply()
+	{
+		Graphic* target = m_Engine->GetDrawTarget();
+
+		if (target)
+			Apply(target->sprite->GetView());
+	}
+
+	void Lighting::Apply(const SpriteView& target)
+	{
+		if (m_Lightmap.pixels.empty() || target.IsEmpty())
+			return;
+
+		const Vector2i& size = m_Lightmap.size;
+		Vector2f scale = Vector2f(size) / Vector2f(target.size);
+
+		// The pixel x of the target is between the columns x0 and x0 + 1 of the lightmap
+		m_Columns.resize(target.size.x);
+		m_Weights.resize(target.size.x);
+
+		for (int x = 0; x < target.size.x; x++)
+		{
+			float u = std::clamp(((float)x + 0.5f) * scale.x - 0.5f, 0.0f, float(size.x - 1));
+			int x0 = std::min((int)u, size.x - 2);
+
+			m_Columns[x] = std::max(x0, 0);
+			m_Weights[x] = size.x > 1 ? uint16_t((u - (float)x0) * 256.0f + 0.5f) : 0;
+		}
+
+		m_Upscaled.resize((size_t)target.size.x * size.y);
+
+		ThreadPool& pool = m_Engine->ThreadPool();
+
+		// Only the rows of the lightmap are upscaled here, there are downscale times less of them
+		pool.ParallelFor(0, size.y,
+			[&](int y)
+			{
+				const Pixel* src = m_Lightmap.GetRow(y);
+				Pixel* dst = &m_Upscaled[(size_t)y * target.size.x];
+
+				for (int x = 0; x < target.size.x; x++)
+				{
+					const Pixel& a = src[m_Columns[x]];
+					const Pixel& b = src[std::min(m_Columns[x] + 1, size.x - 1)];
+
+					int w = m_Weights[x];
+
+					dst[x] = Pixel(
+						uint8_t((a.r * (256 - w) + b.r * w + 128) >> 8),
+						uint8_t((a.g * (256 - w) + b.g * w + 128) >> 8),
+						uint8_t((a.b * (256 - w) + b.b * w + 128) >> 8),
+						255);
+				}
+			}, 4);
+
+		// Then each row of the target is a lerp of two upscaled rows and a multiplication, both in SIMD
+		pool.ParallelFor(0, target.size.y,
+			[&](int y)
+			{
+				float v = std::clamp(((float)y + 0.5f) * scale.y - 0.5f, 0.0f, float(size.y - 1));
+				int y0 = (int)v;
+				int y1 = std::min(y0 + 1, size.y - 1);
+
+				std::span<const Pixel> row0(&m_Upscaled[(size_t)y0 * target.size.x], target.size.x);
+				std::span<const Pixel> row1(&m_Upscaled[(size_t)y1 * target.size.x], target.size.x);
+
+				thread_local std::vector<Pixel> light;
+				light.resize(target.size.x);
+
+				PixelOps::Lerp(row0, row1, v - (float)y0, light);
+
+				std::span<Pixel> row(target.GetRow(y), target.size.x);
+				PixelOps::Modulate(row, light, row);
+			}, 8);
+	}
+
+	void Lighting::Draw()
+	{
+		if (m_Lightmap.pixels.empty())
+			return;
+
+		m_Overlay.Create(m_Lightmap.size);
+
+		for (int y = 0; y < m_Lightmap.size.y; y++)
+		{
+			const Pixel* src = m_Lightmap.GetRow(y);
+			Pixel* dst = m_Overlay.GetRow(y);
+
+			for (int x = 0; x < m_Lightmap.size.x; x++)
+				dst[x] = Pixel(0, 0, 0, uint8_t(255 - std::max({ src[x].r, src[x].g, src[x].b })));
+		}
+
+		if (m_Texture && m_Texture->imageSize == Vector2f(m_Overlay.size))
+			m_Texture->Update(m_Overlay.GetView());
+		else
+			m_Texture = std::make_unique<Texture>(m_Overlay.GetView());
+
+		m_Engine->DrawTexture({ 0.0f, 0.0f }, m_Texture.get(), Vector2f(m_Size) / Vector2f(m_Overlay.size));
+	}
+
+	const Sprite& Lighting::GetLightmap() const
+	{
+		return m_Lightmap;
+	}
+
+	const std::vector<Vector2f>& Lighting::GetVisibility(size_t light) const
+	{
+		return m_Visibility[light];
+	}
+
+	void Lighting::ComputeVisibility(size_t light)
+	{
+		const Light& l = m_Lights[light];
+		std::vector<Vector2f>& polygon = m_Visibility[light];
+
+		polygon.clear();
+
+		if (l.radius <= 0.0f)
+			return;
+
+		Vector2f min = l.pos - l.radius;
+		Vector2f max = l.pos + l.radius;
+
+		// Only the segments that cross the square around the light can cast its shadows
+		// and the square itself stops the rays that don't hit anything
+		std::vector<Segment> segments =
+		{
+			{ min, { max.x, min.y } },
+			{ { max.x, min.y }, max },
+			{ max, { min.x, max.y } },
+			{ { min.x, max.y }, min }
+		};
+
+		for (const Segment& s : m_Segments)
+		{
+			Vector2f from = s.start.Min(s.end);
+			Vector2f to = s.start.Max(s.end);
+
+			if (from.x <= max.x && to.x >= min.x && from.y <= max.y && to.y >= min.y)
+				segments.push_back(s);
+		}
+
+		// The outline only changes its direction at the ends of the segments, so the rays go
+		// to every end and slightly past both sides of it to reach whatever is behind
+		std::vector<float> angles;
+		angles.reserve(segments.size() * 6);
+
+		for (const Segment& s : segments)
+		{
+			for (const Vector2f& p : { s.start, s.end })
+			{
+				float angle = atan2(p.y - l.pos.y, p.x - l.pos.x);
+
+				angles.push_back(angle - 0.0001f);
+				angles.push_back(angle);
+				angles.push_back(angle + 0.0001f);
+			}
+		}
+
+		// Crossing segments switch the closest one between their ends too
+		for (size_t i = 0; i < segments.size(); i++)
+			for (size_t j = i + 1; j < segments.size(); j++)
+			{
+				Vector2f dir = segments[i].end - segments[i].start;
+				float distance = CastRay(segments[i].start, dir, segments[j]);
+
+				if (distance <= 1.0f)
+				{
+					Vector2f p = segments[i].start + dir * distance;
+					angles.push_back(atan2(p.y - l.pos.y, p.x - l.pos.x));
+				}
+			}
+
+		std::sort(angles.begin(), angles.end());
+
+		polygon.reserve(angles.size() + 1);
+		polygon.push_back(l.pos);
+
+		for (float angle : angles)
+		{
+			Vector2f dir(cos(angle), sin(angle));
+			polygon.push_back(l.pos + dir * CastRay(l.pos, dir, segments));
+		}
+	}
+
+	void Lighting::ShadeRow(int y)
+	{
+		const int width = m_Lightmap.size.x;
+		const float downscale = (float)m_Downscale;
+
+		// The centre of the row in pixels of the target
+		float centreY = ((float)y + 0.5f) * downscale;
+
+		thread_local std::vector<float> sum;
+		sum.assign((size_t)width * 3, 0.0f);
+
+		// X of a triangle edge on the row if the edge crosses it, an edge is crossed
+		// if its ends are on different sides so a triangle always has 0 or 2 crossings
+		auto Cross = [centreY](const Vector2f& p, const Vector2f& q, float& x)
+			{
+				if ((p.y <= centreY) == (q.y <= centreY))
+					return false;
+
+				x = p.x + (centreY - p.y) * (q.x - p.x) / (q.y - p.y);
+				return true;
+			};
+
+		for (size_t i = 0; i < m_Lights.size(); i++)
+		{
+			const Light& l = m_Lights[i];
+			const std::vector<Vector2f>& polygon = m_Visibility[i];
+
+			if (polygon.size() < 3 || fabs(centreY - l.pos.y) >= l.radius)
+				continue;
+
+			float invRadius = 1.0f / l.radius;
+			float dy = (centreY - l.pos.y) * invRadius;
+
+			for (size_t j = 1; j < polygon.size(); j++)
+			{
+				const Vector2f& p = polygon[j];
+				const Vector2f& q = polygon[j + 1 < polygon.size() ? j + 1 : 1];
+
+				float xs[2];
+				int crossings = 0;
+
+				// The edges from the light are crossed with the same arguments by both of their
+				// triangles, so neighbouring spans meet exactly and no pixel is lit twice
+				if (Cross(l.pos, p, xs[crossings])) crossings++;
+				if (Cross(p, q, xs[crossings])) crossings++;
+				if (crossings < 2 && Cross(l.pos, q, xs[crossings])) crossings++;
+
+				if (crossings < 2)
+					continue;
+
+				// Pixels whose centres are in [left, right)
+				int from = std::max((int)ceil(std::min(xs[0], xs[1]) / downscale - 0.5f), 0);
+				int to = std::min((int)ceil(std::max(xs[0], xs[1]) / downscale - 0.5f), width);
+
+				for (int x = from; x < to; x++)
+				{
+					float dx = (((float)x + 0.5f) * downscale - l.pos.x) * invRadius;
+					float distance = sqrt(dx * dx + dy * dy);
+
+					if (distance >= 1.0f)
+						continue;
+
+					float falloff = (1.0f - distance) * (1.0f - distance);
+
+					float* s = &sum[(size_t)x * 3];
+					s[0] += (float)l.col.r * falloff;
+					s[1] += (float)l.col.g * falloff;
+					s[2] += (float)l.col.b * falloff;
+				}
+			}
+		}
+
+		Pixel* row = m_Lightmap.GetRow(y);
+
+		for (int x = 0; x < width; x++)
+		{
+			const float* s = &sum[(size_t)x * 3];
+
+			row[x] = Pixel(
+				(uint8_t)std::min((float)m_Ambient.r + s[0], 255.0f),
+				(uint8_t)std::min((float)m_Ambient.g + s[1], 255.0f),
+				(uint8_t)std::min((float)m_Ambient.b + s[2], 255.0f),
+				255);
+		}
+	}
+
+	float Lighting::CastRay(const Vector2f& origin, const Vector2f& dir, const Segment& segment)
+	{
+		Vector2f edge = segment.end - segment.start;
+		float denominator = dir.x * edge.y - dir.y * edge.x;
+
+		// Parallel to the ray
+		if (fabs(denominator) < 1e-8f)
+			return INFINITY;
+
+		Vector2f offset = segment.start - origin;
+
+		float t = (offset.x * edge.y - offset.y * edge.x) / denominator;
+		float u = (offset.x * dir.y - offset.y * dir.x) / denominator;
+
+		return (t > 0.0f && u >= 0.0f && u <= 1.0f) ? t : INFINITY;
+	}
+
+	float Lighting::CastRay(const Vector2f& origin, const Vector2f& dir, const std::vector<Segment>& segments)
+	{
+		float closest = INFINITY;
+
+		for (const Segment& s : segments)
+			closest = std::min(closest, CastRay(origin, dir, s));
+
+		return closest;
+	}
+
+#endif
+
+}
+
+#endif
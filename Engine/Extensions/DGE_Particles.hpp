@@ -0,0 +1,694 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#ifndef DGE_PARTICLES_HPP
+#define DGE_PARTICLES_HPP
+
+#include "../Include/defGameEngine.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DGE_PARTICLES_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define DGE_PARTICLES_NEON
+#endif
+
+namespace def
+{
+	// Describes how an emitter spawns particles and how they look,
+	// positions and sizes are in pixels, angles are in radians
+	struct EmitterDesc
+	{
+		Vector2f position;
+
+		// Particles appear anywhere in the rectangle centred at the position
+		Vector2f area;
+
+		// Particles per second
+		float rate = 100.0f;
+
+		size_t maxParticles = 10000;
+
+		float minLife = 1.0f;
+		float maxLife = 2.0f;
+
+		// The velocity points at a random angle in [direction - spread / 2, direction + spread / 2]
+		float direction = -1.5707963f;
+		float spread = 1.0f;
+
+		float minSpeed = 20.0f;
+		float maxSpeed = 50.0f;
+
+		// Size and colour go from start to end over the life of a particle
+		float startSize = 4.0f;
+		float endSize = 1.0f;
+
+		Pixel startColour = WHITE;
+		Pixel endColour = NONE;
+
+		// Is stretched over each particle, plain quads are drawn if it's nullptr
+		const Texture* texture = nullptr;
+	};
+
+	// Changes the velocities of all particles of an emitter on every update
+	struct Affector
+	{
+		enum class Type
+		{
+			// Adds vector as an acceleration, e.g. gravity
+			FORCE,
+
+			// Slows particles down by strength per second
+			DRAG,
+
+			// Accelerates particles towards vector by strength pixels per second squared,
+			// a negative strength pushes them away
+			ATTRACTOR
+		};
+
+		Type type = Type::FORCE;
+		Vector2f vector;
+		float strength = 0.0f;
+	};
+
+	// Time spent on each phase of the last update and draw in seconds
+	struct ParticleStats
+	{
+		// Spawning new particles
+		float emit = 0.0f;
+
+		// Applying the affectors and moving the particles
+		float simulate = 0.0f;
+
+		// Removing dead particles
+		float compact = 0.0f;
+
+		// Building the vertices
+		float build = 0.0f;
+
+		// Submitting the vertices to the layer
+		float submit = 0.0f;
+
+		size_t alive = 0;
+		size_t emitted = 0;
+		size_t killed = 0;
+	};
+
+	// Keeps the particles as a structure of arrays, so the update
+	// processes 4 particles at once with SSE2 or NEON. Large emitters
+	// are updated and built on the thread pool of the engine.
+	// All particles are drawn with a single batch of triangles
+	class ParticleEmitter
+	{
+	public:
+		ParticleEmitter(GameEngine* engine, const EmitterDesc& desc);
+
+		// Can be changed at any time, e.g. to move the emitter
+		EmitterDesc& Desc();
+		const EmitterDesc& Desc() const;
+
+		void AddAffector(const Affector& affector);
+		void ClearAffectors();
+
+		// Spawns count particles at once ignoring the rate
+		void Burst(size_t count);
+
+		// Stops spawning particles by the rate, the alive ones continue to move
+		void SetEmitting(bool emitting);
+		bool IsEmitting() const;
+
+		void Clear();
+
+		void Update(float deltaTime);
+
+		// Particles are drawn moved by -offset, e.g. by the origin of a camera
+		void Draw(const Vector2f& offset = { 0.0f, 0.0f });
+
+		// Don't use the thread pool for this emitter
+		void SetParallel(bool parallel);
+
+		size_t GetCount() const;
+		const ParticleStats& GetStats() const;
+
+	private:
+		void Emit(size_t count);
+
+		void Simulate(size_t begin, size_t end, float deltaTime);
+		void Build(size_t begin, size_t end, const Vector2f& offset);
+
+		// Calls func(begin, end) for blocks of particles on the thread pool
+		template <class Func>
+		void ForEachBlock(Func&& func);
+
+		float Random();
+		float Random(float min, float max);
+
+	private:
+		GameEngine* m_Engine;
+
+		EmitterDesc m_Desc;
+		std::vector<Affector> m_Affectors;
+
+		// Structure of arrays, only the first m_Count elements are alive
+		std::vector<float> m_PosX;
+		std::vector<float> m_PosY;
+		std::vector<float> m_VelX;
+		std::vector<float> m_VelY;
+		std::vector<float> m_Age;
+		std::vector<float> m_InvLife;
+
+		size_t m_Count = 0;
+
+		// Fraction of a particle that hasn't been spawned yet
+		float m_EmitRemainder = 0.0f;
+
+		bool m_IsEmitting = true;
+		bool m_IsParallel = true;
+
+		uint32_t m_Seed = 0x9E3779B9;
+
+		// 6 vertices per particle, they're moved into the layer
+		// on every draw instead of being copied
+		std::vector<Vector2f> m_Vertices;
+		std::vector<Vector2f> m_UVs;
+		std::vector<Pixel> m_Colours;
+
+		ParticleStats m_Stats;
+
+	};
+
+	// Owns several emitters and updates and draws them in order
+	class ParticleSystem
+	{
+	public:
+		ParticleSystem(GameEngine* engine);
+
+		ParticleEmitter* AddEmitter(const EmitterDesc& desc);
+		void RemoveEmitter(ParticleEmitter* emitter);
+
+		void Clear();
+
+		void Update(float deltaTime);
+		void Draw(const Vector2f& offset = { 0.0f, 0.0f });
+
+		// The sum of the stats of all emitters
+		ParticleStats GetStats() const;
+
+	private:
+		GameEngine* m_Engine;
+		std::vector<std::unique_ptr<ParticleEmitter>> m_Emitters;
+
+	};
+
+#ifdef DGE_PARTICLES
+#undef DGE_PARTICLES
+
+	namespace ParticleSimd
+	{
+	#if defined(DGE_PARTICLES_SSE2)
+		using Float4 = __m128;
+
+		inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+		inline void Store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+		inline Float4 Set(float v) { return _mm_set1_ps(v); }
+		inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+		inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+		inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+		inline Float4 InvSqrt(Float4 a) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a)); }
+	#elif defined(DGE_PARTICLES_NEON)
+		using Float4 = float32x4_t;
+
+		inline Float4 Load(const float* p) { return vld1q_f32(p); }
+		inline void Store(float* p, Float4 v) { vst1q_f32(p, v); }
+		inline Float4 Set(float v) { return vdupq_n_f32(v); }
+		inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+		inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+		inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+
+		// The estimate is refined with two Newton-Raphson steps
+		inline Float4 InvSqrt(Float4 a)
+		{
+			Float4 e = vrsqrteq_f32(a);
+			e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+			return vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+		}
+	#endif
+	}
+
+	// Particles in a block are processed by a single task
+	static constexpr size_t PARTICLES_BLOCK_SIZE = 16384;
+
+	ParticleEmitter::ParticleEmitter(GameEngine* engine, const EmitterDesc& desc)
+		: m_Engine(engine), m_Desc(desc)
+	{
+	}
+
+	EmitterDesc& ParticleEmitter::Desc()
+	{
+		return m_Desc;
+	}
+
+	const EmitterDesc& ParticleEmitter::Desc() const
+	{
+		return m_Desc;
+	}
+
+	void ParticleEmitter::AddAffector(const Affector& affector)
+	{
+		m_Affectors.push_back(affector);
+	}
+
+	void ParticleEmitter::ClearAffectors()
+	{
+		m_Affectors.clear();
+	}
+
+	void ParticleEmitter::Burst(size_t count)
+	{
+		Emit(count);
+	}
+
+	void ParticleEmitter::SetEmitting(bool emitting)
+	{
+		m_IsEmitting = emitting;
+	}
+
+	bool ParticleEmitter::IsEmitting() const
+	{
+		return m_IsEmitting;
+	}
+
+	void ParticleEmitter::Clear()
+	{
+		m_Count = 0;
+		m_EmitRemainder = 0.0f;
+	}
+
+	void ParticleEmitter::Update(float deltaTime)
+	{
+		m_Stats.emitted = 0;
+		m_Stats.killed = 0;
+
+		auto start = Clock::now();
+
+		if (m_IsEmitting)
+		{
+			m_EmitRemainder += m_Desc.rate * deltaTime;
+
+			size_t count = (size_t)m_EmitRemainder;
+			m_EmitRemainder -= (float)count;
+
+			Emit(count);
+		}
+
+		auto emitted = Clock::now();
+
+		ForEachBlock([&](size_t begin, size_t end) { Simulate(begin, end, deltaTime); });
+
+		auto simulated = Clock::now();
+
+		// Dead particles are replaced with the last ones
+		size_t i = 0;
+
+		while (i < m_Count)
+		{
+			if (m_Age[i] * m_InvLife[i] >= 1.0f)
+			{
+				m_Count--;
+
+				m_PosX[i] = m_PosX[m_Count];
+				m_PosY[i] = m_PosY[m_Count];
+				m_VelX[i] = m_VelX[m_Count];
+				m_VelY[i] = m_VelY[m_Count];
+				m_Age[i] = m_Age[m_Count];
+				m_InvLife[i] = m_InvLife[m_Count];
+
+				m_Stats.killed++;
+			}
+			else
+				i++;
+		}
+
+		auto compacted = Clock::now();
+
+		m_Stats.emit = std::chrono::duration<float>(emitted - start).count();
+		m_Stats.simulate = std::chrono::duration<float>(simulated - emitted).count();
+		m_Stats.compact = std::chrono::duration<float>(compacted - simulated).count();
+		m_Stats.alive = m_Count;
+	}
+
+	void ParticleEmitter::Draw(const Vector2f& offset)
+	{
+		auto start = Clock::now();
+
+		size_t verticesCount = m_Count * 6;
+
+		m_Vertices.resize(verticesCount);
+		m_Colours.resize(verticesCount);
+		m_UVs.resize(m_Desc.texture ? verticesCount : 0);
+
+		ForEachBlock([&](size_t begin, size_t end) { Build(begin, end, offset); });
+
+		auto built = Clock::now();
+
+		if (verticesCount > 0)
+			m_Engine->DrawTextureTriangles(m_Desc.texture, std::move(m_Vertices), std::move(m_UVs), std::move(m_Colours));
+
+		m_Stats.build = std::chrono::duration<float>(built - start).count();
+		m_Stats.submit = std::chrono::duration<float>(Clock::now() - built).count();
+	}
+
+	void ParticleEmitter::SetParallel(bool parallel)
+	{
+		m_IsParallel = parallel;
+	}
+
+	size_t ParticleEmitter::GetCount() const
+	{
+		return m_Count;
+	}
+
+	const ParticleStats& ParticleEmitter::GetStats() const
+	{
+		return m_Stats;
+	}
+
+	void ParticleEmitter::Emit(size_t count)
+	{
+		count = std::min(count, m_Desc.maxParticles - std::min(m_Count, m_Desc.maxParticles));
+
+		if (count == 0)
+			return;
+
+		size_t newCount = m_Count + count;
+
+		// Extra space so the SIMD loops never read past the end
+		if (m_PosX.size() < newCount)
+		{
+			size_t capacity = (newCount + 3) & ~size_t(3);
+
+			m_PosX.resize(capacity);
+			m_PosY.resize(capacity);
+			m_VelX.resize(capacity);
+			m_VelY.resize(capacity);
+			m_Age.resize(capacity);
+			m_InvLife.resize(capacity);
+		}
+
+		for (size_t i = m_Count; i < newCount; i++)
+		{
+			float angle = m_Desc.direction + (Random() - 0.5f) * m_Desc.spread;
+			float speed = Random(m_Desc.minSpeed, m_Desc.maxSpeed);
+
+			m_PosX[i] = m_Desc.position.x + (Random() - 0.5f) * m_Desc.area.x;
+			m_PosY[i] = m_Desc.position.y + (Random() - 0.5f) * m_Desc.area.y;
+			m_VelX[i] = cos(angle) * speed;
+			m_VelY[i] = sin(angle) * speed;
+			m_Age[i] = 0.0f;
+			m_InvLife[i] = 1.0f / std::max(Random(m_Desc.minLife, m_Desc.maxLife), 0.0001f);
+		}
+
+		m_Count = newCount;
+		m_Stats.emitted += count;
+	}
+
+	void ParticleEmitter::Simulate(size_t begin, size_t end, float deltaTime)
+	{
+		float* posX = m_PosX.data();
+		float* posY = m_PosY.data();
+		float* velX = m_VelX.data();
+		float* velY = m_VelY.data();
+		float* age = m_Age.data();
+
+		for (const auto& affector : m_Affectors)
+		{
+			size_t i = begin;
+
+			switch (affector.type)
+			{
+			case Affector::Type::FORCE:
+			{
+				float ax = affector.vector.x * deltaTime;
+				float ay = affector.vector.y * deltaTime;
+
+			#if defined(DGE_PARTICLES_SSE2) || defined(DGE_PARTICLES_NEON)
+				using namespace ParticleSimd;
+
+				Float4 ax4 = Set(ax);
+				Float4 ay4 = Set(ay);
+
+				for (; i + 4 <= end; i += 4)
+				{
+					Store(velX + i, Add(Load(velX + i), ax4));
+					Store(velY + i, Add(Load(velY + i), ay4));
+				}
+			#endif
+
+				for (; i < end; i++)
+				{
+					velX[i] += ax;
+					velY[i] += ay;
+				}
+			}
+			break;
+
+			case Affector::Type::DRAG:
+			{
+				float factor = std::max(1.0f - affector.strength * deltaTime, 0.0f);
+
+			#if defined(DGE_PARTICLES_SSE2) || defined(DGE_PARTICLES_NEON)
+				using namespace ParticleSimd;
+
+				Float4 factor4 = Set(factor);
+
+				for (; i + 4 <= end; i += 4)
+				{
+					Store(velX + i, Mul(Load(velX + i), factor4));
+					Store(velY + i, Mul(Load(velY + i), factor4));
+				}
+			#endif
+
+				for (; i < end; i++)
+				{
+					velX[i] *= factor;
+					velY[i] *= factor;
+				}
+			}
+			break;
+
+			case Affector::Type::ATTRACTOR:
+			{
+				float acceleration = affector.strength * deltaTime;
+
+				// Particles at the point itself aren't divided by zero
+				const float epsilon = 0.0001f;
+
+			#if defined(DGE_PARTICLES_SSE2) || defined(DGE_PARTICLES_NEON)
+				using namespace ParticleSimd;
+
+				Float4 pointX4 = Set(affector.vector.x);
+				Float4 pointY4 = Set(affector.vector.y);
+				Float4 acceleration4 = Set(acceleration);
+				Float4 epsilon4 = Set(epsilon);
+
+				for (; i + 4 <= end; i += 4)
+				{
+					Float4 dx = Sub(pointX4, Load(posX + i));
+					Float4 dy = Sub(pointY4, Load(posY + i));
+					Float4 scale = Mul(acceleration4, InvSqrt(Add(Add(Mul(dx, dx), Mul(dy, dy)), epsilon4)));
+
+					Store(velX + i, Add(Load(velX + i), Mul(dx, scale)));
+					Store(velY + i, Add(Load(velY + i), Mul(dy, scale)));
+				}
+			#endif
+
+				for (; i < end; i++)
+				{
+					float dx = affector.vector.x - posX[i];
+					float dy = affector.vector.y - posY[i];
+					float scale = acceleration / sqrt(dx * dx + dy * dy + epsilon);
+
+					velX[i] += dx * scale;
+					velY[i] += dy * scale;
+				}
+			}
+			break;
+
+			}
+		}
+
+		size_t i = begin;
+
+	#if defined(DGE_PARTICLES_SSE2) || defined(DGE_PARTICLES_NEON)
+		using namespace ParticleSimd;
+
+		Float4 deltaTime4 = Set(deltaTime);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			Store(posX + i, Add(Load(posX + i), Mul(Load(velX + i), deltaTime4)));
+			Store(posY + i, Add(Load(posY + i), Mul(Load(velY + i), deltaTime4)));
+			Store(age + i, Add(Load(age + i), deltaTime4));
+		}
+	#endif
+
+		for (; i < end; i++)
+		{
+			posX[i] += velX[i] * deltaTime;
+			posY[i] += velY[i] * deltaTime;
+			age[i] += deltaTime;
+		}
+	}
+
+	void ParticleEmitter::Build(size_t begin, size_t end, const Vector2f& offset)
+	{
+		const Pixel& start = m_Desc.startColour;
+		const Pixel& finish = m_Desc.endColour;
+
+		for (size_t i = begin; i < end; i++)
+		{
+			float t = std::min(m_Age[i] * m_InvLife[i], 1.0f);
+			float halfSize = (m_Desc.startSize + (m_Desc.endSize - m_Desc.startSize) * t) * 0.5f;
+
+			float x = m_PosX[i] - offset.x;
+			float y = m_PosY[i] - offset.y;
+
+			Vector2f tl(x - halfSize, y - halfSize);
+			Vector2f br(x + halfSize, y + halfSize);
+
+			Vector2f* vertices = &m_Vertices[i * 6];
+
+			vertices[0] = tl;
+			vertices[1] = { tl.x, br.y };
+			vertices[2] = br;
+			vertices[3] = tl;
+			vertices[4] = br;
+			vertices[5] = { br.x, tl.y };
+
+			Pixel col(
+				uint8_t(start.r + (finish.r - start.r) * t),
+				uint8_t(start.g + (finish.g - start.g) * t),
+				uint8_t(start.b + (finish.b - start.b) * t),
+				uint8_t(start.a + (finish.a - start.a) * t));
+
+			std::fill_n(&m_Colours[i * 6], 6, col);
+		}
+
+		if (const Texture* tex = m_Desc.texture)
+		{
+			// The same as TextureInstance::ConstructUV
+			Vector2f tl = -tex->pos;
+			Vector2f br = tl + tex->size / tex->imageSize;
+
+			for (size_t i = begin * 6; i < end * 6; i += 6)
+			{
+				m_UVs[i] = tl;
+				m_UVs[i + 1] = { tl.x, br.y };
+				m_UVs[i + 2] = br;
+				m_UVs[i + 3] = tl;
+				m_UVs[i + 4] = br;
+				m_UVs[i + 5] = { br.x, tl.y };
+			}
+		}
+	}
+
+	template <class Func>
+	void ParticleEmitter::ForEachBlock(Func&& func)
+	{
+		if (!m_IsParallel || m_Count <= PARTICLES_BLOCK_SIZE)
+		{
+			func(0, m_Count);
+			return;
+		}
+
+		int blocks = int((m_Count + PARTICLES_BLOCK_SIZE - 1) / PARTICLES_BLOCK_SIZE);
+
+		m_Engine->ThreadPool().ParallelFor(0, blocks,
+			[&](int block)
+			{
+				size_t begin = block * PARTICLES_BLOCK_SIZE;
+				func(begin, std::min(begin + PARTICLES_BLOCK_SIZE, m_Count));
+			});
+	}
+
+	float ParticleEmitter::Random()
+	{
+		// xorshift32, fast and the same on every platform
+		m_Seed ^= m_Seed << 13;
+		m_Seed ^= m_Seed >> 17;
+		m_Seed ^= m_Seed << 5;
+
+		return float(m_Seed >> 8) / float(1 << 24);
+	}
+
+	float ParticleEmitter::Random(float min, float max)
+	{
+		return min + (max - min) * Random();
+	}
+
+	ParticleSystem::ParticleSystem(GameEngine* engine) : m_Engine(engine)
+	{
+	}
+
+	ParticleEmitter* ParticleSystem::AddEmitter(const EmitterDesc& desc)
+	{
+		m_Emitters.push_back(std::make_unique<ParticleEmitter>(m_Engine, desc));
+		return m_Emitters.back().get();
+	}
+
+	void ParticleSystem::RemoveEmitter(ParticleEmitter* emitter)
+	{
+		auto iter = std::find_if(m_Emitters.begin(), m_Emitters.end(),
+			[emitter](const std::unique_ptr<ParticleEmitter>& e) { return e.get() == emitter; });
+
+		if (iter != m_Emitters.end())
+			m_Emitters.erase(iter);
+	}
+
+	void ParticleSystem::Clear()
+	{
+		m_Emitters.clear();
+	}
+
+	void ParticleSystem::Update(float deltaTime)
+	{
+		for (auto& emitter : m_Emitters)
+			emitter->Update(deltaTime);
+	}
+
+	void ParticleSystem::Draw(const Vector2f& offset)
+	{
+		for (auto& emitter : m_Emitters)
+			emitter->Draw(offset);
+	}
+
+	ParticleStats ParticleSystem::GetStats() const
+	{
+		ParticleStats total;
+
+		for (const auto& emitter : m_Emitters)
+		{
+			const ParticleStats& stats = emitter->GetStats();
+
+			total.emit += stats.emit;
+			total.simulate += stats.simulate;
+			total.compact += stats.compact;
+			total.build += stats.build;
+			total.submit += stats.submit;
+			total.alive += stats.alive;
+			total.emitted += stats.emitted;
+			total.killed += stats.killed;
+		}
+
+		return total;
+	}
+
+#endif
+
+}
+
+#endif
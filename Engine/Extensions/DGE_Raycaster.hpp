@@ -0,0 +1,474 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#ifndef DGE_RAYCASTER_HPP
+#define DGE_RAYCASTER_HPP
+
+#include "../Include/defGameEngine.hpp"
+
+namespace def
+{
+	// Pseudo-3D view of a grid of walls: a ray is cast with DDA for every column of the draw target
+	// and the walls, the floor and the ceiling are written straight into its pixels.
+	// The columns and the rows are processed in parallel on the thread pool of the engine.
+	// Positions are in tiles, a wall is one tile wide and high
+	class Raycaster
+	{
+	public:
+		using Tile = uint16_t;
+
+		static constexpr Tile EMPTY_TILE = 0;
+
+		// The wall that a ray has hit
+		struct Hit
+		{
+			// Along the ray direction, for the columns of the view it's the distance
+			// from the plane of the camera so the walls aren't bent
+			float distance = 0.0f;
+
+			Tile tile = EMPTY_TILE;
+			Vector2i cell;
+
+			// The wall is along the X axis, i.e. the ray has crossed a horizontal grid line
+			bool isSideY = false;
+
+			// Where the ray has hit the wall from 0 to 1
+			float wallX = 0.0f;
+
+			// Rows of the wall on the screen, is set by Render
+			int top = 0;
+			int bottom = 0;
+		};
+
+	public:
+		Raycaster() = default;
+		Raycaster(const Vector2i& size);
+
+		// All tiles are empty
+		void Initialise(const Vector2i& size);
+
+		void SetTile(const Vector2i& pos, Tile tile);
+		Tile GetTile(const Vector2i& pos) const;
+
+		// Copies size.x * size.y tiles row by row
+		void SetTiles(const std::vector<Tile>& tiles);
+
+		const Vector2i& GetSize() const;
+
+		// The walls of the tile are covered with the texture or are filled with the colour if it's nullptr
+		void SetWall(Tile tile, const Sprite* texture, const Pixel& col = WHITE);
+
+		// The texture is repeated on every tile
+		void SetFloor(const Sprite* texture, const Pixel& col = DARK_GREY);
+		void SetCeiling(const Sprite* texture, const Pixel& col = BLACK);
+
+		// Horizontal field of view in radians
+		void SetFieldOfView(float fov);
+
+		// Rays stop at this distance and at the edges of the map
+		void SetMaxDistance(float distance);
+
+		// Casts a single ray, e.g. for shooting, the distance of the hit is in lengths of dir
+		bool CastRay(const Vector2f& origin, const Vector2f& dir, Hit& hit) const;
+
+		// Draws the view from pos looking at angle (in radians) into the draw target of the engine
+		void Render(const Vector2f& pos, float angle);
+
+		// Draws a sprite that stands on the floor at pos with the camera of the last Render,
+		// a scale of 1 is as high as a wall. Its columns behind the walls are skipped
+		// and only the opaque pixels are drawn
+		void DrawBillboard(const Vector2f& pos, const Sprite* sprite, float scale = 1.0f);
+
+		// The distance to the wall of each column from the last Render, e.g. to hide other things behind the walls
+		const std::vector<float>& GetDepthBuffer() const;
+
+		// The hit of each column from the last Render
+		const std::vector<Hit>& GetHits() const;
+
+	private:
+		struct Surface
+		{
+			const Sprite* texture = nullptr;
+			Pixel col = WHITE;
+		};
+
+		void DrawColumn(Sprite* target, int x);
+		void DrawFloorRow(Sprite* target, int y);
+
+	private:
+		Vector2i m_Size;
+		std::vector<Tile> m_Tiles;
+
+		// Is indexed by the tile
+		std::vector<Surface> m_Walls;
+
+		Surface m_Floor = { nullptr, DARK_GREY };
+		Surface m_Ceiling = { nullptr, BLACK };
+
+		float m_FieldOfView = 1.0471976f;
+		float m_MaxDistance = 64.0f;
+
+		// Camera of the last Render
+		Vector2f m_Pos;
+		Vector2f m_Dir;
+		Vector2f m_Plane;
+		Vector2i m_ScreenSize;
+		float m_Horizon = 0.0f;
+
+		std::vector<float> m_Depth;
+		std::vector<Hit> m_Hits;
+
+		GameEngine* m_Engine = GameEngine::s_Engine;
+
+	};
+
+#ifdef DGE_RAYCASTER
+#undef DGE_RAYCASTER
+
+	Raycaster::Raycaster(const Vector2i& size)
+	{
+		Initialise(size);
+	}
+
+	void Raycaster::Initialise(const Vector2i& size)
+	{
+		m_Size = size.Max({ 0, 0 });
+		m_Tiles.assign((size_t)m_Size.x * m_Size.y, EMPTY_TILE);
+	}
+
+	void Raycaster::SetTile(const Vector2i& pos, Tile tile)
+	{
+		if (pos.x >= 0 && pos.y >= 0 && pos.x < m_Size.x && pos.y < m_Size.y)
+			m_Tiles[(size_t)pos.y * m_Size.x + pos.x] = tile;
+	}
+
+	Raycaster::Tile Raycaster::GetTile(const Vector2i& pos) const
+	{
+		if (pos.x < 0 || pos.y < 0 || pos.x >= m_Size.x || pos.y >= m_Size.y)
+			return EMPTY_TILE;
+
+		return m_Tiles[(size_t)pos.y * m_Size.x + pos.x];
+	}
+
+	void Raycaster::SetTiles(const std::vector<Tile>& tiles)
+	{
+		std::copy_n(tiles.begin(), std::min(tiles.size(), m_Tiles.size()), m_Tiles.begin());
+	}
+
+	const Vector2i& Raycaster::GetSize() const
+	{
+		return m_Size;
+	}
+
+	void Raycaster::SetWall(Tile tile, const Sprite* texture, const Pixel& col)
+	{
+		if (tile >= m_Walls.size())
+			m_Walls.resize(tile + 1);
+
+		m_Walls[tile] = { texture, col };
+	}
+
+	void Raycaster::SetFloor(const Sprite* texture, const Pixel& col)
+	{
+		m_Floor = { texture, col };
+	}
+
+	void Raycaster::SetCeiling(const Sprite* texture, const Pixel& col)
+	{
+		m_Ceiling = { texture, col };
+	}
+
+	void Raycaster::SetFieldOfView(float fov)
+	{
+		m_FieldOfView = std::clamp(fov, 0.01f, 3.1f);
+	}
+
+	void Raycaster::SetMaxDistance(float distance)
+	{
+		m_MaxDistance = distance;
+	}
+
+	bool Raycaster::CastRay(const Vector2f& origin, const Vector2f& dir, Hit& hit) const
+	{
+		Vector2i cell = origin.Floor();
+
+		// Distance along the ray between two grid lines of each axis
+		Vector2f delta(
+			dir.x == 0.0f ? INFINITY : fabs(1.0f / dir.x),
+			dir.y == 0.0f ? INFINITY : fabs(1.0f / dir.y));
+
+		Vector2i step;
+
+		// Distance to the next grid line of each axis
+		Vector2f next;
+
+		if (dir.x < 0.0f)
+		{
+			step.x = -1;
+			next.x = (origin.x - (float)cell.x) * delta.x;
+		}
+		else
+		{
+			step.x = 1;
+			next.x = ((float)cell.x + 1.0f - origin.x) * delta.x;
+		}
+
+		if (dir.y < 0.0f)
+		{
+			step.y = -1;
+			next.y = (origin.y - (float)cell.y) * delta.y;
+		}
+		else
+		{
+			step.y = 1;
+			next.y = ((float)cell.y + 1.0f - origin.y) * delta.y;
+		}
+
+		while (true)
+		{
+			float distance;
+			bool isSideY;
+
+			if (next.x < next.y)
+			{
+				distance = next.x;
+				next.x += delta.x;
+				cell.x += step.x;
+				isSideY = false;
+			}
+			else
+			{
+				distance = next.y;
+				next.y += delta.y;
+				cell.y += step.y;
+				isSideY = true;
+			}
+
+			if (distance > m_MaxDistance || cell.x < 0 || cell.y < 0 || cell.x >= m_Size.x || cell.y >= m_Size.y)
+				return false;
+
+			Tile tile = m_Tiles[(size_t)cell.y * m_Size.x + cell.x];
+
+			if (tile != EMPTY_TILE)
+			{
+				float wallX = isSideY ? origin.x + distance * dir.x : origin.y + distance * dir.y;
+
+				hit.distance = distance;
+				hit.tile = tile;
+				hit.cell = cell;
+				hit.isSideY = isSideY;
+				hit.wallX = wallX - floor(wallX);
+
+				return true;
+			}
+		}
+	}
+
+	void Raycaster::Render(const Vector2f& pos, float angle)
+	{
+		Graphic* target = m_Engine->GetDrawTarget();
+
+		if (!target)
+			return;
+
+		Sprite* sprite = target->sprite;
+
+		m_ScreenSize = sprite->size;
+		m_Horizon = (float)m_ScreenSize.y * 0.5f;
+
+		m_Pos = pos;
+		m_Dir = Vector2f(cos(angle), sin(angle));
+		m_Plane = Vector2f(-m_Dir.y, m_Dir.x) * tan(m_FieldOfView * 0.5f);
+
+		m_Depth.resize(m_ScreenSize.x);
+		m_Hits.resize(m_ScreenSize.x);
+
+		ThreadPool& pool = m_Engine->ThreadPool();
+
+		// 16 pixels are a cache line, so the threads don't write the same lines of the rows
+		pool.ParallelFor(0, m_ScreenSize.x, [&](int x) { DrawColumn(sprite, x); }, 16);
+
+		// The floor and the ceiling fill the rest of the rows around the walls
+		pool.ParallelFor(0, m_ScreenSize.y, [&](int y) { DrawFloorRow(sprite, y); }, 8);
+	}
+
+	void Raycaster::DrawColumn(Sprite* target, int x)
+	{
+		float cameraX = 2.0f * ((float)x + 0.5f) / (float)m_ScreenSize.x - 1.0f;
+		Vector2f rayDir = m_Dir + m_Plane * cameraX;
+
+		Hit& hit = m_Hits[x];
+
+		if (!CastRay(m_Pos, rayDir, hit))
+		{
+			hit = Hit();
+			hit.distance = m_MaxDistance;
+			hit.top = hit.bottom = (int)m_Horizon;
+
+			m_Depth[x] = m_MaxDistance;
+			return;
+		}
+
+		m_Depth[x] = hit.distance;
+
+		float height = (float)m_ScreenSize.y / std::max(hit.distance, 1e-4f);
+		float top = m_Horizon - height * 0.5f;
+
+		hit.top = std::clamp((int)ceil(top - 0.5f), 0, m_ScreenSize.y);
+		hit.bottom = std::clamp((int)ceil(top + height - 0.5f), 0, m_ScreenSize.y);
+
+		const Surface& wall = hit.tile < m_Walls.size() ? m_Walls[hit.tile] : Surface();
+
+		if (!wall.texture || wall.texture->pixels.empty())
+		{
+			for (int y = hit.top; y < hit.bottom; y++)
+				target->GetRow(y)[x] = wall.col;
+
+			return;
+		}
+
+		const Sprite* texture = wall.texture;
+		const Vector2i& texSize = texture->size;
+
+		int texX = std::min((int)(hit.wallX * (float)texSize.x), texSize.x - 1);
+
+		// The walls that face the other way would be mirrored
+		if ((!hit.isSideY && rayDir.x > 0.0f) || (hit.isSideY && rayDir.y < 0.0f))
+			texX = texSize.x - texX - 1;
+
+		// 16.16 fixed point
+		float step = (float)texSize.y / height;
+		int32_t v = int32_t(((float)hit.top + 0.5f - top) * step * 65536.0f);
+		int32_t dv = int32_t(step * 65536.0f);
+
+		for (int y = hit.top; y < hit.bottom; y++, v += dv)
+		{
+			int texY = std::clamp(v >> 16, 0, texSize.y - 1);
+			target->GetRow(y)[x] = texture->GetRow(texY)[texX];
+		}
+	}
+
+	void Raycaster::DrawFloorRow(Sprite* target, int y)
+	{
+		float centre = (float)y + 0.5f;
+		bool isFloor = centre > m_Horizon;
+
+		const Surface& surface = isFloor ? m_Floor : m_Ceiling;
+		Pixel* row = target->GetRow(y);
+
+		// The walls are one tile high and centred at the horizon,
+		// so the floor and the ceiling are half a tile away from the eyes
+		float distance = (float)m_ScreenSize.y * 0.5f / std::max(std::abs(centre - m_Horizon), 1e-4f);
+
+		auto IsWall = [&](int x) { return y >= m_Hits[x].top && y < m_Hits[x].bottom; };
+
+		if (!surface.texture || surface.texture->pixels.empty() || distance > m_MaxDistance)
+		{
+			for (int x = 0; x < m_ScreenSize.x; x++)
+			{
+				if (!IsWall(x))
+					row[x] = surface.col;
+			}
+
+			return;
+		}
+
+		const Sprite* texture = surface.texture;
+		const Vector2i& texSize = texture->size;
+
+		// Points of the floor under the columns are on a line, they are stepped
+		// in 32.32 fixed point of texels so they don't overflow far from the origin
+		Vector2f start = m_Pos + (m_Dir - m_Plane) * distance;
+		Vector2f step = m_Plane * (2.0f * distance / (float)m_ScreenSize.x);
+
+		start += step * 0.5f;
+
+		int64_t u = int64_t((double)start.x * texSize.x * 4294967296.0);
+		int64_t v = int64_t((double)start.y * texSize.y * 4294967296.0);
+		int64_t du = int64_t((double)step.x * texSize.x * 4294967296.0);
+		int64_t dv = int64_t((double)step.y * texSize.y * 4294967296.0);
+
+		for (int x = 0; x < m_ScreenSize.x; x++, u += du, v += dv)
+		{
+			if (IsWall(x))
+				continue;
+
+			int texX = int((u >> 32) % texSize.x);
+			int texY = int((v >> 32) % texSize.y);
+
+			if (texX < 0) texX += texSize.x;
+			if (texY < 0) texY += texSize.y;
+
+			row[x] = texture->GetRow(texY)[texX];
+		}
+	}
+
+	void Raycaster::DrawBillboard(const Vector2f& pos, const Sprite* sprite, float scale)
+	{
+		Graphic* target = m_Engine->GetDrawTarget();
+
+		if (!target || !sprite || sprite->pixels.empty() || target->sprite->size != m_ScreenSize)
+			return;
+
+		// The position relative to the camera in units of the direction and of the plane
+		Vector2f rel = pos - m_Pos;
+
+		float depth = rel.DotProduct(m_Dir) / m_Dir.DotProduct(m_Dir);
+		float side = rel.DotProduct(m_Plane) / m_Plane.DotProduct(m_Plane);
+
+		if (depth < 0.01f)
+			return;
+
+		float screenX = (side / depth + 1.0f) * 0.5f * (float)m_ScreenSize.x;
+
+		// The bottom is where the floor is at the same distance
+		float height = (float)m_ScreenSize.y / depth * scale;
+		float width = height * (float)sprite->size.x / (float)sprite->size.y;
+
+		float bottom = m_Horizon + (float)m_ScreenSize.y * 0.5f / depth;
+		float top = bottom - height;
+		float left = screenX - width * 0.5f;
+
+		int x0 = std::max((int)ceil(left - 0.5f), 0);
+		int x1 = std::min((int)ceil(left + width - 0.5f), m_ScreenSize.x);
+		int y0 = std::max((int)ceil(top - 0.5f), 0);
+		int y1 = std::min((int)ceil(bottom - 0.5f), m_ScreenSize.y);
+
+		Sprite* dst = target->sprite;
+
+		for (int x = x0; x < x1; x++)
+		{
+			if (depth >= m_Depth[x])
+				continue;
+
+			int texX = std::clamp(int(((float)x + 0.5f - left) / width * (float)sprite->size.x), 0, sprite->size.x - 1);
+
+			for (int y = y0; y < y1; y++)
+			{
+				int texY = std::clamp(int(((float)y + 0.5f - top) / height * (float)sprite->size.y), 0, sprite->size.y - 1);
+				const Pixel& col = sprite->GetRow(texY)[texX];
+
+				if (col.a == 255)
+					dst->GetRow(y)[x] = col;
+			}
+		}
+	}
+
+	const std::vector<float>& Raycaster::GetDepthBuffer() const
+	{
+		return m_Depth;
+	}
+
+	const std::vector<Raycaster::Hit>& Raycaster::GetHits() const
+	{
+		return m_Hits;
+	}
+
+#endif
+
+}
+
+#endif
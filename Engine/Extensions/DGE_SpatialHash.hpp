@@ -0,0 +1,407 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#ifndef DGE_SPATIAL_HASH_HPP
+#define DGE_SPATIAL_HASH_HPP
+
+#include "../Include/defGameEngine.hpp"
+#include "DGE_AffineTransforms.hpp"
+
+namespace def
+{
+	// A loose uniform grid over an unbounded world for the broadphase of collisions and for culling.
+	// Each rectangle is kept in the cell of its centre, so inserting and moving touch a single cell
+	// and the queries look at the neighbouring cells as far as the largest rectangle reaches.
+	// The cells are hashed into a fixed table of buckets and the rectangles are linked through
+	// a single pool, so nothing is allocated per rectangle after the pool has grown.
+	// The cell size should be about the size of a typical rectangle.
+	// A negative size extends a rectangle to the left or up from its position,
+	// it's stored with the top-left corner and a positive size.
+	// The queries are const but they aren't thread-safe, they mark the visited rectangles.
+	// DrawContext::Submit still culls each texture by its own bounding box, because the textures
+	// are submitted one by one and aren't kept between frames. Query the visible region
+	// and draw only the rectangles it returns to skip the rest before they're submitted
+	class SpatialHash
+	{
+	public:
+		using Id = uint32_t;
+
+		static constexpr Id INVALID_ID = 0xFFFFFFFF;
+
+	public:
+		SpatialHash() = default;
+		SpatialHash(float cellSize, size_t bucketsCount = 4096);
+
+		// The number of buckets is rounded up to a power of two and removes everything
+		void Initialise(float cellSize, size_t bucketsCount = 4096);
+
+		// Returns the id of the rectangle, the ids of the removed ones are reused
+		// so they stay small and can index the arrays of the game
+		Id Insert(const Vector2f& pos, const Vector2f& size);
+
+		void Move(Id id, const Vector2f& pos);
+		void Move(Id id, const Vector2f& pos, const Vector2f& size);
+
+		void Remove(Id id);
+		void Clear();
+
+		bool IsValid(Id id) const;
+
+		const Vector2f& GetPosition(Id id) const;
+		const Vector2f& GetSize(Id id) const;
+
+		// Number of rectangles
+		size_t GetCount() const;
+
+		// Appends the ids of the rectangles that intersect the region
+		void Query(const Vector2f& pos, const Vector2f& size, std::vector<Id>& result) const;
+
+		// The same for the region of the world that is visible through the transforms,
+		// so only these rectangles are submitted for drawing
+		void Query(const AffineTransforms& transforms, const Vector2f& viewArea, std::vector<Id>& result) const;
+
+		// Appends every pair of intersecting rectangles once, the first id of a pair is the smaller one
+		void FindPairs(std::vector<std::pair<Id, Id>>& pairs) const;
+
+	private:
+		struct Entry
+		{
+			Vector2f pos;
+			Vector2f size;
+
+			// Neighbours in the list of the bucket, the next free entry if it's removed
+			Id prev = INVALID_ID;
+			Id next = INVALID_ID;
+
+			uint32_t bucket = 0;
+
+			// The number of the last query that visited the entry, a bucket
+			// can be visited twice if two cells of the region share it
+			mutable uint32_t mark = 0;
+
+			bool isAlive = false;
+		};
+
+		uint32_t GetBucket(int32_t cellX, int32_t cellY) const;
+		uint32_t GetBucket(const Vector2f& centre) const;
+
+		void Link(Id id);
+		void Unlink(Id id);
+
+		// Calls func for each rectangle that intersects the region
+		template <class Func>
+		void ForEachInRegion(const Vector2f& pos, const Vector2f& size, Func&& func) const;
+
+		static bool Intersects(const Entry& entry, const Vector2f& pos, const Vector2f& size);
+
+		// Moves the position to the top-left corner and makes the size positive
+		static void Normalise(Vector2f& pos, Vector2f& size);
+
+	private:
+		float m_CellSize = 64.0f;
+		float m_InvCellSize = 1.0f / 64.0f;
+
+		// The first entry of each bucket
+		std::vector<Id> m_Buckets;
+		uint32_t m_BucketMask = 0;
+
+		std::vector<Entry> m_Entries;
+		Id m_FreeList = INVALID_ID;
+		size_t m_Count = 0;
+
+		// The largest half of a size, it's how far a rectangle reaches from the cell of its centre
+		Vector2f m_Reach;
+
+		mutable uint32_t m_Mark = 0;
+
+	};
+
+#ifdef DGE_SPATIAL_HASH
+#undef DGE_SPATIAL_HASH
+
+	SpatialHash::SpatialHash(float cellSize, size_t bucketsCount)
+	{
+		Initialise(cellSize, bucketsCount);
+	}
+
+	void SpatialHash::Initialise(float cellSize, size_t bucketsCount)
+	{
+		m_CellSize = std::max(cellSize, 1e-3f);
+		m_InvCellSize = 1.0f / m_CellSize;
+
+		size_t count = 1;
+
+		while (count < bucketsCount)
+			count <<= 1;
+
+		m_Buckets.assign(count, INVALID_ID);
+		m_BucketMask = uint32_t(count - 1);
+
+		m_Entries.clear();
+		m_FreeList = INVALID_ID;
+		m_Count = 0;
+		m_Reach = { 0.0f, 0.0f };
+	}
+
+	SpatialHash::Id SpatialHash::Insert(const Vector2f& pos, const Vector2f& size)
+	{
+		if (m_Buckets.empty())
+			Initialise(m_CellSize);
+
+		Id id;
+
+		if (m_FreeList != INVALID_ID)
+		{
+			id = m_FreeList;
+			m_FreeList = m_Entries[id].next;
+		}
+		else
+		{
+			id = (Id)m_Entries.size();
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[id];
+
+		entry.pos = pos;
+		entry.size = size;
+		entry.isAlive = true;
+
+		Normalise(entry.pos, entry.size);
+		m_Reach = m_Reach.Max(entry.size * 0.5f);
+
+		Link(id);
+		m_Count++;
+
+		return id;
+	}
+
+	void SpatialHash::Move(Id id, const Vector2f& pos)
+	{
+		if (IsValid(id))
+			Move(id, pos, m_Entries[id].size);
+	}
+
+	void SpatialHash::Move(Id id, const Vector2f& pos, const Vector2f& size)
+	{
+		if (!IsValid(id))
+			return;
+
+		Entry& entry = m_Entries[id];
+
+		entry.pos = pos;
+		entry.size = size;
+
+		Normalise(entry.pos, entry.size);
+		m_Reach = m_Reach.Max(entry.size * 0.5f);
+
+		// Most moves stay in the same cell
+		if (GetBucket(entry.pos + entry.size * 0.5f) != entry.bucket)
+		{
+			Unlink(id);
+			Link(id);
+		}
+	}
+
+	void SpatialHash::Remove(Id id)
+	{
+		if (!IsValid(id))
+			return;
+
+		Unlink(id);
+
+		Entry& entry = m_Entries[id];
+		entry.isAlive = false;
+		entry.next = m_FreeList;
+
+		m_FreeList = id;
+		m_Count--;
+	}
+
+	void SpatialHash::Clear()
+	{
+		std::fill(m_Buckets.begin(), m_Buckets.end(), INVALID_ID);
+
+		m_Entries.clear();
+		m_FreeList = INVALID_ID;
+		m_Count = 0;
+		m_Reach = { 0.0f, 0.0f };
+	}
+
+	bool SpatialHash::IsValid(Id id) const
+	{
+		return id < m_Entries.size() && m_Entries[id].isAlive;
+	}
+
+	const Vector2f& SpatialHash::GetPosition(Id id) const
+	{
+		return m_Entries[id].pos;
+	}
+
+	const Vector2f& SpatialHash::GetSize(Id id) const
+	{
+		return m_Entries[id].size;
+	}
+
+	size_t SpatialHash::GetCount() const
+	{
+		return m_Count;
+	}
+
+	void SpatialHash::Query(const Vector2f& pos, const Vector2f& size, std::vector<Id>& result) const
+	{
+		Vector2f regionPos = pos;
+		Vector2f regionSize = size;
+
+		Normalise(regionPos, regionSize);
+		ForEachInRegion(regionPos, regionSize, [&](Id id) { result.push_back(id); });
+	}
+
+	void SpatialHash::Query(const AffineTransforms& transforms, const Vector2f& viewArea, std::vector<Id>& result) const
+	{
+		Vector2f origin = transforms.ScreenToWorld({ 0.0f, 0.0f });
+		Vector2f end = transforms.ScreenToWorld(viewArea);
+
+		Query(origin.Min(end), (end - origin).Abs(), result);
+	}
+
+	void SpatialHash::FindPairs(std::vector<std::pair<Id, Id>>& pairs) const
+	{
+		for (Id id = 0; id < (Id)m_Entries.size(); id++)
+		{
+			const Entry& entry = m_Entries[id];
+
+			if (!entry.isAlive)
+				continue;
+
+			ForEachInRegion(entry.pos, entry.size,
+				[&](Id other)
+				{
+					if (other > id)
+						pairs.emplace_back(id, other);
+				});
+		}
+	}
+
+	uint32_t SpatialHash::GetBucket(int32_t cellX, int32_t cellY) const
+	{
+		return (uint32_t(cellX) * 73856093u ^ uint32_t(cellY) * 19349663u) & m_BucketMask;
+	}
+
+	uint32_t SpatialHash::GetBucket(const Vector2f& centre) const
+	{
+		return GetBucket((int32_t)floor(centre.x * m_InvCellSize), (int32_t)floor(centre.y * m_InvCellSize));
+	}
+
+	void SpatialHash::Link(Id id)
+	{
+		Entry& entry = m_Entries[id];
+
+		entry.bucket = GetBucket(entry.pos + entry.size * 0.5f);
+		entry.prev = INVALID_ID;
+		entry.next = m_Buckets[entry.bucket];
+
+		if (entry.next != INVALID_ID)
+			m_Entries[entry.next].prev = id;
+
+		m_Buckets[entry.bucket] = id;
+	}
+
+	void SpatialHash::Unlink(Id id)
+	{
+		Entry& entry = m_Entries[id];
+
+		if (entry.prev != INVALID_ID)
+			m_Entries[entry.prev].next = entry.next;
+		else
+			m_Buckets[entry.bucket] = entry.next;
+
+		if (entry.next != INVALID_ID)
+			m_Entries[entry.next].prev = entry.prev;
+	}
+
+	template <class Func>
+	void SpatialHash::ForEachInRegion(const Vector2f& pos, const Vector2f& size, Func&& func) const
+	{
+		if (m_Count == 0)
+			return;
+
+		// The marks are reset when the counter wraps around
+		if (++m_Mark == 0)
+		{
+			for (const Entry& entry : m_Entries)
+				entry.mark = 0;
+
+			m_Mark = 1;
+		}
+
+		// The cells of the centres of all rectangles that can reach the region
+		Vector2f from = (pos - m_Reach) * m_InvCellSize;
+		Vector2f to = (pos + size + m_Reach) * m_InvCellSize;
+
+		float cells = (floor(to.x) - floor(from.x) + 1.0f) * (floor(to.y) - floor(from.y) + 1.0f);
+
+		// A region that covers more cells than there are buckets visits every bucket anyway
+		if (cells >= (float)m_Buckets.size())
+		{
+			for (Id id = 0; id < (Id)m_Entries.size(); id++)
+			{
+				const Entry& entry = m_Entries[id];
+
+				if (entry.isAlive && Intersects(entry, pos, size))
+					func(id);
+			}
+
+			return;
+		}
+
+		int32_t x0 = (int32_t)floor(from.x), y0 = (int32_t)floor(from.y);
+		int32_t x1 = (int32_t)floor(to.x), y1 = (int32_t)floor(to.y);
+
+		for (int32_t y = y0; y <= y1; y++)
+			for (int32_t x = x0; x <= x1; x++)
+			{
+				for (Id id = m_Buckets[GetBucket(x, y)]; id != INVALID_ID; id = m_Entries[id].next)
+				{
+					const Entry& entry = m_Entries[id];
+
+					if (entry.mark == m_Mark)
+						continue;
+
+					entry.mark = m_Mark;
+
+					if (Intersects(entry, pos, size))
+						func(id);
+				}
+			}
+	}
+
+	bool SpatialHash::Intersects(const Entry& entry, const Vector2f& pos, const Vector2f& size)
+	{
+		return entry.pos.x < pos.x + size.x && pos.x < entry.pos.x + entry.size.x &&
+			entry.pos.y < pos.y + size.y && pos.y < entry.pos.y + entry.size.y;
+	}
+
+	void SpatialHash::Normalise(Vector2f& pos, Vector2f& size)
+	{
+		if (size.x < 0.0f)
+		{
+			pos.x += size.x;
+			size.x = -size.x;
+		}
+
+		if (size.y < 0.0f)
+		{
+			pos.y += size.y;
+			size.y = -size.y;
+		}
+	}
+
+#endif
+
+}
+
+#endif
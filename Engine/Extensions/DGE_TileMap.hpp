@@ -0,0 +1,447 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#ifndef DGE_TILEMAP_HPP
+#define DGE_TILEMAP_HPP
+
+#include "../Include/defGameEngine.hpp"
+#include "DGE_Camera2D.hpp"
+#include "DGE_AffineTransforms.hpp"
+
+namespace def
+{
+	// Stores tile indices in chunks of CHUNK_SIZE x CHUNK_SIZE tiles,
+	// the tiles of each chunk are recorded into a draw list once
+	// and recorded again only after the chunk has been edited.
+	// Only chunks that intersect the view are drawn.
+	// Positions in the map are in tiles
+	class TileMap
+	{
+	public:
+		using Tile = uint16_t;
+
+		static constexpr int CHUNK_SIZE = 32;
+		static constexpr Tile EMPTY_TILE = 0xFFFF;
+
+		// The tile is replaced with the frames one after another
+		struct Animation
+		{
+			std::vector<Tile> frames;
+			float frameDuration = 0.1f;
+		};
+
+	public:
+		TileMap() = default;
+		TileMap(GameEngine* engine, const Vector2i& size, const Texture* tileSet, const Vector2i& tileSize, size_t layersCount = 1);
+		~TileMap();
+
+		TileMap(const TileMap&) = delete;
+		TileMap& operator=(const TileMap&) = delete;
+
+		// Tile i of the tile set is taken from column i % columns and row i / columns
+		void Initialise(GameEngine* engine, const Vector2i& size, const Texture* tileSet, const Vector2i& tileSize, size_t layersCount = 1);
+
+		// Returns the index of the new layer, it is drawn on top of the others
+		size_t AddLayer();
+		size_t GetLayersCount() const;
+
+		void SetLayerVisible(size_t layer, bool visible);
+		bool IsLayerVisible(size_t layer) const;
+
+		void SetTile(size_t layer, const Vector2i& pos, Tile tile);
+		Tile GetTile(size_t layer, const Vector2i& pos) const;
+
+		// Copies size.x * size.y tiles row by row
+		void SetTiles(size_t layer, const std::vector<Tile>& tiles);
+
+		void Fill(size_t layer, Tile tile);
+
+		// Animated tiles aren't recorded into the chunks, they are drawn
+		// on every frame with the current frame instead
+		void SetAnimation(Tile tile, const Animation& animation);
+		void RemoveAnimation(Tile tile);
+
+		// Advances the animations
+		void Update(float deltaTime);
+
+		// The origin is the tile at the top-left corner of the screen
+		// and the scale is the size of a tile on the screen in pixels
+		void Draw(const Vector2f& origin, const Vector2f& scale);
+
+		// The camera works in pixels of the map, its view area is stretched over the screen
+		void Draw(const Camera2D& camera);
+
+		// One unit of the transforms is one tile, e.g. TileAffineTransforms with the tile size
+		void Draw(const AffineTransforms& transforms);
+
+		const Vector2i& GetSize() const;
+		const Vector2i& GetTileSize() const;
+
+		// The number of chunks that were drawn by the last call to Draw
+		size_t GetDrawnChunksCount() const;
+
+	private:
+		struct Chunk
+		{
+			std::vector<Tile> tiles;
+
+			// Is created when the chunk is recorded for the first time
+			DrawList* drawList = nullptr;
+
+			// Positions of the animated tiles in the chunk
+			std::vector<Vector2i> animated;
+
+			bool isDirty = true;
+		};
+
+		struct Layer
+		{
+			std::vector<Chunk> chunks;
+			bool isVisible = true;
+		};
+
+		Chunk* GetChunk(size_t layer, const Vector2i& pos, Vector2i& local);
+		const Chunk* GetChunk(size_t layer, const Vector2i& pos, Vector2i& local) const;
+
+		void Build(Chunk& chunk);
+		void Destroy();
+
+		// Returns the animated tile if it has an animation
+		Tile GetFrame(Tile tile) const;
+
+		Vector2f GetFilePos(Tile tile) const;
+
+	private:
+		GameEngine* m_Engine = nullptr;
+		const Texture* m_TileSet = nullptr;
+
+		Vector2i m_Size;
+		Vector2i m_TileSize;
+		Vector2i m_ChunksCount;
+
+		int m_TileSetColumns = 1;
+
+		std::vector<Layer> m_Layers;
+		std::unordered_map<Tile, Animation> m_Animations;
+
+		float m_Time = 0.0f;
+
+		// The vertices of draw lists depend on the size of the screen
+		Vector2i m_ScreenSize;
+
+		size_t m_DrawnChunks = 0;
+
+	};
+
+#ifdef DGE_TILEMAP
+#undef DGE_TILEMAP
+
+	TileMap::TileMap(GameEngine* engine, const Vector2i& size, const Texture* tileSet, const Vector2i& tileSize, size_t layersCount)
+	{
+		Initialise(engine, size, tileSet, tileSize, layersCount);
+	}
+
+	TileMap::~TileMap()
+	{
+		Destroy();
+	}
+
+	void TileMap::Initialise(GameEngine* engine, const Vector2i& size, const Texture* tileSet, const Vector2i& tileSize, size_t layersCount)
+	{
+		Destroy();
+
+		m_Engine = engine;
+		m_TileSet = tileSet;
+		m_Size = size.Max({ 0, 0 });
+		m_TileSize = tileSize.Max({ 1, 1 });
+		m_ChunksCount = (m_Size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		m_TileSetColumns = std::max((int)tileSet->size.x / m_TileSize.x, 1);
+
+		m_Layers.clear();
+
+		for (size_t i = 0; i < layersCount; i++)
+			AddLayer();
+	}
+
+	size_t TileMap::AddLayer()
+	{
+		Layer& layer = m_Layers.emplace_back();
+		layer.chunks.resize(m_ChunksCount.x * m_ChunksCount.y);
+
+		for (auto& chunk : layer.chunks)
+			chunk.tiles.resize(CHUNK_SIZE * CHUNK_SIZE, EMPTY_TILE);
+
+		return m_Layers.size() - 1;
+	}
+
+	size_t TileMap::GetLayersCount() const
+	{
+		return m_Layers.size();
+	}
+
+	void TileMap::SetLayerVisible(size_t layer, bool visible)
+	{
+		m_Layers[layer].isVisible = visible;
+	}
+
+	bool TileMap::IsLayerVisible(size_t layer) const
+	{
+		return m_Layers[layer].isVisible;
+	}
+
+	void TileMap::SetTile(size_t layer, const Vector2i& pos, Tile tile)
+	{
+		Vector2i local;
+		Chunk* chunk = GetChunk(layer, pos, local);
+
+		if (!chunk)
+			return;
+
+		Tile& cell = chunk->tiles[local.y * CHUNK_SIZE + local.x];
+
+		if (cell != tile)
+		{
+			cell = tile;
+			chunk->isDirty = true;
+		}
+	}
+
+	TileMap::Tile TileMap::GetTile(size_t layer, const Vector2i& pos) const
+	{
+		Vector2i local;
+		const Chunk* chunk = GetChunk(layer, pos, local);
+
+		return chunk ? chunk->tiles[local.y * CHUNK_SIZE + local.x] : EMPTY_TILE;
+	}
+
+	void TileMap::SetTiles(size_t layer, const std::vector<Tile>& tiles)
+	{
+		int count = std::min((int)tiles.size(), m_Size.x * m_Size.y);
+
+		for (int i = 0; i < count; i++)
+			SetTile(layer, { i % m_Size.x, i / m_Size.x }, tiles[i]);
+	}
+
+	void TileMap::Fill(size_t layer, Tile tile)
+	{
+		for (auto& chunk : m_Layers[layer].chunks)
+		{
+			std::fill(chunk.tiles.begin(), chunk.tiles.end(), tile);
+			chunk.isDirty = true;
+		}
+	}
+
+	void TileMap::SetAnimation(Tile tile, const Animation& animation)
+	{
+		if (animation.frames.empty())
+		{
+			RemoveAnimation(tile);
+			return;
+		}
+
+		m_Animations[tile] = animation;
+
+		// The tile must be moved out of the recorded chunks
+		for (auto& layer : m_Layers)
+			for (auto& chunk : layer.chunks)
+				chunk.isDirty = true;
+	}
+
+	void TileMap::RemoveAnimation(Tile tile)
+	{
+		if (m_Animations.erase(tile) == 0)
+			return;
+
+		for (auto& layer : m_Layers)
+			for (auto& chunk : layer.chunks)
+				chunk.isDirty = true;
+	}
+
+	void TileMap::Update(float deltaTime)
+	{
+		m_Time += deltaTime;
+	}
+
+	void TileMap::Draw(const Vector2f& origin, const Vector2f& scale)
+	{
+		m_DrawnChunks = 0;
+
+		if (!m_Engine || m_Layers.empty() || scale.x <= 0.0f || scale.y <= 0.0f)
+			return;
+
+		const Vector2i& screenSize = m_Engine->Window().GetScreenSize();
+
+		// The lists are in the normalised coordinates of the screen
+		if (m_ScreenSize != screenSize)
+		{
+			for (auto& layer : m_Layers)
+				for (auto& chunk : layer.chunks)
+					chunk.isDirty = true;
+
+			m_ScreenSize = screenSize;
+		}
+
+		// Only the chunks in the visible range of tiles are touched
+		Vector2f end = origin + Vector2f(screenSize) / scale;
+
+		Vector2i firstChunk = (origin / (float)CHUNK_SIZE).Floor();
+		Vector2i lastChunk = (end / (float)CHUNK_SIZE).Floor();
+
+		firstChunk = firstChunk.Max({ 0, 0 });
+		lastChunk = lastChunk.Min(m_ChunksCount - 1);
+
+		Vector2f listScale = scale / Vector2f(m_TileSize);
+
+		for (auto& layer : m_Layers)
+		{
+			if (!layer.isVisible)
+				continue;
+
+			for (int cy = firstChunk.y; cy <= lastChunk.y; cy++)
+				for (int cx = firstChunk.x; cx <= lastChunk.x; cx++)
+				{
+					Chunk& chunk = layer.chunks[cy * m_ChunksCount.x + cx];
+
+					if (chunk.isDirty)
+						Build(chunk);
+
+					Vector2f chunkPos = (Vector2f(cx, cy) * (float)CHUNK_SIZE - origin) * scale;
+
+					if (chunk.drawList && !chunk.drawList->IsEmpty())
+					{
+						m_Engine->DrawTextureList(chunkPos, chunk.drawList, listScale);
+						m_DrawnChunks++;
+					}
+
+					for (const auto& pos : chunk.animated)
+					{
+						Tile frame = GetFrame(chunk.tiles[pos.y * CHUNK_SIZE + pos.x]);
+
+						if (frame != EMPTY_TILE)
+							m_Engine->DrawPartialTexture(chunkPos + Vector2f(pos) * scale, m_TileSet, GetFilePos(frame), m_TileSize, listScale);
+					}
+				}
+		}
+	}
+
+	void TileMap::Draw(const Camera2D& camera)
+	{
+		Vector2f viewArea = camera.GetViewArea();
+
+		if (!m_Engine || viewArea.x <= 0.0f || viewArea.y <= 0.0f)
+			return;
+
+		Vector2f scale = Vector2f(m_Engine->Window().GetScreenSize()) / viewArea * Vector2f(m_TileSize);
+		Draw(camera.GetOrigin() / Vector2f(m_TileSize), scale);
+	}
+
+	void TileMap::Draw(const AffineTransforms& transforms)
+	{
+		Draw(transforms.GetOffset(), transforms.GetScale());
+	}
+
+	const Vector2i& TileMap::GetSize() const
+	{
+		return m_Size;
+	}
+
+	const Vector2i& TileMap::GetTileSize() const
+	{
+		return m_TileSize;
+	}
+
+	size_t TileMap::GetDrawnChunksCount() const
+	{
+		return m_DrawnChunks;
+	}
+
+	TileMap::Chunk* TileMap::GetChunk(size_t layer, const Vector2i& pos, Vector2i& local)
+	{
+		return const_cast<Chunk*>(static_cast<const TileMap*>(this)->GetChunk(layer, pos, local));
+	}
+
+	const TileMap::Chunk* TileMap::GetChunk(size_t layer, const Vector2i& pos, Vector2i& local) const
+	{
+		if (layer >= m_Layers.size() || pos.x < 0 || pos.y < 0 || pos.x >= m_Size.x || pos.y >= m_Size.y)
+			return nullptr;
+
+		local = { pos.x % CHUNK_SIZE, pos.y % CHUNK_SIZE };
+		return &m_Layers[layer].chunks[(pos.y / CHUNK_SIZE) * m_ChunksCount.x + pos.x / CHUNK_SIZE];
+	}
+
+	void TileMap::Build(Chunk& chunk)
+	{
+		chunk.isDirty = false;
+		chunk.animated.clear();
+
+		if (!chunk.drawList)
+			chunk.drawList = m_Engine->CreateDrawList();
+
+		chunk.drawList->Clear();
+
+		// The tiles are recorded at the top-left corner of the screen with their own size,
+		// Draw moves and scales the whole list
+		DrawList* prevList = m_Engine->GetDrawList();
+		m_Engine->SetDrawList(chunk.drawList);
+
+		for (int y = 0; y < CHUNK_SIZE; y++)
+			for (int x = 0; x < CHUNK_SIZE; x++)
+			{
+				Tile tile = chunk.tiles[y * CHUNK_SIZE + x];
+
+				if (tile == EMPTY_TILE)
+					continue;
+
+				if (m_Animations.count(tile) > 0)
+				{
+					chunk.animated.push_back({ x, y });
+					continue;
+				}
+
+				m_Engine->DrawPartialTexture(Vector2f(x, y) * Vector2f(m_TileSize), m_TileSet, GetFilePos(tile), m_TileSize);
+			}
+
+		m_Engine->SetDrawList(prevList);
+	}
+
+	void TileMap::Destroy()
+	{
+		if (!m_Engine)
+			return;
+
+		for (auto& layer : m_Layers)
+			for (auto& chunk : layer.chunks)
+			{
+				if (chunk.drawList)
+					m_Engine->DestroyDrawList(chunk.drawList);
+			}
+
+		m_Layers.clear();
+	}
+
+	TileMap::Tile TileMap::GetFrame(Tile tile) const
+	{
+		auto animation = m_Animations.find(tile);
+
+		if (animation == m_Animations.end())
+			return tile;
+
+		const Animation& anim = animation->second;
+		size_t frame = anim.frameDuration > 0.0f ? size_t(m_Time / anim.frameDuration) : 0;
+
+		return anim.frames[frame % anim.frames.size()];
+	}
+
+	Vector2f TileMap::GetFilePos(Tile tile) const
+	{
+		return Vector2f(tile % m_TileSetColumns, tile / m_TileSetColumns) * Vector2f(m_TileSize);
+	}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_ALIGNED_ALLOCATOR_HPP
+#define DGE_ALIGNED_ALLOCATOR_HPP
+
+#include "Pch.hpp"
+
+#include <new>
+
+namespace def
+{
+	// Allocates memory aligned to Alignment bytes, e.g. to a cache line
+	// so the rows of images can be processed with aligned SIMD loads
+	template <class T, size_t Alignment>
+	struct AlignedAllocator
+	{
+		static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2");
+
+		using value_type = T;
+
+		template <class U>
+		struct rebind
+		{
+			using other = AlignedAllocator<U, Alignment>;
+		};
+
+		AlignedAllocator() = default;
+
+		template <class U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+		}
+
+		void deallocate(T* ptr, size_t)
+		{
+			::operator delete(ptr, std::align_val_t(Alignment));
+		}
+
+		template <class U>
+		bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+
+		template <class U>
+		bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+	};
+}
+
+#endif
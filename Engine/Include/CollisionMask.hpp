@@ -0,0 +1,74 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_COLLISION_MASK_HPP
+#define DGE_COLLISION_MASK_HPP
+
+#include "Pch.hpp"
+#include "Sprite.hpp"
+
+namespace def
+{
+	// Solid pixels of a sprite packed into bits, 64 pixels of a row per word,
+	// so pixel-perfect collisions compare 64 pixels at once.
+	// Positions are the top-left corners of the masks in the same space, e.g. in pixels of the screen
+	class CollisionMask
+	{
+	public:
+		CollisionMask() = default;
+
+		// Pixels with an alpha of at least threshold are solid. With preShift the mask keeps
+		// 64 copies of itself shifted by every bit, it takes 64 times more memory
+		// but then the words of this mask are compared to the words of the other one without shifting
+		CollisionMask(const ConstSpriteView& sprite, uint8_t threshold = 1, bool preShift = false);
+
+		void Create(const ConstSpriteView& sprite, uint8_t threshold = 1, bool preShift = false);
+
+		const Vector2i& GetSize() const;
+		bool IsEmpty() const;
+
+		// Checks if a pixel of the mask is solid, the pixels outside of the mask aren't
+		bool Get(int x, int y) const;
+
+		// Number of solid pixels
+		int GetCount() const;
+
+		// Checks if at least one solid pixel of a is over a solid pixel of b
+		static bool Overlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB);
+
+		// The same but contact is set to the first overlapping pixel from the top-left corner
+		static bool Overlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB, Vector2i& contact);
+
+		// Returns the number of overlapping pixels, e.g. to tell a graze from a hit
+		static int CountOverlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB);
+
+	private:
+		// Is called for every word of a with the overlapping bits until it returns true,
+		// x is the pixel of the first bit in the space of a
+		template <class Func>
+		static void ForEachOverlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB, Func&& func);
+
+		// Returns 64 pixels of a row starting at the pixel x, it can be outside of the mask
+		uint64_t GetWord(int y, int x) const;
+
+	private:
+		Vector2i m_Size;
+
+		// Number of words in a row
+		int m_Words = 0;
+
+		// Bit x % 64 of word x / 64 of a row is pixel x
+		std::vector<uint64_t> m_Bits;
+
+		// 64 copies of the rows with one more word each, the copy s has pixel x at bit x + s
+		std::vector<uint64_t> m_Shifted;
+
+	};
+}
+
+#endif
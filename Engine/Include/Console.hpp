@@ -13,6 +13,10 @@
 #include "Pixel.hpp"
 #include "defGameEngine.hpp"
 
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
 namespace def
 {
     class Console
@@ -22,29 +26,39 @@ namespace def
         friend class GameEngine;
 
     public:
-        struct Entry
+        // A single line of the console output,
+        // multiline messages are split when they are printed
+        struct Line
         {
-            // Stores user's prompt and is not used if isCommand = false.
-            std::string command;
-            
-            // Output message.
-            std::string output;
-
-            // Colour of the output message.
-            Pixel outputColour;
-
-            // True if the entry is a command and
-            // false if the entry is a regular text
-            // that was printed to the console.
-            bool isCommand = false;
+            std::string text;
+            Pixel colour;
         };
 
+        // Receives the entered command split into arguments,
+        // args[0] is the name of the command
+        using CommandHandler = std::function<void(const std::vector<std::string>& args, std::stringstream& output, Pixel& colour)>;
+
         Console(GameEngine* engine);
 
+        // Registers a command, an existing command with the same name is replaced.
+        // The help text is shown by the "help" command
+        void RegisterCommand(const std::string& name, const std::string& help, const CommandHandler& handler);
+
+        // Removes a command, returns false if it wasn't registered.
+        bool UnregisterCommand(const std::string& name);
+
+        // Returns true if the command is registered.
+        bool HasCommand(const std::string& name) const;
+
+        // Splits the command into arguments by whitespaces,
+        // text in double quotes is kept as a single argument.
+        static std::vector<std::string> ParseArguments(std::string_view command);
+
         // Clears the console and its history.
         void Clear();
         
-        // Prints a text to the console with the specified colour.
+        // Prints a text to the console with the specified colour,
+        // must be called from the main thread, use Log from other threads.
         void Print(const std::string& text, const Pixel& colour = def::WHITE);
 
         // Shows or hides the console.
@@ -56,21 +70,79 @@ namespace def
         // Returns true if the console is visible.
         bool IsShown() const;
 
+        // Sets how many lines of the output and how many commands are kept,
+        // the oldest ones are dropped first.
+        void SetHistorySize(size_t lines, size_t commands);
+
+        // Returns the number of stored lines of the output.
+        size_t GetLinesCount() const;
+
+        // Returns the line by its index, 0 is the oldest one.
+        const Line& GetLine(size_t index) const;
+
     protected:
         void HandleCommand(const std::string& command);
+
+        // Handles UP and DOWN for browsing the commands,
+        // PAGE_UP, PAGE_DOWN and the mouse wheel for scrolling the output
         void HandleHistoryBrowsing();
+
+        // Completes the name of the command on TAB,
+        // prints all candidates if the name is ambiguous
+        void HandleCompletion();
+
+        // Prints the messages that were queued by Log
+        void PrintLog();
+
         void Draw();
 
     private:
+        // Adds a single line, overwrites the oldest one if the history is full
+        void AddLine(std::string_view text, const Pixel& colour);
+
+        // Splits the text into lines and adds them
+        void AddText(std::string_view text, const Pixel& colour);
+
+        // Returns the number of lines that fit on the screen
+        int GetVisibleLinesCount() const;
+
+        // Registers help, clear, stats, layers, memory, gl and profiler
+        void RegisterBuiltInCommands();
+
+    private:
+        struct Command
+        {
+            std::string help;
+            CommandHandler handler;
+        };
         Pixel m_BackgroundColour;
 
-        std::vector<Entry> m_History;
+        // Ring buffer of the output lines, the oldest
+        // line is at m_LinesStart, slots are reused so
+        // printing doesn't allocate once the history is full
+        std::vector<Line> m_Lines;
+        size_t m_LinesStart;
+        size_t m_LinesCount;
+
+        // Ring buffer of the entered commands
+        std::vector<std::string> m_Commands;
+        size_t m_CommandsStart;
+        size_t m_CommandsCount;
 
-        // Index of the current command from the history (m_History),
-        // it's set to m_History.size() if the command hasn't been
+        // Index of the current command from the history (m_Commands),
+        // it's set to m_CommandsCount if the command hasn't been
         // selected yet.
 		size_t m_PickedHistoryCommand;
 
+        // Number of lines the output is scrolled up by, 0 shows the newest lines
+        size_t m_ScrollOffset;
+
+        // All registered commands by their names
+        std::unordered_map<std::string, Command> m_Registry;
+
+        // Is reused to take the messages from Log without allocating
+        std::vector<Log::Message> m_LogMessages;
+
         GameEngine* m_Engine = nullptr;
 
     };
@@ -0,0 +1,201 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_DRAW_CONTEXT_HPP
+#define DGE_DRAW_CONTEXT_HPP
+
+#include "Pch.hpp"
+#include "Pixel.hpp"
+#include "Texture.hpp"
+#include "Graphic.hpp"
+#include "RenderTarget.hpp"
+#include "DrawList.hpp"
+
+namespace def
+{
+	class GameEngine;
+	struct Layer;
+
+	// Exposes the drawing routines of GameEngine for a single target
+	// without using the current layer of the engine, so different
+	// contexts can be used from different threads at the same time.
+	// The engine itself is only read (the window size, the font)
+	class DrawContext
+	{
+	public:
+		using Shader = Pixel (*)(const Vector2i&, const Pixel&, const Pixel&);
+
+		// Processes a whole row at once: fills dst[x0..x1) of the row y reading src,
+		// both point at the beginning of the row and never overlap
+		using SpanShader = void (*)(int y, int x0, int x1, Pixel* dst, const Pixel* src);
+
+		// Draws pixels on the current target of the layer and submits textures to the layer,
+		// the pixel mode, the shader and the texture structure of the layer are used
+		DrawContext(GameEngine* engine, Layer* layer);
+
+		// Draws pixels on the graphic, the texture routines do nothing
+		// unless a texture target is set
+		DrawContext(GameEngine* engine, Graphic* target);
+
+		// Drawing routines
+
+		bool Draw(const Vector2i& pos, const Pixel& col = WHITE);
+		bool Draw(int x, int y, const Pixel& col = WHITE);
+
+		void DrawLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col = WHITE);
+		void DrawLine(int x1, int y1, int x2, int y2, const Pixel& col = WHITE);
+
+		void DrawTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col = WHITE);
+		void DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col = WHITE);
+
+		void FillTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col = WHITE);
+		void FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col = WHITE);
+
+		void DrawRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void DrawRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col = WHITE);
+
+		void FillRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void FillRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col = WHITE);
+
+		void DrawCircle(const Vector2i& pos, int radius, const Pixel& col = WHITE);
+		void DrawCircle(int x, int y, int radius, const Pixel& col = WHITE);
+
+		void FillCircle(const Vector2i& pos, int radius, const Pixel& col = WHITE);
+		void FillCircle(int x, int y, int radius, const Pixel& col = WHITE);
+
+		void DrawEllipse(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void DrawEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col = WHITE);
+
+		void FillEllipse(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void FillEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col = WHITE);
+
+		void DrawSprite(const Vector2i& pos, const Sprite* sprite);
+		void DrawSprite(int x, int y, const Sprite* sprite);
+
+		void DrawPartialSprite(const Vector2i& pos, const Vector2i& filePos, const Vector2i& fileSize, const Sprite* sprite);
+		void DrawPartialSprite(int x, int y, int fileX, int fileY, int fileSizeX, int fileSizeY, const Sprite* sprite);
+
+		void DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation = 0.0f, float scale = 1.0f, const Pixel& col = WHITE);
+		void FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation = 0.0f, float scale = 1.0f, const Pixel& col = WHITE);
+
+		void DrawString(const Vector2i& pos, std::string_view text, const Pixel& col = WHITE, const Vector2i& scale = { 1, 1 });
+		void DrawString(int x, int y, std::string_view text, const Pixel& col = WHITE, int scaleX = 1, int scaleY = 1);
+
+		void Clear(const Pixel& col);
+		void ClearTexture(const Pixel& col);
+
+		void DrawTexture(const Vector2f& pos, const Texture* tex, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+		void DrawPartialTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+
+		void DrawWarpedTexture(const std::vector<Vector2f>& points, const Texture* tex, const Pixel& tint = WHITE);
+
+		void DrawRotatedTexture(const Vector2f& pos, const Texture* tex, float rotation, const Vector2f& center = { 0.0f, 0.0f }, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+		void DrawPartialRotatedTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, float rotation, const Vector2f& center = { 0.0f, 0.0f }, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+
+		void DrawTexturePolygon(const std::vector<Vector2f>& verts, const std::vector<Pixel>& cols, Texture::Structure structure);
+
+		// Draws every 3 vertices (in pixels) as a triangle with a single texture,
+		// uvs are normalised and can be empty if there's no texture,
+		// a single colour is used for all vertices
+		void DrawTextureTriangles(const Texture* tex, const std::vector<Vector2f>& verts, const std::vector<Vector2f>& uvs, const std::vector<Pixel>& cols);
+
+		// The same but the vectors are moved into the texture instead of being copied
+		void DrawTextureTriangles(const Texture* tex, std::vector<Vector2f>&& verts, std::vector<Vector2f>&& uvs, std::vector<Pixel>&& cols);
+
+		void DrawTextureLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col = WHITE);
+
+		void DrawTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col = WHITE);
+		void DrawTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void DrawTextureCircle(const Vector2i& pos, int radius, const Pixel& col = WHITE);
+
+		void FillTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col = WHITE);
+		void FillTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col = WHITE);
+		void FillTextureCircle(const Vector2i& pos, int radius, const Pixel& col = WHITE);
+
+		void GradientTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col1 = WHITE, const Pixel& col2 = WHITE, const Pixel& col3 = WHITE);
+		void GradientTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& colTL = WHITE, const Pixel& colTR = WHITE, const Pixel& colBR = WHITE, const Pixel& colBL = WHITE);
+
+		void DrawTextureString(const Vector2i& pos, std::string_view text, const Pixel& col = WHITE, const Vector2f& scale = { 1.0f, 1.0f });
+
+		// Draws the recorded textures moved by pos pixels and scaled relative to the top-left corner of the screen
+		void DrawTextureList(const Vector2f& pos, const DrawList* list, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+
+		// Pass nullptr to draw on the pixels of the layer again.
+		// Unlike GameEngine::SetDrawTarget the texture of the target isn't updated,
+		// because it can only be done on the main thread
+		void SetDrawTarget(Graphic* target);
+		Graphic* GetDrawTarget() const;
+
+		// Textures go into the render target instead of the layer, pass nullptr to reset it
+		void SetTextureTarget(RenderTarget* target);
+		RenderTarget* GetTextureTarget() const;
+
+		// Textures are recorded into the list instead of being drawn, pass nullptr to stop recording
+		void SetDrawList(DrawList* list);
+		DrawList* GetDrawList() const;
+
+		// Is assigned to all textures that are drawn after the call,
+		// see Layer::SortMode
+		void SetTextureDepth(float depth);
+		float GetTextureDepth() const;
+
+		void SetPixelMode(Pixel::Mode pixelMode);
+		Pixel::Mode GetPixelMode() const;
+
+		void SetShader(Shader shader);
+		Shader GetShader() const;
+
+		void SetTextureStructure(Texture::Structure textureStructure);
+		Texture::Structure GetTextureStructure() const;
+
+		// Returns nullptr if the context is bound to a graphic
+		Layer* GetLayer() const;
+
+	private:
+		// Fills a horizontal line, both ends are included
+		void DrawSpan(int x1, int x2, int y, const Pixel& col);
+
+		// Sends the texture to the texture target or to the layer
+		// if its bounding box is on the screen
+		void Submit(TextureInstance&& texInst);
+
+		// The same if the bounding box of the vertices is already known
+		void Submit(TextureInstance&& texInst, Vector2f min, Vector2f max);
+
+		// Converts the vertices from pixels to normalised coordinates and submits them
+		void SubmitTriangles(TextureInstance&& texInst);
+
+		friend class GameEngine;
+
+	private:
+		GameEngine* m_Engine;
+
+		// The state is taken from the layer if it's set
+		// and from the fields below otherwise
+		Layer* m_Layer;
+
+		Graphic* m_Target;
+		Pixel::Mode m_PixelMode;
+		Shader m_Shader;
+		Texture::Structure m_TextureStructure;
+
+		RenderTarget* m_TextureTarget;
+		DrawList* m_DrawList;
+
+		float m_TextureDepth;
+
+		// Textures that were culled since the engine has taken the count
+		uint32_t m_CulledTextures;
+
+		// Transformed points of wire frame models, is kept so they don't allocate on every call
+		std::vector<Vector2f> m_Coordinates;
+
+	};
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_DRAW_LIST_HPP
+#define DGE_DRAW_LIST_HPP
+
+#include "Pch.hpp"
+#include "Texture.hpp"
+
+namespace def
+{
+	class Platform;
+
+	// Records texture draws once and keeps them as a single block of vertices
+	// (in a vertex buffer on the GPU), so static content like level geometry
+	// or UI frames is submitted on every frame with a single call
+	class DrawList
+	{
+	public:
+		struct Vertex
+		{
+			Vector2f pos;
+			Vector2f uv;
+			Pixel col;
+		};
+
+		// Consecutive textures with the same texture and primitive are merged
+		struct Batch
+		{
+			const Texture* texture = nullptr;
+
+			// Triangles or lines
+			bool lines = false;
+
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+
+		DrawList(Platform* platform);
+		~DrawList();
+
+		DrawList(const DrawList&) = delete;
+		DrawList& operator=(const DrawList&) = delete;
+
+		// Removes everything that has been recorded
+		void Clear();
+
+		// Records a texture, its vertices are in normalised coordinates of the screen
+		void Add(TextureInstance&& texInst);
+
+		bool IsEmpty() const;
+
+		// Bounding box of all recorded vertices
+		const Vector2f& GetMin() const;
+		const Vector2f& GetMax() const;
+
+		// The recorded textures are converted into batches when they are needed for the first time
+		const std::vector<Vertex>& GetVertices() const;
+		const std::vector<Batch>& GetBatches() const;
+
+		// Returns the vertices scaled, moved and multiplied by the tint,
+		// the result is cached so nothing is done while the arguments are the same.
+		// Sets changed to true if the vertices have been recalculated
+		const std::vector<Vertex>& Bake(const Vector2f& offset, const Vector2f& scale, const Pixel& tint, bool& changed) const;
+
+		friend class PlatformGL;
+		friend class PlatformEmscripten;
+		friend class PlatformHeadless;
+
+	private:
+		void Compile() const;
+
+	private:
+		Platform* m_Platform;
+
+		// Are kept only until they are compiled
+		mutable std::vector<TextureInstance> m_Textures;
+
+		Vector2f m_Min;
+		Vector2f m_Max;
+
+		// Are built from m_Textures by Compile
+		mutable std::vector<Vertex> m_Vertices;
+		mutable std::vector<Batch> m_Batches;
+		mutable bool m_IsCompiled;
+
+		mutable std::vector<Vertex> m_Baked;
+		mutable bool m_IsBaked;
+		mutable Vector2f m_BakedOffset;
+		mutable Vector2f m_BakedScale;
+		mutable Pixel m_BakedTint;
+
+		// Is managed by the platform, the buffer must be uploaded again
+		// after the vertices have been recalculated
+		mutable uint32_t m_Buffer;
+		mutable bool m_IsUploaded;
+
+	};
+}
+
+#endif
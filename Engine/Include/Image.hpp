@@ -0,0 +1,324 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_IMAGE_HPP
+#define DGE_IMAGE_HPP
+
+#include "Pch.hpp"
+
+#ifndef DGE_IGNORE_VECTOR2D
+#include "Vector2D.hpp"
+#endif
+
+#include "Pixel.hpp"
+#include "AlignedAllocator.hpp"
+
+#include <type_traits>
+
+namespace def
+{
+	// Formats of the pixels an image can store, RGBA8 is def::Pixel
+	enum class PixelFormat
+	{
+		R8,
+		RG8,
+		RGBA8,
+		R16,
+		R32F,
+		INDEX8
+	};
+
+	// A single 8-bit channel, e.g. a mask
+	struct PixelR8
+	{
+		uint8_t r = 0;
+		bool operator==(const PixelR8&) const = default;
+	};
+
+	struct PixelRG8
+	{
+		uint8_t r = 0;
+		uint8_t g = 0;
+		bool operator==(const PixelRG8&) const = default;
+	};
+
+	// A single 16-bit channel, e.g. a heightmap
+	struct PixelR16
+	{
+		uint16_t r = 0;
+		bool operator==(const PixelR16&) const = default;
+	};
+
+	// A single float channel, e.g. a distance field
+	struct PixelR32F
+	{
+		float r = 0.0f;
+		bool operator==(const PixelR32F&) const = default;
+	};
+
+	// An index into a palette of up to 256 colours
+	struct PixelIndex8
+	{
+		uint8_t index = 0;
+		bool operator==(const PixelIndex8&) const = default;
+	};
+
+	struct PixelTraitsBase
+	{
+		// Rounded brightness with the same weights as PixelOps::Grayscale
+		static uint8_t Luma(const Pixel& p)
+		{
+			return uint8_t((77 * p.r + 150 * p.g + 29 * p.b + 128) >> 8);
+		}
+	};
+
+	// Describes a format at compile time. ToRGBA is how the pixels are shown on the screen,
+	// FromRGBA is how a colour is stored and Lerp is used by the bilinear sampling.
+	// The formats of a single channel also convert to and from floats from 0 to 1 without RGBA
+	template <class T>
+	struct PixelTraits;
+
+	template <>
+	struct PixelTraits<PixelR8> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::R8;
+
+		static Pixel ToRGBA(PixelR8 p) { return Pixel(p.r, p.r, p.r); }
+		static PixelR8 FromRGBA(const Pixel& p) { return { Luma(p) }; }
+
+		static float ToFloat(PixelR8 p) { return (float)p.r / 255.0f; }
+		static PixelR8 FromFloat(float f) { return { uint8_t(std::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f) }; }
+
+		static PixelR8 Lerp(PixelR8 a, PixelR8 b, float t) { return { uint8_t((float)a.r + float(b.r - a.r) * t + 0.5f) }; }
+	};
+
+	template <>
+	struct PixelTraits<PixelRG8> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::RG8;
+
+		static Pixel ToRGBA(PixelRG8 p) { return Pixel(p.r, p.g, 0); }
+		static PixelRG8 FromRGBA(const Pixel& p) { return { p.r, p.g }; }
+
+		static PixelRG8 Lerp(PixelRG8 a, PixelRG8 b, float t)
+		{
+			return {
+				uint8_t((float)a.r + float(b.r - a.r) * t + 0.5f),
+				uint8_t((float)a.g + float(b.g - a.g) * t + 0.5f)
+			};
+		}
+	};
+
+	template <>
+	struct PixelTraits<Pixel> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::RGBA8;
+
+		static Pixel ToRGBA(const Pixel& p) { return p; }
+		static Pixel FromRGBA(const Pixel& p) { return p; }
+
+		static Pixel Lerp(const Pixel& a, const Pixel& b, float t) { return b * t + a * (1.0f - t); }
+	};
+
+	template <>
+	struct PixelTraits<PixelR16> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::R16;
+
+		static Pixel ToRGBA(PixelR16 p) { uint8_t v = p.r >> 8; return Pixel(v, v, v); }
+		static PixelR16 FromRGBA(const Pixel& p) { return { uint16_t(Luma(p) * 257) }; }
+
+		static float ToFloat(PixelR16 p) { return (float)p.r / 65535.0f; }
+		static PixelR16 FromFloat(float f) { return { uint16_t(std::clamp(f, 0.0f, 1.0f) * 65535.0f + 0.5f) }; }
+
+		static PixelR16 Lerp(PixelR16 a, PixelR16 b, float t) { return { uint16_t((float)a.r + float(b.r - a.r) * t + 0.5f) }; }
+	};
+
+	template <>
+	struct PixelTraits<PixelR32F> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::R32F;
+
+		// The values outside of [0, 1] are stored as they are but shown clamped
+		static Pixel ToRGBA(PixelR32F p) { uint8_t v = PixelTraits<PixelR8>::FromFloat(p.r).r; return Pixel(v, v, v); }
+		static PixelR32F FromRGBA(const Pixel& p) { return { (float)Luma(p) / 255.0f }; }
+
+		static float ToFloat(PixelR32F p) { return p.r; }
+		static PixelR32F FromFloat(float f) { return { f }; }
+
+		static PixelR32F Lerp(PixelR32F a, PixelR32F b, float t) { return { a.r + (b.r - a.r) * t }; }
+	};
+
+	template <>
+	struct PixelTraits<PixelIndex8> : PixelTraitsBase
+	{
+		static constexpr PixelFormat FORMAT = PixelFormat::INDEX8;
+
+		// Without a palette the index is shown as a shade of grey
+		static Pixel ToRGBA(PixelIndex8 p) { return Pixel(p.index, p.index, p.index); }
+		static PixelIndex8 FromRGBA(const Pixel& p) { return { p.r }; }
+
+		// Indices can't be blended so the nearest one is taken
+		static PixelIndex8 Lerp(PixelIndex8 a, PixelIndex8 b, float t) { return t < 0.5f ? a : b; }
+	};
+
+	// Settings that are the same for the images of all formats
+	struct ImageBase
+	{
+		// Can be used only within the Sample method
+		enum class SampleMethod { LINEAR, BILINEAR, TRILINEAR };
+		enum class WrapMethod { NONE, REPEAT, MIRROR, CLAMP };
+	};
+
+	// Pixels of an image that belongs to something else, e.g. a part of a sprite,
+	// so it can be read and processed without copying. Each row is stride pixels after the previous one
+	template <class T>
+	struct ImageView : ImageBase
+	{
+		using Value = std::remove_const_t<T>;
+
+		ImageView() = default;
+		ImageView(T* pixels, const Vector2i& size, int stride);
+
+		// A view of mutable pixels can be used as a view of constant ones
+		template <class U> requires std::is_convertible_v<U*, T*>
+		ImageView(const ImageView<U>& view) : pixels(view.pixels), size(view.size), stride(view.stride) {}
+
+		T* pixels = nullptr;
+		Vector2i size;
+		int stride = 0;
+
+		inline T* GetRow(int y) const { return pixels + (ptrdiff_t)y * stride; }
+
+		inline bool IsEmpty() const { return !pixels || size.x <= 0 || size.y <= 0; }
+
+		// Returns a view of the rectangle which is clipped to this view
+		ImageView GetView(const Vector2i& pos, const Vector2i& size) const;
+
+		bool SetPixel(int x, int y, const Value& col) const requires (!std::is_const_v<T>);
+
+		Value GetPixel(int x, int y, WrapMethod wrap = WrapMethod::NONE) const;
+		Value GetPixel(const Vector2i& pos, WrapMethod wrap = WrapMethod::NONE) const;
+
+		// Takes values X and Y from 0 to 1, TRILINEAR is the same as BILINEAR for all formats except RGBA8
+		Value Sample(const Vector2f& pos, SampleMethod sampleMethod, WrapMethod wrapMethod) const;
+	};
+
+	// Pixels of a single format stored row by row, def::Sprite is the image of RGBA8 pixels.
+	// Other formats take less memory and are uploaded as they are, e.g. R16 for a heightmap
+	template <class T>
+	class Image : public ImageBase
+	{
+	public:
+		using Traits = PixelTraits<T>;
+
+		Image() = default;
+		Image(const Vector2i& size);
+
+		// Copies the pixels of the view
+		explicit Image(const ImageView<const T>& view);
+
+	public:
+		Vector2i size;
+
+		// Number of pixels from the beginning of a row to the beginning of the next one,
+		// it's at least size.x and the pixels after size.x are padding
+		int stride = 0;
+
+		// The first pixel is aligned to a cache line, pixel (x, y) is pixels[y * stride + x]
+		std::vector<T, AlignedAllocator<T, 64>> pixels;
+
+	public:
+		// Creates an image of a specified size filled with the default pixels (black for RGBA8),
+		// the stride of 0 is the same as size.x
+		void Create(const Vector2i& size, int stride = 0);
+
+		// Rounds the width up so every row starts at a cache line
+		static int GetAlignedStride(int width);
+
+		inline T* GetRow(int y) { return pixels.data() + (size_t)y * stride; }
+		inline const T* GetRow(int y) const { return pixels.data() + (size_t)y * stride; }
+
+		// Views of the whole image or of a rectangle which is clipped to the image,
+		// they are valid until the image is created again
+		ImageView<T> GetView();
+		ImageView<const T> GetView() const;
+		ImageView<T> GetView(const Vector2i& pos, const Vector2i& size);
+		ImageView<const T> GetView(const Vector2i& pos, const Vector2i& size) const;
+
+		operator ImageView<T>();
+		operator ImageView<const T>() const;
+
+		// Changes a specific pixel value
+		bool SetPixel(int x, int y, const T& col);
+
+		// Changes a specific pixel value
+		bool SetPixel(const Vector2i& pos, const T& col);
+
+		// Returns a pixel on a specified coordinates
+		T GetPixel(int x, int y, WrapMethod wrap = WrapMethod::NONE) const;
+
+		// Returns a pixel on a specified coordinates
+		T GetPixel(const Vector2i& pos, WrapMethod wrap = WrapMethod::NONE) const;
+
+		// Sets every pixel of the image to a specified colour
+		void SetPixelData(const T& col);
+
+		// Takes values X and Y from 0 to 1 and applies sampling and wrapping to the pixel at the specified coordinates
+		T Sample(float x, float y, SampleMethod sampleMethod, WrapMethod wrapMethod) const;
+
+		// Takes values X and Y from 0 to 1 and applies sampling and wrapping to the pixel at the specified coordinates
+		T Sample(const Vector2f& pos, SampleMethod sampleMethod, WrapMethod wrapMethod) const;
+	};
+
+	using ImageR8 = Image<PixelR8>;
+	using ImageRG8 = Image<PixelRG8>;
+	using ImageR16 = Image<PixelR16>;
+	using ImageR32F = Image<PixelR32F>;
+	using ImageIndex8 = Image<PixelIndex8>;
+
+	// Converts the pixels of src into the format To, e.g. ConvertImage<PixelR8>(sprite).
+	// The formats of a single channel are converted through floats so no precision is lost
+	// between R16 and R32F, the others are converted through RGBA
+	template <class To, class From>
+	Image<To> ConvertImage(const ImageView<const From>& src)
+	{
+		Image<To> dst;
+
+		if (src.IsEmpty())
+			return dst;
+
+		dst.Create(src.size);
+
+		for (int y = 0; y < src.size.y; y++)
+		{
+			const From* srcRow = src.GetRow(y);
+			To* dstRow = dst.GetRow(y);
+
+			for (int x = 0; x < src.size.x; x++)
+			{
+				if constexpr (std::is_same_v<To, From>)
+					dstRow[x] = srcRow[x];
+				else if constexpr (requires { PixelTraits<From>::ToFloat(srcRow[x]); PixelTraits<To>::FromFloat(0.0f); })
+					dstRow[x] = PixelTraits<To>::FromFloat(PixelTraits<From>::ToFloat(srcRow[x]));
+				else
+					dstRow[x] = PixelTraits<To>::FromRGBA(PixelTraits<From>::ToRGBA(srcRow[x]));
+			}
+		}
+
+		return dst;
+	}
+
+	template <class To, class From>
+	Image<To> ConvertImage(const Image<From>& src)
+	{
+		return ConvertImage<To>(src.GetView());
+	}
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_IMAGE_PROCESSING_HPP
+#define DGE_IMAGE_PROCESSING_HPP
+
+#include "Pch.hpp"
+#include "Sprite.hpp"
+
+#include <span>
+
+namespace def
+{
+	class ThreadPool;
+
+	// Operations on whole sprites. Pixels are processed with SSE2 or NEON when they are available
+	// and the rows are processed in parallel if a thread pool is passed, e.g. GameEngine::ThreadPool().
+	// A sprite can be passed wherever a view is expected, src must not be a part of dst
+	class ImageProcessing
+	{
+	public:
+		enum class Filter
+		{
+			BOX,
+			BILINEAR,
+			LANCZOS
+		};
+
+		// Resamples src into dst which gets the new size,
+		// when shrinking the filters average all pixels that are covered
+		static bool Resize(const ConstSpriteView& src, Sprite& dst, const Vector2i& size, Filter filter = Filter::BILINEAR, ThreadPool* pool = nullptr);
+
+		// Separable gaussian blur, pixels outside of the sprite are the same as the nearest edge
+		static bool Blur(const ConstSpriteView& src, Sprite& dst, float sigma, ThreadPool* pool = nullptr);
+
+		// Convolves with kernelSize.x * kernelSize.y weights stored row by row,
+		// the kernel is centred at kernelSize / 2 and the edges are clamped
+		static bool Convolve(const ConstSpriteView& src, Sprite& dst, std::span<const float> kernel, const Vector2i& kernelSize, ThreadPool* pool = nullptr);
+
+		static void FlipHorizontally(const SpriteView& sprite, ThreadPool* pool = nullptr);
+		static void FlipVertically(const SpriteView& sprite, ThreadPool* pool = nullptr);
+
+		// Rotates clockwise by 90 degrees the number of turns, negative turns are counter-clockwise
+		static bool Rotate90(const ConstSpriteView& src, Sprite& dst, int turns, ThreadPool* pool = nullptr);
+
+		// Copies the rectangle of src at srcPos to dstPos of dst, the rectangle is clipped to both views
+		static void Copy(const ConstSpriteView& src, const Vector2i& srcPos, const Vector2i& size, const SpriteView& dst, const Vector2i& dstPos, ThreadPool* pool = nullptr);
+
+		// The same as Copy but src is drawn over dst using its alpha multiplied by the opacity
+		static void Blend(const ConstSpriteView& src, const Vector2i& srcPos, const Vector2i& size, const SpriteView& dst, const Vector2i& dstPos, uint8_t opacity = 255, ThreadPool* pool = nullptr);
+
+		// Writes the colour of every index of src to the same position of dst, the area is clipped to both views
+		// and the indices past the end of the palette become NONE
+		static void ResolvePalette(const ImageView<const PixelIndex8>& src, std::span<const Pixel> palette, const SpriteView& dst, ThreadPool* pool = nullptr);
+
+	};
+}
+
+#endif
@@ -12,6 +12,10 @@
 #include "Pch.hpp"
 #include "Vector2D.hpp"
 #include "Platform.hpp"
+#include "Timer.hpp"
+
+#include <array>
+#include <fstream>
 
 namespace def
 {
@@ -51,6 +55,7 @@ namespace def
 	// Key::COUNT
 	inline static constexpr uint8_t KEYS_COUNT = static_cast<uint8_t>(Key::COUNT);
     
+
 	// You can get a state of each button specified here using GetButtonState method
 	enum class Button
 	{
@@ -73,6 +78,38 @@ namespace def
 		bool pressed;
 	};
 
+	// A single event reported by the platform,
+	// events are queued as they arrive and processed at the start of a frame
+	struct InputEvent
+	{
+		enum class Type : uint8_t
+		{
+			KEY, BUTTON, SCROLL, MOVE, CHAR
+		};
+
+		Type type = Type::KEY;
+
+		// KEY and BUTTON: true if the key or the button went down, false if it went up
+		bool down = false;
+
+		// KEY: true if the event was generated by the key auto-repeat
+		bool repeat = false;
+
+		// KEY: value from the Key enum, BUTTON: value from the Button enum,
+		// CHAR: unicode code point of the typed character
+		uint32_t code = 0;
+
+		// MOVE: mouse position in screen coordinates,
+		// SCROLL: offsets on both axes
+		Vector2f value;
+
+		// The moment at which the platform has reported the event
+		TimePoint timestamp;
+	};
+
+	// Maximum number of events that can be received between 2 frames
+	inline static constexpr size_t INPUT_EVENTS_CAPACITY = 512;
+
 	// Provides an API for capturing user input (mouse, keyboard, touches)
     class InputHandler
     {
@@ -81,6 +118,7 @@ namespace def
 		friend class PlatformGL;
 		friend class PlatformGLFW3;
 		friend class PlatformEmscripten;
+		friend class PlatformHeadless;
 		friend class Console;
 		friend class GameEngine;
 
@@ -124,13 +162,38 @@ namespace def
 		// Returns true if the CAPS key was activated
 		bool IsCaps() const;
 
+		// Returns true if any key, button, mouse movement or scroll
+		// has been received on the current frame
+		bool HasActivity() const;
+
+		// Returns all events received since the last frame in the order they've arrived,
+		// the key and button states are built from exactly these events
+		const std::vector<InputEvent>& GetEvents() const;
+
+		// Returns the number of events that didn't fit into the queue
+		size_t GetDroppedEventsCount() const;
+
+		// Starts writing every input event together with the delta time
+		// of each frame to a binary file, returns false if the file can't be opened
+		bool StartRecording(const std::string& fileName);
+		void StopRecording();
+		bool IsRecording() const;
+
+		// Starts feeding the events from a recording instead of the platform ones,
+		// the engine also switches the timer to the recorded delta times
+		bool StartReplay(const std::string& fileName);
+		void StopReplay();
+		bool IsReplaying() const;
+
     public:
 		// For now we have only US keyboard layout,
-		// here we map a key to its character analogue on the keyboard
-        static std::unordered_map<Key, std::pair<char, char>> s_KeyboardUS;
+		// here we map a key to its character analogue on the keyboard,
+		// the table is indexed by the value from the Key enum, keys without a character map to { 0, 0 }
+        static const std::array<std::pair<char, char>, KEYS_COUNT> s_KeyboardUS;
 
 		// Maps the platform specific key constant to the value from the Key enum
-		static std::unordered_map<int, Key> s_KeysTable;
+		// using a dense table, returns Key::NONE for unknown constants
+		static Key MapKey(int platformKey);
 
 	protected:
 		// Sets the m_CapturedText field to text
@@ -139,17 +202,36 @@ namespace def
 		// Sets the m_CapturedTextCursorPos to pos
 		void SetCapturedTextCursorPosition(size_t pos);
 
+		// Are called by the platform callbacks, each event is queued with the current timestamp
+		void PushKeyEvent(Key key, bool down, bool repeat);
+		void PushButtonEvent(Button button, bool down);
+		void PushScrollEvent(const Vector2f& offset);
+		void PushMoveEvent(const Vector2i& pos);
+		void PushCharEvent(uint32_t codePoint);
+		void PushEvent(const InputEvent& event);
+
 		// Polls all events on the current frame
 		void GrabEvents();
+
+		// Same as GrabEvents but blocks until an event arrives or the timeout (in seconds) expires
+		void WaitEvents(float timeout);
 		
-		// Updates states of the keys and buttons buffers
+		// Drains the event queue and updates states of the keys and buttons
 		void FlushBuffers();
 
 		// Handles text input from the keyboard
 		void GrabText();
 
+		// Writes the events of the current frame to the recording
+		void RecordFrame(float deltaTime);
+
+		// Queues the events of the next recorded frame,
+		// returns false if there are no frames left
+		bool ReplayFrame(float& deltaTime);
+
     private:
-        static void UpdateState(KeyState* data, bool* newState, bool* oldState, uint8_t count);
+        // Applies the event to the key or button states, mouse position and scroll
+        void ProcessEvent(const InputEvent& event);
 
     private:
 		// Storing states of all possible keys
@@ -158,23 +240,34 @@ namespace def
 		// Storing state of all possible buttons or touches
         KeyState m_Mouse[8];
 
-		// Used for storing the old state of the keys, buttons, and touches
-		// so we can distinguish held and pressed states
-
-        bool m_KeyOldState[KEYS_COUNT];
-        bool m_KeyNewState[KEYS_COUNT];
+		// Ring buffer of the events that have been received since the last frame
+		std::array<InputEvent, INPUT_EVENTS_CAPACITY> m_EventQueue;
+		size_t m_EventQueueStart;
+		size_t m_EventQueueSize;
+		size_t m_DroppedEvents;
 
-        bool m_MouseOldState[8];
-        bool m_MouseNewState[8];
+		// Events that were drained from the queue on the current frame
+		std::vector<InputEvent> m_Events;
 
 		// Storing current mouse position in screen coordinates
         Vector2i m_MousePos;
 
         int m_ScrollDelta;
 
+		// Fractional part of the scrolling that hasn't been reported yet
+		float m_ScrollAccumulator;
+
+		std::ofstream m_RecordFile;
+		std::ifstream m_ReplayFile;
+
+		// Is true while the recorded events are being queued,
+		// all other events are ignored during a replay
+		bool m_IsInjecting;
+
 		bool m_CaptureText;
 		bool m_Caps;
 
+
 		std::string m_CapturedText;
 		size_t m_CapturedTextCursorPos;
 
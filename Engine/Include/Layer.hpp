@@ -12,6 +12,7 @@
 #include "Pch.hpp"
 #include "Texture.hpp"
 #include "Graphic.hpp"
+#include "DrawContext.hpp"
 #include "defGameEngine.hpp"
 
 namespace def
@@ -28,11 +29,18 @@ namespace def
 
 		friend class GameEngine;
 		friend class Console;
+		friend class DrawContext;
 
 	protected:
 		// All textures on the current layer
 		std::vector<TextureInstance> textures;
 
+		// Number of textures that were submitted on the last frame
+		size_t drawnTextures = 0;
+
+		// Number of textures that were off the screen on the last frame
+		size_t culledTextures = 0;
+
 		// Pixel data that will be drawn by default on the current layer
 		Graphic* pixels = nullptr;
 
@@ -49,6 +57,8 @@ namespace def
 		// Each texture on the layer will use this value as a structure
 		Texture::Structure textureStructure = Texture::Structure::TRIANGLE_FAN;
 
+		TextureInstance::SortMode sortMode = TextureInstance::SortMode::NONE;
+
 		// Each pixel that is being drawn on this layer
 		// will use this mode to be drawn
 		Pixel::Mode pixelMode = Pixel::Mode::DEFAULT;
@@ -60,6 +70,11 @@ namespace def
 		// if this value is false
 		bool update = true;
 
+		// OnUpdate of the layer will be called on a worker thread at the same time
+		// as the other layers, so it must draw only through drawContext
+		// and must not change the state of the engine
+		bool parallelUpdate = false;
+
 		// Tint that only applied to the current laeyer
 		Pixel tint = WHITE;
 
@@ -67,7 +82,35 @@ namespace def
 		// knowing its current value and its position on the screen
 		Pixel (*shader)(const Vector2i&, const Pixel&, const Pixel&) = nullptr;
 
+		// Passes that are applied one after another to the whole layer after OnUpdate,
+		// each one reads the result of the previous one. The processed image is what
+		// is shown on the screen, the pixels of the layer itself stay the same
+		std::vector<DrawContext::SpanShader> postProcess;
+
+		// The passes write into these in turns, postProcessed points
+		// at the result of the last frame or is nullptr if there are no passes
+		Sprite postProcessBuffers[2];
+		Sprite* postProcessed = nullptr;
+
+		// Indices into the palette that are shown instead of the pixels if the layer is indexed,
+		// only they are uploaded and the colours are looked up on the GPU. They are resolved into
+		// the pixels on the CPU if the platform can't do it or if the layer has post-process passes
+		ImageIndex8 indices;
+
+		// 256x1 colours of the indices, the layer is indexed if it isn't empty
+		Sprite palette;
+
+		// Are created on the first frame the indices are drawn on the GPU
+		Texture* indexTexture = nullptr;
+		Texture* paletteTexture = nullptr;
+
+		// Only a changed palette is uploaded again
+		bool paletteChanged = false;
+
 		GameEngine& context;
+
+		// Draws on this layer regardless of the current layer of the engine
+		DrawContext drawContext;
 	};
 }
 
@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_LOG_HPP
+#define DGE_LOG_HPP
+
+#include "Pch.hpp"
+
+#include <atomic>
+#include <sstream>
+
+namespace def
+{
+	// Thread-safe logger, any thread can write messages
+	// without locking, they are queued and later dispatched
+	// to the console, stderr and a log file
+	class Log
+	{
+	public:
+		// ERR and WARN are shortened because of the macros in windows.h
+		enum class Level : uint8_t
+		{
+			TRACE, DEBUG, INFO, WARN, ERR, FATAL,
+
+			// Disables the logging if it's used as a minimum level
+			NONE
+		};
+
+		struct Message
+		{
+			Level level = Level::INFO;
+			std::chrono::system_clock::time_point time;
+			std::string text;
+		};
+
+		// Messages below the level are discarded before they are formatted
+		static void SetLevel(Level level);
+		static Level GetLevel();
+
+		static bool IsEnabled(Level level)
+		{
+			return level >= s_Level.load(std::memory_order_relaxed) && level != Level::NONE;
+		}
+
+		// Formats the arguments with operator<< and queues the message,
+		// if the queue is full the message is dropped
+		template <class... T>
+		static void Write(Level level, T&&... args)
+		{
+			if (!IsEnabled(level))
+				return;
+
+			std::ostringstream ss;
+			(ss << ... << std::forward<T>(args));
+
+			Push(level, ss.str());
+
+			// The application is probably about to terminate
+			if (level == Level::FATAL)
+				Flush();
+		}
+
+		template <class... T> static void Trace(T&&... args) { Write(Level::TRACE, std::forward<T>(args)...); }
+		template <class... T> static void Debug(T&&... args) { Write(Level::DEBUG, std::forward<T>(args)...); }
+		template <class... T> static void Info(T&&... args) { Write(Level::INFO, std::forward<T>(args)...); }
+		template <class... T> static void Warn(T&&... args) { Write(Level::WARN, std::forward<T>(args)...); }
+		template <class... T> static void Error(T&&... args) { Write(Level::ERR, std::forward<T>(args)...); }
+		template <class... T> static void Fatal(T&&... args) { Write(Level::FATAL, std::forward<T>(args)...); }
+
+		// Messages of the level or higher are printed to the console
+		// and to stderr, pass NONE to disable the output
+		static void SetConsoleLevel(Level level);
+		static void SetStderrLevel(Level level);
+
+		// Starts a background thread that writes messages to the file.
+		// When the file exceeds maxFileSize bytes it's renamed to fileName.1,
+		// fileName.1 to fileName.2 and so on, only maxFiles old files are kept
+		static bool OpenFile(const std::string& fileName, size_t maxFileSize = 4 * 1024 * 1024, size_t maxFiles = 3);
+
+		// Writes everything that is left and stops the background thread
+		static void CloseFile();
+
+		// Takes all queued messages and hands them to the file writer,
+		// stderr and the console backlog, is called by the engine on every frame.
+		// The background thread also calls it if nobody has done it for a while
+		static void Drain();
+
+		// Drains the queue and waits until the file writer has written everything
+		static void Flush();
+
+		// Moves the messages for the console into the vector, the vector is cleared first
+		static void TakeConsoleMessages(std::vector<Message>& messages);
+
+		// Returns the number of messages that were dropped because the queue was full
+		static uint64_t GetDroppedCount();
+
+		static const char* GetLevelName(Level level);
+
+	private:
+		static void Push(Level level, std::string&& text);
+
+		static std::atomic<Level> s_Level;
+
+	};
+}
+
+// Unlike Log::Write the arguments aren't evaluated if the level is disabled,
+// so it can be used in hot loops, e.g. DGE_LOG(TRACE, "Spawned ", count, " particles")
+#define DGE_LOG(level, ...) \
+	do \
+	{ \
+		if (def::Log::IsEnabled(def::Log::Level::level)) \
+			def::Log::Write(def::Log::Level::level, __VA_ARGS__); \
+	} while (false)
+
+#endif
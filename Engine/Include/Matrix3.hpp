@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_MATRIX3_HPP
+#define DGE_MATRIX3_HPP
+
+#include "Pch.hpp"
+#include "Vector2D.hpp"
+
+#include <span>
+
+namespace def
+{
+	// 3x3 matrix of a 2D affine transform, the last row is always (0, 0, 1).
+	// Points are column vectors so A * B applies B first and then A
+	struct Matrix3
+	{
+		// Creates an identity matrix
+		Matrix3();
+
+		Matrix3(float m00, float m01, float m02, float m10, float m11, float m12);
+
+		static Matrix3 Translate(const Vector2f& offset);
+		static Matrix3 Rotate(float angle);
+		static Matrix3 Scale(const Vector2f& scale);
+
+		Matrix3 operator*(const Matrix3& rhs) const;
+		Matrix3& operator*=(const Matrix3& rhs);
+
+		// Returns the identity matrix if the matrix can't be inverted
+		Matrix3 Inverse() const;
+
+		inline Vector2f Transform(const Vector2f& point) const
+		{
+			return { m[0][0] * point.x + m[0][1] * point.y + m[0][2], m[1][0] * point.x + m[1][1] * point.y + m[1][2] };
+		}
+
+		// Ignores the translation, e.g. for sizes
+		inline Vector2f TransformDirection(const Vector2f& direction) const
+		{
+			return { m[0][0] * direction.x + m[0][1] * direction.y, m[1][0] * direction.x + m[1][1] * direction.y };
+		}
+
+		// Transforms in.size() points into out which must have at least as many,
+		// in and out can be the same. Uses SSE2 or NEON when they are available
+		void TransformPoints(std::span<const Vector2f> in, std::span<Vector2f> out) const;
+
+		// The same for points that are stored as separate arrays of coordinates
+		void TransformPoints(const float* inX, const float* inY, float* outX, float* outY, size_t count) const;
+
+		// True if there is no rotation or shear, so rectangles stay rectangles
+		bool IsAxisAligned() const;
+
+		// Decomposes the matrix assuming there is no shear,
+		// a mirrored matrix has a negative Y scale
+		float GetRotation() const;
+		Vector2f GetScale() const;
+		Vector2f GetTranslation() const;
+
+		float m[3][3];
+	};
+}
+
+#endif
@@ -40,7 +40,9 @@ namespace def
 			uint8_t rgba_v[4];
 		};
 
-		// Linearly interpolates between this and rhs values with factor
+		// Linearly interpolates between this and rhs values with factor.
+		// It stays in floating point so the existing results don't change,
+		// PixelOps::Lerp rounds the factor to 1/256 steps and may differ by 1
 		Pixel Lerp(const Pixel& rhs, float factor) const;
 
 		// Represents pixel value as a string: (r, g, b, a)
@@ -0,0 +1,52 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_PIXEL_OPS_HPP
+#define DGE_PIXEL_OPS_HPP
+
+#include "Pch.hpp"
+#include "Pixel.hpp"
+
+#include <span>
+
+namespace def
+{
+	// Colour operations over whole spans of pixels in integer arithmetic,
+	// processed with AVX2, SSE2 or NEON when they are available except for Unpremultiply,
+	// which is scalar. Every path gives exactly the same results. The output can be one of the inputs
+	// and only as many pixels as the shortest span has are processed
+	class PixelOps
+	{
+	public:
+		// out = from + (to - from) * factor for all 4 channels,
+		// the factor is rounded to 1/256 steps
+		static void Lerp(std::span<const Pixel> from, std::span<const Pixel> to, float factor, std::span<Pixel> out);
+
+		// out = src * tint / 255 for all 4 channels, rounded to the nearest value
+		static void Modulate(std::span<const Pixel> src, const Pixel& tint, std::span<Pixel> out);
+
+		// out = src1 * src2 / 255 for all 4 channels, rounded to the nearest value
+		static void Modulate(std::span<const Pixel> src1, std::span<const Pixel> src2, std::span<Pixel> out);
+
+		// out = min(src1 + src2, 255) for all 4 channels
+		static void AddSaturate(std::span<const Pixel> src1, std::span<const Pixel> src2, std::span<Pixel> out);
+
+		// Replaces RGB with the luma (0.3, 0.59, 0.11 in 1/256 steps), keeps the alpha
+		static void Grayscale(std::span<const Pixel> src, std::span<Pixel> out);
+
+		// Multiplies RGB by the alpha
+		static void Premultiply(std::span<const Pixel> src, std::span<Pixel> out);
+
+		// Divides RGB by the alpha, fully transparent pixels become NONE.
+		// It's scalar, the divisions are multiplications by reciprocals from a table
+		static void Unpremultiply(std::span<const Pixel> src, std::span<Pixel> out);
+
+	};
+}
+
+#endif
@@ -17,6 +17,21 @@ namespace def
 	class InputHandler;
 	class Window;
 	class GameEngine;
+	class RenderTarget;
+	class DrawList;
+
+	// Number of calls to the graphics API during a frame
+	struct RenderStats
+	{
+		uint32_t drawCalls = 0;
+		uint32_t textureBinds = 0;
+		uint32_t vertices = 0;
+
+		// Textures that reached the platform and that were
+		// dropped at submission because they were off the screen
+		uint32_t submitted = 0;
+		uint32_t culled = 0;
+	};
 
 	// An abstract class that uses
 	// platform specific API for capturing input
@@ -56,6 +71,10 @@ namespace def
 		// Polls events from the event queue
 		virtual void PollEvents() const = 0;
 
+		// Waits until at least one event is available or
+		// the timeout (in seconds) expires and then polls the events
+		virtual void WaitEvents(float timeout) const = 0;
+
 		// Draws a quad:
 		// 1) polygon vertices: (-1, -1), (1, -1), (-1, 1), (1, 1)
 		// 2) texture vertices: (0, 1), (1, 1), (0, 0), (1, 0)
@@ -64,9 +83,41 @@ namespace def
 		// Draws a texture on the screen using info from TextureInstance
 		virtual void DrawTexture(const TextureInstance& texInst) const = 0;
 
+		// Draws all textures of a layer in their order,
+		// consecutive textures with the same ID are drawn with a single bind
+		virtual void DrawTextures(const std::vector<TextureInstance>& textures) const;
+
+		// Checks if DrawPalettedTexture looks up the colours on the GPU
+		virtual bool IsPaletteSupported() const;
+
+		// Draws a texture of 8-bit indices with the colours of the 256x1 palette texture,
+		// by default the texture is drawn as it is
+		virtual void DrawPalettedTexture(const TextureInstance& texInst, const Texture* palette) const;
+
+		// Draws the list of TextureInstance::drawList, the vertices are uploaded
+		// to the GPU once and only the transform is applied on every frame
+		virtual void DrawTextureList(const TextureInstance& texInst) const = 0;
+
+		// Releases the vertex buffer of the list
+		virtual void DestroyDrawList(DrawList& list) = 0;
+
 		// Binds a texture to work with
 		virtual void BindTexture(int id) const = 0;
 
+		// Creates a framebuffer that uses the texture of the target,
+		// if it's not supported the target stays invalid
+		virtual void CreateRenderTarget(RenderTarget& target) = 0;
+		virtual void DestroyRenderTarget(RenderTarget& target) = 0;
+
+		// Clears the target if it's needed and draws its queued textures into it
+		virtual void DrawRenderTarget(RenderTarget& target) = 0;
+
+		// Starts copying pixels of the target to the CPU
+		virtual void BeginReadback(RenderTarget& target) = 0;
+
+		// Waits until the copy is done and writes the pixels into the sprite of the target
+		virtual void FinishReadback(RenderTarget& target) = 0;
+
 		// Constructs a window or a canvas with specified params
 		virtual bool ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) = 0;
 
@@ -89,6 +140,15 @@ namespace def
 		// Sets input handler pointer for internal usage
 		void SetInputHandler(std::shared_ptr<InputHandler> input);
 
+		// Returns the counters of the last finished frame
+		const RenderStats& GetRenderStats() const;
+
+		// Is called by the engine with the number of textures that were culled by a layer
+		void CountCulledTextures(uint32_t count);
+
+		// Finishes counting the current frame and starts the next one
+		void ResetRenderStats();
+
 		friend class InputHandler;
 
 	protected:
@@ -100,6 +160,10 @@ namespace def
 
 		GameEngine* m_Engine = nullptr;
 
+		// Drawing methods are const so the counters are mutable
+		mutable RenderStats m_RenderStats;
+		RenderStats m_LastRenderStats;
+
 	};
 }
 
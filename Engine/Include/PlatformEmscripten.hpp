@@ -7,7 +7,7 @@
 #include "Graphic.hpp"
 
 #include <EGL/egl.h>
-#include <GLES2/gl2.h>
+#include <GLES3/gl3.h>
 
 #define GL_GLEXT_PROTOTYPES
 #include <GLES2/gl2ext.h>
@@ -16,6 +16,9 @@
 #include <emscripten/key_codes.h>
 #include <emscripten/html5.h>
 
+// WebGL 2 reads pixel buffers with getBufferSubData instead of mapping them, Emscripten implements it under the desktop name
+extern "C" void glGetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void* data);
+
 namespace def
 {
 	class PlatformEmscripten : public Platform
@@ -37,12 +40,25 @@ namespace def
 
 		virtual void FlushScreen(bool vsync) const override;
 		virtual void PollEvents() const override;
+		virtual void WaitEvents(float timeout) const override;
 
 		virtual void DrawQuad(const Pixel& tint) const override;
 		virtual void DrawTexture(const TextureInstance& texInst) const override;
 
 		virtual void BindTexture(int id) const override;
 
+		virtual bool IsPaletteSupported() const override;
+		virtual void DrawPalettedTexture(const TextureInstance& texInst, const Texture* palette) const override;
+
+		virtual void DrawTextureList(const TextureInstance& texInst) const override;
+		virtual void DestroyDrawList(DrawList& list) override;
+
+		virtual void CreateRenderTarget(RenderTarget& target) override;
+		virtual void DestroyRenderTarget(RenderTarget& target) override;
+		virtual void DrawRenderTarget(RenderTarget& target) override;
+		virtual void BeginReadback(RenderTarget& target) override;
+		virtual void FinishReadback(RenderTarget& target) override;
+
 		virtual bool ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) override;
 
 		virtual void SetIcon(Sprite& icon) const override;
@@ -68,6 +84,11 @@ namespace def
 		uint32_t m_FragmentShader = 0;
 		uint32_t m_VertexShader = 0;
 		uint32_t m_QuadShader = 0;
+
+		// Looks up the colours of the indexed layers
+		uint32_t m_PaletteShader = 0;
+		uint32_t m_PaletteProgram = 0;
+
 		uint32_t m_VbQuad = 0;
 		uint32_t m_VaQuad = 0;
 
@@ -78,7 +99,11 @@ namespace def
 			Pixel col;
 		};
 
-		mutable Vertex m_VertexMemory[128];
+		// Grows to the largest polygon, e.g. batched triangles
+		mutable std::vector<Vertex> m_VertexMemory;
+
+		// Vertices of a draw list in the layout of the shader
+		mutable std::vector<Vertex> m_ListVertices;
 
 		Graphic m_BlankQuad;
 	};
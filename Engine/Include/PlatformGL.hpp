@@ -26,9 +26,22 @@ namespace def
 
 		void DrawQuad(const Pixel& tint) const override;
 		void DrawTexture(const TextureInstance& texInst) const override;
+		void DrawTextures(const std::vector<TextureInstance>& textures) const override;
 
 		void BindTexture(int id) const override;
 
+		bool IsPaletteSupported() const override;
+		void DrawPalettedTexture(const TextureInstance& texInst, const Texture* palette) const override;
+
+		void DrawTextureList(const TextureInstance& texInst) const override;
+		void DestroyDrawList(DrawList& list) override;
+
+		void CreateRenderTarget(RenderTarget& target) override;
+		void DestroyRenderTarget(RenderTarget& target) override;
+		void DrawRenderTarget(RenderTarget& target) override;
+		void BeginReadback(RenderTarget& target) override;
+		void FinishReadback(RenderTarget& target) override;
+
 		void Destroy() const override;
 		void SetTitle(const std::string_view text) const override;
 
@@ -37,6 +50,7 @@ namespace def
 
 		void FlushScreen(bool vsync) const override;
 		void PollEvents() const override;
+		void WaitEvents(float timeout) const override;
 
 		bool ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) override;
 
@@ -45,6 +59,34 @@ namespace def
 		void EnableVSync(bool enable) override;
 
 		void EnableFullscreen(bool enable) override;
+
+	protected:
+		// Returns the address of an OpenGL function that isn't declared
+		// in the OpenGL 1.1 headers (e.g. glGenFramebuffers)
+		virtual void* LoadFunction(const char* name) const;
+
+	private:
+		// Draws the vertices with the currently bound texture
+		void DrawVertices(const TextureInstance& texInst) const;
+
+		// Loads the functions for framebuffers and buffer objects once,
+		// returns false if framebuffers aren't supported
+		bool LoadExtensions() const;
+
+		// Compiles the fragment program that looks up the palette once,
+		// returns false if shaders aren't supported
+		bool CreatePaletteProgram() const;
+
+	private:
+		mutable bool m_IsExtensionsLoaded = false;
+		mutable bool m_HasFramebuffers = false;
+		mutable bool m_HasBuffers = false;
+		mutable bool m_HasPixelBuffers = false;
+		mutable bool m_HasShaders = false;
+
+		mutable bool m_IsPaletteProgramCreated = false;
+		mutable uint32_t m_PaletteProgram = 0;
+
 	};
 }
 
@@ -40,6 +40,7 @@ namespace def
 		static void ScrollCallback(GLFWwindow* window, double x, double y);
 		static void MousePosCallback(GLFWwindow* window, double x, double y);
 		static void KeyboardCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+		static void CharCallback(GLFWwindow* window, unsigned int codePoint);
 		static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 		static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
 		static void WindowPosCallback(GLFWwindow* window, int x, int y);
@@ -52,11 +53,14 @@ namespace def
 
 		void FlushScreen(bool vsync) const override;
 		void PollEvents() const override;
+		void WaitEvents(float timeout) const override;
 
 		bool ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) override;
 
 		void SetIcon(Sprite& icon) const override;
 
+		void* LoadFunction(const char* name) const override;
+
 		void EnableVSync(bool enable) override;
 		void EnableFullscreen(bool enable) override;
 
@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_PLATFORM_HEADLESS_HPP
+#define DGE_PLATFORM_HEADLESS_HPP
+
+#include "Pch.hpp"
+#include "Platform.hpp"
+
+namespace def
+{
+	// A platform without a window and a graphics API,
+	// nothing is shown on the screen and input comes only from replays,
+	// so it can run on machines without a display (e.g. CI)
+	class PlatformHeadless : public Platform
+	{
+	public:
+		PlatformHeadless(GameEngine* engine);
+
+		friend class GameEngine;
+		friend class Window;
+
+		void Destroy() const override;
+		void SetTitle(const std::string_view text) const override;
+
+		bool IsWindowClose() const override;
+		bool IsWindowFocused() const override;
+
+		void ClearBuffer(const Pixel& col) const override;
+
+		void OnBeforeDraw() override;
+		void OnAfterDraw() override;
+
+		void FlushScreen(bool vsync) const override;
+		void PollEvents() const override;
+		void WaitEvents(float timeout) const override;
+
+		void DrawQuad(const Pixel& tint) const override;
+		void DrawTexture(const TextureInstance& texInst) const override;
+
+		void BindTexture(int id) const override;
+
+		void DrawTextureList(const TextureInstance& texInst) const override;
+		void DestroyDrawList(DrawList& list) override;
+
+		void CreateRenderTarget(RenderTarget& target) override;
+		void DestroyRenderTarget(RenderTarget& target) override;
+		void DrawRenderTarget(RenderTarget& target) override;
+		void BeginReadback(RenderTarget& target) override;
+		void FinishReadback(RenderTarget& target) override;
+
+		bool ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) override;
+
+		void SetIcon(Sprite& icon) const override;
+
+		void EnableVSync(bool enable) override;
+		void EnableFullscreen(bool enable) override;
+
+		// Are used by Texture in place of glGenTextures and glTexImage2D,
+		// a copy of the pixels is kept so textures can be drawn into render targets
+		static uint32_t CreateTexture(const ConstSpriteView& view);
+		static void UpdateTexture(uint32_t id, const ConstSpriteView& view);
+		static void UpdateTextureRegion(uint32_t id, const ConstSpriteView& view, const Vector2i& offset);
+
+	private:
+		// Software rasteriser for the render targets, the vertices are in
+		// normalised coordinates of the target with (-1, -1) in the top-left corner
+		void RasteriseTexture(Sprite* target, const TextureInstance& texInst) const;
+		void RasteriseTriangle(Sprite* target, const Sprite* texture, const TextureInstance& texInst, uint32_t i1, uint32_t i2, uint32_t i3) const;
+
+	private:
+		static uint32_t s_TexturesCount;
+
+		// Pixels of each texture by its ID
+		static std::unordered_map<uint32_t, Sprite> s_Textures;
+
+	};
+}
+
+#endif
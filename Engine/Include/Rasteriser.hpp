@@ -0,0 +1,702 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_RASTERISER_HPP
+#define DGE_RASTERISER_HPP
+
+#include "Pch.hpp"
+#include "Vector2D.hpp"
+#include "Matrix3.hpp"
+#include "Sprite.hpp"
+
+namespace def
+{
+	// Rasterisation algorithms that don't know where the pixels go:
+	// plot(x, y) is called for each pixel of an outline and
+	// span(x1, x2, y) for each horizontal line of a filled shape (both ends are included),
+	// so the same code is used by GameEngine and by DrawContext
+	class Rasteriser
+	{
+	public:
+		template <class Plot>
+		static void Line(int x1, int y1, int x2, int y2, Plot&& plot)
+		{
+			int dx = x2 - x1;
+			int dy = y2 - y1;
+
+			int dx1 = abs(dx);
+			int dy1 = abs(dy);
+
+			int px = 2 * dy1 - dx1;
+			int py = 2 * dx1 - dy1;
+
+			int x, y, xe, ye;
+
+			if (dy1 <= dx1)
+			{
+				if (dx >= 0)
+				{
+					x = x1;
+					y = y1;
+					xe = x2;
+				}
+				else
+				{
+					x = x2;
+					y = y2;
+					xe = x1;
+				}
+
+				plot(x, y);
+
+				while (x < xe)
+				{
+					x++;
+
+					if (px < 0)
+						px = px + 2 * dy1;
+					else
+					{
+						y += ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) ? 1 : -1;
+						px = px + 2 * (dy1 - dx1);
+					}
+
+					plot(x, y);
+				}
+			}
+			else
+			{
+				if (dy >= 0)
+				{
+					x = x1;
+					y = y1;
+					ye = y2;
+				}
+				else
+				{
+					x = x2;
+					y = y2;
+					ye = y1;
+				}
+
+				plot(x, y);
+
+				while (y < ye)
+				{
+					y++;
+
+					if (py <= 0)
+						py = py + 2 * dx1;
+					else
+					{
+						x += ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) ? 1 : -1;
+						py = py + 2 * (dx1 - dy1);
+					}
+
+					plot(x, y);
+				}
+			}
+		}
+
+		template <class Plot>
+		static void Triangle(int x1, int y1, int x2, int y2, int x3, int y3, Plot&& plot)
+		{
+			Line(x1, y1, x2, y2, plot);
+			Line(x2, y2, x3, y3, plot);
+			Line(x3, y3, x1, y1, plot);
+		}
+
+		template <class Span>
+		static void FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, Span&& span)
+		{
+			int t1x, t2x, y, minx, maxx, t1xp, t2xp;
+
+			bool changed1 = false;
+			bool changed2 = false;
+
+			int signx1, signx2, dx1, dy1, dx2, dy2;
+			int e1, e2;
+
+			if (y1 > y2)
+			{
+				std::swap(y1, y2);
+				std::swap(x1, x2);
+			}
+
+			if (y1 > y3)
+			{
+				std::swap(y1, y3);
+				std::swap(x1, x3);
+			}
+
+			if (y2 > y3)
+			{
+				std::swap(y2, y3);
+				std::swap(x2, x3);
+			}
+
+			t1x = t2x = x1;
+			y = y1;
+			dx1 = x2 - x1;
+
+			if (dx1 < 0)
+			{
+				dx1 = -dx1;
+				signx1 = -1;
+			}
+			else
+				signx1 = 1;
+
+			dy1 = y2 - y1;
+			dx2 = x3 - x1;
+
+			if (dx2 < 0)
+			{
+				dx2 = -dx2;
+				signx2 = -1;
+			}
+			else
+				signx2 = 1;
+
+			dy2 = y3 - y1;
+
+			if (dy1 > dx1)
+			{
+				std::swap(dx1, dy1);
+				changed1 = true;
+			}
+
+			if (dy2 > dx2)
+			{
+				std::swap(dy2, dx2);
+				changed2 = true;
+			}
+
+			e2 = dx2 >> 1;
+
+			if (y1 == y2)
+				goto next;
+
+			e1 = dx1 >> 1;
+
+			for (int i = 0; i < dx1;)
+			{
+				t1xp = t2xp = 0;
+
+				if (t1x < t2x)
+				{
+					minx = t1x;
+					maxx = t2x;
+				}
+				else
+				{
+					minx = t2x;
+					maxx = t1x;
+				}
+
+				while (i++ < dx1)
+				{
+					e1 += dy1;
+
+					while (e1 >= dx1)
+					{
+						e1 -= dx1;
+
+						if (changed1)
+							t1xp = signx1;
+						else
+							goto next1;
+					}
+
+					if (changed1)
+						break;
+					else
+						t1x += signx1;
+				}
+
+			next1:
+				while (1)
+				{
+					e2 += dy2;
+
+					while (e2 >= dx2)
+					{
+						e2 -= dx2;
+
+						if (changed2)
+							t2xp = signx2;
+						else
+							goto next2;
+					}
+
+					if (changed2)
+						break;
+					else
+						t2x += signx2;
+				}
+
+			next2:
+				if (minx > t1x) minx = t1x;
+				if (minx > t2x) minx = t2x;
+				if (maxx < t1x) maxx = t1x;
+				if (maxx < t2x) maxx = t2x;
+
+				span(minx, maxx, y);
+
+				if (!changed1)
+					t1x += signx1;
+
+				t1x += t1xp;
+
+				if (!changed2)
+					t2x += signx2;
+
+				t2x += t2xp;
+				y++;
+
+				if (y == y2)
+					break;
+			}
+
+		next:
+			dx1 = x3 - x2;
+
+			if (dx1 < 0)
+			{
+				dx1 = -dx1;
+				signx1 = -1;
+			}
+			else
+				signx1 = 1;
+
+			dy1 = y3 - y2;
+			t1x = x2;
+
+			if (dy1 > dx1)
+			{
+				std::swap(dy1, dx1);
+				changed1 = true;
+			}
+			else
+				changed1 = false;
+
+			e1 = dx1 >> 1;
+
+			for (int i = 0; i <= dx1; i++)
+			{
+				t1xp = t2xp = 0;
+
+				if (t1x < t2x)
+				{
+					minx = t1x;
+					maxx = t2x;
+				}
+				else
+				{
+					minx = t2x;
+					maxx = t1x;
+				}
+
+				while (i < dx1)
+				{
+					e1 += dy1;
+
+					while (e1 >= dx1)
+					{
+						e1 -= dx1;
+
+						if (changed1)
+						{
+							t1xp = signx1;
+							break;
+						}
+						else
+							goto next3;
+					}
+
+					if (changed1)
+						break;
+					else
+						t1x += signx1;
+
+					if (i < dx1) i++;
+				}
+
+			next3:
+				while (t2x != x3)
+				{
+					e2 += dy2;
+
+					while (e2 >= dx2)
+					{
+						e2 -= dx2;
+
+						if (changed2)
+							t2xp = signx2;
+						else
+							goto next4;
+					}
+
+					if (changed2)
+						break;
+					else
+						t2x += signx2;
+				}
+
+			next4:
+				if (minx > t1x) minx = t1x;
+				if (minx > t2x) minx = t2x;
+				if (maxx < t1x) maxx = t1x;
+				if (maxx < t2x) maxx = t2x;
+
+				span(minx, maxx, y);
+
+				if (!changed1)
+					t1x += signx1;
+
+				t1x += t1xp;
+
+				if (!changed2)
+					t2x += signx2;
+
+				t2x += t2xp;
+				y++;
+
+				if (y > y3)
+					return;
+			}
+		}
+
+		template <class Plot>
+		static void Rectangle(int x, int y, int sizeX, int sizeY, Plot&& plot)
+		{
+			for (int i = 0; i < sizeX; i++)
+			{
+				plot(x + i, y);
+				plot(x + i, y + sizeY);
+			}
+
+			for (int i = 0; i < sizeY; i++)
+			{
+				plot(x, y + i);
+				plot(x + sizeX - 1, y + i);
+			}
+		}
+
+		template <class Span>
+		static void FillRectangle(int x, int y, int sizeX, int sizeY, Span&& span)
+		{
+			if (sizeX <= 0)
+				return;
+
+			for (int j = 0; j < sizeY; j++)
+				span(x, x + sizeX - 1, y + j);
+		}
+
+		template <class Plot>
+		static void Circle(int x, int y, int radius, Plot&& plot)
+		{
+			int x1 = 0;
+			int y1 = radius;
+			int p1 = 3 - 2 * radius;
+
+			while (y1 >= x1)
+			{
+				plot(x - x1, y - y1);
+				plot(x - y1, y - x1);
+				plot(x + y1, y - x1);
+				plot(x + x1, y - y1);
+				plot(x - x1, y + y1);
+				plot(x - y1, y + x1);
+				plot(x + y1, y + x1);
+				plot(x + x1, y + y1);
+
+				if (p1 < 0)
+				{
+					p1 += 4 * x1 + 6;
+					x1++;
+				}
+				else
+				{
+					p1 += 4 * (x1 - y1) + 10;
+					x1++;
+					y1--;
+				}
+			}
+		}
+
+		template <class Span>
+		static void FillCircle(int x, int y, int radius, Span&& span)
+		{
+			int x1 = 0;
+			int y1 = radius;
+			int p1 = 3 - 2 * radius;
+
+			while (y1 >= x1)
+			{
+				span(x - x1, x + x1, y - y1);
+				span(x - y1, x + y1, y - x1);
+				span(x - x1, x + x1, y + y1);
+				span(x - y1, x + y1, y + x1);
+
+				if (p1 < 0)
+				{
+					p1 += 4 * x1 + 6;
+					x1++;
+				}
+				else
+				{
+					p1 += 4 * (x1 - y1) + 10;
+					x1++;
+					y1--;
+				}
+			}
+		}
+
+		template <class Plot>
+		static void Ellipse(int x, int y, int sizeX, int sizeY, Plot&& plot)
+		{
+			int x1 = x + sizeX;
+			int y1 = y + sizeY;
+
+			int a = abs(x1 - x);
+			int b = abs(y1 - y);
+			int b1 = b & 1;
+
+			int dx = 4 * (1 - a) * b * b;
+			int dy = 4 * (b1 + 1) * a * a;
+
+			int err = dx + dy + b1 * a * a;
+
+			if (x > x1)
+			{
+				x = x1;
+				x1 += a;
+			}
+
+			if (y > y1)
+				y = y1;
+
+			y += (b + 1) / 2;
+			y1 = y - b1;
+
+			a *= 8 * a;
+			b1 = 8 * b * b;
+
+			do
+			{
+				plot(x1, y);
+				plot(x, y);
+				plot(x, y1);
+				plot(x1, y1);
+
+				int e2 = 2 * err;
+
+				if (e2 <= dy)
+				{
+					y++;
+					y1--;
+					err += dy += a;
+				}
+
+				if (e2 >= dx || 2 * err > dy)
+				{
+					x++;
+					x1--;
+					err += dx += b1;
+				}
+			} while (x <= x1);
+
+			while (y - y1 < b)
+			{
+				plot(x - 1, y);
+				plot(x1 + 1, y++);
+				plot(x - 1, y1);
+				plot(x1 + 1, y1--);
+			}
+		}
+
+		template <class Span>
+		static void FillEllipse(int x, int y, int sizeX, int sizeY, Span&& span)
+		{
+			int x1 = x + sizeX;
+			int y1 = y + sizeY;
+
+			int a = abs(x1 - x);
+			int b = abs(y1 - y);
+			int b1 = b & 1;
+
+			int dx = 4 * (1 - a) * b * b;
+			int dy = 4 * (b1 + 1) * a * a;
+
+			int err = dx + dy + b1 * a * a;
+
+			if (x > x1)
+			{
+				x = x1;
+				x1 += a;
+			}
+
+			if (y > y1)
+				y = y1;
+
+			y += (b + 1) / 2;
+			y1 = y - b1;
+
+			a *= 8 * a;
+			b1 = 8 * b * b;
+
+			do
+			{
+				span(x, x1, y);
+				span(x, x1, y1);
+
+				int e2 = 2 * err;
+
+				if (e2 <= dy)
+				{
+					y++;
+					y1--;
+					err += dy += a;
+				}
+
+				if (e2 >= dx || 2 * err > dy)
+				{
+					x++;
+					x1--;
+					err += dx += b1;
+				}
+			} while (x <= x1);
+
+			while (y - y1 < b)
+			{
+				span(x - 1, x1 + 1, y++);
+				span(x - 1, x1 + 1, y1--);
+			}
+		}
+
+		// Rotates, scales and moves the vertices of the model
+		static void TransformModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, std::vector<Vector2f>& coordinates)
+		{
+			Matrix3 transform = Matrix3::Translate({ x, y }) * Matrix3::Rotate(rotation) * Matrix3::Scale({ scale, scale });
+
+			coordinates.resize(modelCoordinates.size());
+			transform.TransformPoints(modelCoordinates, coordinates);
+		}
+
+		template <class Plot>
+		static void WireFrame(const std::vector<Vector2f>& coordinates, Plot&& plot)
+		{
+			size_t verts = coordinates.size();
+
+			for (size_t i = 0; i <= verts; i++)
+			{
+				const Vector2f& pos1 = coordinates[i % verts];
+				const Vector2f& pos2 = coordinates[(i + 1) % verts];
+
+				Line((int)pos1.x, (int)pos1.y, (int)pos2.x, (int)pos2.y, plot);
+			}
+		}
+
+		// The coordinates are already transformed
+		template <class Plot>
+		static void FillWireFrame(std::vector<Vector2f>& coordinates, Plot&& plot)
+		{
+			size_t verts = coordinates.size();
+
+			auto GetAngle = [](const Vector2f& p1, const Vector2f& p2)
+				{
+					float a = atan2(p2.y, p2.x) - atan2(p1.y, p1.x);
+					while (a > 3.14159f) a -= 3.14159f * 2.0f;
+					while (a < -3.14159f) a += 3.14159f * 2.0f;
+					return a;
+				};
+
+			auto PointInPolygon = [&](const Vector2f& p)
+				{
+					float angle = 0.0f;
+
+					for (size_t i = 0; i < verts; i++)
+						angle += GetAngle(coordinates[i] - p, coordinates[(i + 1) % verts] - p);
+
+					return std::abs(angle) >= 3.14159f;
+				};
+
+			Vector2f& min = coordinates.front();
+			Vector2f& max = coordinates.front();
+
+			for (size_t i = 1; i < verts; i++)
+			{
+				if (min.x > coordinates[i].x) min.x = coordinates[i].x;
+				if (min.y > coordinates[i].y) min.y = coordinates[i].y;
+
+				if (max.x < coordinates[i].x) max.x = coordinates[i].x;
+				if (max.y < coordinates[i].y) max.y = coordinates[i].y;
+			}
+
+			Vector2f point;
+			for (point.x = min.x; point.x < max.x; point.x++)
+				for (point.y = min.y; point.y < max.y; point.y++)
+				{
+					if (PointInPolygon(point))
+						plot((int)point.x, (int)point.y);
+				}
+		}
+
+		// The font is a sprite with 16 characters of 8x8 pixels in a row
+		template <class Plot>
+		static void String(int x, int y, std::string_view s, const Sprite* font, int tabSize, int scaleX, int scaleY, Plot&& plot)
+		{
+			int sx = 0;
+			int sy = 0;
+
+			for (auto c : s)
+			{
+				if (c == '\n')
+				{
+					sx = 0;
+					sy += 8 * scaleY;
+				}
+				else if (c == '\t')
+					sx += 8 * tabSize * scaleX;
+				else
+				{
+					int ox = (c - 32) % 16;
+					int oy = (c - 32) / 16;
+
+					if (scaleX > 1 || scaleY > 1)
+					{
+						for (int i = 0; i < 8; i++)
+							for (int j = 0; j < 8; j++)
+							{
+								if (font->GetPixel(i + ox * 8, j + oy * 8).r > 0)
+								{
+									for (int is = 0; is < scaleX; is++)
+										for (int js = 0; js < scaleY; js++)
+											plot(x + sx + i * scaleX + is, y + sy + j * scaleY + js);
+								}
+							}
+					}
+					else
+					{
+						for (int i = 0; i < 8; i++)
+							for (int j = 0; j < 8; j++)
+							{
+								if (font->GetPixel(i + ox * 8, j + oy * 8).r > 0)
+									plot(x + sx + i, y + sy + j);
+							}
+					}
+
+					sx += 8 * scaleX;
+				}
+			}
+		}
+	};
+}
+
+#endif
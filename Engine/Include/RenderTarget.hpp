@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_RENDER_TARGET_HPP
+#define DGE_RENDER_TARGET_HPP
+
+#include "Pch.hpp"
+#include "Graphic.hpp"
+
+namespace def
+{
+	class Platform;
+
+	// Off-screen target that textures are drawn into (a framebuffer object on the GPU),
+	// the result stays in its texture and can be drawn as any other texture,
+	// so static composites are drawn once instead of on every frame
+	class RenderTarget
+	{
+	public:
+		RenderTarget(Platform* platform, const Vector2i& size);
+		~RenderTarget();
+
+		RenderTarget(const RenderTarget&) = delete;
+		RenderTarget& operator=(const RenderTarget&) = delete;
+
+		// Returns false if the platform doesn't support render targets
+		bool IsValid() const;
+
+		const Vector2i& GetSize() const;
+
+		// Contains everything that has been rendered into the target
+		const Texture* GetTexture() const;
+
+		// The queued textures are drawn into the target before the layers are drawn,
+		// the vertices must be in normalised coordinates of the target
+		// with (-1, -1) in the top-left corner (DrawContext converts them itself)
+		void Submit(TextureInstance&& texInst);
+
+		// The target is filled with the colour before the queued textures are drawn
+		void Clear(const Pixel& col = NONE);
+
+		bool HasPendingWork() const;
+
+		// Copies the content to the CPU right after the next rendering of the target,
+		// on OpenGL it's done through a pixel buffer so it doesn't stall the frame
+		void RequestReadback();
+
+		// Returns the content of the target as it was after the last rendering.
+		// The copy is made only if the target has changed since the last call
+		// and waits for the GPU if RequestReadback hasn't been called before
+		const Sprite* GetSprite();
+
+		friend class GameEngine;
+		friend class PlatformGL;
+		friend class PlatformEmscripten;
+		friend class PlatformHeadless;
+
+	private:
+		// Draws the queued textures and starts the requested readback
+		void Render();
+
+	private:
+		Platform* m_Platform;
+
+		Graphic m_Graphic;
+
+		// The queue is cleared after the textures are drawn
+		std::vector<TextureInstance> m_Textures;
+
+		Pixel m_ClearColour;
+		bool m_IsClearPending;
+
+		// The GPU content differs from the sprite
+		bool m_IsChanged;
+
+		bool m_IsReadbackRequested;
+		bool m_IsReadbackStarted;
+
+		// Are managed by the platform
+		uint32_t m_Framebuffer;
+		uint32_t m_PixelBuffer;
+
+	};
+}
+
+#endif
@@ -10,37 +10,38 @@
 #define DGE_SPRITE_HPP
 
 #include "Pch.hpp"
-
-#ifndef DGE_IGNORE_VECTOR2D
-#include "Vector2D.hpp"
-#endif
-
-#include "Pixel.hpp"
+#include "Image.hpp"
 
 namespace def
 {
-	class Sprite
+	using SpriteView = ImageView<Pixel>;
+	using ConstSpriteView = ImageView<const Pixel>;
+
+	// The image of RGBA8 pixels that can be loaded from and saved to files
+	class Sprite : public Image<Pixel>
 	{
 	public:
 		// These are supported file formats for loading and saving image data
 		enum class FileType { BMP, PNG, JPG, TGA, TGA_RLE };
 
-		// Can be used only within the Sample method
-		enum class SampleMethod { LINEAR, BILINEAR, TRILINEAR };
-		enum class WrapMethod { NONE, REPEAT, MIRROR, CLAMP };
-
 		Sprite() = default;
 		Sprite(const Vector2i& size);
 		Sprite(std::string_view fileName);
+
+		// Copies the pixels of the view
+		explicit Sprite(const ConstSpriteView& view);
+
 		~Sprite();
 
 	public:
-		Vector2i size;
-		std::vector<Pixel> pixels;
+		// Each one is half the size of the previous one, the last one is 1x1.
+		// Is empty until GenerateMipmaps is called
+		std::vector<Sprite> mipmaps;
 
 	public:
-		// Creates a sprite of a specified size filled with black pixels
-		void Create(const Vector2i& size);
+		// Creates a sprite of a specified size filled with black pixels,
+		// the stride of 0 is the same as size.x
+		void Create(const Vector2i& size, int stride = 0);
 
 		// Loads an image data from a file
 		void Load(std::string_view fileName);
@@ -48,26 +49,14 @@ namespace def
 		// Saves an image data to a file
 		void Save(std::string_view fileName, FileType type) const;
 
-		// Changes a specific pixel value
-		bool SetPixel(int x, int y, const Pixel& col);
-
-		// Changes a specific pixel value
-		bool SetPixel(const Vector2i& pos, const Pixel& col);
-
-		// Returns a pixel on a specified coordinates
-		Pixel GetPixel(int x, int y, WrapMethod wrap = WrapMethod::NONE) const;
-
-		// Returns a pixel on a specified coordinates
-		Pixel GetPixel(const Vector2i& pos, WrapMethod wrap = WrapMethod::NONE) const;
-
-		// Sets every pixel of the image to a specified colour
-		void SetPixelData(const Pixel& col);
+		// Saves the pixels of the view, e.g. a frame of a sprite sheet
+		static void Save(const ConstSpriteView& view, std::string_view fileName, FileType type);
 
-		// Takes values X and Y from 0 to 1 and applies sampling and wrapping to the pixel at the specified coordinates
-		Pixel Sample(float x, float y, SampleMethod sampleMethod, WrapMethod wrapMethod) const;
+		// Builds the mipmaps with a 2x2 box filter, must be called again after the pixels are changed
+		void GenerateMipmaps();
 
-		// Takes values X and Y from 0 to 1 and applies sampling and wrapping to the pixel at the specified coordinates
-		Pixel Sample(const Vector2f& pos, SampleMethod sampleMethod, WrapMethod wrapMethod) const;
+		// Returns the sprite itself for the level 0 and the smallest mipmap if the level is too high
+		const Sprite* GetMipmap(int level) const;
 	};
 }
 
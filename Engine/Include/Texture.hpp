@@ -16,6 +16,8 @@
 
 namespace def
 {
+	class DrawList;
+
 	// Creates a texture, loads it to a GPU, stores ID and size
 	struct Texture
 	{
@@ -33,6 +35,27 @@ namespace def
 		Texture(Sprite* sprite, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& size = { -1.0f, -1.0f });
 		Texture(std::string_view fileName, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& size = { -1.0f, -1.0f });
 
+		template <class T>
+		Texture(const ImageView<T>& view, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& size = { -1.0f, -1.0f })
+		{
+			LoadPixels(view, pos, size);
+		}
+
+		// Pixels of a view of any format, is used internally by the methods for views
+		struct PixelData
+		{
+			template <class T>
+			PixelData(const ImageView<T>& view) :
+				pixels(view.pixels), size(view.size), stride(view.stride),
+				pixelSize(sizeof(T)), format(PixelTraits<std::remove_const_t<T>>::FORMAT) {}
+
+			const void* pixels;
+			Vector2i size;
+			int stride;
+			int pixelSize;
+			PixelFormat format;
+		};
+
 		// Is used internally to identify a texture
 		uint32_t id;
 
@@ -48,21 +71,67 @@ namespace def
 		// Position of an image relative to the texture
 		Vector2f pos;
 
+		// Format of the pixels on the GPU, it's the format of the last loaded image
+		PixelFormat format;
+
 		// Creates a texture from Sprite data and loads it to the GPU
 		void Load(Sprite* sprite, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& customSize = { -1.0f, -1.0f });
 
 		// Updates already existing texture on the GPU with Sprite data
 		void Update(Sprite* sprite, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& customSize = { -1.0f, -1.0f });
 
+		// The same for a view of any format, e.g. a frame of a sprite sheet or a heightmap in R16.
+		// The texture gets the matching GL format so only the stored bytes are uploaded,
+		// the rows are uploaded with their stride so nothing is copied on the CPU
+		template <class T>
+		void Load(const ImageView<T>& view, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& customSize = { -1.0f, -1.0f })
+		{
+			LoadPixels(view, pos, customSize);
+		}
+
+		template <class T>
+		void Update(const ImageView<T>& view, const Vector2f& pos = { 0.0f, 0.0f }, const Vector2f& customSize = { -1.0f, -1.0f })
+		{
+			UpdatePixels(view, pos, customSize);
+		}
+
+		// Replaces only a rectangle of the texture at the offset with the pixels of the view
+		template <class T>
+		void UpdateRegion(const ImageView<T>& view, const Vector2i& offset)
+		{
+			UpdatePixelsRegion(view, offset);
+		}
+
 	private:
 		void Construct(Sprite* sprite, bool deleteSprite, const Vector2f& customPos, const Vector2f& customSize);
 
+		void LoadPixels(const PixelData& data, const Vector2f& customPos, const Vector2f& customSize);
+		void UpdatePixels(const PixelData& data, const Vector2f& customPos, const Vector2f& customSize);
+		void UpdatePixelsRegion(const PixelData& data, const Vector2i& offset);
+
 	};
 
 	// It stores a textured polygon and used internally
 	// to draw rectangular images and arbitrary coloured polygons
 	struct TextureInstance
 	{
+		// Order in which the textures of a layer are drawn, each sort is stable
+		// so the textures with equal keys keep the order of submission
+		enum class SortMode
+		{
+			// In the order of submission
+			NONE,
+
+			// By the depth of the textures
+			DEPTH,
+
+			// By the textures and then by the depth, so the textures are bound once
+			TEXTURE,
+
+			// By the depth and then by the textures within each depth
+			DEPTH_TEXTURE
+		};
+
 		TextureInstance();
 
 		void ConstructUV();
@@ -82,6 +151,15 @@ namespace def
 
 		// Texture coordinates of each vertex
 		std::vector<Vector2f> uv;
+
+		// Is used to sort the textures of a layer, lower values are drawn first
+		float depth;
+
+		// If it's set the list is drawn instead of the vertices, its vertices are scaled
+		// and moved in normalised coordinates, the vertices above only hold its bounding box
+		const DrawList* drawList;
+		Vector2f listScale;
+		Vector2f listOffset;
 	};
 }
 
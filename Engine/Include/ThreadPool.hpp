@@ -0,0 +1,130 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_THREAD_POOL_HPP
+#define DGE_THREAD_POOL_HPP
+
+#include "Pch.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace def
+{
+	// Fixed set of worker threads that run submitted tasks,
+	// the thread that waits for the tasks also runs them
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+
+		// Pass 0 to use one thread less than the hardware supports,
+		// because the main thread also does the work
+		ThreadPool(size_t threads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Submit(Task task);
+
+		// Runs the queued tasks on the calling thread until all submitted tasks are finished,
+		// must not be called from a task
+		void Wait();
+
+		// Calls func(i) for each i in [begin, end), the indices are split into chunks of grain size.
+		// The calling thread takes part in the work and returns when all indices are processed,
+		// so it can be called from a task too
+		template <class Func>
+		void ParallelFor(int begin, int end, Func&& func, int grain = 1);
+
+		// Doesn't include the calling thread
+		size_t GetThreadsCount() const;
+
+	private:
+		// Returns false if there were no tasks in the queue
+		bool RunPendingTask();
+
+		void Worker();
+
+	private:
+		std::vector<std::thread> m_Threads;
+		std::deque<Task> m_Tasks;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeUp;
+		std::condition_variable m_Finished;
+
+		// Queued and running tasks
+		size_t m_Pending;
+		bool m_Stop;
+
+	};
+
+	template <class Func>
+	void ThreadPool::ParallelFor(int begin, int end, Func&& func, int grain)
+	{
+		if (begin >= end)
+			return;
+
+		grain = std::max(grain, 1);
+
+		int chunks = (end - begin + grain - 1) / grain;
+
+		if (m_Threads.empty() || chunks == 1)
+		{
+			for (int i = begin; i < end; i++)
+				func(i);
+
+			return;
+		}
+
+		std::atomic<int> next = begin;
+		std::atomic<int> helpers = 0;
+
+		auto work = [&]()
+			{
+				int start;
+
+				while ((start = next.fetch_add(grain, std::memory_order_relaxed)) < end)
+				{
+					int stop = std::min(start + grain, end);
+
+					for (int i = start; i < stop; i++)
+						func(i);
+				}
+			};
+
+		int helpersCount = (int)std::min(m_Threads.size(), (size_t)chunks - 1);
+		helpers.store(helpersCount, std::memory_order_relaxed);
+
+		for (int i = 0; i < helpersCount; i++)
+		{
+			Submit([&]()
+				{
+					work();
+					helpers.fetch_sub(1, std::memory_order_acq_rel);
+				});
+		}
+
+		work();
+
+		// The helpers might still be queued behind other tasks so they are run here
+		while (helpers.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunPendingTask())
+				std::this_thread::yield();
+		}
+	}
+}
+
+#endif
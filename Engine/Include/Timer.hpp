@@ -10,10 +10,68 @@
 #define DGE_TIMER_HPP
 
 #include <chrono>
+#include <cstdint>
 
 namespace def
 {
-	using TimePoint = std::chrono::system_clock::time_point;
+	// Monotonic clock, so pacing is not affected by changes of the system time
+	using Clock = std::chrono::steady_clock;
+	using TimePoint = Clock::time_point;
+
+	// Statistics of the frame limiter, all durations are in seconds
+	struct FramePacingStats
+	{
+		// Duration of a frame the limiter aims for, 0 if the limiter is disabled
+		float targetFrameTime = 0.0f;
+
+		// Time the last frame has spent before reaching the limiter
+		float workTime = 0.0f;
+
+		// Time the last frame has spent sleeping and then spinning until the deadline
+		float sleepTime = 0.0f;
+		float spinTime = 0.0f;
+
+		// Current estimate of how much later than requested the OS wakes us up
+		float oversleep = 0.0f;
+
+		// How late the last frame has finished relative to its deadline
+		float lateness = 0.0f;
+
+		// Number of frames that were paced, that have missed their deadline
+		// and that were waiting for events in the idle mode
+		uint64_t pacedFrames = 0;
+		uint64_t missedFrames = 0;
+		uint64_t idleFrames = 0;
+	};
+
+	// Time spent on each phase of the last frame in seconds
+	struct FrameTimings
+	{
+		// States, OnUserUpdate and the console input
+		float update = 0.0f;
+
+		// OnUpdate and the post-process of the layers
+		float layers = 0.0f;
+
+		// Uploading textures and drawing the layers, including OnAfterDraw
+		float draw = 0.0f;
+
+		// Flushing the screen
+		float present = 0.0f;
+
+		// Everything above, the time spent by the frame limiter is not included
+		float total = 0.0f;
+	};
+
+	// Timings of the frames that were collected by the profiler
+	struct FrameProfile
+	{
+		FrameTimings min;
+		FrameTimings max;
+		FrameTimings sum;
+
+		uint64_t frames = 0;
+	};
 
 	class Timer
 	{
@@ -27,6 +85,19 @@ namespace def
 		// We update frames count in the title bar only every second so the returned value is more precise in here than in the title bar
 		int GetFPS() const;
 
+		// Limits the number of frames per second, pass 0 to disable the limiter
+		void SetTargetFrameRate(float fps);
+
+		// Returns the limit of frames per second or 0 if the limiter is disabled
+		float GetTargetFrameRate() const;
+
+		const FramePacingStats& GetPacingStats() const;
+
+		// Makes GetDeltaTime return the specified value instead of the measured one,
+		// the frame limiter is disabled meanwhile, pass 0 to use the real clock again
+		void SetFixedDeltaTime(float deltaTime);
+		float GetFixedDeltaTime() const;
+
 		friend class GameEngine;
 
 	protected:
@@ -34,6 +105,13 @@ namespace def
 		float GetTicks();
 		void ResetTicks();
 
+		// Restarts measuring time from the current moment
+		void Reset();
+
+		// Blocks until the deadline of the current frame:
+		// sleeps while there is enough time left and then spins for precision
+		void Pace();
+
 	private:
 		TimePoint m_TimeStart;
 		TimePoint m_TimeEnd;
@@ -44,6 +122,20 @@ namespace def
 		// Is used for updating frames count in the title bar
 		float m_TickTimer;
 
+		// Replaces the measured delta time if it's greater than 0
+		float m_FixedDeltaTime;
+
+		// Time of the end of the current frame if the limiter is enabled
+		TimePoint m_Deadline;
+		float m_TargetFrameTime;
+
+		// Running mean and deviation of the measured oversleep,
+		// they are used to decide when to stop sleeping and start spinning
+		float m_OversleepMean;
+		float m_OversleepDeviation;
+
+		FramePacingStats m_PacingStats;
+
 	};
 }
 
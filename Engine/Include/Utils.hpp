@@ -10,22 +10,21 @@
 #define DGE_UTILS_HPP
 
 #include "Pch.hpp"
+#include "Log.hpp"
 
 namespace def
 {
-	// Prints an error to the console and terminates an application
+	// Logs a fatal error and terminates an application,
+	// the log is flushed so the message reaches stderr and the log file
 	template <class... T>
 	inline void Assert(bool expr, T&&... args)
 	{
 		if (!expr)
 		{
-			std::list<const char*> values;
-			(values.emplace_back(std::move(args)), ...);
-
-			for (const auto& val : values)
-				fprintf(stderr, "%s\n", val);
-
-			fprintf(stderr, "\n");
+			if (Log::IsEnabled(Log::Level::FATAL))
+				Log::Fatal(std::forward<T>(args)...);
+			else
+				(std::cerr << ... << std::forward<T>(args)) << std::endl;
 
 			exit(1);
 		}
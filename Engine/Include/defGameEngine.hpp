@@ -14,7 +14,10 @@
 
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
 
-#ifdef __EMSCRIPTEN__
+#if defined(DGE_PLATFORM_HEADLESS)
+// Is defined by the build system (premake5 --headless),
+// nothing is shown and input comes only from replays
+#elif defined(__EMSCRIPTEN__)
 #define DGE_PLATFORM_EMSCRIPTEN
 #else
 #define DGE_PLATFORM_GL
@@ -46,13 +49,23 @@
 
 #ifndef DGE_IGNORE_VECTOR2D
 #include "Vector2D.hpp"
+#include "Matrix3.hpp"
 #endif
 
 #include "Pixel.hpp"
+#include "PixelOps.hpp"
 #include "Sprite.hpp"
+#include "ImageProcessing.hpp"
+#include "CollisionMask.hpp"
 #include "Texture.hpp"
 #include "Graphic.hpp"
 #include "Timer.hpp"
+#include "Log.hpp"
+#include "ThreadPool.hpp"
+#include "Rasteriser.hpp"
+#include "RenderTarget.hpp"
+#include "DrawList.hpp"
+#include "DrawContext.hpp"
 
 #ifdef DGE_PLATFORM_GLFW3
 #include "PlatformGLFW3.hpp"
@@ -62,6 +75,10 @@
 #include "PlatformEmscripten.hpp"
 #endif
 
+#ifdef DGE_PLATFORM_HEADLESS
+#include "PlatformHeadless.hpp"
+#endif
+
 #include "State.hpp"
 #include "Layer.hpp"
 #include "Window.hpp"
@@ -93,12 +110,17 @@ namespace def
 		friend class PlatformEmscripten;
 	#endif
 
+	#ifdef DGE_PLATFORM_HEADLESS
+		friend class PlatformHeadless;
+	#endif
+
 		friend class Console;
 		friend class InputHandler;
+		friend class DrawContext;
 
 	public:
 		// Is used internally
-		//static GameEngine* s_Engine;
+		static GameEngine* s_Engine;
 
 		// Is called before the main loop
 		virtual bool OnUserCreate() = 0;
@@ -122,6 +144,13 @@ namespace def
 		// Must be called only after Construct method, basically starts the main loop
 		void Run();
 
+		// Handles the engine's options and skips everything else:
+		// --record <file> records the input to the file,
+		// --replay <file> replays the input from the file and stops the application at the end,
+		// --timings <file> writes timings of each frame to the file as CSV.
+		// Returns false if an option is incomplete or its file can't be opened
+		bool ParseCommandLine(int argc, char* argv[]);
+
 	private:
 		// Frees memory
 		void Destroy();
@@ -193,6 +222,9 @@ namespace def
 
 		void DrawTexturePolygon(const std::vector<Vector2f>& verts, const std::vector<Pixel>& cols, Texture::Structure structure);
 
+		void DrawTextureTriangles(const Texture* tex, const std::vector<Vector2f>& verts, const std::vector<Vector2f>& uvs, const std::vector<Pixel>& cols);
+		void DrawTextureTriangles(const Texture* tex, std::vector<Vector2f>&& verts, std::vector<Vector2f>&& uvs, std::vector<Pixel>&& cols);
+
 		void DrawTextureLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col = WHITE);
 
 		void DrawTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col = WHITE);
@@ -208,11 +240,24 @@ namespace def
 
 		void DrawTextureString(const Vector2i& pos, std::string_view text, const Pixel& col = WHITE, const Vector2f& scale = { 1.0f, 1.0f });
 
+		// Draws the recorded textures moved by pos pixels and scaled relative to the top-left corner of the screen
+		void DrawTextureList(const Vector2f& pos, const DrawList* list, const Vector2f& scale = { 1.0f, 1.0f }, const Pixel& tint = WHITE);
+
 		// Drawing targets
 
 		void SetDrawTarget(Graphic* target);
 		Graphic* GetDrawTarget();
 
+		// Textures that are drawn after the call go into the render target
+		// instead of the current layer, pass nullptr to draw on the layer again
+		void SetTextureTarget(RenderTarget* target);
+		RenderTarget* GetTextureTarget() const;
+
+		// Textures that are drawn after the call are recorded into the list
+		// instead of being drawn, pass nullptr to stop recording
+		void SetDrawList(DrawList* list);
+		DrawList* GetDrawList() const;
+
 		// Pixel modes
 
 		void SetPixelMode(Pixel::Mode pixelMode);
@@ -230,10 +275,38 @@ namespace def
 		Texture::Structure GetTextureStructure() const;
 		void UseOnlyTextures(bool enable);
 
+		// Textures that are drawn after the call get the depth,
+		// it's used by the sort mode of the current layer
+		void SetTextureDepth(float depth);
+		float GetTextureDepth() const;
+
+		// Sets the order of drawing textures on the current layer
+		void SetSortMode(TextureInstance::SortMode sortMode);
+		TextureInstance::SortMode GetSortMode() const;
+
 		// Shaders
 
 		void SetShader(Pixel (*func)(const Vector2i&, const Pixel&, const Pixel&));
 
+		// Adds a pass to the post-process of the current layer, the passes are applied
+		// to the whole layer after the update in parallel across rows
+		void AddPostProcess(DrawContext::SpanShader shader);
+		void ClearPostProcess();
+
+		// Palette
+
+		// Makes the current layer indexed and replaces the colours of its palette from the first index,
+		// the other colours stay the same and are NONE at first. The layer shows the colours of GetIndices()
+		// instead of its pixels, so the drawing routines don't change what's on the screen.
+		// Only a changed palette is uploaded again, so cycling the colours is cheap
+		void SetPalette(std::span<const Pixel> colours, uint8_t first = 0);
+
+		// Returns the indices of the current layer or nullptr if it isn't indexed
+		ImageIndex8* GetIndices();
+
+		// Makes the current layer show its pixels again
+		void ClearPalette();
+
 		// Font
 
 		// The file must be 128×48 image with an 8×8 grid.
@@ -250,6 +323,20 @@ namespace def
 		size_t GetCurrentLayer() const;
 		Layer* GetLayer(size_t index);
 
+		// Render targets stuff
+
+		// The target is owned by the engine and can be created only after the window is constructed,
+		// the queued textures are drawn into the targets before the layers are drawn
+		RenderTarget* CreateRenderTarget(const Vector2i& size);
+		void DestroyRenderTarget(RenderTarget* target);
+
+		// Draw lists stuff
+
+		// The list is owned by the engine, its vertices are uploaded to the GPU
+		// when it's drawn for the first time after recording
+		DrawList* CreateDrawList();
+		void DestroyDrawList(DrawList* list);
+
 		// State stuff
 
 		size_t CreateState(State* state);
@@ -264,6 +351,49 @@ namespace def
 		Console& Console();
 		Timer& Timer();
 
+		// Layers with parallelUpdate are updated on this pool,
+		// it can also be used by the application
+		ThreadPool& ThreadPool();
+
+		// Frame pacing
+
+		// Limits the number of frames per second, pass 0 to disable the limiter.
+		// The engine sleeps until it's close to the deadline and then spins for precision
+		void SetTargetFrameRate(float fps);
+		float GetTargetFrameRate() const;
+
+		const FramePacingStats& GetPacingStats() const;
+
+		// In the idle mode the engine waits for events (no longer than timeout seconds)
+		// instead of polling them if nothing has happened on the last frame
+		void EnableIdleMode(bool enable, float timeout = 0.5f);
+		bool IsIdleMode() const;
+
+		// Tells the engine that the next frame must be processed
+		// immediately even if there was no input, has an effect only in the idle mode
+		void MarkDirty();
+
+		// Returns time spent on each phase of the last frame
+		const FrameTimings& GetFrameTimings() const;
+
+		// Writes a CSV line with timings of every frame to the file, pass an empty name to stop
+		bool SetTimingsOutput(const std::string& fileName);
+
+		// The profiler collects min, max and average timings of the frames while it's enabled
+		void EnableProfiler(bool enable);
+		bool IsProfilerEnabled() const;
+		void ResetProfiler();
+
+		const FrameProfile& GetFrameProfile() const;
+
+	private:
+		// Runs the post-process passes of the layer on the thread pool
+		void ApplyPostProcess(Layer* layer);
+
+		// Checks if the indices of the layer are uploaded as they are and the palette
+		// is looked up on the GPU, otherwise they are resolved into the pixels of the layer
+		bool IsPaletteOnGPU(const Layer* layer) const;
+
 	private:
 		bool m_IsAppRunning;
 		bool m_OnlyTextures;
@@ -279,6 +409,9 @@ namespace def
 		// Index of the currently selected layer in m_Layers
 		size_t m_CurrentLayer;
 
+		std::vector<std::unique_ptr<RenderTarget>> m_RenderTargets;
+		std::vector<std::unique_ptr<DrawList>> m_DrawLists;
+
 		// Stores all available states
 		std::vector<std::unique_ptr<State>> m_States;
 
@@ -290,6 +423,25 @@ namespace def
 		std::shared_ptr<def::Window> m_Window;
 		std::unique_ptr<def::Console> m_Console;
 		std::unique_ptr<def::Timer> m_Timer;
+		std::unique_ptr<def::ThreadPool> m_ThreadPool;
+
+		bool m_IsIdleMode;
+		bool m_IsDirty;
+
+		// Maximum time of waiting for events in the idle mode
+		float m_IdleTimeout;
+
+		FrameTimings m_FrameTimings;
+		std::ofstream m_TimingsFile;
+
+		bool m_IsProfiling;
+		FrameProfile m_FrameProfile;
+
+		// Index of the current frame since the start of the application
+		uint64_t m_FrameIndex;
+
+		// Is set if the replay was requested from the command line
+		bool m_QuitAfterReplay;
 
 	#ifndef PLATFORM_EMSCRIPTEN
 		uint32_t m_FramesCount;
@@ -0,0 +1,205 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "CollisionMask.hpp"
+
+#include <bit>
+
+namespace def
+{
+	CollisionMask::CollisionMask(const ConstSpriteView& sprite, uint8_t threshold, bool preShift)
+	{
+		Create(sprite, threshold, preShift);
+	}
+
+	void CollisionMask::Create(const ConstSpriteView& sprite, uint8_t threshold, bool preShift)
+	{
+		m_Size = sprite.IsEmpty() ? Vector2i(0, 0) : sprite.size;
+		m_Words = (m_Size.x + 63) / 64;
+
+		m_Bits.assign((size_t)m_Words * m_Size.y, 0);
+		m_Shifted.clear();
+
+		for (int y = 0; y < m_Size.y; y++)
+		{
+			const Pixel* row = sprite.GetRow(y);
+			uint64_t* bits = &m_Bits[(size_t)y * m_Words];
+
+			for (int x = 0; x < m_Size.x; x++)
+			{
+				if (row[x].a >= threshold)
+					bits[x / 64] |= 1ull << (x % 64);
+			}
+		}
+
+		if (!preShift)
+			return;
+
+		int words = m_Words + 1;
+		m_Shifted.assign((size_t)64 * words * m_Size.y, 0);
+
+		for (int shift = 0; shift < 64; shift++)
+		{
+			for (int y = 0; y < m_Size.y; y++)
+			{
+				const uint64_t* src = &m_Bits[(size_t)y * m_Words];
+				uint64_t* dst = &m_Shifted[((size_t)shift * m_Size.y + y) * words];
+
+				for (int w = 0; w < m_Words; w++)
+				{
+					dst[w] |= src[w] << shift;
+
+					if (shift > 0)
+						dst[w + 1] |= src[w] >> (64 - shift);
+				}
+			}
+		}
+	}
+
+	const Vector2i& CollisionMask::GetSize() const
+	{
+		return m_Size;
+	}
+
+	bool CollisionMask::IsEmpty() const
+	{
+		return m_Bits.empty();
+	}
+
+	bool CollisionMask::Get(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= m_Size.x || y >= m_Size.y)
+			return false;
+
+		return (m_Bits[(size_t)y * m_Words + x / 64] >> (x % 64)) & 1;
+	}
+
+	int CollisionMask::GetCount() const
+	{
+		int count = 0;
+
+		for (uint64_t word : m_Bits)
+			count += std::popcount(word);
+
+		return count;
+	}
+
+	uint64_t CollisionMask::GetWord(int y, int x) const
+	{
+		if (!m_Shifted.empty())
+		{
+			// The copy where pixel x starts a word
+			int shift = -x & 63;
+			int word = (x + shift) / 64;
+
+			if (word < 0 || word > m_Words)
+				return 0;
+
+			return m_Shifted[((size_t)shift * m_Size.y + y) * (m_Words + 1) + word];
+		}
+
+		const uint64_t* row = &m_Bits[(size_t)y * m_Words];
+
+		// Floors for the negative pixels too
+		int word = x >> 6;
+		int shift = x & 63;
+
+		auto Word = [&](int index)
+			{
+				return (index >= 0 && index < m_Words) ? row[index] : 0ull;
+			};
+
+		if (shift == 0)
+			return Word(word);
+
+		return (Word(word) >> shift) | (Word(word + 1) << (64 - shift));
+	}
+
+	template <class Func>
+	void CollisionMask::ForEachOverlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB, Func&& func)
+	{
+		if (a.IsEmpty() || b.IsEmpty())
+			return;
+
+		int top = std::max(posA.y, posB.y);
+		int bottom = std::min(posA.y + a.m_Size.y, posB.y + b.m_Size.y);
+
+		int left = std::max(posA.x, posB.x);
+		int right = std::min(posA.x + a.m_Size.x, posB.x + b.m_Size.x);
+
+		if (top >= bottom || left >= right)
+			return;
+
+		// Only the words of a that cover the intersection are compared,
+		// the bits outside of either mask are zero so they never overlap
+		int first = (left - posA.x) / 64;
+		int last = (right - 1 - posA.x) / 64;
+
+		// Pixel x of a is pixel x + offset of b
+		int offset = posA.x - posB.x;
+
+		for (int y = top; y < bottom; y++)
+		{
+			int ya = y - posA.y;
+			int yb = y - posB.y;
+
+			const uint64_t* row = &a.m_Bits[(size_t)ya * a.m_Words];
+
+			for (int w = first; w <= last; w++)
+			{
+				uint64_t bits = row[w] & b.GetWord(yb, w * 64 + offset);
+
+				if (bits && func(bits, w * 64, ya))
+					return;
+			}
+		}
+	}
+
+	bool CollisionMask::Overlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB)
+	{
+		bool overlap = false;
+
+		ForEachOverlap(a, posA, b, posB,
+			[&](uint64_t, int, int)
+			{
+				overlap = true;
+				return true;
+			});
+
+		return overlap;
+	}
+
+	bool CollisionMask::Overlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB, Vector2i& contact)
+	{
+		bool overlap = false;
+
+		ForEachOverlap(a, posA, b, posB,
+			[&](uint64_t bits, int x, int y)
+			{
+				contact = posA + Vector2i(x + std::countr_zero(bits), y);
+				overlap = true;
+
+				return true;
+			});
+
+		return overlap;
+	}
+
+	int CollisionMask::CountOverlap(const CollisionMask& a, const Vector2i& posA, const CollisionMask& b, const Vector2i& posB)
+	{
+		int count = 0;
+
+		ForEachOverlap(a, posA, b, posB,
+			[&](uint64_t bits, int, int)
+			{
+				count += std::popcount(bits);
+				return false;
+			});
+
+		return count;
+	}
+}
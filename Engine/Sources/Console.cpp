@@ -7,21 +7,266 @@
 #include "Pch.hpp"
 #include "Console.hpp"
 
+#include <fstream>
+#include <iomanip>
+
+#if defined(_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <windows.h>
+#include <psapi.h>
+
+#elif defined(__APPLE__)
+
+#include <mach/mach.h>
+
+#elif defined(__linux__)
+
+#include <unistd.h>
+
+#endif
+
 namespace def
 {
-    Console::Console(GameEngine* engine) : m_Engine(engine), m_BackgroundColour(0, 0, 255, 100), m_PickedHistoryCommand(0)
+    // Default limits of the history
+    static constexpr size_t DEFAULT_HISTORY_LINES = 1024;
+    static constexpr size_t DEFAULT_HISTORY_COMMANDS = 64;
+
+    static constexpr int LINE_HEIGHT = 10;
+
+    // Returns the physical memory used by the process or 0 if it's unknown
+    static size_t GetProcessMemoryUsage()
+    {
+    #if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.WorkingSetSize;
+    #elif defined(__APPLE__)
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+            return info.resident_size;
+    #elif defined(__linux__)
+        // The second number is the resident set size in pages
+        std::ifstream statm("/proc/self/statm");
+        size_t total, resident;
+
+        if (statm >> total >> resident)
+            return resident * (size_t)sysconf(_SC_PAGESIZE);
+    #endif
+
+        return 0;
+    }
+
+    static std::string FormatBytes(size_t bytes)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+
+        if (bytes >= 1024 * 1024)
+            ss << (double)bytes / (1024.0 * 1024.0) << " MB";
+        else if (bytes >= 1024)
+            ss << (double)bytes / 1024.0 << " KB";
+        else
+            ss << bytes << " B";
+
+        return ss.str();
+    }
+
+    static size_t GetGraphicMemoryUsage(const Graphic* graphic)
+    {
+        if (!graphic || !graphic->sprite)
+            return 0;
+
+        return graphic->sprite->pixels.size() * sizeof(Pixel);
+    }
+
+    Console::Console(GameEngine* engine) : m_Engine(engine), m_BackgroundColour(0, 0, 255, 100)
+    {
+        m_LinesStart = 0;
+        m_LinesCount = 0;
+
+        m_CommandsStart = 0;
+        m_CommandsCount = 0;
+
+        m_PickedHistoryCommand = 0;
+        m_ScrollOffset = 0;
+
+        m_Lines.resize(DEFAULT_HISTORY_LINES);
+        m_Commands.resize(DEFAULT_HISTORY_COMMANDS);
+
+        RegisterBuiltInCommands();
+    }
+
+    void Console::RegisterCommand(const std::string& name, const std::string& help, const CommandHandler& handler)
+    {
+        m_Registry[name] = { help, handler };
+    }
+
+    bool Console::UnregisterCommand(const std::string& name)
     {
+        return m_Registry.erase(name) > 0;
+    }
+
+    bool Console::HasCommand(const std::string& name) const
+    {
+        return m_Registry.find(name) != m_Registry.end();
+    }
+
+    std::vector<std::string> Console::ParseArguments(std::string_view command)
+    {
+        std::vector<std::string> args;
+
+        size_t i = 0;
+
+        while (i < command.length())
+        {
+            while (i < command.length() && isspace((unsigned char)command[i]))
+                i++;
+
+            if (i == command.length())
+                break;
+
+            std::string arg;
+
+            if (command[i] == '"')
+            {
+                // Everything up to the closing quote is a single argument
+                size_t end = command.find('"', ++i);
+
+                if (end == std::string_view::npos)
+                    end = command.length();
+
+                arg = command.substr(i, end - i);
+                i = end + 1;
+            }
+            else
+            {
+                size_t start = i;
+
+                while (i < command.length() && !isspace((unsigned char)command[i]))
+                    i++;
+
+                arg = command.substr(start, i - start);
+            }
+
+            args.push_back(std::move(arg));
+        }
+
+        return args;
     }
 
     void Console::Clear()
     {
+        m_LinesStart = 0;
+        m_LinesCount = 0;
+
+        m_CommandsStart = 0;
+        m_CommandsCount = 0;
+
         m_PickedHistoryCommand = 0;
-        m_History.clear();
+        m_ScrollOffset = 0;
     }
 
     void Console::Print(const std::string& text, const Pixel& colour)
     {
-        m_History.push_back({ "", text, colour, false });
+        AddText(text, colour);
+    }
+
+    void Console::SetHistorySize(size_t lines, size_t commands)
+    {
+        lines = std::max<size_t>(lines, 1);
+        commands = std::max<size_t>(commands, 1);
+
+        // Keep the newest lines and commands in the same order
+
+        std::vector<Line> newLines(lines);
+        size_t linesCount = std::min(m_LinesCount, lines);
+
+        for (size_t i = 0; i < linesCount; i++)
+            newLines[i] = std::move(m_Lines[(m_LinesStart + m_LinesCount - linesCount + i) % m_Lines.size()]);
+
+        std::vector<std::string> newCommands(commands);
+        size_t commandsCount = std::min(m_CommandsCount, commands);
+
+        for (size_t i = 0; i < commandsCount; i++)
+            newCommands[i] = std::move(m_Commands[(m_CommandsStart + m_CommandsCount - commandsCount + i) % m_Commands.size()]);
+
+        m_Lines = std::move(newLines);
+        m_LinesStart = 0;
+        m_LinesCount = linesCount;
+
+        m_Commands = std::move(newCommands);
+        m_CommandsStart = 0;
+        m_CommandsCount = commandsCount;
+
+        m_PickedHistoryCommand = m_CommandsCount;
+        m_ScrollOffset = 0;
+    }
+
+    size_t Console::GetLinesCount() const
+    {
+        return m_LinesCount;
+    }
+
+    const Console::Line& Console::GetLine(size_t index) const
+    {
+        return m_Lines[(m_LinesStart + index) % m_Lines.size()];
+    }
+
+    void Console::AddLine(std::string_view text, const Pixel& colour)
+    {
+        Line* line;
+
+        if (m_LinesCount < m_Lines.size())
+            line = &m_Lines[(m_LinesStart + m_LinesCount++) % m_Lines.size()];
+        else
+        {
+            line = &m_Lines[m_LinesStart];
+            m_LinesStart = (m_LinesStart + 1) % m_Lines.size();
+        }
+
+        // Assigning reuses the memory of the overwritten line
+        line->text.assign(text);
+        line->colour = colour;
+
+        // Keep the same lines on the screen if the output is scrolled up
+        if (m_ScrollOffset > 0)
+            m_ScrollOffset = std::min(m_ScrollOffset + 1, m_LinesCount);
+    }
+
+    void Console::AddText(std::string_view text, const Pixel& colour)
+    {
+        size_t start = 0;
+
+        while (true)
+        {
+            size_t end = text.find('\n', start);
+
+            if (end == std::string_view::npos)
+            {
+                AddLine(text.substr(start), colour);
+                break;
+            }
+
+            AddLine(text.substr(start, end - start), colour);
+            start = end + 1;
+        }
+    }
+
+    int Console::GetVisibleLinesCount() const
+    {
+        int historyBottomY = m_Engine->m_Window->GetScreenHeight() - 2 * LINE_HEIGHT - 5;
+        return std::max(historyBottomY / LINE_HEIGHT + 1, 1);
     }
 
     void Console::HandleCommand(const std::string& command)
@@ -29,136 +274,387 @@ namespace def
         if (!IsShown())
             return;
 
+        std::vector<std::string> args = ParseArguments(command);
+
+        if (args.empty())
+            return;
+
+        // The command is printed first so a handler can clear it
+        AddLine("> " + command, WHITE);
+        m_ScrollOffset = 0;
+
         std::stringstream output;
         Pixel colour = WHITE;
 
-        if (m_Engine->OnConsoleCommand(command, output, colour))
+        auto it = m_Registry.find(args[0]);
+
+        if (it != m_Registry.end())
+            it->second.handler(args, output, colour);
+
+        else if (!m_Engine->OnConsoleCommand(command, output, colour))
         {
-            if (!command.empty())
-            {
-                m_History.push_back({ command, output.str(), colour, true });
-                m_PickedHistoryCommand = m_History.size();
-            }
+            output << "Unknown command: " << args[0] << ", type help to list the commands";
+            colour = RED;
+        }
+
+        std::string text = output.str();
+
+        if (!text.empty())
+            AddText(text, colour);
+
+        if (m_CommandsCount < m_Commands.size())
+            m_Commands[(m_CommandsStart + m_CommandsCount++) % m_Commands.size()] = command;
+        else
+        {
+            m_Commands[m_CommandsStart] = command;
+            m_CommandsStart = (m_CommandsStart + 1) % m_Commands.size();
         }
+
+        m_PickedHistoryCommand = m_CommandsCount;
     }
 
     void Console::HandleHistoryBrowsing()
     {
-        if (!IsShown() || m_History.empty())
+        if (!IsShown())
+            return;
+
+        auto& input = *m_Engine->m_Input;
+
+        // Scrolling the output
+
+        size_t page = (size_t)GetVisibleLinesCount();
+        size_t maxOffset = m_LinesCount > page ? m_LinesCount - page : 0;
+
+        if (input.GetKeyState(Key::PAGE_UP).pressed)
+            m_ScrollOffset += page - 1;
+
+        if (input.GetKeyState(Key::PAGE_DOWN).pressed)
+            m_ScrollOffset = m_ScrollOffset > page - 1 ? m_ScrollOffset - (page - 1) : 0;
+
+        int scroll = input.GetScrollDelta();
+
+        if (scroll > 0)
+            m_ScrollOffset += (size_t)scroll * 3;
+        else if (scroll < 0)
+            m_ScrollOffset = m_ScrollOffset > (size_t)-scroll * 3 ? m_ScrollOffset - (size_t)-scroll * 3 : 0;
+
+        m_ScrollOffset = std::min(m_ScrollOffset, maxOffset);
+
+        // Browsing the commands
+
+        if (m_CommandsCount == 0)
             return;
 
         bool moved = false;
 
-        if (m_Engine->m_Input->GetKeyState(Key::UP).pressed)
+        if (input.GetKeyState(Key::UP).pressed && m_PickedHistoryCommand > 0)
         {
-            do
-            {
-                if (m_PickedHistoryCommand > 0)
-                {
-                    m_PickedHistoryCommand--;
-                    moved = m_History[m_PickedHistoryCommand].isCommand;
-                }
-            }
-            while (!moved && m_PickedHistoryCommand > 0);
+            m_PickedHistoryCommand--;
+            moved = true;
         }
 
-        if (m_Engine->m_Input->GetKeyState(Key::DOWN).pressed)
+        if (input.GetKeyState(Key::DOWN).pressed && m_PickedHistoryCommand + 1 < m_CommandsCount)
         {
-            do
-            {
-                if (m_PickedHistoryCommand < m_History.size() - 1)
-                {
-                    m_PickedHistoryCommand++;
-                    moved = m_History[m_PickedHistoryCommand].isCommand;
-                }
-            }
-            while (!moved && m_PickedHistoryCommand < m_History.size() - 1);
+            m_PickedHistoryCommand++;
+            moved = true;
         }
 
         if (moved)
         {
-            const std::string& command = m_History[m_PickedHistoryCommand].command;
+            const std::string& command = m_Commands[(m_CommandsStart + m_PickedHistoryCommand) % m_Commands.size()];
             
-            m_Engine->m_Input->SetCapturedText(command);
-            m_Engine->m_Input->SetCapturedTextCursorPosition(command.length());
+            input.SetCapturedText(command);
+            input.SetCapturedTextCursorPosition(command.length());
         }
     }
 
-    void Console::Draw()
+    void Console::HandleCompletion()
     {
         if (!IsShown())
             return;
 
-        int currentLayer = m_Engine->m_CurrentLayer;
-        m_Engine->SetLayer(0);
+        auto& input = *m_Engine->m_Input;
 
-        m_Engine->FillTextureRectangle({ 0, 0 }, m_Engine->m_Window->GetScreenSize(), m_BackgroundColour);
+        if (!input.GetKeyState(Key::TAB).pressed)
+            return;
 
-        int lineHeight = 10;
-        int screenHeight = m_Engine->m_Window->GetScreenHeight();
+        // Only the name of the command is completed
+        const std::string& text = input.GetCapturedText();
+
+        if (text.find(' ') != std::string::npos)
+            return;
+
+        std::vector<const std::string*> candidates;
+
+        for (const auto& [name, command] : m_Registry)
+        {
+            if (name.compare(0, text.length(), text) == 0)
+                candidates.push_back(&name);
+        }
+
+        if (candidates.empty())
+            return;
+
+        if (candidates.size() == 1)
+        {
+            std::string completed = *candidates[0] + ' ';
+
+            input.SetCapturedText(completed);
+            input.SetCapturedTextCursorPosition(completed.length());
+
+            return;
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
 
-        int inputY = screenHeight - lineHeight - 5;
-        int historyBottomY = inputY - lineHeight;
+        // The first and the last names have the shortest common prefix
+        const std::string& first = *candidates.front();
+        const std::string& last = *candidates.back();
 
-        int offset = historyBottomY;
+        size_t common = 0;
 
-        for (int i = (int)m_History.size() - 1; i >= 0; i--)
+        while (common < first.length() && common < last.length() && first[common] == last[common])
+            common++;
+
+        if (common > text.length())
         {
-            const auto& entry = m_History[i];
+            input.SetCapturedText(first.substr(0, common));
+            input.SetCapturedTextCursorPosition(common);
+
+            return;
+        }
 
-            int lines = 1;
+        std::string list;
 
-            for (char c : entry.output)
+        for (const std::string* name : candidates)
+        {
+            if (!list.empty())
+                list += "  ";
+
+            list += *name;
+        }
+
+        AddText(list, GREY);
+        m_ScrollOffset = 0;
+    }
+
+    void Console::PrintLog()
+    {
+        Log::TakeConsoleMessages(m_LogMessages);
+
+        for (const auto& message : m_LogMessages)
+        {
+            Pixel colour;
+
+            switch (message.level)
             {
-                if (c == '\n')
-                    lines++;
+            case Log::Level::TRACE: colour = DARK_GREY; break;
+            case Log::Level::DEBUG: colour = GREY; break;
+            case Log::Level::WARN: colour = YELLOW; break;
+            case Log::Level::ERR: case Log::Level::FATAL: colour = RED; break;
+            default: colour = WHITE;
             }
 
-            if (entry.isCommand)
+            AddText(std::string("[") + Log::GetLevelName(message.level) + "] " + message.text, colour);
+        }
+    }
+
+    void Console::RegisterBuiltInCommands()
+    {
+        RegisterCommand("help", "help [command] - lists the commands or shows help of the command",
+            [this](const std::vector<std::string>& args, std::stringstream& output, Pixel& colour)
             {
-                if (offset < 0)
-                    break;
+                if (args.size() > 1)
+                {
+                    auto it = m_Registry.find(args[1]);
 
-                m_Engine->DrawTextureString({ 10, offset }, "> " + entry.command, WHITE);
-                offset -= lineHeight;
-            }
+                    if (it == m_Registry.end())
+                    {
+                        output << "Unknown command: " << args[1];
+                        colour = RED;
+                    }
+                    else
+                        output << it->second.help;
+
+                    return;
+                }
+
+                std::vector<const std::string*> names;
 
-            for (int l = 0; l < lines; l++)
+                for (const auto& [name, command] : m_Registry)
+                    names.push_back(&name);
+
+                std::sort(names.begin(), names.end(),
+                    [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+
+                for (size_t i = 0; i < names.size(); i++)
+                    output << (i > 0 ? "\n" : "") << m_Registry.at(*names[i]).help;
+            });
+
+        RegisterCommand("clear", "clear - clears the console",
+            [this](const std::vector<std::string>&, std::stringstream&, Pixel&)
             {
-                if (offset < 0) break;
+                Clear();
+            });
 
-                std::string text;
+        RegisterCommand("stats", "stats - shows timings of the last frame and the frame limiter",
+            [this](const std::vector<std::string>&, std::stringstream& output, Pixel&)
+            {
+                const Timer& timer = *m_Engine->m_Timer;
+                const FrameTimings& timings = m_Engine->m_FrameTimings;
+                const FramePacingStats& pacing = timer.GetPacingStats();
 
-                if (lines == 1)
-                    text = entry.output;
-                else
+                output << std::fixed << std::setprecision(2);
+
+                output << "fps " << timer.GetFPS() << ", delta " << timer.GetDeltaTime() * 1000.0f << " ms\n";
+
+                output << "update " << timings.update * 1000.0f << " ms, layers " << timings.layers * 1000.0f
+                    << " ms, draw " << timings.draw * 1000.0f << " ms, present " << timings.present * 1000.0f
+                    << " ms, total " << timings.total * 1000.0f << " ms";
+
+                if (pacing.targetFrameTime > 0.0f)
                 {
-                    size_t start = 0;
-                    size_t end = entry.output.find('\n');
+                    output << "\nlimiter " << pacing.targetFrameTime * 1000.0f << " ms: work " << pacing.workTime * 1000.0f
+                        << " ms, sleep " << pacing.sleepTime * 1000.0f << " ms, spin " << pacing.spinTime * 1000.0f
+                        << " ms, oversleep " << pacing.oversleep * 1000.0f << " ms";
+
+                    output << "\npaced " << pacing.pacedFrames << ", missed " << pacing.missedFrames << ", idle " << pacing.idleFrames;
+                }
+            });
+
+        RegisterCommand("layers", "layers - lists the layers and their textures on the last frame",
+            [this](const std::vector<std::string>&, std::stringstream& output, Pixel&)
+            {
+                const auto& layers = m_Engine->m_Layers;
 
-                    for (int j = 0; j <= l; j++)
+                for (size_t i = 0; i < layers.size(); i++)
+                {
+                    const Layer& layer = *layers[i];
+
+                    output << (i > 0 ? "\n" : "") << i << (i == 0 ? " (console)" : "")
+                        << ": offset " << layer.offset.x << "x" << layer.offset.y
+                        << ", size " << layer.size.x << "x" << layer.size.y
+                        << (layer.visible ? ", visible" : ", hidden")
+                        << (layer.update ? ", updated" : ", frozen")
+                        << ", textures " << layer.drawnTextures
+                        << ", culled " << layer.culledTextures;
+                }
+            });
+
+        RegisterCommand("memory", "memory - shows memory used by the process and by the layers",
+            [this](const std::vector<std::string>&, std::stringstream& output, Pixel&)
+            {
+                size_t process = GetProcessMemoryUsage();
+
+                // Each layer keeps a copy of its pixels in the RAM and on the GPU
+                size_t layers = 0;
+
+                for (const auto& layer : m_Engine->m_Layers)
+                    layers += GetGraphicMemoryUsage(layer->pixels);
+
+                output << "process " << (process > 0 ? FormatBytes(process) : "unknown") << "\n";
+                output << "layers " << FormatBytes(layers) << " (+" << FormatBytes(layers) << " on the GPU)\n";
+                output << "font " << FormatBytes(GetGraphicMemoryUsage(&m_Engine->m_Font));
+            });
+
+        RegisterCommand("gl", "gl - shows the number of calls to the graphics API on the last frame",
+            [this](const std::vector<std::string>&, std::stringstream& output, Pixel&)
+            {
+                const RenderStats& stats = m_Engine->m_Platform->GetRenderStats();
+
+                output << "draw calls " << stats.drawCalls << ", texture binds " << stats.textureBinds
+                    << ", vertices " << stats.vertices << "\n";
+                output << "textures submitted " << stats.submitted << ", culled " << stats.culled;
+            });
+
+        RegisterCommand("profiler", "profiler [on|off|reset] - collects min, avg and max timings of the frames",
+            [this](const std::vector<std::string>& args, std::stringstream& output, Pixel& colour)
+            {
+                if (args.size() > 1)
+                {
+                    if (args[1] == "on")
+                        m_Engine->EnableProfiler(true);
+                    else if (args[1] == "off")
+                        m_Engine->EnableProfiler(false);
+                    else if (args[1] == "reset")
+                        m_Engine->ResetProfiler();
+                    else
                     {
-                        start = (j == 0 ? 0 : end + 1);
-                        end = entry.output.find('\n', start);
+                        output << "Expected on, off or reset";
+                        colour = RED;
+                        return;
                     }
-
-                    text = entry.output.substr(
-                        start,
-                        end == std::string::npos ? std::string::npos : end - start
-                    );
                 }
 
-                m_Engine->DrawTextureString({ 10, offset }, text, entry.outputColour);
-                offset -= lineHeight;
-            }
+                const FrameProfile& profile = m_Engine->GetFrameProfile();
+
+                output << "profiler is " << (m_Engine->IsProfilerEnabled() ? "on" : "off") << ", frames " << profile.frames;
+
+                if (profile.frames == 0)
+                    return;
+
+                output << std::fixed << std::setprecision(2);
+
+                auto Row = [&](const char* name, float FrameTimings::* phase)
+                    {
+                        output << "\n" << name << " min " << profile.min.*phase * 1000.0f
+                            << " ms, avg " << profile.sum.*phase / (float)profile.frames * 1000.0f
+                            << " ms, max " << profile.max.*phase * 1000.0f << " ms";
+                    };
+
+                Row("update", &FrameTimings::update);
+                Row("layers", &FrameTimings::layers);
+                Row("draw", &FrameTimings::draw);
+                Row("present", &FrameTimings::present);
+                Row("total", &FrameTimings::total);
+            });
+    }
+
+    void Console::Draw()
+    {
+        if (!IsShown())
+            return;
+
+        int currentLayer = m_Engine->m_CurrentLayer;
+        m_Engine->SetLayer(0);
+
+        m_Engine->FillTextureRectangle({ 0, 0 }, m_Engine->m_Window->GetScreenSize(), m_BackgroundColour);
+
+        int screenHeight = m_Engine->m_Window->GetScreenHeight();
+
+        int inputY = screenHeight - LINE_HEIGHT - 5;
+        int offset = inputY - LINE_HEIGHT;
+
+        // Only the lines that fit on the screen are visited
+        size_t visible = std::min((size_t)GetVisibleLinesCount(), m_LinesCount - m_ScrollOffset);
+        size_t last = m_LinesCount - m_ScrollOffset;
+
+        for (size_t i = last; i > last - visible; i--)
+        {
+            const Line& line = GetLine(i - 1);
+
+            m_Engine->DrawTextureString({ 10, offset }, line.text, line.colour);
+            offset -= LINE_HEIGHT;
         }
 
-        std::string input = m_Engine->m_Input->GetCapturedText();
+        const std::string& input = m_Engine->m_Input->GetCapturedText();
+        size_t cursorPos = m_Engine->m_Input->GetCapturedTextCursorPosition();
 
 		// Draw an input prompt
         m_Engine->DrawTextureString({ 10, inputY }, "> " + input, YELLOW);
 
-        int cursorX = 10 + 8 * (2 + (int)input.size());
+        // Each character of the font is 8 pixels wide so count
+        // the code points (not the bytes) before the cursor
+        int chars = 0;
+
+        for (size_t i = 0; i < cursorPos && i < input.length(); i++)
+        {
+            if ((input[i] & 0xC0) != 0x80)
+                chars++;
+        }
+
+        int cursorX = 10 + 8 * (2 + chars);
 
         // Draw a cursor
         m_Engine->DrawTextureLine({ cursorX, inputY }, { cursorX, inputY + 8 }, RED);
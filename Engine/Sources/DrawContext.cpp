@@ -0,0 +1,868 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "DrawContext.hpp"
+#include "Rasteriser.hpp"
+#include "defGameEngine.hpp"
+
+namespace def
+{
+	DrawContext::DrawContext(GameEngine* engine, Layer* layer) : m_Engine(engine), m_Layer(layer)
+	{
+		m_Target = nullptr;
+		m_PixelMode = Pixel::Mode::DEFAULT;
+		m_Shader = nullptr;
+		m_TextureStructure = Texture::Structure::TRIANGLE_FAN;
+		m_TextureTarget = nullptr;
+		m_DrawList = nullptr;
+		m_TextureDepth = 0.0f;
+		m_CulledTextures = 0;
+	}
+
+	DrawContext::DrawContext(GameEngine* engine, Graphic* target) : m_Engine(engine), m_Layer(nullptr)
+	{
+		m_Target = target;
+		m_PixelMode = Pixel::Mode::DEFAULT;
+		m_Shader = nullptr;
+		m_TextureStructure = Texture::Structure::TRIANGLE_FAN;
+		m_TextureTarget = nullptr;
+		m_DrawList = nullptr;
+		m_TextureDepth = 0.0f;
+		m_CulledTextures = 0;
+	}
+
+	bool DrawContext::Draw(int x, int y, const Pixel& col)
+	{
+		Graphic* target = GetDrawTarget();
+
+		if (!target)
+			return false;
+
+		Sprite* sprite = target->sprite;
+
+		switch (GetPixelMode())
+		{
+		case Pixel::Mode::CUSTOM:
+		return sprite->SetPixel(x, y, GetShader()({ x, y }, sprite->GetPixel(x, y), col));
+
+		case Pixel::Mode::DEFAULT:
+		return sprite->SetPixel(x, y, col);
+
+		case Pixel::Mode::MASK:
+		{
+			if (col.a == 255)
+				return sprite->SetPixel(x, y, col);
+		}
+		break;
+
+		case Pixel::Mode::ALPHA:
+		{
+			Pixel d = sprite->GetPixel(x, y);
+
+			uint8_t r = uint8_t(std::lerp(d.r, col.r, (float)col.a / 255.0f));
+			uint8_t g = uint8_t(std::lerp(d.g, col.g, (float)col.a / 255.0f));
+			uint8_t b = uint8_t(std::lerp(d.b, col.b, (float)col.a / 255.0f));
+
+			return sprite->SetPixel(x, y, { r, g, b });
+		}
+
+		}
+
+		return false;
+	}
+
+	void DrawContext::DrawSpan(int x1, int x2, int y, const Pixel& col)
+	{
+		Graphic* target = GetDrawTarget();
+
+		if (!target)
+			return;
+
+		Sprite* sprite = target->sprite;
+
+		// Without blending the clipped span is filled at once
+		if (GetPixelMode() == Pixel::Mode::DEFAULT)
+		{
+			if (y < 0 || y >= sprite->size.y)
+				return;
+
+			x1 = std::max(x1, 0);
+			x2 = std::min(x2, sprite->size.x - 1);
+
+			if (x1 <= x2)
+			{
+				Pixel* row = sprite->GetRow(y);
+				std::fill(row + x1, row + x2 + 1, col);
+			}
+
+			return;
+		}
+
+		for (int x = x1; x <= x2; x++)
+			Draw(x, y, col);
+	}
+
+	void DrawContext::DrawLine(int x1, int y1, int x2, int y2, const Pixel& col)
+	{
+		Rasteriser::Line(x1, y1, x2, y2, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col)
+	{
+		Rasteriser::Triangle(x1, y1, x2, y2, x3, y3, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col)
+	{
+		Rasteriser::FillTriangle(x1, y1, x2, y2, x3, y3, [&](int start, int end, int py) { DrawSpan(start, end, py, col); });
+	}
+
+	void DrawContext::DrawRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col)
+	{
+		Rasteriser::Rectangle(x, y, sizeX, sizeY, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::FillRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col)
+	{
+		Rasteriser::FillRectangle(x, y, sizeX, sizeY, [&](int start, int end, int py) { DrawSpan(start, end, py, col); });
+	}
+
+	void DrawContext::DrawCircle(int x, int y, int radius, const Pixel& col)
+	{
+		Rasteriser::Circle(x, y, radius, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::FillCircle(int x, int y, int radius, const Pixel& col)
+	{
+		Rasteriser::FillCircle(x, y, radius, [&](int start, int end, int py) { DrawSpan(start, end, py, col); });
+	}
+
+	void DrawContext::DrawEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col)
+	{
+		Rasteriser::Ellipse(x, y, sizeX, sizeY, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::FillEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col)
+	{
+		Rasteriser::FillEllipse(x, y, sizeX, sizeY, [&](int start, int end, int py) { DrawSpan(start, end, py, col); });
+	}
+
+	void DrawContext::DrawSprite(int x, int y, const Sprite* sprite)
+	{
+		for (int j = 0; j < sprite->size.y; j++)
+			for (int i = 0; i < sprite->size.x; i++)
+				Draw(x + i, y + j, sprite->GetPixel(i, j));
+	}
+
+	void DrawContext::DrawPartialSprite(int x, int y, int fileX, int fileY, int fileSizeX, int fileSizeY, const Sprite* sprite)
+	{
+		for (int j = 0; j < fileSizeY; j++)
+			for (int i = 0; i < fileSizeX; i++)
+				Draw(x + i, y + j, sprite->GetPixel(fileX + i, fileY + j));
+	}
+
+	void DrawContext::DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation, float scale, const Pixel& col)
+	{
+		Rasteriser::TransformModel(modelCoordinates, pos.x, pos.y, rotation, scale, m_Coordinates);
+		Rasteriser::WireFrame(m_Coordinates, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, const Vector2f& pos, float rotation, float scale, const Pixel& col)
+	{
+		Rasteriser::TransformModel(modelCoordinates, pos.x, pos.y, rotation, scale, m_Coordinates);
+		Rasteriser::FillWireFrame(m_Coordinates, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::DrawString(int x, int y, std::string_view text, const Pixel& col, int scaleX, int scaleY)
+	{
+		Rasteriser::String(x, y, text, m_Engine->m_Font.sprite, m_Engine->m_TabSize, scaleX, scaleY, [&](int px, int py) { Draw(px, py, col); });
+	}
+
+	void DrawContext::Clear(const Pixel& col)
+	{
+		if (Graphic* target = GetDrawTarget())
+			target->sprite->SetPixelData(col);
+	}
+
+	void DrawContext::ClearTexture(const Pixel& col)
+	{
+		if (m_TextureTarget)
+			m_TextureTarget->Clear(col);
+
+		else if (m_Layer)
+			FillTextureRectangle({ 0, 0 }, m_Layer->size, col);
+	}
+
+	void DrawContext::Submit(TextureInstance&& texInst)
+	{
+		// The list is transformed later so nothing is culled
+		if (m_DrawList)
+		{
+			if (!texInst.drawList)
+			{
+				m_DrawList->Add(std::move(texInst));
+				return;
+			}
+
+			// A list that is drawn while another one is recorded is copied into it,
+			// each batch becomes a texture with the vertices moved, scaled and tinted already
+			bool changed;
+			const auto& vertices = texInst.drawList->Bake(texInst.listOffset, texInst.listScale, texInst.tint.empty() ? WHITE : texInst.tint[0], changed);
+
+			for (const auto& batch : texInst.drawList->GetBatches())
+			{
+				TextureInstance part;
+
+				part.texture = batch.texture;
+				part.structure = batch.lines ? Texture::Structure::LINES : Texture::Structure::DEFAULT;
+				part.points = batch.count;
+
+				part.vertices.reserve(batch.count);
+				part.uv.reserve(batch.count);
+				part.tint.reserve(batch.count);
+
+				for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+				{
+					part.vertices.push_back(vertices[i].pos);
+					part.uv.push_back(vertices[i].uv);
+					part.tint.push_back(vertices[i].col);
+				}
+
+				m_DrawList->Add(std::move(part));
+			}
+
+			return;
+		}
+
+		if (texInst.vertices.empty())
+			return;
+
+		Vector2f min = texInst.vertices[0];
+		Vector2f max = texInst.vertices[0];
+
+		for (const auto& vertex : texInst.vertices)
+		{
+			min = min.Min(vertex);
+			max = max.Max(vertex);
+		}
+
+		Submit(std::move(texInst), min, max);
+	}
+
+	void DrawContext::Submit(TextureInstance&& texInst, Vector2f min, Vector2f max)
+	{
+		if (m_DrawList)
+		{
+			Submit(std::move(texInst));
+			return;
+		}
+
+		if (m_TextureTarget)
+		{
+			// The vertices are in normalised coordinates of the screen with Y pointing up,
+			// in the target Y points down so the first row of its texture is the top one
+			Vector2f scale = Vector2f(m_Engine->m_Window->GetScreenSize()) / Vector2f(m_TextureTarget->GetSize());
+
+			for (auto& vertex : texInst.vertices)
+				vertex = Vector2f(vertex.x + 1.0f, 1.0f - vertex.y) * scale - 1.0f;
+
+			// The same is applied to the transform of the list
+			if (texInst.drawList)
+			{
+				texInst.listOffset = Vector2f(texInst.listOffset.x + 1.0f, 1.0f - texInst.listOffset.y) * scale - 1.0f;
+				texInst.listScale *= Vector2f(scale.x, -scale.y);
+			}
+
+			// and to the bounding box, whose Y is flipped
+			Vector2f oldMin = min;
+
+			min = Vector2f(min.x + 1.0f, 1.0f - max.y) * scale - 1.0f;
+			max = Vector2f(max.x + 1.0f, 1.0f - oldMin.y) * scale - 1.0f;
+		}
+
+		// Both the screen and the targets are [-1, 1] in normalised coordinates
+		if (max.x < -1.0f || max.y < -1.0f || min.x > 1.0f || min.y > 1.0f)
+		{
+			m_CulledTextures++;
+			return;
+		}
+
+		texInst.depth = m_TextureDepth;
+
+		if (m_TextureTarget)
+			m_TextureTarget->Submit(std::move(texInst));
+		else
+			m_Layer->textures.push_back(std::move(texInst));
+	}
+
+	bool DrawContext::Draw(const Vector2i& pos, const Pixel& col)
+	{
+		return Draw(pos.x, pos.y, col);
+	}
+
+	void DrawContext::DrawLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col)
+	{
+		DrawLine(pos1.x, pos1.y, pos2.x, pos2.y, col);
+	}
+
+	void DrawContext::DrawTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
+	{
+		DrawTriangle(pos1.x, pos1.y, pos2.x, pos2.y, pos3.x, pos3.y, col);
+	}
+
+	void DrawContext::FillTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
+	{
+		FillTriangle(pos1.x, pos1.y, pos2.x, pos2.y, pos3.x, pos3.y, col);
+	}
+
+	void DrawContext::DrawRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		DrawRectangle(pos.x, pos.y, size.x, size.y, col);
+	}
+
+	void DrawContext::FillRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		FillRectangle(pos.x, pos.y, size.x, size.y, col);
+	}
+
+	void DrawContext::DrawCircle(const Vector2i& pos, int radius, const Pixel& col)
+	{
+		DrawCircle(pos.x, pos.y, radius, col);
+	}
+
+	void DrawContext::FillCircle(const Vector2i& pos, int radius, const Pixel& col)
+	{
+		FillCircle(pos.x, pos.y, radius, col);
+	}
+
+	void DrawContext::DrawEllipse(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		DrawEllipse(pos.x, pos.y, size.x, size.y, col);
+	}
+
+	void DrawContext::FillEllipse(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		FillEllipse(pos.x, pos.y, size.x, size.y, col);
+	}
+
+	void DrawContext::DrawSprite(const Vector2i& pos, const Sprite* sprite)
+	{
+		DrawSprite(pos.x, pos.y, sprite);
+	}
+
+	void DrawContext::DrawPartialSprite(const Vector2i& pos, const Vector2i& filePos, const Vector2i& fileSize, const Sprite* sprite)
+	{
+		DrawPartialSprite(pos.x, pos.y, filePos.x, filePos.y, fileSize.x, fileSize.y, sprite);
+	}
+
+	void DrawContext::DrawString(const Vector2i& pos, std::string_view text, const Pixel& col, const Vector2i& scale)
+	{
+		DrawString(pos.x, pos.y, text, col, scale.x, scale.y);
+	}
+
+	void DrawContext::DrawTexturePolygon(const std::vector<Vector2f>& verts, const std::vector<Pixel>& cols, Texture::Structure structure)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = nullptr;
+		texInst.points = verts.size();
+		texInst.structure = structure;
+
+		texInst.tint.resize(verts.size());
+
+		if (cols.size() > 1)
+		{
+			std::copy(
+				cols.begin(),
+				cols.end(),
+				texInst.tint.begin());
+		}
+		else
+		{
+			std::fill(
+				texInst.tint.begin(),
+				texInst.tint.end(),
+				cols.empty() ? def::WHITE : cols[0]);
+		}
+
+		texInst.uv.resize(verts.size());
+		texInst.vertices.resize(verts.size());
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		for (size_t i = 0; i < verts.size(); i++)
+		{
+			texInst.vertices[i].x = verts[i].x * inv.x * 2.0f - 1.0f;
+			texInst.vertices[i].y = 1.0f - verts[i].y * inv.y * 2.0f;
+		}
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawTextureTriangles(const Texture* tex, const std::vector<Vector2f>& verts, const std::vector<Vector2f>& uvs, const std::vector<Pixel>& cols)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		size_t points = verts.size() - verts.size() % 3;
+
+		if (points == 0)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = (uint32_t)points;
+		texInst.structure = Texture::Structure::DEFAULT;
+
+		if (cols.size() >= points)
+			texInst.tint.assign(cols.begin(), cols.begin() + points);
+		else
+			texInst.tint.resize(points, cols.empty() ? WHITE : cols[0]);
+
+		if (uvs.size() >= points)
+			texInst.uv.assign(uvs.begin(), uvs.begin() + points);
+		else
+			texInst.uv.resize(points);
+
+		texInst.vertices.assign(verts.begin(), verts.begin() + points);
+
+		SubmitTriangles(std::move(texInst));
+	}
+
+	void DrawContext::DrawTextureTriangles(const Texture* tex, std::vector<Vector2f>&& verts, std::vector<Vector2f>&& uvs, std::vector<Pixel>&& cols)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		size_t points = verts.size() - verts.size() % 3;
+
+		if (points == 0)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = (uint32_t)points;
+		texInst.structure = Texture::Structure::DEFAULT;
+
+		if (cols.size() >= points)
+		{
+			cols.resize(points);
+			texInst.tint = std::move(cols);
+		}
+		else
+			texInst.tint.resize(points, cols.empty() ? WHITE : cols[0]);
+
+		if (uvs.size() >= points)
+		{
+			uvs.resize(points);
+			texInst.uv = std::move(uvs);
+		}
+		else
+			texInst.uv.resize(points);
+
+		verts.resize(points);
+		texInst.vertices = std::move(verts);
+
+		SubmitTriangles(std::move(texInst));
+	}
+
+	void DrawContext::SubmitTriangles(TextureInstance&& texInst)
+	{
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		Vector2f min = texInst.vertices[0];
+		Vector2f max = texInst.vertices[0];
+
+		// The bounding box is found in the same pass, so Submit doesn't go over the vertices again
+		for (auto& vertex : texInst.vertices)
+		{
+			min = min.Min(vertex);
+			max = max.Max(vertex);
+
+			vertex.x = vertex.x * inv.x * 2.0f - 1.0f;
+			vertex.y = 1.0f - vertex.y * inv.y * 2.0f;
+		}
+
+		// Y is flipped so the top of the box becomes its bottom
+		Submit(
+			std::move(texInst),
+			{ min.x * inv.x * 2.0f - 1.0f, 1.0f - max.y * inv.y * 2.0f },
+			{ max.x * inv.x * 2.0f - 1.0f, 1.0f - min.y * inv.y * 2.0f });
+	}
+
+	void DrawContext::DrawTextureLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col)
+	{
+		DrawTexturePolygon({ pos1, pos2 }, { col }, Texture::Structure::WIREFRAME);
+	}
+
+	void DrawContext::DrawTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
+	{
+		DrawTexturePolygon({ pos1, pos2, pos3 }, { col }, Texture::Structure::WIREFRAME);
+	}
+
+	void DrawContext::FillTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
+	{
+		DrawTexturePolygon({ pos1, pos2, pos3 }, { col }, Texture::Structure::TRIANGLE_FAN);
+	}
+
+	void DrawContext::DrawTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { col }, Texture::Structure::WIREFRAME);
+	}
+
+	void DrawContext::FillTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
+	{
+		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { col }, Texture::Structure::TRIANGLE_FAN);
+	}
+
+	void DrawContext::DrawTextureCircle(const Vector2i& pos, int radius, const Pixel& col)
+	{
+		std::vector<Vector2f> verts(GameEngine::s_UnitCircle.size());
+
+		for (size_t i = 0; i < verts.size(); i++)
+			verts[i] = GameEngine::s_UnitCircle[i] * (float)radius + pos;
+
+		DrawTexturePolygon(verts, { col }, Texture::Structure::WIREFRAME);
+	}
+
+	void DrawContext::FillTextureCircle(const Vector2i& pos, int radius, const Pixel& col)
+	{
+		std::vector<Vector2f> verts(GameEngine::s_UnitCircle.size());
+
+		for (size_t i = 0; i < verts.size(); i++)
+			verts[i] = GameEngine::s_UnitCircle[i] * (float)radius + pos;
+
+		DrawTexturePolygon(verts, { col }, Texture::Structure::TRIANGLE_FAN);
+	}
+
+	void DrawContext::GradientTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col1, const Pixel& col2, const Pixel& col3)
+	{
+		DrawTexturePolygon({ pos1, pos2, pos3 }, { col1, col2, col3 }, Texture::Structure::TRIANGLE_FAN);
+	}
+
+	void DrawContext::GradientTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& colTL, const Pixel& colTR, const Pixel& colBR, const Pixel& colBL)
+	{
+		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { colTL, colTR, colBR, colBL }, Texture::Structure::TRIANGLE_FAN);
+	}
+
+	void DrawContext::DrawTextureString(const Vector2i& pos, std::string_view text, const Pixel& col, const Vector2f& scale)
+	{
+		Vector2f p = { 0.0f, 0.0f };
+
+		for (auto c : text)
+		{
+			if (c == '\n')
+			{
+				p.x = 0;
+				p.y += 8.0f * scale.y;
+			}
+			else if (c == '\t')
+			{
+				p.x += 8.0f * float(m_Engine->m_TabSize) * scale.x;
+			}
+			else
+			{
+				Vector2f offset((c - 32) % 16, (c - 32) / 16);
+
+				DrawPartialTexture(pos + p, m_Engine->m_Font.texture, offset * 8.0f, { 8.0f, 8.0f }, scale, col);
+				p.x += 8.0f * scale.x;
+			}
+		}
+	}
+
+	void DrawContext::DrawTextureList(const Vector2f& pos, const DrawList* list, const Vector2f& scale, const Pixel& tint)
+	{
+		if ((!m_Layer && !m_TextureTarget) || !list || list->IsEmpty())
+			return;
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		TextureInstance texInst;
+
+		texInst.drawList = list;
+		texInst.tint = { tint };
+
+		// The top-left corner of the screen (-1, 1) stays in place when the list is scaled
+		texInst.listScale = scale;
+		texInst.listOffset = Vector2f(scale.x - 1.0f, 1.0f - scale.y) + pos * inv * Vector2f(2.0f, -2.0f);
+
+		// Only the bounding box is stored so the list can be culled
+		texInst.vertices = { list->GetMin() * scale + texInst.listOffset, list->GetMax() * scale + texInst.listOffset };
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawTexture(const Vector2f& pos, const Texture* tex, const Vector2f& scale, const Pixel& tint)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		Vector2f pos1 = (pos * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
+		Vector2f pos2 = pos1 + 2.0f * tex->size * inv * scale * Vector2f(1.0f, -1.0f);
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = 4;
+		texInst.structure = GetTextureStructure();
+		texInst.tint = { tint, tint, tint, tint };
+		texInst.vertices = { pos1, { pos1.x, pos2.y }, pos2, { pos2.x, pos1.y } };
+		texInst.ConstructUV();
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawPartialTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, const Vector2f& scale, const Pixel& tint)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		Vector2f screenPos1 = (pos * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
+		Vector2f screenPos2 = ((pos + fileSize * scale) * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
+
+		const Vector2i& size = m_Engine->m_Window->GetWindowSize();
+
+		Vector2f quantPos1 = (screenPos1 * Vector2f(m_Engine->m_Window->GetWindowSize()) + Vector2f(0.5f, 0.5f)).Floor() / Vector2f(size);
+		Vector2f quantPos2 = (screenPos2 * Vector2f(m_Engine->m_Window->GetWindowSize()) + Vector2f(0.5f, -0.5f)).Ceil() / Vector2f(size);
+
+		Vector2f tl = (filePos + 0.0001f) * tex->uvScale;
+		Vector2f br = (filePos + fileSize - 0.0001f) * tex->uvScale;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = 4;
+		texInst.structure = GetTextureStructure();
+		texInst.tint = { tint, tint, tint, tint };
+		texInst.vertices = { quantPos1, { quantPos1.x, quantPos2.y }, quantPos2, { quantPos2.x, quantPos1.y } };
+		texInst.uv = { tl, { tl.x, br.y }, br, { br.x, tl.y } };
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawRotatedTexture(const Vector2f& pos, const Texture* tex, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = 4;
+		texInst.structure = GetTextureStructure();
+		texInst.tint = { tint, tint, tint, tint };
+
+		Vector2f denormCenter = center * tex->size;
+
+		texInst.vertices = {
+			-denormCenter * scale,
+			(Vector2f(0.0f, tex->size.y) - denormCenter) * scale,
+			(tex->size - denormCenter) * scale,
+			(Vector2f(tex->size.x, 0.0f) - denormCenter) * scale
+		};
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		float c = cos(rotation), s = sin(rotation);
+		for (size_t i = 0; i < texInst.points; i++)
+		{
+			Vector2f offset =
+			{
+				texInst.vertices[i].x * c - texInst.vertices[i].y * s,
+				texInst.vertices[i].x * s + texInst.vertices[i].y * c
+			};
+
+			texInst.vertices[i] = pos + offset;
+			texInst.vertices[i] = texInst.vertices[i] * inv * 2.0f - 1.0f;
+			texInst.vertices[i].y *= -1.0f;
+		}
+
+		texInst.ConstructUV();
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawPartialRotatedTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.points = 4;
+		texInst.structure = GetTextureStructure();
+		texInst.tint = { tint, tint, tint, tint };
+
+		Vector2f denormCenter = center * fileSize;
+
+		texInst.vertices = {
+			-denormCenter * scale,
+			(Vector2f(0.0f, fileSize.y) - denormCenter) * scale,
+			(fileSize - denormCenter) * scale,
+			(Vector2f(fileSize.x, 0.0f) - denormCenter) * scale
+		};
+
+		const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+		float c = cos(rotation), s = sin(rotation);
+		for (size_t i = 0; i < texInst.points; i++)
+		{
+			Vector2f offset =
+			{
+				texInst.vertices[i].x * c - texInst.vertices[i].y * s,
+				texInst.vertices[i].x * s + texInst.vertices[i].y * c
+			};
+
+			texInst.vertices[i] = pos + offset;
+			texInst.vertices[i] = texInst.vertices[i] * inv * 2.0f - 1.0f;
+			texInst.vertices[i].y *= -1.0f;
+		}
+
+		Vector2f tl = filePos * tex->uvScale;
+		Vector2f br = tl + fileSize * tex->uvScale;
+
+		texInst.uv = { tl, { tl.x, br.y }, br, { br.x, tl.y } };
+
+		Submit(std::move(texInst));
+	}
+
+	void DrawContext::DrawWarpedTexture(const std::vector<Vector2f>& points, const Texture* tex, const Pixel& tint)
+	{
+		if (!m_Layer && !m_TextureTarget && !m_DrawList)
+			return;
+
+		TextureInstance texInst;
+
+		texInst.texture = tex;
+		texInst.structure = GetTextureStructure();
+		texInst.points = 4;
+		texInst.tint = { tint, tint, tint, tint };
+		texInst.vertices.resize(texInst.points);
+		texInst.ConstructUV();
+
+		float rd = ((points[2].x - points[0].x) * (points[3].y - points[1].y) - (points[3].x - points[1].x) * (points[2].y - points[0].y));
+
+		if (rd != 0.0f)
+		{
+			rd = 1.0f / rd;
+
+			float rn = ((points[3].x - points[1].x) * (points[0].y - points[1].y) - (points[3].y - points[1].y) * (points[0].x - points[1].x)) * rd;
+			float sn = ((points[2].x - points[0].x) * (points[0].y - points[1].y) - (points[2].y - points[0].y) * (points[0].x - points[1].x)) * rd;
+
+			Vector2f center;
+
+			if (rn >= 0.0f && rn <= 1.0f && sn >= 0.0f && sn <= 1.0f)
+				center = points[0] + rn * (points[2] - points[0]);
+
+			float d[4];
+
+			for (int i = 0; i < 4; i++)
+				d[i] = (points[i] - center).Length();
+
+			const Vector2f& inv = m_Engine->m_Window->GetInvertedScreenSize();
+
+			for (int i = 0; i < 4; i++)
+			{
+				float q = d[i] == 0.0f ? 1.0f : (d[i] + d[(i + 2) & 3]) / d[(i + 2) & 3];
+				texInst.uv[i] *= q;
+				texInst.vertices[i] = { points[i].x * inv.x * 2.0f - 1.0f, 1.0f - points[i].y * inv.y * 2.0f };
+			}
+
+			Submit(std::move(texInst));
+		}
+	}
+
+	void DrawContext::SetDrawTarget(Graphic* target)
+	{
+		if (m_Layer)
+			m_Layer->target = target ? target : m_Layer->pixels;
+		else
+			m_Target = target;
+	}
+
+	Graphic* DrawContext::GetDrawTarget() const
+	{
+		Graphic* target = m_Layer ? m_Layer->target : m_Target;
+		return target && target->sprite ? target : nullptr;
+	}
+
+	void DrawContext::SetTextureTarget(RenderTarget* target)
+	{
+		m_TextureTarget = target;
+	}
+
+	RenderTarget* DrawContext::GetTextureTarget() const
+	{
+		return m_TextureTarget;
+	}
+
+	void DrawContext::SetDrawList(DrawList* list)
+	{
+		m_DrawList = list;
+	}
+
+	DrawList* DrawContext::GetDrawList() const
+	{
+		return m_DrawList;
+	}
+
+	void DrawContext::SetTextureDepth(float depth)
+	{
+		m_TextureDepth = depth;
+	}
+
+	float DrawContext::GetTextureDepth() const
+	{
+		return m_TextureDepth;
+	}
+
+	void DrawContext::SetPixelMode(Pixel::Mode pixelMode)
+	{
+		(m_Layer ? m_Layer->pixelMode : m_PixelMode) = pixelMode;
+	}
+
+	Pixel::Mode DrawContext::GetPixelMode() const
+	{
+		return m_Layer ? m_Layer->pixelMode : m_PixelMode;
+	}
+
+	void DrawContext::SetShader(Shader shader)
+	{
+		(m_Layer ? m_Layer->shader : m_Shader) = shader;
+		SetPixelMode(shader ? Pixel::Mode::CUSTOM : Pixel::Mode::DEFAULT);
+	}
+
+	DrawContext::Shader DrawContext::GetShader() const
+	{
+		return m_Layer ? m_Layer->shader : m_Shader;
+	}
+
+	void DrawContext::SetTextureStructure(Texture::Structure textureStructure)
+	{
+		(m_Layer ? m_Layer->textureStructure : m_TextureStructure) = textureStructure;
+	}
+
+	Texture::Structure DrawContext::GetTextureStructure() const
+	{
+		return m_Layer ? m_Layer->textureStructure : m_TextureStructure;
+	}
+
+	Layer* DrawContext::GetLayer() const
+	{
+		return m_Layer;
+	}
+}
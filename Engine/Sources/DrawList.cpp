@@ -0,0 +1,223 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "DrawList.hpp"
+#include "Platform.hpp"
+
+namespace def
+{
+	DrawList::DrawList(Platform* platform) : m_Platform(platform)
+	{
+		m_IsCompiled = true;
+		m_IsBaked = false;
+
+		m_Buffer = 0;
+		m_IsUploaded = false;
+	}
+
+	DrawList::~DrawList()
+	{
+		m_Platform->DestroyDrawList(*this);
+	}
+
+	void DrawList::Clear()
+	{
+		m_Textures.clear();
+
+		m_Vertices.clear();
+		m_Batches.clear();
+
+		m_IsCompiled = true;
+		m_IsBaked = false;
+		m_IsUploaded = false;
+	}
+
+	void DrawList::Add(TextureInstance&& texInst)
+	{
+		if (texInst.vertices.empty())
+			return;
+
+		if (IsEmpty())
+		{
+			m_Min = texInst.vertices[0];
+			m_Max = texInst.vertices[0];
+		}
+
+		for (const auto& vertex : texInst.vertices)
+		{
+			m_Min = m_Min.Min(vertex);
+			m_Max = m_Max.Max(vertex);
+		}
+
+		m_Textures.push_back(std::move(texInst));
+
+		m_IsCompiled = false;
+		m_IsBaked = false;
+		m_IsUploaded = false;
+	}
+
+	bool DrawList::IsEmpty() const
+	{
+		return m_Textures.empty() && m_Vertices.empty();
+	}
+
+	const Vector2f& DrawList::GetMin() const
+	{
+		return m_Min;
+	}
+
+	const Vector2f& DrawList::GetMax() const
+	{
+		return m_Max;
+	}
+
+	const std::vector<DrawList::Vertex>& DrawList::GetVertices() const
+	{
+		Compile();
+		return m_Vertices;
+	}
+
+	const std::vector<DrawList::Batch>& DrawList::GetBatches() const
+	{
+		Compile();
+		return m_Batches;
+	}
+
+	const std::vector<DrawList::Vertex>& DrawList::Bake(const Vector2f& offset, const Vector2f& scale, const Pixel& tint, bool& changed) const
+	{
+		Compile();
+
+		changed = !m_IsBaked || offset != m_BakedOffset || scale != m_BakedScale || tint != m_BakedTint;
+
+		if (!changed)
+			return m_Baked;
+
+		m_Baked.resize(m_Vertices.size());
+
+		for (size_t i = 0; i < m_Vertices.size(); i++)
+		{
+			const Vertex& source = m_Vertices[i];
+			Vertex& baked = m_Baked[i];
+
+			baked.pos = source.pos * scale + offset;
+			baked.uv = source.uv;
+
+			for (int j = 0; j < 4; j++)
+				baked.col.rgba_v[j] = uint8_t((source.col.rgba_v[j] * tint.rgba_v[j] + 127) / 255);
+		}
+
+		m_BakedOffset = offset;
+		m_BakedScale = scale;
+		m_BakedTint = tint;
+
+		m_IsBaked = true;
+		m_IsUploaded = false;
+
+		return m_Baked;
+	}
+
+	void DrawList::Compile() const
+	{
+		if (m_IsCompiled)
+			return;
+
+		// The textures that were added after the last compilation are appended
+
+		for (const auto& texInst : m_Textures)
+		{
+			bool lines =
+				texInst.structure == Texture::Structure::LINES ||
+				texInst.structure == Texture::Structure::LINE_STRIP ||
+				texInst.structure == Texture::Structure::WIREFRAME;
+
+			if (m_Batches.empty() || m_Batches.back().texture != texInst.texture || m_Batches.back().lines != lines)
+			{
+				Batch batch;
+				batch.texture = texInst.texture;
+				batch.lines = lines;
+				batch.first = (uint32_t)m_Vertices.size();
+
+				m_Batches.push_back(batch);
+			}
+
+			auto Add = [&](uint32_t index)
+				{
+					Vertex vertex;
+					vertex.pos = texInst.vertices[index];
+					vertex.uv = texInst.texture ? texInst.uv[index] : Vector2f(0.0f, 0.0f);
+					vertex.col = texInst.tint[index];
+
+					m_Vertices.push_back(vertex);
+				};
+
+			uint32_t points = texInst.points;
+
+			switch (texInst.structure)
+			{
+			case Texture::Structure::DEFAULT:
+			{
+				for (uint32_t i = 0; i + 2 < points; i += 3)
+				{
+					Add(i); Add(i + 1); Add(i + 2);
+				}
+			}
+			break;
+
+			case Texture::Structure::TRIANGLE_FAN:
+			{
+				for (uint32_t i = 1; i + 1 < points; i++)
+				{
+					Add(0); Add(i); Add(i + 1);
+				}
+			}
+			break;
+
+			case Texture::Structure::TRIANGLE_STRIP:
+			{
+				for (uint32_t i = 0; i + 2 < points; i++)
+				{
+					Add(i); Add(i + 1); Add(i + 2);
+				}
+			}
+			break;
+
+			case Texture::Structure::LINES:
+			{
+				for (uint32_t i = 0; i + 1 < points; i += 2)
+				{
+					Add(i); Add(i + 1);
+				}
+			}
+			break;
+
+			case Texture::Structure::LINE_STRIP:
+			case Texture::Structure::WIREFRAME:
+			{
+				for (uint32_t i = 0; i + 1 < points; i++)
+				{
+					Add(i); Add(i + 1);
+				}
+
+				if (texInst.structure == Texture::Structure::WIREFRAME && points > 2)
+				{
+					Add(points - 1); Add(0);
+				}
+			}
+			break;
+
+			}
+
+			m_Batches.back().count = (uint32_t)m_Vertices.size() - m_Batches.back().first;
+		}
+
+		// The textures aren't needed anymore
+		m_Textures.clear();
+		m_Textures.shrink_to_fit();
+
+		m_IsCompiled = true;
+	}
+}
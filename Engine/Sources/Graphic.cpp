@@ -44,6 +44,6 @@ namespace def
 
 	void Graphic::UpdateTexture(const Vector2i& customSize)
 	{
-		texture->Update(sprite, customSize);
+		texture->Update(sprite, { 0.0f, 0.0f }, customSize);
 	}
 }
@@ -0,0 +1,333 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "Image.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+
+namespace def
+{
+	template <class T>
+	ImageView<T>::ImageView(T* pixels, const Vector2i& size, int stride) : pixels(pixels), size(size), stride(stride)
+	{
+
+	}
+
+	template <class T>
+	ImageView<T> ImageView<T>::GetView(const Vector2i& pos, const Vector2i& size) const
+	{
+		Vector2i start = pos.Max({ 0, 0 });
+		Vector2i end = (pos + size).Min(this->size);
+
+		if (end.x <= start.x || end.y <= start.y)
+			return ImageView();
+
+		return ImageView(GetRow(start.y) + start.x, end - start, stride);
+	}
+
+	template <class T>
+	bool ImageView<T>::SetPixel(int x, int y, const Value& col) const requires (!std::is_const_v<T>)
+	{
+		if (x >= 0 && y >= 0 && x < size.x && y < size.y)
+		{
+			GetRow(y)[x] = col;
+			return true;
+		}
+
+		return false;
+	}
+
+	template <class T>
+	typename ImageView<T>::Value ImageView<T>::GetPixel(int x, int y, const WrapMethod wrap) const
+	{
+		auto GetPixel = [&](int x, int y)
+			{
+				return GetRow(y)[x];
+			};
+
+		switch (wrap)
+		{
+		case WrapMethod::NONE:
+		{
+			if (x >= 0 && y >= 0 && x < size.x && y < size.y)
+				return GetPixel(x, y);
+		}
+		break;
+
+		case WrapMethod::REPEAT:
+			return GetPixel(abs(x) % size.x, abs(y) % size.y);
+
+		case WrapMethod::MIRROR:
+		{
+			int mx = (x < 0) ? size.x - 1 - abs(x) % size.x : abs(x) % size.x;
+			int my = (y < 0) ? size.y - 1 - abs(y) % size.y : abs(y) % size.y;
+
+			return GetPixel(mx, my);
+		}
+
+		case WrapMethod::CLAMP:
+		{
+			int cx = std::clamp(x, 0, size.x - 1);
+			int cy = std::clamp(y, 0, size.y - 1);
+
+			return GetPixel(cx, cy);
+		}
+
+		}
+
+		if constexpr (std::is_same_v<Value, Pixel>)
+			return BLACK;
+		else
+			return Value();
+	}
+
+	template <class T>
+	typename ImageView<T>::Value ImageView<T>::GetPixel(const Vector2i& pos, const WrapMethod wrap) const
+	{
+		return GetPixel(pos.x, pos.y, wrap);
+	}
+
+	template <class T>
+	typename ImageView<T>::Value ImageView<T>::Sample(const Vector2f& pos, const SampleMethod sample, const WrapMethod wrap) const
+	{
+		using Traits = PixelTraits<Value>;
+
+		// We want a position to be size invariant
+		// so lets use normalised coordinates
+		Vector2f denorm = pos * Vector2f(size);
+
+		if constexpr (std::is_same_v<Value, Pixel>)
+		{
+			if (sample == SampleMethod::TRILINEAR)
+			{
+				// Using Catmull-Rom splines as the basis functions
+
+				Vector2i center = (denorm - Vector2f(0.5f, 0.5f)).Floor();
+				Vector2f offset = denorm - Vector2f(0.5f, 0.5f) - Vector2f(center);
+
+				struct Pixelf
+				{
+					float r = 0.0f;
+					float g = 0.0f;
+					float b = 0.0f;
+					float a = 0.0f;
+				};
+
+				Pixelf splineX[4][4];
+
+				Vector2i s;
+				for (s.y = 0; s.y < 4; s.y++)
+					for (s.x = 0; s.x < 4; s.x++)
+					{
+						Pixel p = GetPixel(center + s - 1, wrap);
+						splineX[s.y][s.x] = { (float)p.r, (float)p.g, (float)p.b, (float)p.a };
+					}
+
+				Vector2f t = offset;
+				Vector2f tt = t * t;
+				Vector2f ttt = tt * tt;
+
+				Vector2f q[4];
+				q[0] = 0.5f * (-1.0f * ttt + 2.0f * tt - t);
+				q[1] = 0.5f * (3.0f * ttt - 5.0f * tt + 2.0f);
+				q[2] = 0.5f * (-3.0f * ttt + 4.0f * tt + t);
+				q[3] = 0.5f * (ttt - tt);
+
+				Pixelf splineY[4];
+
+				for (int i = 0; i < 4; i++)
+					for (int j = 0; j < 4; j++)
+					{
+						splineY[i].r += splineX[i][j].r * q[j].x;
+						splineY[i].g += splineX[i][j].g * q[j].x;
+						splineY[i].b += splineX[i][j].b * q[j].x;
+						splineY[i].a += splineX[i][j].a * q[j].x;
+					}
+
+				Pixelf pix;
+				for (int i = 0; i < 4; i++)
+				{
+					pix.r += splineY[i].r * q[i].y;
+					pix.g += splineY[i].g * q[i].y;
+					pix.b += splineY[i].b * q[i].y;
+					pix.a += splineY[i].a * q[i].y;
+				}
+
+				return Pixel(
+					ClampFloatToUint8(pix.r),
+					ClampFloatToUint8(pix.g),
+					ClampFloatToUint8(pix.b),
+					ClampFloatToUint8(pix.a)
+				);
+			}
+		}
+
+		if (sample == SampleMethod::LINEAR)
+			return GetPixel(denorm, wrap);
+
+		Vector2i cell = denorm.Floor();
+		Vector2f offset = denorm - cell;
+
+		Value tl = GetPixel(cell + Vector2i(0, 0), wrap);
+		Value tr = GetPixel(cell + Vector2i(1, 0), wrap);
+		Value bl = GetPixel(cell + Vector2i(0, 1), wrap);
+		Value br = GetPixel(cell + Vector2i(1, 1), wrap);
+
+		// Firstly interpolate along top border
+		Value topCol = Traits::Lerp(tl, tr, offset.x);
+
+		// Now interpolate along bottom border
+		Value bottomCol = Traits::Lerp(bl, br, offset.x);
+
+		// Now interpolate between top and bottom borders
+		return Traits::Lerp(topCol, bottomCol, offset.y);
+	}
+
+	template <class T>
+	Image<T>::Image(const Vector2i& size)
+	{
+		Create(size);
+	}
+
+	template <class T>
+	Image<T>::Image(const ImageView<const T>& view)
+	{
+		Create(view.size);
+
+		for (int y = 0; y < size.y; y++)
+			std::copy(view.GetRow(y), view.GetRow(y) + size.x, GetRow(y));
+	}
+
+	template <class T>
+	void Image<T>::Create(const Vector2i& size, int stride)
+	{
+		Assert(size.x > 0 && size.y > 0, "[Image.Create Error] Width and height should be > 0");
+		Assert(stride == 0 || stride >= size.x, "[Image.Create Error] Stride should be >= width");
+
+		pixels.clear();
+		this->size = size;
+		this->stride = stride == 0 ? size.x : stride;
+
+		T col;
+
+		if constexpr (std::is_same_v<T, Pixel>)
+			col = BLACK;
+
+		pixels.resize((size_t)this->stride * size.y);
+		std::fill(pixels.begin(), pixels.end(), col);
+	}
+
+	template <class T>
+	int Image<T>::GetAlignedStride(int width)
+	{
+		constexpr int PIXELS_PER_LINE = 64 / sizeof(T);
+		return (width + PIXELS_PER_LINE - 1) / PIXELS_PER_LINE * PIXELS_PER_LINE;
+	}
+
+	template <class T>
+	ImageView<T> Image<T>::GetView()
+	{
+		return ImageView<T>(pixels.data(), size, stride);
+	}
+
+	template <class T>
+	ImageView<const T> Image<T>::GetView() const
+	{
+		return ImageView<const T>(pixels.data(), size, stride);
+	}
+
+	template <class T>
+	ImageView<T> Image<T>::GetView(const Vector2i& pos, const Vector2i& size)
+	{
+		return GetView().GetView(pos, size);
+	}
+
+	template <class T>
+	ImageView<const T> Image<T>::GetView(const Vector2i& pos, const Vector2i& size) const
+	{
+		return GetView().GetView(pos, size);
+	}
+
+	template <class T>
+	Image<T>::operator ImageView<T>()
+	{
+		return GetView();
+	}
+
+	template <class T>
+	Image<T>::operator ImageView<const T>() const
+	{
+		return GetView();
+	}
+
+	template <class T>
+	bool Image<T>::SetPixel(int x, int y, const T& col)
+	{
+		return GetView().SetPixel(x, y, col);
+	}
+
+	template <class T>
+	bool Image<T>::SetPixel(const Vector2i& pos, const T& col)
+	{
+		return SetPixel(pos.x, pos.y, col);
+	}
+
+	template <class T>
+	T Image<T>::GetPixel(int x, int y, const WrapMethod wrap) const
+	{
+		return GetView().GetPixel(x, y, wrap);
+	}
+
+	template <class T>
+	T Image<T>::GetPixel(const Vector2i& pos, const WrapMethod wrap) const
+	{
+		return GetPixel(pos.x, pos.y, wrap);
+	}
+
+	template <class T>
+	void Image<T>::SetPixelData(const T& col)
+	{
+		std::fill(pixels.begin(), pixels.end(), col);
+	}
+
+	template <class T>
+	T Image<T>::Sample(float x, float y, const SampleMethod sample, const WrapMethod wrap) const
+	{
+		return Sample({ x, y }, sample, wrap);
+	}
+
+	template <class T>
+	T Image<T>::Sample(const Vector2f& pos, const SampleMethod sample, const WrapMethod wrap) const
+	{
+		return GetView().Sample(pos, sample, wrap);
+	}
+
+	template struct ImageView<PixelR8>;
+	template struct ImageView<const PixelR8>;
+	template class Image<PixelR8>;
+
+	template struct ImageView<PixelRG8>;
+	template struct ImageView<const PixelRG8>;
+	template class Image<PixelRG8>;
+
+	template struct ImageView<Pixel>;
+	template struct ImageView<const Pixel>;
+	template class Image<Pixel>;
+
+	template struct ImageView<PixelR16>;
+	template struct ImageView<const PixelR16>;
+	template class Image<PixelR16>;
+
+	template struct ImageView<PixelR32F>;
+	template struct ImageView<const PixelR32F>;
+	template class Image<PixelR32F>;
+
+	template struct ImageView<PixelIndex8>;
+	template struct ImageView<const PixelIndex8>;
+	template class Image<PixelIndex8>;
+}
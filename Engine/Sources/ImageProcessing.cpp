@@ -0,0 +1,808 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "ImageProcessing.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DGE_IMAGE_PROCESSING_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define DGE_IMAGE_PROCESSING_NEON
+#endif
+
+namespace def
+{
+	// RGBA of one pixel as 4 floats in a single register
+	struct Colour4
+	{
+	#if defined(DGE_IMAGE_PROCESSING_SSE2)
+		__m128 v;
+
+		static inline Colour4 Zero() { return { _mm_setzero_ps() }; }
+		static inline Colour4 Load(const float* src) { return { _mm_loadu_ps(src) }; }
+
+		static inline Colour4 Load(const Pixel& p)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)p.rgba_n), zero), zero);
+			return { _mm_cvtepi32_ps(x) };
+		}
+
+		inline void Store(float* dst) const { _mm_storeu_ps(dst, v); }
+
+		// Rounds to the nearest and saturates
+		inline Pixel ToPixel() const
+		{
+			__m128i x = _mm_cvtps_epi32(v);
+			x = _mm_packs_epi32(x, x);
+			return Pixel((uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(x, x)));
+		}
+
+		inline void MulAdd(const Colour4& c, float w) { v = _mm_add_ps(v, _mm_mul_ps(c.v, _mm_set1_ps(w))); }
+	#elif defined(DGE_IMAGE_PROCESSING_NEON)
+		float32x4_t v;
+
+		static inline Colour4 Zero() { return { vdupq_n_f32(0.0f) }; }
+		static inline Colour4 Load(const float* src) { return { vld1q_f32(src) }; }
+
+		static inline Colour4 Load(const Pixel& p)
+		{
+			uint16x8_t x = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p.rgba_n)));
+			return { vcvtq_f32_u32(vmovl_u16(vget_low_u16(x))) };
+		}
+
+		inline void Store(float* dst) const { vst1q_f32(dst, v); }
+
+		inline Pixel ToPixel() const
+		{
+			int32x4_t x = vcvtq_s32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)));
+			uint8x8_t b = vqmovn_u16(vcombine_u16(vqmovun_s32(x), vdup_n_u16(0)));
+			return Pixel(vget_lane_u32(vreinterpret_u32_u8(b), 0));
+		}
+
+		inline void MulAdd(const Colour4& c, float w) { v = vmlaq_n_f32(v, c.v, w); }
+	#else
+		float v[4];
+
+		static inline Colour4 Zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+		static inline Colour4 Load(const float* src) { return { { src[0], src[1], src[2], src[3] } }; }
+		static inline Colour4 Load(const Pixel& p) { return { { (float)p.r, (float)p.g, (float)p.b, (float)p.a } }; }
+
+		inline void Store(float* dst) const { std::memcpy(dst, v, sizeof(v)); }
+
+		inline Pixel ToPixel() const
+		{
+			uint8_t c[4];
+
+			for (int i = 0; i < 4; i++)
+				c[i] = (uint8_t)std::clamp((int)std::lrintf(v[i]), 0, 255);
+
+			return Pixel(c[0], c[1], c[2], c[3]);
+		}
+
+		inline void MulAdd(const Colour4& c, float w)
+		{
+			for (int i = 0; i < 4; i++)
+				v[i] += c.v[i] * w;
+		}
+	#endif
+	};
+
+	// Weights of the source pixels for each destination pixel along one axis,
+	// the source pixels of each destination pixel are consecutive
+	struct Contributions
+	{
+		std::vector<int> first;
+		std::vector<int> count;
+		std::vector<int> offset;
+		std::vector<float> weights;
+
+		// Normalises the weights of the source pixels [left, right) and adds them
+		template <class Kernel>
+		void Add(int left, int right, Kernel&& kernel)
+		{
+			first.push_back(left);
+			count.push_back(right - left);
+			offset.push_back((int)weights.size());
+
+			float sum = 0.0f;
+
+			for (int i = left; i < right; i++)
+			{
+				weights.push_back(kernel(i));
+				sum += weights.back();
+			}
+
+			if (sum != 0.0f)
+			{
+				for (int i = 0; i < right - left; i++)
+					weights[offset.back() + i] /= sum;
+			}
+		}
+	};
+
+	template <class Func>
+	static void ForEachRow(ThreadPool* pool, int rows, int rowLength, Func&& func)
+	{
+		if (pool)
+		{
+			// Enough rows per task to make the scheduling cost negligible
+			pool->ParallelFor(0, rows, func, std::max(1, 16384 / std::max(rowLength, 1)));
+		}
+		else
+		{
+			for (int y = 0; y < rows; y++)
+				func(y);
+		}
+	}
+
+	static float Sinc(float x)
+	{
+		if (x == 0.0f)
+			return 1.0f;
+
+		x *= 3.14159265f;
+		return sinf(x) / x;
+	}
+
+	static Contributions MakeResizeContributions(int srcSize, int dstSize, ImageProcessing::Filter filter)
+	{
+		float support;
+
+		switch (filter)
+		{
+		case ImageProcessing::Filter::BOX: support = 0.5f; break;
+		case ImageProcessing::Filter::BILINEAR: support = 1.0f; break;
+		default: support = 3.0f;
+		}
+
+		float scale = (float)srcSize / (float)dstSize;
+
+		// When shrinking the filter is stretched to cover all source pixels
+		float filterScale = std::max(scale, 1.0f);
+		support *= filterScale;
+
+		Contributions contributions;
+
+		for (int i = 0; i < dstSize; i++)
+		{
+			float centre = ((float)i + 0.5f) * scale;
+
+			int left = std::max((int)floorf(centre - support), 0);
+			int right = std::min((int)ceilf(centre + support), srcSize);
+
+			auto kernel = [&](int j)
+				{
+					float x = ((float)j + 0.5f - centre) / filterScale;
+
+					switch (filter)
+					{
+					case ImageProcessing::Filter::BOX: return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+					case ImageProcessing::Filter::BILINEAR: return std::max(1.0f - fabsf(x), 0.0f);
+					default: return (fabsf(x) < 3.0f) ? Sinc(x) * Sinc(x / 3.0f) : 0.0f;
+					}
+				};
+
+			float sum = 0.0f;
+
+			for (int j = left; j < right; j++)
+				sum += kernel(j);
+
+			// The box can miss every pixel centre when enlarging, so the nearest pixel is taken
+			if (sum == 0.0f)
+			{
+				int nearest = std::clamp((int)centre, 0, srcSize - 1);
+				contributions.Add(nearest, nearest + 1, [](int) { return 1.0f; });
+			}
+			else
+				contributions.Add(left, right, kernel);
+		}
+
+		return contributions;
+	}
+
+	static Contributions MakeBlurContributions(int size, float sigma)
+	{
+		int radius = (int)ceilf(sigma * 3.0f);
+
+		std::vector<float> kernel(radius * 2 + 1);
+
+		for (int i = -radius; i <= radius; i++)
+			kernel[i + radius] = expf(-(float)(i * i) / (2.0f * sigma * sigma));
+
+		Contributions contributions;
+
+		for (int i = 0; i < size; i++)
+		{
+			int left = std::max(i - radius, 0);
+			int right = std::min(i + radius + 1, size);
+
+			// The taps outside of the image are added to the edge pixels
+			contributions.Add(left, right,
+				[&](int j)
+				{
+					float weight = kernel[j - i + radius];
+
+					if (j == 0)
+					{
+						for (int k = i - radius; k < 0; k++)
+							weight += kernel[k - i + radius];
+					}
+
+					if (j == size - 1)
+					{
+						for (int k = size; k <= i + radius; k++)
+							weight += kernel[k - i + radius];
+					}
+
+					return weight;
+				});
+		}
+
+		return contributions;
+	}
+
+	// Filters the rows and then the columns. The destination is processed in bands of rows
+	// and only the source rows of a band are kept filtered in floats, so they stay in the cache
+	static void Resample(const ConstSpriteView& src, Sprite& dst, const Contributions& horizontal, const Contributions& vertical, ThreadPool* pool)
+	{
+		constexpr int BAND_HEIGHT = 16;
+
+		int width = dst.size.x;
+		int bands = (dst.size.y + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+		ForEachRow(pool, bands, width * BAND_HEIGHT,
+			[&](int band)
+			{
+				int bandStart = band * BAND_HEIGHT;
+				int bandEnd = std::min(bandStart + BAND_HEIGHT, dst.size.y);
+
+				int firstRow = src.size.y, lastRow = 0;
+
+				for (int y = bandStart; y < bandEnd; y++)
+				{
+					firstRow = std::min(firstRow, vertical.first[y]);
+					lastRow = std::max(lastRow, vertical.first[y] + vertical.count[y]);
+				}
+
+				thread_local std::vector<float> rows;
+				rows.resize((size_t)(lastRow - firstRow) * width * 4);
+
+				// Two rows at once give two independent sums, the additions take longer than they're issued
+				for (int y = firstRow; y < lastRow; y += 2)
+				{
+					bool pair = y + 1 < lastRow;
+
+					const Pixel* srcRow1 = src.GetRow(y);
+					const Pixel* srcRow2 = pair ? src.GetRow(y + 1) : srcRow1;
+
+					float* tmpRow1 = rows.data() + (size_t)(y - firstRow) * width * 4;
+					float* tmpRow2 = tmpRow1 + width * 4;
+
+					for (int x = 0; x < width; x++)
+					{
+						const float* weights = horizontal.weights.data() + horizontal.offset[x];
+						int first = horizontal.first[x];
+
+						Colour4 sum1 = Colour4::Zero();
+						Colour4 sum2 = Colour4::Zero();
+
+						for (int i = 0; i < horizontal.count[x]; i++)
+						{
+							sum1.MulAdd(Colour4::Load(srcRow1[first + i]), weights[i]);
+							sum2.MulAdd(Colour4::Load(srcRow2[first + i]), weights[i]);
+						}
+
+						sum1.Store(tmpRow1 + x * 4);
+
+						if (pair)
+							sum2.Store(tmpRow2 + x * 4);
+					}
+				}
+
+				for (int y = bandStart; y < bandEnd; y++)
+				{
+					const float* weights = vertical.weights.data() + vertical.offset[y];
+					const float* tmpRows = rows.data() + (size_t)(vertical.first[y] - firstRow) * width * 4;
+
+					Pixel* dstRow = dst.GetRow(y);
+
+					int x = 0;
+
+					for (; x + 4 <= width; x += 4)
+					{
+						Colour4 sum[4] = { Colour4::Zero(), Colour4::Zero(), Colour4::Zero(), Colour4::Zero() };
+
+						for (int i = 0; i < vertical.count[y]; i++)
+						{
+							const float* colours = tmpRows + ((size_t)i * width + x) * 4;
+
+							for (int j = 0; j < 4; j++)
+								sum[j].MulAdd(Colour4::Load(colours + j * 4), weights[i]);
+						}
+
+						for (int j = 0; j < 4; j++)
+							dstRow[x + j] = sum[j].ToPixel();
+					}
+
+					for (; x < width; x++)
+					{
+						Colour4 sum = Colour4::Zero();
+
+						for (int i = 0; i < vertical.count[y]; i++)
+							sum.MulAdd(Colour4::Load(tmpRows + ((size_t)i * width + x) * 4), weights[i]);
+
+						dstRow[x] = sum.ToPixel();
+					}
+				}
+			});
+	}
+
+	// Rounded x / 255 for x in [0, 255 * 255]
+	static inline uint32_t Div255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+#if defined(DGE_IMAGE_PROCESSING_SSE2)
+	static inline __m128i Div255_SSE2(__m128i x)
+	{
+		x = _mm_add_epi16(x, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	// (p3, p2, p1, p0)
+	static inline __m128i Reverse_SSE2(__m128i x)
+	{
+		return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+	}
+#elif defined(DGE_IMAGE_PROCESSING_NEON)
+	static inline uint8x8_t Div255_NEON(uint16x8_t x)
+	{
+		x = vaddq_u16(x, vdupq_n_u16(128));
+		return vshrn_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+	}
+
+	static inline uint32x4_t Reverse_NEON(uint32x4_t x)
+	{
+		x = vrev64q_u32(x);
+		return vextq_u32(x, x, 2);
+	}
+#endif
+
+	// Writes the columns of a 4x4 block of src as the rows of dst, each row is reversed
+	// if reverse is true. A negative stride of dst writes the rows from the bottom up
+	static inline void TransposeBlock(const Pixel* src, ptrdiff_t srcStride, Pixel* dst, ptrdiff_t dstStride, bool reverse)
+	{
+	#if defined(DGE_IMAGE_PROCESSING_SSE2)
+		__m128i r0 = _mm_loadu_si128((const __m128i*)(src));
+		__m128i r1 = _mm_loadu_si128((const __m128i*)(src + srcStride));
+		__m128i r2 = _mm_loadu_si128((const __m128i*)(src + srcStride * 2));
+		__m128i r3 = _mm_loadu_si128((const __m128i*)(src + srcStride * 3));
+
+		__m128i t0 = _mm_unpacklo_epi32(r0, r1);
+		__m128i t1 = _mm_unpacklo_epi32(r2, r3);
+		__m128i t2 = _mm_unpackhi_epi32(r0, r1);
+		__m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+		__m128i c[4] =
+		{
+			_mm_unpacklo_epi64(t0, t1),
+			_mm_unpackhi_epi64(t0, t1),
+			_mm_unpacklo_epi64(t2, t3),
+			_mm_unpackhi_epi64(t2, t3)
+		};
+
+		for (int i = 0; i < 4; i++)
+			_mm_storeu_si128((__m128i*)(dst + dstStride * i), reverse ? Reverse_SSE2(c[i]) : c[i]);
+	#elif defined(DGE_IMAGE_PROCESSING_NEON)
+		uint32x4_t r0 = vld1q_u32((const uint32_t*)(src));
+		uint32x4_t r1 = vld1q_u32((const uint32_t*)(src + srcStride));
+		uint32x4_t r2 = vld1q_u32((const uint32_t*)(src + srcStride * 2));
+		uint32x4_t r3 = vld1q_u32((const uint32_t*)(src + srcStride * 3));
+
+		uint32x4x2_t t01 = vtrnq_u32(r0, r1);
+		uint32x4x2_t t23 = vtrnq_u32(r2, r3);
+
+		uint32x4_t c[4] =
+		{
+			vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])),
+			vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])),
+			vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])),
+			vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]))
+		};
+
+		for (int i = 0; i < 4; i++)
+			vst1q_u32((uint32_t*)(dst + dstStride * i), reverse ? Reverse_NEON(c[i]) : c[i]);
+	#else
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+				dst[dstStride * i + (reverse ? 3 - j : j)] = src[srcStride * j + i];
+		}
+	#endif
+	}
+
+	// Returns true if the view points into the pixels of the sprite,
+	// then the sprite can't be created again while the view is read
+	static bool IsViewOf(const ConstSpriteView& view, const Sprite& sprite)
+	{
+		const Pixel* begin = sprite.pixels.data();
+		const Pixel* end = begin + sprite.pixels.size();
+
+		return std::less_equal<const Pixel*>()(begin, view.pixels) && std::less<const Pixel*>()(view.pixels, end);
+	}
+
+	// Clips the rectangle to both views, returns false if nothing is left
+	static bool ClipRectangle(const ConstSpriteView& src, Vector2i& srcPos, Vector2i& size, const ConstSpriteView& dst, Vector2i& dstPos)
+	{
+		for (int axis = 0; axis < 2; axis++)
+		{
+			int& s = axis == 0 ? srcPos.x : srcPos.y;
+			int& d = axis == 0 ? dstPos.x : dstPos.y;
+			int& n = axis == 0 ? size.x : size.y;
+
+			int skip = std::max({ 0, -s, -d });
+
+			s += skip;
+			d += skip;
+			n -= skip;
+
+			n = std::min({ n, (axis == 0 ? src.size.x : src.size.y) - s, (axis == 0 ? dst.size.x : dst.size.y) - d });
+
+			if (n <= 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool ImageProcessing::Resize(const ConstSpriteView& src, Sprite& dst, const Vector2i& size, Filter filter, ThreadPool* pool)
+	{
+		if (IsViewOf(src, dst) || src.IsEmpty() || size.x <= 0 || size.y <= 0)
+			return false;
+
+		dst.Create(size);
+
+		Resample(src, dst,
+			MakeResizeContributions(src.size.x, size.x, filter),
+			MakeResizeContributions(src.size.y, size.y, filter), pool);
+
+		return true;
+	}
+
+	bool ImageProcessing::Blur(const ConstSpriteView& src, Sprite& dst, float sigma, ThreadPool* pool)
+	{
+		if (IsViewOf(src, dst) || src.IsEmpty())
+			return false;
+
+		if (sigma <= 0.0f)
+		{
+			dst = Sprite(src);
+			return true;
+		}
+
+		dst.Create(src.size);
+
+		Resample(src, dst,
+			MakeBlurContributions(src.size.x, sigma),
+			MakeBlurContributions(src.size.y, sigma), pool);
+
+		return true;
+	}
+
+	bool ImageProcessing::Convolve(const ConstSpriteView& src, Sprite& dst, std::span<const float> kernel, const Vector2i& kernelSize, ThreadPool* pool)
+	{
+		if (IsViewOf(src, dst) || src.IsEmpty() || kernelSize.x <= 0 || kernelSize.y <= 0 || kernel.size() < size_t(kernelSize.x * kernelSize.y))
+			return false;
+
+		dst.Create(src.size);
+
+		Vector2i centre = kernelSize / 2;
+		Vector2i size = src.size;
+
+		ForEachRow(pool, size.y, size.x * kernelSize.x * kernelSize.y,
+			[&](int y)
+			{
+				Pixel* dstRow = dst.GetRow(y);
+
+				for (int x = 0; x < size.x; x++)
+				{
+					Colour4 sum = Colour4::Zero();
+
+					// The clamping is needed only near the edges
+					bool inside = x >= centre.x && y >= centre.y &&
+						x - centre.x + kernelSize.x <= size.x && y - centre.y + kernelSize.y <= size.y;
+
+					for (int ky = 0; ky < kernelSize.y; ky++)
+					{
+						const float* weights = kernel.data() + ky * kernelSize.x;
+
+						if (inside)
+						{
+							const Pixel* srcRow = src.GetRow(y - centre.y + ky) + x - centre.x;
+
+							for (int kx = 0; kx < kernelSize.x; kx++)
+								sum.MulAdd(Colour4::Load(srcRow[kx]), weights[kx]);
+						}
+						else
+						{
+							int sy = std::clamp(y - centre.y + ky, 0, size.y - 1);
+							const Pixel* srcRow = src.GetRow(sy);
+
+							for (int kx = 0; kx < kernelSize.x; kx++)
+								sum.MulAdd(Colour4::Load(srcRow[std::clamp(x - centre.x + kx, 0, size.x - 1)]), weights[kx]);
+						}
+					}
+
+					dstRow[x] = sum.ToPixel();
+				}
+			});
+
+		return true;
+	}
+
+	void ImageProcessing::FlipHorizontally(const SpriteView& sprite, ThreadPool* pool)
+	{
+		ForEachRow(pool, sprite.size.y, sprite.size.x,
+			[&](int y)
+			{
+				Pixel* row = sprite.GetRow(y);
+
+				// 4 pixels from both ends are reversed and swapped until they meet
+				int left = 0, right = sprite.size.x;
+
+			#if defined(DGE_IMAGE_PROCESSING_SSE2)
+				for (; right - left >= 8; left += 4, right -= 4)
+				{
+					__m128i l = _mm_loadu_si128((const __m128i*)(row + left));
+					__m128i r = _mm_loadu_si128((const __m128i*)(row + right - 4));
+
+					_mm_storeu_si128((__m128i*)(row + left), Reverse_SSE2(r));
+					_mm_storeu_si128((__m128i*)(row + right - 4), Reverse_SSE2(l));
+				}
+			#elif defined(DGE_IMAGE_PROCESSING_NEON)
+				for (; right - left >= 8; left += 4, right -= 4)
+				{
+					uint32x4_t l = vld1q_u32((const uint32_t*)(row + left));
+					uint32x4_t r = vld1q_u32((const uint32_t*)(row + right - 4));
+
+					vst1q_u32((uint32_t*)(row + left), Reverse_NEON(r));
+					vst1q_u32((uint32_t*)(row + right - 4), Reverse_NEON(l));
+				}
+			#endif
+
+				std::reverse(row + left, row + right);
+			});
+	}
+
+	void ImageProcessing::FlipVertically(const SpriteView& sprite, ThreadPool* pool)
+	{
+		int width = sprite.size.x;
+		int height = sprite.size.y;
+
+		ForEachRow(pool, height / 2, width,
+			[&](int y)
+			{
+				Pixel* top = sprite.GetRow(y);
+				Pixel* bottom = sprite.GetRow(height - 1 - y);
+
+				std::swap_ranges(top, top + width, bottom);
+			});
+	}
+
+	bool ImageProcessing::Rotate90(const ConstSpriteView& src, Sprite& dst, int turns, ThreadPool* pool)
+	{
+		if (IsViewOf(src, dst) || src.IsEmpty())
+			return false;
+
+		turns = ((turns % 4) + 4) % 4;
+
+		int width = src.size.x;
+		int height = src.size.y;
+
+		if (turns == 0)
+		{
+			dst = Sprite(src);
+			return true;
+		}
+
+		if (turns == 2)
+		{
+			dst.Create(src.size);
+
+			ForEachRow(pool, height, width,
+				[&](int y)
+				{
+					const Pixel* srcRow = src.GetRow(y);
+					std::reverse_copy(srcRow, srcRow + width, dst.GetRow(height - 1 - y));
+				});
+
+			return true;
+		}
+
+		// The rows of dst are the columns of src, so src is read in 4x4 blocks
+		dst.Create({ height, width });
+
+		bool clockwise = turns == 1;
+
+		// The source column of a destination row and the destination column of a source row
+		auto Column = [&](int dstY) { return clockwise ? dstY : width - 1 - dstY; };
+		auto Position = [&](int srcY) { return clockwise ? height - 1 - srcY : srcY; };
+
+		int blocks = (width + 3) / 4;
+
+		ForEachRow(pool, blocks, height * 4,
+			[&](int block)
+			{
+				int dstY = block * 4;
+
+				if (dstY + 4 <= width)
+				{
+					// The block starts at the leftmost of the 4 source columns
+					int srcX = clockwise ? dstY : width - 4 - dstY;
+
+					int srcY = 0;
+
+					for (; srcY + 4 <= height; srcY += 4)
+					{
+						const Pixel* from = src.GetRow(srcY) + srcX;
+
+						// Clockwise the source rows go right to left, otherwise
+						// the source columns go from the bottom row of the block up
+						if (clockwise)
+							TransposeBlock(from, src.stride, dst.GetRow(dstY) + height - 4 - srcY, dst.stride, true);
+						else
+							TransposeBlock(from, src.stride, dst.GetRow(dstY + 3) + srcY, -(ptrdiff_t)dst.stride, false);
+					}
+
+					for (; srcY < height; srcY++)
+					{
+						for (int i = 0; i < 4; i++)
+							dst.GetRow(dstY + i)[Position(srcY)] = src.GetRow(srcY)[Column(dstY + i)];
+					}
+				}
+				else
+				{
+					for (int y = dstY; y < width; y++)
+					{
+						for (int srcY = 0; srcY < height; srcY++)
+							dst.GetRow(y)[Position(srcY)] = src.GetRow(srcY)[Column(y)];
+					}
+				}
+			});
+
+		return true;
+	}
+
+	void ImageProcessing::Copy(const ConstSpriteView& src, const Vector2i& srcPos, const Vector2i& size, const SpriteView& dst, const Vector2i& dstPos, ThreadPool* pool)
+	{
+		Vector2i from = srcPos, to = dstPos, area = size;
+
+		if (!ClipRectangle(src, from, area, dst, to))
+			return;
+
+		ForEachRow(pool, area.y, area.x,
+			[&](int y)
+			{
+				const Pixel* srcRow = src.GetRow(from.y + y) + from.x;
+				Pixel* dstRow = dst.GetRow(to.y + y) + to.x;
+
+				std::memmove(dstRow, srcRow, area.x * sizeof(Pixel));
+			});
+	}
+
+	void ImageProcessing::Blend(const ConstSpriteView& src, const Vector2i& srcPos, const Vector2i& size, const SpriteView& dst, const Vector2i& dstPos, uint8_t opacity, ThreadPool* pool)
+	{
+		Vector2i from = srcPos, to = dstPos, area = size;
+
+		if (!ClipRectangle(src, from, area, dst, to))
+			return;
+
+		// out = (src * alpha + dst * (255 - alpha)) / 255 where alpha = src.a * opacity / 255,
+		// the alpha of src is treated as 255 so the alpha of the result is the usual "over"
+		ForEachRow(pool, area.y, area.x,
+			[&](int y)
+			{
+				const Pixel* srcRow = src.GetRow(from.y + y) + from.x;
+				Pixel* dstRow = dst.GetRow(to.y + y) + to.x;
+
+				int x = 0;
+
+			#if defined(DGE_IMAGE_PROCESSING_SSE2)
+				__m128i zero = _mm_setzero_si128();
+				__m128i full = _mm_set1_epi16(255);
+				__m128i vopacity = _mm_set1_epi16(opacity);
+				__m128i alphaLane = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+				__m128i colourMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+
+				auto BlendHalf = [&](__m128i s, __m128i d)
+					{
+						__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+						alpha = Div255_SSE2(_mm_mullo_epi16(alpha, vopacity));
+
+						s = _mm_or_si128(_mm_and_si128(s, colourMask), alphaLane);
+
+						return Div255_SSE2(_mm_add_epi16(_mm_mullo_epi16(s, alpha), _mm_mullo_epi16(d, _mm_sub_epi16(full, alpha))));
+					};
+
+				for (; x + 4 <= area.x; x += 4)
+				{
+					__m128i s = _mm_loadu_si128((const __m128i*)(srcRow + x));
+					__m128i d = _mm_loadu_si128((const __m128i*)(dstRow + x));
+
+					__m128i lo = BlendHalf(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+					__m128i hi = BlendHalf(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+
+					_mm_storeu_si128((__m128i*)(dstRow + x), _mm_packus_epi16(lo, hi));
+				}
+			#elif defined(DGE_IMAGE_PROCESSING_NEON)
+				for (; x + 8 <= area.x; x += 8)
+				{
+					uint8x8x4_t s = vld4_u8((const uint8_t*)(srcRow + x));
+					uint8x8x4_t d = vld4_u8((const uint8_t*)(dstRow + x));
+
+					uint8x8_t alpha = Div255_NEON(vmull_u8(s.val[3], vdup_n_u8(opacity)));
+					uint8x8_t inverse = vsub_u8(vdup_n_u8(255), alpha);
+
+					s.val[3] = vdup_n_u8(255);
+
+					for (int i = 0; i < 4; i++)
+						d.val[i] = Div255_NEON(vmlal_u8(vmull_u8(s.val[i], alpha), d.val[i], inverse));
+
+					vst4_u8((uint8_t*)(dstRow + x), d);
+				}
+			#endif
+
+				for (; x < area.x; x++)
+				{
+					const Pixel& s = srcRow[x];
+					Pixel& d = dstRow[x];
+
+					uint32_t alpha = Div255(s.a * opacity);
+					uint32_t inverse = 255 - alpha;
+
+					d = Pixel(
+						(uint8_t)Div255(s.r * alpha + d.r * inverse),
+						(uint8_t)Div255(s.g * alpha + d.g * inverse),
+						(uint8_t)Div255(s.b * alpha + d.b * inverse),
+						(uint8_t)Div255(255 * alpha + d.a * inverse));
+				}
+			});
+	}
+
+	void ImageProcessing::ResolvePalette(const ImageView<const PixelIndex8>& src, std::span<const Pixel> palette, const SpriteView& dst, ThreadPool* pool)
+	{
+		Vector2i area = src.size.Min(dst.size);
+
+		if (src.IsEmpty() || dst.IsEmpty())
+			return;
+
+		// A full table so every index can be looked up without a check
+		Pixel table[256];
+		std::fill(table, table + 256, NONE);
+		std::copy_n(palette.begin(), std::min(palette.size(), (size_t)256), table);
+
+		ForEachRow(pool, area.y, area.x,
+			[&](int y)
+			{
+				const PixelIndex8* srcRow = src.GetRow(y);
+				Pixel* dstRow = dst.GetRow(y);
+
+				for (int x = 0; x < area.x; x++)
+					dstRow[x] = table[srcRow[x].index];
+			});
+	}
+}
@@ -8,9 +8,55 @@
 #include "InputHandler.hpp"
 #include "defGameEngine.hpp"
 
+#include <cstring>
+
 namespace def
 {
-    std::unordered_map<Key, std::pair<char, char>> InputHandler::s_KeyboardUS =
+    // Both tables are built at compile time so looking up a key is just an indexing
+
+    // Size of the table that maps platform specific key constants to the Key enum
+#if defined(DGE_PLATFORM_GLFW3)
+    static constexpr size_t PLATFORM_KEYS_COUNT = GLFW_KEY_LAST + 1;
+#elif defined(DGE_PLATFORM_EMSCRIPTEN)
+    // DOM_PK codes are in 0x0000..0x00FF or in 0xE000..0xE0FF,
+    // the second range is folded into 0x0100..0x01FF
+    static constexpr size_t PLATFORM_KEYS_COUNT = 0x200;
+#else
+    // The headless platform doesn't receive keys from the OS
+    static constexpr size_t PLATFORM_KEYS_COUNT = 1;
+#endif
+
+    static constexpr size_t PlatformKeyIndex(int platformKey)
+    {
+    #ifdef DGE_PLATFORM_EMSCRIPTEN
+        return (platformKey & 0xFF) | ((platformKey & 0xFF00) == 0xE000 ? 0x100 : 0);
+    #else
+        return (size_t)platformKey;
+    #endif
+    }
+
+    static constexpr auto MakeKeyboardTable(std::initializer_list<std::pair<Key, std::pair<char, char>>> chars)
+    {
+        std::array<std::pair<char, char>, KEYS_COUNT> table{};
+
+        for (const auto& [key, pair] : chars)
+            table[static_cast<size_t>(key)] = pair;
+
+        return table;
+    }
+
+    static constexpr auto MakeKeysTable(std::initializer_list<std::pair<int, Key>> keys)
+    {
+        std::array<Key, PLATFORM_KEYS_COUNT> table{};
+        table.fill(Key::NONE);
+
+        for (const auto& [platformKey, key] : keys)
+            table[PlatformKeyIndex(platformKey)] = key;
+
+        return table;
+    }
+
+    const std::array<std::pair<char, char>, KEYS_COUNT> InputHandler::s_KeyboardUS = MakeKeyboardTable(
     {
         { Key::SPACE, { ' ', ' ' } }, { Key::APOSTROPHE, { '\'', '"' } },
         { Key::COMMA, { ',', '<' } }, { Key::MINUS, { '-', '_' } },
@@ -44,11 +90,11 @@ namespace def
         { Key::NP_DIVIDE, { '/', '/' } }, { Key::NP_MULTIPLY, { '*', '*' } },
         { Key::NP_SUBTRACT, { '-', '-' } }, { Key::NP_ADD, { '+', '+' } },
         { Key::NP_EQUAL, { '=', '+' } }
-    };
+    });
 
 #ifdef DGE_PLATFORM_GLFW3
 
-    std::unordered_map<int, Key> InputHandler::s_KeysTable =
+    static constexpr std::array<Key, PLATFORM_KEYS_COUNT> s_KeysTable = MakeKeysTable(
     {
         { GLFW_KEY_SPACE, Key::SPACE }, { GLFW_KEY_APOSTROPHE, Key::APOSTROPHE }, { GLFW_KEY_COMMA, Key::COMMA },
         { GLFW_KEY_MINUS, Key::MINUS }, { GLFW_KEY_PERIOD, Key::PERIOD }, { GLFW_KEY_SLASH, Key::SLASH },
@@ -90,16 +136,14 @@ namespace def
         { GLFW_KEY_LEFT_SHIFT, Key::LEFT_SHIFT }, { GLFW_KEY_LEFT_CONTROL, Key::LEFT_CONTROL },
         { GLFW_KEY_LEFT_ALT, Key::LEFT_ALT }, { GLFW_KEY_LEFT_SUPER, Key::LEFT_SUPER },
         { GLFW_KEY_RIGHT_SHIFT, Key::RIGHT_SHIFT }, { GLFW_KEY_RIGHT_CONTROL, Key::RIGHT_CONTROL },
-        { GLFW_KEY_RIGHT_ALT, Key::RIGHT_ALT }, { GLFW_KEY_RIGHT_SUPER, Key::RIGHT_SUPER }, { GLFW_KEY_MENU, Key::MENU },
-
-        { GLFW_KEY_UNKNOWN, Key::NONE }
-    };
+        { GLFW_KEY_RIGHT_ALT, Key::RIGHT_ALT }, { GLFW_KEY_RIGHT_SUPER, Key::RIGHT_SUPER }, { GLFW_KEY_MENU, Key::MENU }
+    });
 
 #endif
 
 #ifdef DGE_PLATFORM_EMSCRIPTEN
 
-    std::unordered_map<int, Key> InputHandler::s_KeysTable =
+    static constexpr std::array<Key, PLATFORM_KEYS_COUNT> s_KeysTable = MakeKeysTable(
     {
         { DOM_PK_SPACE, Key::SPACE }, { DOM_PK_QUOTE, Key::APOSTROPHE }, { DOM_PK_COMMA, Key::COMMA },
         { DOM_PK_MINUS, Key::MINUS }, { DOM_PK_PERIOD, Key::PERIOD }, { DOM_PK_SLASH, Key::SLASH },
@@ -142,10 +186,14 @@ namespace def
         { DOM_PK_SHIFT_LEFT, Key::LEFT_SHIFT }, { DOM_PK_CONTROL_LEFT, Key::LEFT_CONTROL },
         { DOM_PK_ALT_LEFT, Key::LEFT_ALT }, { DOM_PK_OS_LEFT, Key::LEFT_SUPER },
         { DOM_PK_SHIFT_RIGHT, Key::RIGHT_SHIFT }, { DOM_PK_CONTROL_RIGHT, Key::RIGHT_CONTROL },
-        { DOM_PK_ALT_RIGHT, Key::RIGHT_ALT }, { DOM_PK_OS_RIGHT, Key::RIGHT_SUPER }, { DOM_PK_CONTEXT_MENU, Key::MENU },
+        { DOM_PK_ALT_RIGHT, Key::RIGHT_ALT }, { DOM_PK_OS_RIGHT, Key::RIGHT_SUPER }, { DOM_PK_CONTEXT_MENU, Key::MENU }
+    });
 
-        { DOM_PK_UNKNOWN, Key::NONE }
-    };
+#endif
+
+#ifdef DGE_PLATFORM_HEADLESS
+
+    static constexpr std::array<Key, PLATFORM_KEYS_COUNT> s_KeysTable = MakeKeysTable({});
 
 #endif
 
@@ -166,92 +214,332 @@ namespace def
         uint8_t keysCount = static_cast<uint8_t>(KEYS_COUNT);
 
         for (uint8_t i = 0; i < keysCount; i++)
-        {
             m_Keys[i] = { false, false, false };
-            m_KeyOldState[i] = false;
-            m_KeyNewState[i] = false;
-        }
 
         for (uint8_t i = 0; i < 8; i++)
-        {
             m_Mouse[i] = { false, false, false };
-            m_MouseOldState[i] = false;
-            m_MouseNewState[i] = false;
+
+        m_EventQueueStart = 0;
+        m_EventQueueSize = 0;
+        m_DroppedEvents = 0;
+
+        m_ScrollAccumulator = 0.0f;
+        m_IsInjecting = false;
+
+        m_Events.reserve(INPUT_EVENTS_CAPACITY);
+    }
+
+    void InputHandler::PushKeyEvent(Key key, bool down, bool repeat)
+    {
+        if (key == Key::NONE)
+            return;
+
+        InputEvent event;
+        event.type = InputEvent::Type::KEY;
+        event.code = static_cast<uint32_t>(key);
+        event.down = down;
+        event.repeat = repeat;
+
+        PushEvent(event);
+    }
+
+    void InputHandler::PushButtonEvent(Button button, bool down)
+    {
+        if (button >= Button::COUNT)
+            return;
+
+        InputEvent event;
+        event.type = InputEvent::Type::BUTTON;
+        event.code = static_cast<uint32_t>(button);
+        event.down = down;
+
+        PushEvent(event);
+    }
+
+    void InputHandler::PushScrollEvent(const Vector2f& offset)
+    {
+        InputEvent event;
+        event.type = InputEvent::Type::SCROLL;
+        event.value = offset;
+
+        PushEvent(event);
+    }
+
+    void InputHandler::PushMoveEvent(const Vector2i& pos)
+    {
+        InputEvent event;
+        event.type = InputEvent::Type::MOVE;
+        event.value = pos;
+
+        PushEvent(event);
+    }
+
+    void InputHandler::PushCharEvent(uint32_t codePoint)
+    {
+        InputEvent event;
+        event.type = InputEvent::Type::CHAR;
+        event.code = codePoint;
+
+        PushEvent(event);
+    }
+
+    void InputHandler::PushEvent(const InputEvent& event)
+    {
+        if (m_ReplayFile.is_open() && !m_IsInjecting)
+            return;
+
+        if (m_EventQueueSize == INPUT_EVENTS_CAPACITY)
+        {
+            InputEvent& last = m_EventQueue[(m_EventQueueStart + m_EventQueueSize - 1) % INPUT_EVENTS_CAPACITY];
+
+            // Moves and scrolls can be merged with the previous event of the same type
+            // without changing the final state, everything else is lost
+            if (last.type == event.type && event.type == InputEvent::Type::MOVE)
+            {
+                last.value = event.value;
+                last.timestamp = Clock::now();
+            }
+            else if (last.type == event.type && event.type == InputEvent::Type::SCROLL)
+            {
+                last.value += event.value;
+                last.timestamp = Clock::now();
+            }
+            else
+                m_DroppedEvents++;
+
+            return;
         }
+
+        InputEvent& slot = m_EventQueue[(m_EventQueueStart + m_EventQueueSize) % INPUT_EVENTS_CAPACITY];
+
+        slot = event;
+        slot.timestamp = Clock::now();
+
+        m_EventQueueSize++;
     }
 
     void InputHandler::GrabEvents()
     {
-        m_ScrollDelta = 0;
         m_Platform->PollEvents();
     }
 
-    void InputHandler::FlushBuffers()
+    void InputHandler::WaitEvents(float timeout)
     {
-        UpdateState(m_Keys, m_KeyNewState, m_KeyOldState, static_cast<uint8_t>(KEYS_COUNT));
-		UpdateState(m_Mouse, m_MouseNewState, m_MouseOldState, 8);
+        m_Platform->WaitEvents(timeout);
     }
 
-    void InputHandler::GrabText()
+    void InputHandler::FlushBuffers()
     {
-        if (GetKeyState(Key::CAPS_LOCK).pressed)
-			m_Caps = !m_Caps;
+        for (auto& key : m_Keys)
+        {
+            key.pressed = false;
+            key.released = false;
+        }
 
-        if (!m_CaptureText)
-            return;
+        for (auto& button : m_Mouse)
+        {
+            button.pressed = false;
+            button.released = false;
+        }
 
-        bool isUp = GetKeyState(Key::LEFT_SHIFT).held || GetKeyState(Key::RIGHT_SHIFT).held;
+        m_ScrollDelta = 0;
+        m_Events.clear();
 
-        for (const auto& [key, chars] : s_KeyboardUS)
+        while (m_EventQueueSize > 0)
         {
-            if (GetKeyState(key).pressed)
+            const InputEvent& event = m_EventQueue[m_EventQueueStart];
+
+            ProcessEvent(event);
+            m_Events.push_back(event);
+
+            m_EventQueueStart = (m_EventQueueStart + 1) % INPUT_EVENTS_CAPACITY;
+            m_EventQueueSize--;
+        }
+    }
+
+    void InputHandler::ProcessEvent(const InputEvent& event)
+    {
+        auto Apply = [](KeyState& state, bool down)
             {
-                if (m_Caps || isUp)
-                    m_CapturedText.insert(m_CapturedTextCursorPos, 1, chars.second);
-                else
-                    m_CapturedText.insert(m_CapturedTextCursorPos, 1, chars.first);
+                if (down)
+                {
+                    // Both pressed and released can be set on the same frame
+                    // if the key went down and up in between 2 frames
+                    state.pressed |= !state.held;
+                    state.held = true;
+                }
+                else if (state.held)
+                {
+                    state.released = true;
+                    state.held = false;
+                }
+            };
 
-                m_CapturedTextCursorPos++;
-            }
+        switch (event.type)
+        {
+        case InputEvent::Type::KEY:
+        {
+            if (!event.repeat)
+                Apply(m_Keys[event.code], event.down);
         }
+        break;
+
+        case InputEvent::Type::BUTTON:
+            Apply(m_Mouse[event.code], event.down);
+        break;
 
-        if (GetKeyState(Key::BACKSPACE).pressed)
+        case InputEvent::Type::SCROLL:
         {
-            if (m_CapturedTextCursorPos > 0)
-            {
-                m_CapturedText.erase(m_CapturedTextCursorPos - 1, 1);
-                m_CapturedTextCursorPos--;
-            }
+            // Touchpads report fractional offsets so accumulate them
+            // until they make a whole step
+            m_ScrollAccumulator += event.value.y;
+
+            int steps = (int)m_ScrollAccumulator;
+
+            m_ScrollDelta += steps;
+            m_ScrollAccumulator -= (float)steps;
+        }
+        break;
+
+        case InputEvent::Type::MOVE:
+            m_MousePos = event.value;
+        break;
+
+        case InputEvent::Type::CHAR: break;
+
+        }
+    }
+
+    // Returns the position of the code point before pos in the UTF-8 string
+    static size_t PrevCodePoint(const std::string& text, size_t pos)
+    {
+        if (pos == 0)
+            return 0;
+
+        do pos--;
+        while (pos > 0 && (text[pos] & 0xC0) == 0x80);
+
+        return pos;
+    }
+
+    // Returns the position of the code point after pos in the UTF-8 string
+    static size_t NextCodePoint(const std::string& text, size_t pos)
+    {
+        if (pos >= text.length())
+            return text.length();
+
+        do pos++;
+        while (pos < text.length() && (text[pos] & 0xC0) == 0x80);
+
+        return pos;
+    }
+
+    // Encodes the code point as UTF-8 and returns the number of written bytes
+    static size_t EncodeUTF8(uint32_t codePoint, char* out)
+    {
+        if (codePoint < 0x80)
+        {
+            out[0] = (char)codePoint;
+            return 1;
         }
 
-        if (GetKeyState(Key::DEL).pressed)
+        if (codePoint < 0x800)
         {
-            if (m_CapturedTextCursorPos < m_CapturedText.length())
-                m_CapturedText.erase(m_CapturedTextCursorPos, 1);
+            out[0] = (char)(0xC0 | (codePoint >> 6));
+            out[1] = (char)(0x80 | (codePoint & 0x3F));
+            return 2;
         }
 
-        if (GetKeyState(Key::LEFT).pressed)
+        if (codePoint < 0x10000)
         {
-            if (m_CapturedTextCursorPos > 0)
-                m_CapturedTextCursorPos--;
+            out[0] = (char)(0xE0 | (codePoint >> 12));
+            out[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            out[2] = (char)(0x80 | (codePoint & 0x3F));
+            return 3;
         }
 
-        if (GetKeyState(Key::RIGHT).pressed)
+        if (codePoint < 0x110000)
         {
-            if (m_CapturedTextCursorPos < m_CapturedText.length())
-                m_CapturedTextCursorPos++;
+            out[0] = (char)(0xF0 | (codePoint >> 18));
+            out[1] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+            out[2] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            out[3] = (char)(0x80 | (codePoint & 0x3F));
+            return 4;
         }
 
-        if (GetKeyState(Key::ENTER).pressed)
+        return 0;
+    }
+
+    void InputHandler::GrabText()
+    {
+        if (GetKeyState(Key::CAPS_LOCK).pressed)
+			m_Caps = !m_Caps;
+
+        if (!m_CaptureText)
+            return;
+
+        // The characters come from the platform so they already respect
+        // the keyboard layout, shift and caps lock, the editing keys
+        // are processed in the same order as they were typed
+        for (const auto& event : m_Events)
         {
-            m_Platform->m_Engine->OnTextCapturingComplete(m_CapturedText);
-            m_Platform->m_Engine->m_Console->HandleCommand(m_CapturedText);
+            if (event.type == InputEvent::Type::CHAR)
+            {
+                char bytes[4];
+                size_t count = EncodeUTF8(event.code, bytes);
+
+                m_CapturedText.insert(m_CapturedTextCursorPos, bytes, count);
+                m_CapturedTextCursorPos += count;
+
+                continue;
+            }
 
-            m_CapturedText.clear();
-            m_CapturedTextCursorPos = 0;
+            if (event.type != InputEvent::Type::KEY || !event.down)
+                continue;
+
+            switch (static_cast<Key>(event.code))
+            {
+            case Key::BACKSPACE:
+            {
+                size_t start = PrevCodePoint(m_CapturedText, m_CapturedTextCursorPos);
+
+                m_CapturedText.erase(start, m_CapturedTextCursorPos - start);
+                m_CapturedTextCursorPos = start;
+            }
+            break;
+
+            case Key::DEL:
+            {
+                size_t end = NextCodePoint(m_CapturedText, m_CapturedTextCursorPos);
+                m_CapturedText.erase(m_CapturedTextCursorPos, end - m_CapturedTextCursorPos);
+            }
+            break;
+
+            case Key::LEFT: m_CapturedTextCursorPos = PrevCodePoint(m_CapturedText, m_CapturedTextCursorPos); break;
+            case Key::RIGHT: m_CapturedTextCursorPos = NextCodePoint(m_CapturedText, m_CapturedTextCursorPos); break;
+            case Key::HOME: m_CapturedTextCursorPos = 0; break;
+            case Key::END: m_CapturedTextCursorPos = m_CapturedText.length(); break;
+
+            case Key::ENTER:
+            case Key::NP_ENTER:
+            {
+                if (event.repeat)
+                    break;
+
+                m_Platform->m_Engine->OnTextCapturingComplete(m_CapturedText);
+                m_Platform->m_Engine->m_Console->HandleCommand(m_CapturedText);
+
+                m_CapturedText.clear();
+                m_CapturedTextCursorPos = 0;
+            }
+            break;
+
+            default: break;
+            }
         }
 
         m_Platform->m_Engine->m_Console->HandleHistoryBrowsing();
+        m_Platform->m_Engine->m_Console->HandleCompletion();
     }
 
     void InputHandler::SetCapturedText(const std::string& text)
@@ -270,6 +558,19 @@ namespace def
 	    m_CapturedTextCursorPos = 0;
     }
 
+    Key InputHandler::MapKey(int platformKey)
+    {
+        if (platformKey < 0)
+            return Key::NONE;
+
+        size_t index = PlatformKeyIndex(platformKey);
+
+        if (index >= PLATFORM_KEYS_COUNT)
+            return Key::NONE;
+
+        return s_KeysTable[index];
+    }
+
     const KeyState& InputHandler::GetKeyState(Key key) const
     {
         return m_Keys[static_cast<uint8_t>(key)];
@@ -325,28 +626,151 @@ namespace def
         return m_Caps;
     }
 
-    void InputHandler::UpdateState(KeyState* data, bool* newState, bool* oldState, uint8_t count)
+    bool InputHandler::HasActivity() const
+    {
+        return !m_Events.empty();
+    }
+
+    const std::vector<InputEvent>& InputHandler::GetEvents() const
+    {
+        return m_Events;
+    }
+
+    size_t InputHandler::GetDroppedEventsCount() const
     {
-        for (uint8_t i = 0; i < count; i++)
+        return m_DroppedEvents;
+    }
+
+    // Recording is a header followed by frames, each frame is
+    // the delta time, the number of events and the events themselves
+
+    static constexpr char RECORDING_MAGIC[4] = { 'D', 'G', 'E', 'R' };
+    static constexpr uint32_t RECORDING_VERSION = 1;
+
+    template <class T>
+    static void WriteValue(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    static bool ReadValue(std::ifstream& file, T& value)
+    {
+        return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    bool InputHandler::StartRecording(const std::string& fileName)
+    {
+        m_RecordFile.open(fileName, std::ios::binary | std::ios::trunc);
+
+        if (!m_RecordFile.is_open())
+            return false;
+
+        m_RecordFile.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+        WriteValue(m_RecordFile, RECORDING_VERSION);
+
+        return true;
+    }
+
+    void InputHandler::StopRecording()
+    {
+        m_RecordFile.close();
+    }
+
+    bool InputHandler::IsRecording() const
+    {
+        return m_RecordFile.is_open();
+    }
+
+    bool InputHandler::StartReplay(const std::string& fileName)
+    {
+        m_ReplayFile.open(fileName, std::ios::binary);
+
+        if (!m_ReplayFile.is_open())
+            return false;
+
+        char magic[4];
+        uint32_t version;
+
+        m_ReplayFile.read(magic, sizeof(magic));
+
+        if (!m_ReplayFile || memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0 ||
+            !ReadValue(m_ReplayFile, version) || version != RECORDING_VERSION)
+        {
+            m_ReplayFile.close();
+            return false;
+        }
+
+        // The live input must not leak into the replay
+        m_EventQueueSize = 0;
+
+        return true;
+    }
+
+    void InputHandler::StopReplay()
+    {
+        m_ReplayFile.close();
+    }
+
+    bool InputHandler::IsReplaying() const
+    {
+        return m_ReplayFile.is_open();
+    }
+
+    void InputHandler::RecordFrame(float deltaTime)
+    {
+        if (!m_RecordFile.is_open())
+            return;
+
+        WriteValue(m_RecordFile, deltaTime);
+        WriteValue(m_RecordFile, (uint32_t)m_Events.size());
+
+        for (const auto& event : m_Events)
         {
-            data[i].pressed = false;
-            data[i].released = false;
+            uint8_t flags = (event.down ? 1 : 0) | (event.repeat ? 2 : 0);
 
-            if (newState[i] != oldState[i])
+            WriteValue(m_RecordFile, event.type);
+            WriteValue(m_RecordFile, flags);
+            WriteValue(m_RecordFile, event.code);
+            WriteValue(m_RecordFile, event.value.x);
+            WriteValue(m_RecordFile, event.value.y);
+        }
+    }
+
+    bool InputHandler::ReplayFrame(float& deltaTime)
+    {
+        uint32_t count;
+
+        if (!ReadValue(m_ReplayFile, deltaTime) || !ReadValue(m_ReplayFile, count))
+            return false;
+
+        m_IsInjecting = true;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            InputEvent event;
+            uint8_t flags;
+
+            if (!ReadValue(m_ReplayFile, event.type) || !ReadValue(m_ReplayFile, flags) || !ReadValue(m_ReplayFile, event.code) ||
+                !ReadValue(m_ReplayFile, event.value.x) || !ReadValue(m_ReplayFile, event.value.y))
             {
-                if (newState[i])
-                {
-                    data[i].pressed = !data[i].held;
-                    data[i].held = true;
-                }
-                else
-                {
-                    data[i].released = true;
-                    data[i].held = false;
-                }
+                m_IsInjecting = false;
+                return false;
             }
 
-            oldState[i] = newState[i];
+            event.down = flags & 1;
+            event.repeat = flags & 2;
+
+            bool valid = event.type <= InputEvent::Type::CHAR &&
+                (event.type != InputEvent::Type::KEY || event.code < KEYS_COUNT) &&
+                (event.type != InputEvent::Type::BUTTON || event.code < BUTTONS_COUNT);
+
+            if (valid)
+                PushEvent(event);
         }
+
+        m_IsInjecting = false;
+
+        return true;
     }
 }
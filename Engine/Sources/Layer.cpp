@@ -9,7 +9,7 @@
 
 namespace def
 {
-    Layer::Layer(GameEngine* context) : context(*context)
+    Layer::Layer(GameEngine* context) : context(*context), drawContext(context, this)
     {
     }
 
@@ -17,6 +17,9 @@ namespace def
     {
         if (pixels)
             delete pixels;
+
+        delete indexTexture;
+        delete paletteTexture;
     }
 
     bool Layer::OnCreate() { return true; }
@@ -0,0 +1,422 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "Log.hpp"
+
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace def
+{
+	std::atomic<Log::Level> Log::s_Level = Log::Level::INFO;
+
+	// Must be a power of 2
+	static constexpr size_t QUEUE_CAPACITY = 4096;
+	static constexpr size_t QUEUE_MASK = QUEUE_CAPACITY - 1;
+
+	// The writer drains the queue by itself if it hasn't received
+	// anything for this long, e.g. when the engine isn't running
+	static constexpr std::chrono::milliseconds WRITER_DRAIN_INTERVAL(100);
+
+	// Bounded queue by Dmitry Vyukov: each cell has a sequence number
+	// that tells if the cell is ready to be written or to be read,
+	// so producers only compete for the enqueue position and never block
+	struct LogQueue
+	{
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			Log::Message message;
+		};
+
+		LogQueue() : cells(new Cell[QUEUE_CAPACITY])
+		{
+			for (size_t i = 0; i < QUEUE_CAPACITY; i++)
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		// Can be called from any thread, returns false if the queue is full
+		bool Push(Log::Message&& message)
+		{
+			size_t pos = enqueuePos.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			while (true)
+			{
+				cell = &cells[pos & QUEUE_MASK];
+
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+				if (diff == 0)
+				{
+					if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+
+			cell->message = std::move(message);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		// Only one thread at a time can pop the messages
+		bool Pop(Log::Message& message)
+		{
+			Cell& cell = cells[dequeuePos & QUEUE_MASK];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+			if ((intptr_t)sequence - (intptr_t)(dequeuePos + 1) < 0)
+				return false;
+
+			message = std::move(cell.message);
+			cell.sequence.store(dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+
+			dequeuePos++;
+
+			return true;
+		}
+
+		std::unique_ptr<Cell[]> cells;
+
+		// Producers and the consumer don't share cache lines
+		alignas(64) std::atomic<size_t> enqueuePos = 0;
+		alignas(64) size_t dequeuePos = 0;
+
+		std::atomic<uint64_t> dropped = 0;
+	};
+
+	// Writes batches of messages to the file on a background thread
+	struct LogWriter
+	{
+		~LogWriter()
+		{
+			Stop();
+		}
+
+		bool Start(const std::string& name, size_t maxSize, size_t maxCount)
+		{
+			Stop();
+
+			// Appending so the log of the previous run isn't lost
+			file.open(name, std::ios::app);
+
+			if (!file.is_open())
+				return false;
+
+			file.seekp(0, std::ios::end);
+
+			fileName = name;
+			fileSize = (size_t)file.tellp();
+			maxFileSize = maxSize;
+			maxFiles = maxCount;
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = true;
+				stop = false;
+			}
+
+			thread = std::thread(&LogWriter::Run, this);
+
+			return true;
+		}
+
+		void Stop()
+		{
+			if (!thread.joinable())
+				return;
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+
+			wakeUp.notify_one();
+			thread.join();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isRunning = false;
+				pending.clear();
+			}
+
+			written.notify_all();
+			file.close();
+		}
+
+		// Moves the messages to the writer, the batch is always cleared
+		void Submit(std::vector<Log::Message>& batch)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (isRunning)
+					pending.insert(pending.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+			}
+
+			batch.clear();
+			wakeUp.notify_one();
+		}
+
+		// Blocks until everything that was submitted is written
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			written.wait(lock, [this] { return !isRunning || (pending.empty() && !isWriting); });
+		}
+
+		void Run()
+		{
+			std::vector<Log::Message> batch;
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				if (pending.empty() && !stop)
+				{
+					if (!wakeUp.wait_for(lock, WRITER_DRAIN_INTERVAL, [this] { return stop || !pending.empty(); }))
+					{
+						lock.unlock();
+						Log::Drain();
+						lock.lock();
+
+						continue;
+					}
+				}
+
+				if (pending.empty())
+					break;
+
+				batch.swap(pending);
+				isWriting = true;
+
+				lock.unlock();
+
+				for (const auto& message : batch)
+					Write(message);
+
+				file.flush();
+				batch.clear();
+
+				lock.lock();
+
+				isWriting = false;
+				written.notify_all();
+			}
+		}
+
+		void Write(const Log::Message& message)
+		{
+			std::time_t time = std::chrono::system_clock::to_time_t(message.time);
+			std::tm local;
+
+		#ifdef _WIN32
+			localtime_s(&local, &time);
+		#else
+			localtime_r(&time, &local);
+		#endif
+
+			int millis = int(std::chrono::duration_cast<std::chrono::milliseconds>(message.time.time_since_epoch()).count() % 1000);
+
+			char prefix[64];
+			size_t length = strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+			length += snprintf(prefix + length, sizeof(prefix) - length, ".%03d [%s] ", millis, Log::GetLevelName(message.level));
+
+			size_t lineSize = length + message.text.length() + 1;
+
+			if (maxFileSize > 0 && fileSize > 0 && fileSize + lineSize > maxFileSize)
+				Rotate();
+
+			file.write(prefix, length);
+			file.write(message.text.data(), message.text.length());
+			file.put('\n');
+
+			fileSize += lineSize;
+		}
+
+		// The current file becomes fileName.1, the oldest one is removed
+		void Rotate()
+		{
+			file.close();
+
+			if (maxFiles > 0)
+			{
+				std::remove((fileName + '.' + std::to_string(maxFiles)).c_str());
+
+				for (size_t i = maxFiles; i > 1; i--)
+					std::rename((fileName + '.' + std::to_string(i - 1)).c_str(), (fileName + '.' + std::to_string(i)).c_str());
+
+				std::rename(fileName.c_str(), (fileName + ".1").c_str());
+			}
+
+			file.open(fileName, std::ios::trunc);
+			fileSize = 0;
+		}
+
+		std::thread thread;
+		std::mutex mutex;
+
+		std::condition_variable wakeUp;
+		std::condition_variable written;
+
+		// Are protected by the mutex
+		std::vector<Log::Message> pending;
+		bool isRunning = false;
+		bool isWriting = false;
+		bool stop = false;
+
+		// Are used only by the thread while it's running
+		std::ofstream file;
+		std::string fileName;
+		size_t fileSize = 0;
+		size_t maxFileSize = 0;
+		size_t maxFiles = 0;
+	};
+
+	struct LogState
+	{
+		LogQueue queue;
+
+		// Protects the consumer side of the queue and everything below
+		std::mutex drainMutex;
+
+		std::vector<Log::Message> consoleBacklog;
+		std::vector<Log::Message> batch;
+
+		std::atomic<Log::Level> consoleLevel = Log::Level::INFO;
+		std::atomic<Log::Level> stderrLevel = Log::Level::WARN;
+
+		// Is declared last so the thread is stopped before the rest is destroyed
+		LogWriter writer;
+	};
+
+	static LogState& GetState()
+	{
+		static LogState state;
+		return state;
+	}
+
+	void Log::SetLevel(Level level)
+	{
+		s_Level.store(level, std::memory_order_relaxed);
+	}
+
+	Log::Level Log::GetLevel()
+	{
+		return s_Level.load(std::memory_order_relaxed);
+	}
+
+	void Log::SetConsoleLevel(Level level)
+	{
+		GetState().consoleLevel.store(level, std::memory_order_relaxed);
+	}
+
+	void Log::SetStderrLevel(Level level)
+	{
+		GetState().stderrLevel.store(level, std::memory_order_relaxed);
+	}
+
+	bool Log::OpenFile(const std::string& fileName, size_t maxFileSize, size_t maxFiles)
+	{
+	#ifdef __EMSCRIPTEN__
+		// Threads aren't available without building with pthreads
+		return false;
+	#else
+		Drain();
+		return GetState().writer.Start(fileName, maxFileSize, maxFiles);
+	#endif
+	}
+
+	void Log::CloseFile()
+	{
+		Drain();
+		GetState().writer.Stop();
+	}
+
+	void Log::Drain()
+	{
+		LogState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.drainMutex);
+
+		Level consoleLevel = state.consoleLevel.load(std::memory_order_relaxed);
+		Level stderrLevel = state.stderrLevel.load(std::memory_order_relaxed);
+
+		Message message;
+
+		while (state.queue.Pop(message))
+		{
+			if (message.level >= stderrLevel && stderrLevel != Level::NONE)
+				fprintf(stderr, "[%s] %s\n", GetLevelName(message.level), message.text.c_str());
+
+			// The backlog isn't taken if the engine isn't running, so it's limited
+			if (message.level >= consoleLevel && consoleLevel != Level::NONE && state.consoleBacklog.size() < QUEUE_CAPACITY)
+				state.consoleBacklog.push_back(message);
+
+			state.batch.push_back(std::move(message));
+		}
+
+		if (!state.batch.empty())
+			state.writer.Submit(state.batch);
+	}
+
+	void Log::Flush()
+	{
+		Drain();
+		GetState().writer.Wait();
+	}
+
+	void Log::TakeConsoleMessages(std::vector<Message>& messages)
+	{
+		LogState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.drainMutex);
+
+		messages.clear();
+		messages.swap(state.consoleBacklog);
+	}
+
+	uint64_t Log::GetDroppedCount()
+	{
+		return GetState().queue.dropped.load(std::memory_order_relaxed);
+	}
+
+	const char* Log::GetLevelName(Level level)
+	{
+		switch (level)
+		{
+		case Level::TRACE: return "TRACE";
+		case Level::DEBUG: return "DEBUG";
+		case Level::INFO: return "INFO";
+		case Level::WARN: return "WARN";
+		case Level::ERR: return "ERROR";
+		case Level::FATAL: return "FATAL";
+		default: return "NONE";
+		}
+	}
+
+	void Log::Push(Level level, std::string&& text)
+	{
+		LogState& state = GetState();
+
+		Message message;
+		message.level = level;
+		message.time = std::chrono::system_clock::now();
+		message.text = std::move(text);
+
+		if (!state.queue.Push(std::move(message)))
+			state.queue.dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,193 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "Matrix3.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DGE_MATRIX3_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define DGE_MATRIX3_NEON
+#endif
+
+namespace def
+{
+	// The points are read as an array of floats
+	static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Vector2f must be tightly packed");
+
+	Matrix3::Matrix3() : Matrix3(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f)
+	{
+
+	}
+
+	Matrix3::Matrix3(float m00, float m01, float m02, float m10, float m11, float m12)
+	{
+		m[0][0] = m00; m[0][1] = m01; m[0][2] = m02;
+		m[1][0] = m10; m[1][1] = m11; m[1][2] = m12;
+		m[2][0] = 0.0f; m[2][1] = 0.0f; m[2][2] = 1.0f;
+	}
+
+	Matrix3 Matrix3::Translate(const Vector2f& offset)
+	{
+		return Matrix3(1.0f, 0.0f, offset.x, 0.0f, 1.0f, offset.y);
+	}
+
+	Matrix3 Matrix3::Rotate(float angle)
+	{
+		float cs = cosf(angle), sn = sinf(angle);
+		return Matrix3(cs, -sn, 0.0f, sn, cs, 0.0f);
+	}
+
+	Matrix3 Matrix3::Scale(const Vector2f& scale)
+	{
+		return Matrix3(scale.x, 0.0f, 0.0f, 0.0f, scale.y, 0.0f);
+	}
+
+	Matrix3 Matrix3::operator*(const Matrix3& rhs) const
+	{
+		return Matrix3(
+			m[0][0] * rhs.m[0][0] + m[0][1] * rhs.m[1][0],
+			m[0][0] * rhs.m[0][1] + m[0][1] * rhs.m[1][1],
+			m[0][0] * rhs.m[0][2] + m[0][1] * rhs.m[1][2] + m[0][2],
+			m[1][0] * rhs.m[0][0] + m[1][1] * rhs.m[1][0],
+			m[1][0] * rhs.m[0][1] + m[1][1] * rhs.m[1][1],
+			m[1][0] * rhs.m[0][2] + m[1][1] * rhs.m[1][2] + m[1][2]);
+	}
+
+	Matrix3& Matrix3::operator*=(const Matrix3& rhs)
+	{
+		*this = *this * rhs;
+		return *this;
+	}
+
+	Matrix3 Matrix3::Inverse() const
+	{
+		float det = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+		if (det == 0.0f)
+			return Matrix3();
+
+		float inv = 1.0f / det;
+
+		float i00 = m[1][1] * inv;
+		float i01 = -m[0][1] * inv;
+		float i10 = -m[1][0] * inv;
+		float i11 = m[0][0] * inv;
+
+		return Matrix3(
+			i00, i01, -(i00 * m[0][2] + i01 * m[1][2]),
+			i10, i11, -(i10 * m[0][2] + i11 * m[1][2]));
+	}
+
+	void Matrix3::TransformPoints(std::span<const Vector2f> in, std::span<Vector2f> out) const
+	{
+		size_t count = std::min(in.size(), out.size());
+
+		const float* src = (const float*)in.data();
+		float* dst = (float*)out.data();
+
+		size_t i = 0;
+
+	#if defined(DGE_MATRIX3_SSE2)
+		// Two interleaved points per register: (x0, y0, x1, y1)
+		__m128 col0 = _mm_setr_ps(m[0][0], m[1][0], m[0][0], m[1][0]);
+		__m128 col1 = _mm_setr_ps(m[0][1], m[1][1], m[0][1], m[1][1]);
+		__m128 col2 = _mm_setr_ps(m[0][2], m[1][2], m[0][2], m[1][2]);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 p0 = _mm_loadu_ps(src + i * 2);
+			__m128 p1 = _mm_loadu_ps(src + i * 2 + 4);
+
+			__m128 x0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(2, 2, 0, 0));
+			__m128 y0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 3, 1, 1));
+			__m128 x1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(2, 2, 0, 0));
+			__m128 y1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 3, 1, 1));
+
+			_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, col0), _mm_mul_ps(y0, col1)), col2));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, col0), _mm_mul_ps(y1, col1)), col2));
+		}
+	#elif defined(DGE_MATRIX3_NEON)
+		// Four points are split into the X and the Y lanes while loading
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4x2_t p = vld2q_f32(src + i * 2);
+			float32x4x2_t r;
+
+			r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[0][2]), p.val[0], m[0][0]), p.val[1], m[0][1]);
+			r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[1][2]), p.val[0], m[1][0]), p.val[1], m[1][1]);
+
+			vst2q_f32(dst + i * 2, r);
+		}
+	#endif
+
+		for (; i < count; i++)
+			out[i] = Transform(in[i]);
+	}
+
+	void Matrix3::TransformPoints(const float* inX, const float* inY, float* outX, float* outY, size_t count) const
+	{
+		size_t i = 0;
+
+	#if defined(DGE_MATRIX3_SSE2)
+		__m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]);
+		__m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(inX + i);
+			__m128 y = _mm_loadu_ps(inY + i);
+
+			_mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m01)), m02));
+			_mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m10), _mm_mul_ps(y, m11)), m12));
+		}
+	#elif defined(DGE_MATRIX3_NEON)
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t x = vld1q_f32(inX + i);
+			float32x4_t y = vld1q_f32(inY + i);
+
+			vst1q_f32(outX + i, vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[0][2]), x, m[0][0]), y, m[0][1]));
+			vst1q_f32(outY + i, vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[1][2]), x, m[1][0]), y, m[1][1]));
+		}
+	#endif
+
+		for (; i < count; i++)
+		{
+			float x = inX[i], y = inY[i];
+
+			outX[i] = m[0][0] * x + m[0][1] * y + m[0][2];
+			outY[i] = m[1][0] * x + m[1][1] * y + m[1][2];
+		}
+	}
+
+	bool Matrix3::IsAxisAligned() const
+	{
+		return m[0][1] == 0.0f && m[1][0] == 0.0f;
+	}
+
+	float Matrix3::GetRotation() const
+	{
+		return atan2f(m[1][0], m[0][0]);
+	}
+
+	Vector2f Matrix3::GetScale() const
+	{
+		float scaleX = sqrtf(m[0][0] * m[0][0] + m[1][0] * m[1][0]);
+
+		if (scaleX == 0.0f)
+			return { 0.0f, 0.0f };
+
+		return { scaleX, (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / scaleX };
+	}
+
+	Vector2f Matrix3::GetTranslation() const
+	{
+		return { m[0][2], m[1][2] };
+	}
+}
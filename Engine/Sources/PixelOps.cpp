@@ -0,0 +1,485 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "PixelOps.hpp"
+
+#include <algorithm>
+
+// DGE_PIXEL_OPS_NO_SIMD and DGE_PIXEL_OPS_NO_AVX2 leave out the wider paths,
+// the tests build this file once per path to compare them
+
+#if defined(DGE_PIXEL_OPS_NO_SIMD)
+	// Only the scalar loops
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DGE_PIXEL_OPS_SSE2
+
+	#if defined(__AVX2__) && !defined(DGE_PIXEL_OPS_NO_AVX2)
+		#include <immintrin.h>
+		#define DGE_PIXEL_OPS_AVX2
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define DGE_PIXEL_OPS_NEON
+#endif
+
+namespace def
+{
+	// The pixels are read as arrays of bytes and 32-bit words
+	static_assert(sizeof(Pixel) == 4, "Pixel must be 4 bytes");
+
+	// Rounded x / 255 for x in [0, 255 * 255], every SIMD path below does the same
+	static inline uint32_t Div255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	// 255 / alpha in 16.16 fixed point for the unpremultiplication
+	struct Reciprocals
+	{
+		constexpr Reciprocals()
+		{
+			for (uint32_t i = 1; i < 256; i++)
+				values[i] = (255u * 65536u + i / 2) / i;
+		}
+
+		uint32_t values[256] = {};
+	};
+
+	// Filled at compile time so nothing of this file runs before the first call
+	static constexpr Reciprocals s_Reciprocals;
+
+	static inline uint32_t LerpFactor(float factor)
+	{
+		return (uint32_t)std::clamp((int)(factor * 256.0f + 0.5f), 0, 256);
+	}
+
+#if defined(DGE_PIXEL_OPS_SSE2)
+	static inline __m128i Div255_SSE2(__m128i x)
+	{
+		x = _mm_add_epi16(x, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	// 4 pixels times 4 pixels divided by 255
+	static inline __m128i Modulate_SSE2(__m128i a, __m128i b)
+	{
+		__m128i zero = _mm_setzero_si128();
+
+		__m128i lo = Div255_SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+		__m128i hi = Div255_SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+
+		return _mm_packus_epi16(lo, hi);
+	}
+#endif
+
+#if defined(DGE_PIXEL_OPS_AVX2)
+	static inline __m256i Div255_AVX2(__m256i x)
+	{
+		x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+	}
+
+	// The unpacks and the pack work per 128-bit lane so the order is kept
+	static inline __m256i Modulate_AVX2(__m256i a, __m256i b)
+	{
+		__m256i zero = _mm256_setzero_si256();
+
+		__m256i lo = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)));
+		__m256i hi = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)));
+
+		return _mm256_packus_epi16(lo, hi);
+	}
+#endif
+
+#if defined(DGE_PIXEL_OPS_NEON)
+	// Rounded x / 255 of 8 products narrowed back to bytes
+	static inline uint8x8_t Div255_NEON(uint16x8_t x)
+	{
+		x = vaddq_u16(x, vdupq_n_u16(128));
+		return vshrn_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+	}
+#endif
+
+	void PixelOps::Lerp(std::span<const Pixel> from, std::span<const Pixel> to, float factor, std::span<Pixel> out)
+	{
+		size_t count = std::min({ from.size(), to.size(), out.size() });
+
+		const uint8_t* src1 = (const uint8_t*)from.data();
+		const uint8_t* src2 = (const uint8_t*)to.data();
+		uint8_t* dst = (uint8_t*)out.data();
+
+		// from * (256 - f) + to * f never exceeds 255 * 256 so it fits into 16 bits
+		uint32_t f = LerpFactor(factor);
+		uint32_t invf = 256 - f;
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_AVX2)
+		{
+			__m256i zero = _mm256_setzero_si256();
+			__m256i vf = _mm256_set1_epi16((short)f);
+			__m256i vinvf = _mm256_set1_epi16((short)invf);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i a = _mm256_loadu_si256((const __m256i*)(src1 + i * 4));
+				__m256i b = _mm256_loadu_si256((const __m256i*)(src2 + i * 4));
+
+				__m256i lo = _mm256_add_epi16(
+					_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), vinvf),
+					_mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), vf));
+
+				__m256i hi = _mm256_add_epi16(
+					_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), vinvf),
+					_mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), vf));
+
+				_mm256_storeu_si256((__m256i*)(dst + i * 4),
+					_mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+			}
+		}
+	#endif
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i vf = _mm_set1_epi16((short)f);
+			__m128i vinvf = _mm_set1_epi16((short)invf);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i a = _mm_loadu_si128((const __m128i*)(src1 + i * 4));
+				__m128i b = _mm_loadu_si128((const __m128i*)(src2 + i * 4));
+
+				__m128i lo = _mm_add_epi16(
+					_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), vinvf),
+					_mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), vf));
+
+				__m128i hi = _mm_add_epi16(
+					_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), vinvf),
+					_mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), vf));
+
+				_mm_storeu_si128((__m128i*)(dst + i * 4),
+					_mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+			}
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		{
+			uint16x8_t vf = vdupq_n_u16((uint16_t)f);
+			uint16x8_t vinvf = vdupq_n_u16((uint16_t)invf);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				uint8x16_t a = vld1q_u8(src1 + i * 4);
+				uint8x16_t b = vld1q_u8(src2 + i * 4);
+
+				uint16x8_t lo = vmlaq_u16(vmulq_u16(vmovl_u8(vget_low_u8(a)), vinvf), vmovl_u8(vget_low_u8(b)), vf);
+				uint16x8_t hi = vmlaq_u16(vmulq_u16(vmovl_u8(vget_high_u8(a)), vinvf), vmovl_u8(vget_high_u8(b)), vf);
+
+				vst1q_u8(dst + i * 4, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+			}
+		}
+	#endif
+
+		for (i *= 4; i < count * 4; i++)
+			dst[i] = uint8_t((src1[i] * invf + src2[i] * f) >> 8);
+	}
+
+	void PixelOps::Modulate(std::span<const Pixel> src, const Pixel& tint, std::span<Pixel> out)
+	{
+		size_t count = std::min(src.size(), out.size());
+
+		const uint8_t* src1 = (const uint8_t*)src.data();
+		uint8_t* dst = (uint8_t*)out.data();
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_AVX2)
+		{
+			__m256i t = _mm256_set1_epi32((int)tint.rgba_n);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i a = _mm256_loadu_si256((const __m256i*)(src1 + i * 4));
+				_mm256_storeu_si256((__m256i*)(dst + i * 4), Modulate_AVX2(a, t));
+			}
+		}
+	#endif
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		{
+			__m128i t = _mm_set1_epi32((int)tint.rgba_n);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i a = _mm_loadu_si128((const __m128i*)(src1 + i * 4));
+				_mm_storeu_si128((__m128i*)(dst + i * 4), Modulate_SSE2(a, t));
+			}
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		{
+			uint8x16_t t = vreinterpretq_u8_u32(vdupq_n_u32(tint.rgba_n));
+
+			for (; i + 4 <= count; i += 4)
+			{
+				uint8x16_t a = vld1q_u8(src1 + i * 4);
+
+				uint8x8_t lo = Div255_NEON(vmull_u8(vget_low_u8(a), vget_low_u8(t)));
+				uint8x8_t hi = Div255_NEON(vmull_u8(vget_high_u8(a), vget_high_u8(t)));
+
+				vst1q_u8(dst + i * 4, vcombine_u8(lo, hi));
+			}
+		}
+	#endif
+
+		const uint8_t* t = tint.rgba_v;
+
+		for (i *= 4; i < count * 4; i++)
+			dst[i] = (uint8_t)Div255(src1[i] * t[i % 4]);
+	}
+
+	void PixelOps::Modulate(std::span<const Pixel> src1, std::span<const Pixel> src2, std::span<Pixel> out)
+	{
+		size_t count = std::min({ src1.size(), src2.size(), out.size() });
+
+		const uint8_t* a = (const uint8_t*)src1.data();
+		const uint8_t* b = (const uint8_t*)src2.data();
+		uint8_t* dst = (uint8_t*)out.data();
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_AVX2)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i va = _mm256_loadu_si256((const __m256i*)(a + i * 4));
+			__m256i vb = _mm256_loadu_si256((const __m256i*)(b + i * 4));
+
+			_mm256_storeu_si256((__m256i*)(dst + i * 4), Modulate_AVX2(va, vb));
+		}
+	#endif
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i va = _mm_loadu_si128((const __m128i*)(a + i * 4));
+			__m128i vb = _mm_loadu_si128((const __m128i*)(b + i * 4));
+
+			_mm_storeu_si128((__m128i*)(dst + i * 4), Modulate_SSE2(va, vb));
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		for (; i + 4 <= count; i += 4)
+		{
+			uint8x16_t va = vld1q_u8(a + i * 4);
+			uint8x16_t vb = vld1q_u8(b + i * 4);
+
+			uint8x8_t lo = Div255_NEON(vmull_u8(vget_low_u8(va), vget_low_u8(vb)));
+			uint8x8_t hi = Div255_NEON(vmull_u8(vget_high_u8(va), vget_high_u8(vb)));
+
+			vst1q_u8(dst + i * 4, vcombine_u8(lo, hi));
+		}
+	#endif
+
+		for (i *= 4; i < count * 4; i++)
+			dst[i] = (uint8_t)Div255(a[i] * b[i]);
+	}
+
+	void PixelOps::AddSaturate(std::span<const Pixel> src1, std::span<const Pixel> src2, std::span<Pixel> out)
+	{
+		size_t count = std::min({ src1.size(), src2.size(), out.size() });
+
+		const uint8_t* a = (const uint8_t*)src1.data();
+		const uint8_t* b = (const uint8_t*)src2.data();
+		uint8_t* dst = (uint8_t*)out.data();
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_AVX2)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i va = _mm256_loadu_si256((const __m256i*)(a + i * 4));
+			__m256i vb = _mm256_loadu_si256((const __m256i*)(b + i * 4));
+
+			_mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_adds_epu8(va, vb));
+		}
+	#endif
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i va = _mm_loadu_si128((const __m128i*)(a + i * 4));
+			__m128i vb = _mm_loadu_si128((const __m128i*)(b + i * 4));
+
+			_mm_storeu_si128((__m128i*)(dst + i * 4), _mm_adds_epu8(va, vb));
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		for (; i + 4 <= count; i += 4)
+			vst1q_u8(dst + i * 4, vqaddq_u8(vld1q_u8(a + i * 4), vld1q_u8(b + i * 4)));
+	#endif
+
+		for (i *= 4; i < count * 4; i++)
+			dst[i] = (uint8_t)std::min(a[i] + b[i], 255);
+	}
+
+	void PixelOps::Grayscale(std::span<const Pixel> src, std::span<Pixel> out)
+	{
+		size_t count = std::min(src.size(), out.size());
+
+		const Pixel* in = src.data();
+		Pixel* dst = out.data();
+
+		// 77 + 150 + 29 = 256 so white stays white
+		constexpr uint32_t WEIGHT_R = 77;
+		constexpr uint32_t WEIGHT_G = 150;
+		constexpr uint32_t WEIGHT_B = 29;
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		{
+			__m128i zero = _mm_setzero_si128();
+			__m128i weights = _mm_setr_epi16(WEIGHT_R, WEIGHT_G, WEIGHT_B, 0, WEIGHT_R, WEIGHT_G, WEIGHT_B, 0);
+			__m128i round = _mm_set1_epi32(128);
+			__m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i p = _mm_loadu_si128((const __m128i*)(in + i));
+
+				// (77r + 150g, 29b) pairs for 2 pixels in each half
+				__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(p, zero), weights);
+				__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(p, zero), weights);
+
+				lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+				hi = _mm_add_epi32(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+
+				// One luma per 32-bit lane in the order of the pixels
+				__m128i y = _mm_unpacklo_epi64(
+					_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)),
+					_mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+
+				y = _mm_srli_epi32(_mm_add_epi32(y, round), 8);
+				y = _mm_or_si128(_mm_or_si128(y, _mm_slli_epi32(y, 8)), _mm_slli_epi32(y, 16));
+
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(y, _mm_and_si128(p, alphaMask)));
+			}
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t p = vld4_u8((const uint8_t*)(in + i));
+
+			uint16x8_t sum = vmull_u8(p.val[0], vdup_n_u8(WEIGHT_R));
+			sum = vmlal_u8(sum, p.val[1], vdup_n_u8(WEIGHT_G));
+			sum = vmlal_u8(sum, p.val[2], vdup_n_u8(WEIGHT_B));
+
+			uint8x8_t y = vrshrn_n_u16(sum, 8);
+
+			p.val[0] = y;
+			p.val[1] = y;
+			p.val[2] = y;
+
+			vst4_u8((uint8_t*)(dst + i), p);
+		}
+	#endif
+
+		for (; i < count; i++)
+		{
+			const Pixel& p = in[i];
+			uint8_t y = uint8_t((p.r * WEIGHT_R + p.g * WEIGHT_G + p.b * WEIGHT_B + 128) >> 8);
+
+			dst[i] = Pixel(y, y, y, p.a);
+		}
+	}
+
+	void PixelOps::Premultiply(std::span<const Pixel> src, std::span<Pixel> out)
+	{
+		size_t count = std::min(src.size(), out.size());
+
+		const Pixel* in = src.data();
+		Pixel* dst = out.data();
+
+		size_t i = 0;
+
+	#if defined(DGE_PIXEL_OPS_SSE2)
+		{
+			__m128i zero = _mm_setzero_si128();
+
+			// Div255(a * 255) is a so the alpha goes through the same multiplication
+			__m128i alphaLane = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+			__m128i colourMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i p = _mm_loadu_si128((const __m128i*)(in + i));
+
+				__m128i lo = _mm_unpacklo_epi8(p, zero);
+				__m128i hi = _mm_unpackhi_epi8(p, zero);
+
+				__m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				__m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+				alphaLo = _mm_or_si128(_mm_and_si128(alphaLo, colourMask), alphaLane);
+				alphaHi = _mm_or_si128(_mm_and_si128(alphaHi, colourMask), alphaLane);
+
+				lo = Div255_SSE2(_mm_mullo_epi16(lo, alphaLo));
+				hi = Div255_SSE2(_mm_mullo_epi16(hi, alphaHi));
+
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+			}
+		}
+	#elif defined(DGE_PIXEL_OPS_NEON)
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t p = vld4_u8((const uint8_t*)(in + i));
+
+			p.val[0] = Div255_NEON(vmull_u8(p.val[0], p.val[3]));
+			p.val[1] = Div255_NEON(vmull_u8(p.val[1], p.val[3]));
+			p.val[2] = Div255_NEON(vmull_u8(p.val[2], p.val[3]));
+
+			vst4_u8((uint8_t*)(dst + i), p);
+		}
+	#endif
+
+		for (; i < count; i++)
+		{
+			const Pixel& p = in[i];
+
+			dst[i] = Pixel(
+				(uint8_t)Div255(p.r * p.a),
+				(uint8_t)Div255(p.g * p.a),
+				(uint8_t)Div255(p.b * p.a),
+				p.a);
+		}
+	}
+
+	void PixelOps::Unpremultiply(std::span<const Pixel> src, std::span<Pixel> out)
+	{
+		size_t count = std::min(src.size(), out.size());
+
+		// A division per channel doesn't map onto SSE2 or NEON,
+		// so it's a multiplication by a reciprocal from the table instead
+		for (size_t i = 0; i < count; i++)
+		{
+			Pixel p = src[i];
+
+			if (p.a == 0)
+			{
+				out[i] = Pixel(0, 0, 0, 0);
+				continue;
+			}
+
+			uint32_t recip = s_Reciprocals.values[p.a];
+
+			out[i] = Pixel(
+				(uint8_t)std::min((p.r * recip + 32768) >> 16, 255u),
+				(uint8_t)std::min((p.g * recip + 32768) >> 16, 255u),
+				(uint8_t)std::min((p.b * recip + 32768) >> 16, 255u),
+				p.a);
+		}
+	}
+}
@@ -32,4 +32,38 @@ namespace def
     {
         m_Input = input;
     }
+
+    bool Platform::IsPaletteSupported() const
+    {
+        return false;
+    }
+
+    void Platform::DrawPalettedTexture(const TextureInstance& texInst, const Texture*) const
+    {
+        DrawTexture(texInst);
+    }
+
+    void Platform::DrawTextures(const std::vector<TextureInstance>& textures) const
+    {
+        m_RenderStats.submitted += (uint32_t)textures.size();
+
+        for (const auto& texInst : textures)
+            DrawTexture(texInst);
+    }
+
+    void Platform::CountCulledTextures(uint32_t count)
+    {
+        m_RenderStats.culled += count;
+    }
+
+    const RenderStats& Platform::GetRenderStats() const
+    {
+        return m_LastRenderStats;
+    }
+
+    void Platform::ResetRenderStats()
+    {
+        m_LastRenderStats = m_RenderStats;
+        m_RenderStats = {};
+    }
 }
@@ -72,6 +72,11 @@ namespace def
 
 	}
 
+	void PlatformEmscripten::WaitEvents(float timeout) const
+	{
+		// The browser drives the main loop so we can't block here
+	}
+
 	void PlatformEmscripten::DrawQuad(const Pixel& tint) const
 	{
 		glBindBuffer(GL_ARRAY_BUFFER, m_VbQuad);
@@ -84,14 +89,26 @@ namespace def
 
 		glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * 4, verts, GL_STREAM_DRAW);
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += 4;
 	}
 
 	void PlatformEmscripten::DrawTexture(const TextureInstance& texInst) const
 	{
+		if (texInst.drawList)
+		{
+			DrawTextureList(texInst);
+			return;
+		}
+
 		BindTexture(texInst.texture ? texInst.texture->id : 0);
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_VbQuad);
 
+		if (m_VertexMemory.size() < texInst.points)
+			m_VertexMemory.resize(texInst.points);
+
 		for (uint32_t i = 0; i < texInst.points; i++)
 		{
 			m_VertexMemory[i].pos[0] = texInst.vertices[i].x;
@@ -103,7 +120,7 @@ namespace def
 			m_VertexMemory[i].col = texInst.tint[i];
 		}
 
-		glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * texInst.points, m_VertexMemory, GL_STREAM_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * texInst.points, m_VertexMemory.data(), GL_STREAM_DRAW);
 
 		switch (texInst.structure)
 		{
@@ -114,6 +131,101 @@ namespace def
 		case Texture::Structure::LINES: glDrawArrays(GL_LINES, 0, texInst.points); break;
 		case Texture::Structure::DEFAULT: glDrawArrays(GL_TRIANGLES, 0, texInst.points); break;
 		}
+
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += texInst.points;
+	}
+
+	bool PlatformEmscripten::IsPaletteSupported() const
+	{
+		return m_PaletteProgram != 0;
+	}
+
+	void PlatformEmscripten::DrawPalettedTexture(const TextureInstance& texInst, const Texture* palette) const
+	{
+		if (!palette || m_PaletteProgram == 0)
+		{
+			DrawTexture(texInst);
+			return;
+		}
+
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, palette->id);
+		glActiveTexture(GL_TEXTURE0);
+
+		m_RenderStats.textureBinds++;
+
+		glUseProgram(m_PaletteProgram);
+		DrawTexture(texInst);
+		glUseProgram(m_QuadShader);
+
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	void PlatformEmscripten::DrawTextureList(const TextureInstance& texInst) const
+	{
+		const DrawList& list = *texInst.drawList;
+
+		// The shader doesn't have a transform so the vertices
+		// are uploaded again only when the transform or the tint changes
+		bool changed;
+		const auto& vertices = list.Bake(texInst.listOffset, texInst.listScale, texInst.tint.empty() ? WHITE : texInst.tint[0], changed);
+
+		if (vertices.empty())
+			return;
+
+		if (list.m_Buffer == 0)
+			glGenBuffers(1, &list.m_Buffer);
+
+		glBindBuffer(GL_ARRAY_BUFFER, list.m_Buffer);
+
+		if (!list.m_IsUploaded)
+		{
+			m_ListVertices.resize(vertices.size());
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				m_ListVertices[i].pos[0] = vertices[i].pos.x;
+				m_ListVertices[i].pos[1] = vertices[i].pos.y;
+				m_ListVertices[i].pos[2] = 1.0f;
+				m_ListVertices[i].uv = vertices[i].uv;
+				m_ListVertices[i].col = vertices[i].col;
+			}
+
+			glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * m_ListVertices.size(), m_ListVertices.data(), GL_STATIC_DRAW);
+			list.m_IsUploaded = true;
+		}
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(5 * sizeof(float)));
+
+		for (const auto& batch : list.GetBatches())
+		{
+			BindTexture(batch.texture ? batch.texture->id : 0);
+			glDrawArrays(batch.lines ? GL_LINES : GL_TRIANGLES, batch.first, batch.count);
+
+			m_RenderStats.drawCalls++;
+			m_RenderStats.vertices += batch.count;
+		}
+
+		// The other textures are streamed through the quad buffer
+		glBindBuffer(GL_ARRAY_BUFFER, m_VbQuad);
+
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(5 * sizeof(float)));
+	}
+
+	void PlatformEmscripten::DestroyDrawList(DrawList& list)
+	{
+		if (list.m_Buffer != 0)
+			glDeleteBuffers(1, &list.m_Buffer);
+
+		list.m_Buffer = 0;
+		list.m_IsUploaded = false;
 	}
 
 	void PlatformEmscripten::BindTexture(int id) const
@@ -122,6 +234,99 @@ namespace def
 			glBindTexture(GL_TEXTURE_2D, id);
 		else
 			glBindTexture(GL_TEXTURE_2D, m_BlankQuad.texture->id);
+
+		m_RenderStats.textureBinds++;
+	}
+
+	void PlatformEmscripten::CreateRenderTarget(RenderTarget& target)
+	{
+		GLuint framebuffer;
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.GetTexture()->id, 0);
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			Log::Error("[WebGL] Framebuffer is incomplete: 0x", std::hex, status);
+			glDeleteFramebuffers(1, &framebuffer);
+			return;
+		}
+
+		target.m_Framebuffer = framebuffer;
+	}
+
+	void PlatformEmscripten::DestroyRenderTarget(RenderTarget& target)
+	{
+		if (target.m_PixelBuffer != 0)
+			glDeleteBuffers(1, &target.m_PixelBuffer);
+
+		if (target.m_Framebuffer != 0)
+			glDeleteFramebuffers(1, &target.m_Framebuffer);
+
+		target.m_PixelBuffer = 0;
+		target.m_Framebuffer = 0;
+	}
+
+	void PlatformEmscripten::DrawRenderTarget(RenderTarget& target)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, target.m_Framebuffer);
+		glViewport(0, 0, target.GetSize().x, target.GetSize().y);
+
+		if (target.m_IsClearPending)
+			ClearBuffer(target.m_ClearColour);
+
+		for (const auto& texInst : target.m_Textures)
+			DrawTexture(texInst);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+	void PlatformEmscripten::BeginReadback(RenderTarget& target)
+	{
+		Sprite* sprite = target.m_Graphic.sprite;
+
+		// The buffer has the rows with the stride of the sprite, so it's copied into the sprite at once
+		if (target.m_PixelBuffer == 0)
+		{
+			glGenBuffers(1, &target.m_PixelBuffer);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+			glBufferData(GL_PIXEL_PACK_BUFFER, sprite->pixels.size() * sizeof(Pixel), nullptr, GL_STREAM_READ);
+		}
+		else
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+
+		// The call returns immediately and the copy is done by the GPU
+		glBindFramebuffer(GL_FRAMEBUFFER, target.m_Framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glPixelStorei(GL_PACK_ROW_LENGTH, sprite->stride);
+		glReadPixels(0, 0, sprite->size.x, sprite->size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	void PlatformEmscripten::FinishReadback(RenderTarget& target)
+	{
+		if (target.m_PixelBuffer == 0)
+			return;
+
+		Sprite* sprite = target.m_Graphic.sprite;
+
+		// The padding after the last row isn't written by glReadPixels
+		size_t count = (size_t)(sprite->size.y - 1) * sprite->stride + sprite->size.x;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+		glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, count * sizeof(Pixel), sprite->pixels.data());
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 	}
 
 	bool PlatformEmscripten::ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel)
@@ -129,7 +334,7 @@ namespace def
 		emscripten_set_canvas_element_size("#canvas", windowSize.x, windowSize.y);
 
 		const EGLint attributes[] = { EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8, EGL_NONE };
-		const EGLint configAttributes[] = { EGL_CONTEXT_CLIENT_VERSION , 2, EGL_NONE };
+		const EGLint configAttributes[] = { EGL_CONTEXT_CLIENT_VERSION , 3, EGL_NONE };
 		EGLint configsCount;
 
 		m_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
@@ -173,6 +378,42 @@ namespace def
 
 		glLinkProgram(m_QuadShader);
 
+		// The same vertices, but the colour comes from the palette at the index in the red channel
+		m_PaletteShader = glCreateShader(GL_FRAGMENT_SHADER);
+
+		const GLchar* paletteShader =
+			"#version 300 es\n"
+			"precision mediump float;"
+			"out vec4 pixel;\n""in vec2 oTex;\n""in vec4 oCol;\n"
+			"uniform sampler2D sprTex;\n""uniform sampler2D palette;\n"
+			"void main(){float index = texture(sprTex, oTex).r; pixel = texture(palette, vec2((index * 255.0 + 0.5) / 256.0, 0.5)) * oCol;}";
+
+		glShaderSource(m_PaletteShader, 1, &paletteShader, NULL);
+		glCompileShader(m_PaletteShader);
+
+		m_PaletteProgram = glCreateProgram();
+
+		glAttachShader(m_PaletteProgram, m_PaletteShader);
+		glAttachShader(m_PaletteProgram, m_VertexShader);
+
+		glLinkProgram(m_PaletteProgram);
+
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(m_PaletteProgram, GL_LINK_STATUS, &isLinked);
+
+		if (isLinked)
+		{
+			glUseProgram(m_PaletteProgram);
+			glUniform1i(glGetUniformLocation(m_PaletteProgram, "sprTex"), 0);
+			glUniform1i(glGetUniformLocation(m_PaletteProgram, "palette"), 1);
+			glUseProgram(0);
+		}
+		else
+		{
+			glDeleteProgram(m_PaletteProgram);
+			m_PaletteProgram = 0;
+		}
+
 		glGenBuffers(1, &m_VbQuad);
 		glGenVertexArraysOES(1, &m_VaQuad);
 
@@ -238,14 +479,50 @@ namespace def
 		return EM_FALSE;
 	}
 
+	// Decodes the UTF-8 name of a key if it's a single code point, e.g. "a" or "€" but not "Enter"
+	static bool DecodeKey(const char* key, uint32_t& codePoint)
+	{
+		const uint8_t* c = (const uint8_t*)key;
+
+		int length;
+
+		if (c[0] < 0x80) { codePoint = c[0]; length = 1; }
+		else if ((c[0] & 0xE0) == 0xC0) { codePoint = c[0] & 0x1F; length = 2; }
+		else if ((c[0] & 0xF0) == 0xE0) { codePoint = c[0] & 0x0F; length = 3; }
+		else if ((c[0] & 0xF8) == 0xF0) { codePoint = c[0] & 0x07; length = 4; }
+		else return false;
+
+		for (int i = 1; i < length; i++)
+		{
+			if ((c[i] & 0xC0) != 0x80)
+				return false;
+
+			codePoint = (codePoint << 6) | (c[i] & 0x3F);
+		}
+
+		return codePoint >= 0x20 && codePoint != 0x7F && c[length] == '\0';
+	}
+
 	EM_BOOL PlatformEmscripten::KeyboardCallback(int eventType, const EmscriptenKeyboardEvent* event, void* userData)
 	{
 		auto e = m_Engine->GetInput();
 
 		switch (eventType)
 		{
-		case EMSCRIPTEN_EVENT_KEYDOWN: e->m_KeyNewState[size_t(InputHandler::s_KeysTable[emscripten_compute_dom_pk_code(event->code)])] = true; break;
-		case EMSCRIPTEN_EVENT_KEYUP: e->m_KeyNewState[size_t(InputHandler::s_KeysTable[emscripten_compute_dom_pk_code(event->code)])] = false; break;
+		case EMSCRIPTEN_EVENT_KEYDOWN:
+		{
+			e->PushKeyEvent(InputHandler::MapKey(emscripten_compute_dom_pk_code(event->code)), true, event->repeat);
+
+			// keypress never comes because the default action of keydown is prevented,
+			// so the character is taken from the key, it's a single code point only for the printable keys
+			uint32_t codePoint;
+
+			if (!event->ctrlKey && !event->metaKey && DecodeKey(event->key, codePoint))
+				e->PushCharEvent(codePoint);
+		}
+		break;
+
+		case EMSCRIPTEN_EVENT_KEYUP: e->PushKeyEvent(InputHandler::MapKey(emscripten_compute_dom_pk_code(event->code)), false, false); break;
 		}
 
 		return EM_TRUE;
@@ -254,7 +531,7 @@ namespace def
 	EM_BOOL PlatformEmscripten::WheelCallback(int eventType, const EmscriptenWheelEvent* event, void* userData)
 	{
 		if (eventType == EMSCRIPTEN_EVENT_WHEEL)
-			m_Engine->GetInput()->m_ScrollDelta = -int(event->deltaY);
+			m_Engine->GetInput()->PushScrollEvent({ -(float)event->deltaX, -(float)event->deltaY });
 
 		return EM_TRUE;
 	}
@@ -267,23 +544,18 @@ namespace def
 		switch (eventType)
 		{
 		case EMSCRIPTEN_EVENT_TOUCHMOVE:
-		{
-			i->m_MousePos.x = event->touches->targetX / w->m_PixelSize.x;
-			i->m_MousePos.y = event->touches->targetY / w->m_PixelSize.y;
-		}
+			i->PushMoveEvent(Vector2i(event->touches->targetX, event->touches->targetY) / w->m_PixelSize);
 		break;
 
 		case EMSCRIPTEN_EVENT_TOUCHSTART:
 		{
-			i->m_MousePos.x = event->touches->targetX;
-			i->m_MousePos.y = event->touches->targetY;
-
-			i->m_MouseNewState[0] = true;
+			i->PushMoveEvent(Vector2i(event->touches->targetX, event->touches->targetY));
+			i->PushButtonEvent(Button::LEFT, true);
 		}
 		break;
 
 		case EMSCRIPTEN_EVENT_TOUCHEND:
-			i->m_MouseNewState[0] = false;
+			i->PushButtonEvent(Button::LEFT, false);
 		break;
 
 		}
@@ -298,8 +570,7 @@ namespace def
 
 		if (eventType == EMSCRIPTEN_EVENT_MOUSEMOVE)
 		{
-			i->m_MousePos.x = event->targetX / w->m_PixelSize.x;
-			i->m_MousePos.y = event->targetY / w->m_PixelSize.y;
+			i->PushMoveEvent(Vector2i(event->targetX, event->targetY) / w->m_PixelSize);
 		}
 
 		auto check = [&](int button, int index)
@@ -308,8 +579,8 @@ namespace def
 				{
 					switch (eventType)
 					{
-					case EMSCRIPTEN_EVENT_MOUSEDOWN: i->m_MouseNewState[index] = true; break;
-					case EMSCRIPTEN_EVENT_MOUSEUP: i->m_MouseNewState[index] = false; break;
+					case EMSCRIPTEN_EVENT_MOUSEDOWN: i->PushButtonEvent(static_cast<Button>(index), true); break;
+					case EMSCRIPTEN_EVENT_MOUSEUP: i->PushButtonEvent(static_cast<Button>(index), false); break;
 					}
 
 					return true;
@@ -6,6 +6,12 @@
 
 #include "Pch.hpp"
 #include "PlatformGL.hpp"
+#include "RenderTarget.hpp"
+#include "DrawList.hpp"
+#include "Log.hpp"
+
+#include <cstring>
+#include <type_traits>
 
 #if defined(_WIN32)
 
@@ -45,8 +51,97 @@
 #define GL_CLAMP_TO_BORDER 0x812D
 #endif
 
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#endif
+
+#ifndef GL_TEXTURE1
+#define GL_TEXTURE1 0x84C1
+#endif
+
 namespace def
 {
+	// Functions that are loaded at runtime because
+	// they aren't a part of OpenGL 1.1
+	static struct
+	{
+		void (APIENTRY* GenFramebuffers)(GLsizei, GLuint*);
+		void (APIENTRY* DeleteFramebuffers)(GLsizei, const GLuint*);
+		void (APIENTRY* BindFramebuffer)(GLenum, GLuint);
+		void (APIENTRY* FramebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+		GLenum (APIENTRY* CheckFramebufferStatus)(GLenum);
+
+		void (APIENTRY* GenBuffers)(GLsizei, GLuint*);
+		void (APIENTRY* DeleteBuffers)(GLsizei, const GLuint*);
+		void (APIENTRY* BindBuffer)(GLenum, GLuint);
+		void (APIENTRY* BufferData)(GLenum, ptrdiff_t, const void*, GLenum);
+		void* (APIENTRY* MapBuffer)(GLenum, GLenum);
+		GLboolean (APIENTRY* UnmapBuffer)(GLenum);
+
+		GLuint (APIENTRY* CreateShader)(GLenum);
+		void (APIENTRY* DeleteShader)(GLuint);
+		void (APIENTRY* ShaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+		void (APIENTRY* CompileShader)(GLuint);
+		void (APIENTRY* GetShaderiv)(GLuint, GLenum, GLint*);
+		GLuint (APIENTRY* CreateProgram)();
+		void (APIENTRY* DeleteProgram)(GLuint);
+		void (APIENTRY* AttachShader)(GLuint, GLuint);
+		void (APIENTRY* LinkProgram)(GLuint);
+		void (APIENTRY* GetProgramiv)(GLuint, GLenum, GLint*);
+		void (APIENTRY* UseProgram)(GLuint);
+		GLint (APIENTRY* GetUniformLocation)(GLuint, const char*);
+		void (APIENTRY* Uniform1i)(GLint, GLint);
+		void (APIENTRY* ActiveTexture)(GLenum);
+	} s_GL;
+
 	PlatformGL::PlatformGL(GameEngine* engine) : Platform(engine)
 	{
 	}
@@ -76,12 +171,213 @@ namespace def
 			glTexCoord2f(1.0f, 0.0f); glVertex2f(1.0f, 1.0f);
 			glTexCoord2f(1.0f, 1.0f); glVertex2f(1.0f, -1.0f);
 		glEnd();
+
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += 4;
 	}
 
 	void PlatformGL::DrawTexture(const TextureInstance& texInst) const
 	{
+		if (texInst.drawList)
+		{
+			DrawTextureList(texInst);
+			return;
+		}
+
 		BindTexture(texInst.texture ? texInst.texture->id : 0);
+		DrawVertices(texInst);
+	}
+
+	void PlatformGL::DrawTextures(const std::vector<TextureInstance>& textures) const
+	{
+		m_RenderStats.submitted += (uint32_t)textures.size();
+
+		auto IsFilled = [](const TextureInstance& texInst)
+			{
+				return !texInst.drawList && (texInst.structure == Texture::Structure::DEFAULT ||
+					texInst.structure == Texture::Structure::TRIANGLE_FAN ||
+					texInst.structure == Texture::Structure::TRIANGLE_STRIP);
+			};
+
+		auto GetID = [](const TextureInstance& texInst)
+			{
+				return texInst.texture ? (int)texInst.texture->id : 0;
+			};
+
+		int boundTexture = -1;
+
+		for (size_t i = 0; i < textures.size();)
+		{
+			const TextureInstance& first = textures[i];
+
+			// The list binds its own textures
+			if (first.drawList)
+			{
+				DrawTextureList(first);
+				boundTexture = -1;
+				i++;
+
+				continue;
+			}
+
+			int id = GetID(first);
+
+			if (id != boundTexture)
+			{
+				BindTexture(id);
+				boundTexture = id;
+			}
+
+			// Polygons with the same texture are merged into a single list of triangles
+			size_t end = i + 1;
+
+			if (IsFilled(first))
+			{
+				while (end < textures.size() && GetID(textures[end]) == id && IsFilled(textures[end]))
+					end++;
+			}
+
+			if (end - i == 1)
+			{
+				DrawVertices(first);
+				i++;
+
+				continue;
+			}
+
+			if (id == 0)
+				glDisable(GL_TEXTURE_2D);
+
+			uint32_t vertices = 0;
+
+			auto Vertex = [&](const TextureInstance& texInst, uint32_t index)
+				{
+					const Pixel& tint = texInst.tint[index];
+					glColor4ub(tint.r, tint.g, tint.b, tint.a);
+
+					if (texInst.texture)
+						glTexCoord2f(texInst.uv[index].x, texInst.uv[index].y);
+
+					glVertex2f(texInst.vertices[index].x, texInst.vertices[index].y);
+					vertices++;
+				};
+
+			glBegin(GL_TRIANGLES);
+
+			for (; i < end; i++)
+			{
+				const TextureInstance& texInst = textures[i];
+
+				for (uint32_t j = 0; j + 2 < texInst.points; j += (texInst.structure == Texture::Structure::DEFAULT) ? 3 : 1)
+				{
+					switch (texInst.structure)
+					{
+					case Texture::Structure::TRIANGLE_FAN: Vertex(texInst, 0); Vertex(texInst, j + 1); Vertex(texInst, j + 2); break;
+					default: Vertex(texInst, j); Vertex(texInst, j + 1); Vertex(texInst, j + 2); break;
+					}
+				}
+			}
+
+			glEnd();
+
+			m_RenderStats.drawCalls++;
+			m_RenderStats.vertices += vertices;
+
+			if (id == 0)
+				glEnable(GL_TEXTURE_2D);
+		}
+	}
+
+	void PlatformGL::DrawTextureList(const TextureInstance& texInst) const
+	{
+		const DrawList& list = *texInst.drawList;
+
+		// The transform is done by the matrix so only a new tint changes the vertices
+		bool changed;
+		const auto& vertices = list.Bake({ 0.0f, 0.0f }, { 1.0f, 1.0f }, texInst.tint.empty() ? WHITE : texInst.tint[0], changed);
+
+		if (vertices.empty())
+			return;
+
+		LoadExtensions();
+
+		const char* data = (const char*)vertices.data();
+
+		if (m_HasBuffers)
+		{
+			if (list.m_Buffer == 0)
+				s_GL.GenBuffers(1, &list.m_Buffer);
+
+			s_GL.BindBuffer(GL_ARRAY_BUFFER, list.m_Buffer);
+
+			if (!list.m_IsUploaded)
+			{
+				s_GL.BufferData(GL_ARRAY_BUFFER, (ptrdiff_t)(vertices.size() * sizeof(DrawList::Vertex)), vertices.data(), GL_STATIC_DRAW);
+				list.m_IsUploaded = true;
+			}
+
+			// The pointers are offsets in the buffer
+			data = nullptr;
+		}
+
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glTranslatef(texInst.listOffset.x, texInst.listOffset.y, 0.0f);
+		glScalef(texInst.listScale.x, texInst.listScale.y, 1.0f);
+
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+
+		glVertexPointer(2, GL_FLOAT, sizeof(DrawList::Vertex), data + offsetof(DrawList::Vertex, pos));
+		glTexCoordPointer(2, GL_FLOAT, sizeof(DrawList::Vertex), data + offsetof(DrawList::Vertex, uv));
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(DrawList::Vertex), data + offsetof(DrawList::Vertex, col));
+
+		int boundTexture = -1;
+
+		for (const auto& batch : list.GetBatches())
+		{
+			int id = batch.texture ? batch.texture->id : 0;
+
+			if (id != boundTexture)
+			{
+				BindTexture(id);
+				boundTexture = id;
+			}
+
+			if (!batch.texture)
+				glDisable(GL_TEXTURE_2D);
+
+			glDrawArrays(batch.lines ? GL_LINES : GL_TRIANGLES, batch.first, batch.count);
+
+			if (!batch.texture)
+				glEnable(GL_TEXTURE_2D);
+
+			m_RenderStats.drawCalls++;
+			m_RenderStats.vertices += batch.count;
+		}
+
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+
+		glPopMatrix();
+
+		if (m_HasBuffers)
+			s_GL.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
 
+	void PlatformGL::DestroyDrawList(DrawList& list)
+	{
+		if (list.m_Buffer != 0)
+			s_GL.DeleteBuffers(1, &list.m_Buffer);
+
+		list.m_Buffer = 0;
+		list.m_IsUploaded = false;
+	}
+
+	void PlatformGL::DrawVertices(const TextureInstance& texInst) const
+	{
 		if (!texInst.texture)
 			glDisable(GL_TEXTURE_2D);
 
@@ -107,13 +403,114 @@ namespace def
 
 		glEnd();
 
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += texInst.points;
+
 		if (!texInst.texture)
 			glEnable(GL_TEXTURE_2D);
 	}
 
+	bool PlatformGL::IsPaletteSupported() const
+	{
+		return CreatePaletteProgram();
+	}
+
+	void PlatformGL::DrawPalettedTexture(const TextureInstance& texInst, const Texture* palette) const
+	{
+		if (!palette || !CreatePaletteProgram())
+		{
+			DrawTexture(texInst);
+			return;
+		}
+
+		s_GL.ActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, palette->id);
+		s_GL.ActiveTexture(GL_TEXTURE0);
+
+		m_RenderStats.textureBinds++;
+		BindTexture(texInst.texture ? texInst.texture->id : 0);
+
+		// Filtered indices would point at unrelated colours
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		s_GL.UseProgram(m_PaletteProgram);
+		DrawVertices(texInst);
+		s_GL.UseProgram(0);
+
+		s_GL.ActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		s_GL.ActiveTexture(GL_TEXTURE0);
+	}
+
+	bool PlatformGL::CreatePaletteProgram() const
+	{
+		if (m_IsPaletteProgramCreated)
+			return m_PaletteProgram != 0;
+
+		m_IsPaletteProgramCreated = true;
+
+		LoadExtensions();
+
+		if (!m_HasShaders)
+			return false;
+
+		// The rest of the pipeline is fixed-function, so only the colour of a fragment is replaced
+		const char* source =
+			"#version 110\n"
+			"uniform sampler2D indices;\n"
+			"uniform sampler2D palette;\n"
+			"void main()\n"
+			"{\n"
+			"	float index = texture2D(indices, gl_TexCoord[0].xy).r;\n"
+			"	gl_FragColor = texture2D(palette, vec2((index * 255.0 + 0.5) / 256.0, 0.5)) * gl_Color;\n"
+			"}\n";
+
+		GLuint shader = s_GL.CreateShader(GL_FRAGMENT_SHADER);
+		s_GL.ShaderSource(shader, 1, &source, nullptr);
+		s_GL.CompileShader(shader);
+
+		GLint status = 0;
+		s_GL.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+		if (!status)
+		{
+			Log::Warn("[OpenGL] The palette shader can't be compiled, indexed layers are resolved on the CPU");
+			s_GL.DeleteShader(shader);
+
+			return false;
+		}
+
+		GLuint program = s_GL.CreateProgram();
+		s_GL.AttachShader(program, shader);
+		s_GL.LinkProgram(program);
+
+		// The program keeps the shader alive
+		s_GL.DeleteShader(shader);
+		s_GL.GetProgramiv(program, GL_LINK_STATUS, &status);
+
+		if (!status)
+		{
+			Log::Warn("[OpenGL] The palette shader can't be linked, indexed layers are resolved on the CPU");
+			s_GL.DeleteProgram(program);
+
+			return false;
+		}
+
+		s_GL.UseProgram(program);
+		s_GL.Uniform1i(s_GL.GetUniformLocation(program, "indices"), 0);
+		s_GL.Uniform1i(s_GL.GetUniformLocation(program, "palette"), 1);
+		s_GL.UseProgram(0);
+
+		m_PaletteProgram = program;
+
+		return true;
+	}
+
 	void PlatformGL::BindTexture(int id) const
 	{
 		glBindTexture(GL_TEXTURE_2D, id);
+		m_RenderStats.textureBinds++;
 
 		switch (m_WrapMethod)
 		{
@@ -156,6 +553,173 @@ namespace def
 		}
 	}
 
+	void PlatformGL::CreateRenderTarget(RenderTarget& target)
+	{
+		if (!LoadExtensions())
+		{
+			Log::Error("[OpenGL] Framebuffers aren't supported, the render target can't be created");
+			return;
+		}
+
+		GLuint framebuffer;
+
+		s_GL.GenFramebuffers(1, &framebuffer);
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		s_GL.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.GetTexture()->id, 0);
+
+		GLenum status = s_GL.CheckFramebufferStatus(GL_FRAMEBUFFER);
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			Log::Error("[OpenGL] Framebuffer is incomplete: 0x", std::hex, status);
+			s_GL.DeleteFramebuffers(1, &framebuffer);
+			return;
+		}
+
+		target.m_Framebuffer = framebuffer;
+	}
+
+	void PlatformGL::DestroyRenderTarget(RenderTarget& target)
+	{
+		if (target.m_PixelBuffer != 0)
+			s_GL.DeleteBuffers(1, &target.m_PixelBuffer);
+
+		if (target.m_Framebuffer != 0)
+			s_GL.DeleteFramebuffers(1, &target.m_Framebuffer);
+
+		target.m_PixelBuffer = 0;
+		target.m_Framebuffer = 0;
+	}
+
+	void PlatformGL::DrawRenderTarget(RenderTarget& target)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, target.m_Framebuffer);
+		glViewport(0, 0, target.GetSize().x, target.GetSize().y);
+
+		if (target.m_IsClearPending)
+			ClearBuffer(target.m_ClearColour);
+
+		for (const auto& texInst : target.m_Textures)
+			DrawTexture(texInst);
+
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+	void PlatformGL::BeginReadback(RenderTarget& target)
+	{
+		// Without pixel buffers the pixels are read in FinishReadback
+		if (!m_HasPixelBuffers)
+			return;
+
+		const Vector2i& size = target.GetSize();
+
+		if (target.m_PixelBuffer == 0)
+		{
+			s_GL.GenBuffers(1, &target.m_PixelBuffer);
+			s_GL.BindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+			s_GL.BufferData(GL_PIXEL_PACK_BUFFER, (ptrdiff_t)size.x * size.y * sizeof(Pixel), nullptr, GL_STREAM_READ);
+		}
+		else
+			s_GL.BindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+
+		// The call returns immediately and the copy is done by the driver
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, target.m_Framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, 0);
+		s_GL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	void PlatformGL::FinishReadback(RenderTarget& target)
+	{
+		Sprite* sprite = target.m_Graphic.sprite;
+		size_t rowBytes = sprite->size.x * sizeof(Pixel);
+
+		if (m_HasPixelBuffers && target.m_PixelBuffer != 0)
+		{
+			s_GL.BindBuffer(GL_PIXEL_PACK_BUFFER, target.m_PixelBuffer);
+
+			// The buffer has the rows one after another
+			if (const uint8_t* data = (const uint8_t*)s_GL.MapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY))
+			{
+				for (int y = 0; y < sprite->size.y; y++)
+					memcpy(sprite->GetRow(y), data + y * rowBytes, rowBytes);
+
+				s_GL.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+
+			s_GL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			return;
+		}
+
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, target.m_Framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glPixelStorei(GL_PACK_ROW_LENGTH, sprite->stride);
+		glReadPixels(0, 0, sprite->size.x, sprite->size.y, GL_RGBA, GL_UNSIGNED_BYTE, sprite->pixels.data());
+		glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+		s_GL.BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void* PlatformGL::LoadFunction(const char*) const
+	{
+		return nullptr;
+	}
+
+	bool PlatformGL::LoadExtensions() const
+	{
+		if (m_IsExtensionsLoaded)
+			return m_HasFramebuffers;
+
+		m_IsExtensionsLoaded = true;
+
+		auto Load = [this](auto& function, const char* name)
+			{
+				function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(LoadFunction(name));
+				return function != nullptr;
+			};
+
+		m_HasFramebuffers =
+			Load(s_GL.GenFramebuffers, "glGenFramebuffers") &&
+			Load(s_GL.DeleteFramebuffers, "glDeleteFramebuffers") &&
+			Load(s_GL.BindFramebuffer, "glBindFramebuffer") &&
+			Load(s_GL.FramebufferTexture2D, "glFramebufferTexture2D") &&
+			Load(s_GL.CheckFramebufferStatus, "glCheckFramebufferStatus");
+
+		m_HasBuffers =
+			Load(s_GL.GenBuffers, "glGenBuffers") &&
+			Load(s_GL.DeleteBuffers, "glDeleteBuffers") &&
+			Load(s_GL.BindBuffer, "glBindBuffer") &&
+			Load(s_GL.BufferData, "glBufferData") &&
+			Load(s_GL.MapBuffer, "glMapBuffer") &&
+			Load(s_GL.UnmapBuffer, "glUnmapBuffer");
+
+		m_HasPixelBuffers = m_HasFramebuffers && m_HasBuffers;
+
+		m_HasShaders =
+			Load(s_GL.CreateShader, "glCreateShader") &&
+			Load(s_GL.DeleteShader, "glDeleteShader") &&
+			Load(s_GL.ShaderSource, "glShaderSource") &&
+			Load(s_GL.CompileShader, "glCompileShader") &&
+			Load(s_GL.GetShaderiv, "glGetShaderiv") &&
+			Load(s_GL.CreateProgram, "glCreateProgram") &&
+			Load(s_GL.DeleteProgram, "glDeleteProgram") &&
+			Load(s_GL.AttachShader, "glAttachShader") &&
+			Load(s_GL.LinkProgram, "glLinkProgram") &&
+			Load(s_GL.GetProgramiv, "glGetProgramiv") &&
+			Load(s_GL.UseProgram, "glUseProgram") &&
+			Load(s_GL.GetUniformLocation, "glGetUniformLocation") &&
+			Load(s_GL.Uniform1i, "glUniform1i") &&
+			Load(s_GL.ActiveTexture, "glActiveTexture");
+
+		return m_HasFramebuffers;
+	}
+
 	void PlatformGL::Destroy() const {}
 	void PlatformGL::SetTitle(const std::string_view text) const {}
 
@@ -163,6 +727,7 @@ namespace def
 	bool PlatformGL::IsWindowFocused() const { return false; }
 	void PlatformGL::FlushScreen(bool vsync) const {}
 	void PlatformGL::PollEvents() const {}
+	void PlatformGL::WaitEvents(float) const {}
 
 	bool PlatformGL::ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel) { return false; }
 	void PlatformGL::SetIcon(Sprite& icon) const {}
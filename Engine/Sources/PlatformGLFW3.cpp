@@ -23,9 +23,7 @@ namespace def
 	{
 		if (errorCode != GLFW_INVALID_ENUM)
 		{
-			std::cout << "[GLFW Error] "
-				<< "0x000" << std::hex << errorCode
-				<< ' ' << description << std::endl;
+			Log::Fatal("[GLFW Error] 0x000", std::hex, errorCode, ' ', description);
 
 			exit(1);
 		}
@@ -49,12 +47,10 @@ namespace def
 
 	void PlatformGLFW3::ScrollCallback(GLFWwindow* window, double x, double y)
 	{
-		(void)x;
-
 		PlatformGLFW3* platform = static_cast<PlatformGLFW3*>(glfwGetWindowUserPointer(window));
 
 		if (auto input = platform->m_Input.lock())
-			input->m_ScrollDelta = (int)y;
+			input->PushScrollEvent({ (float)x, (float)y });
 	}
 
 	void PlatformGLFW3::MousePosCallback(GLFWwindow* nativeWindow, double x, double y)
@@ -74,10 +70,10 @@ namespace def
 
 			Vector2f scale = platform->m_ViewSize / Vector2f(window->m_ScreenSize * window->m_PixelSize);
 
-			input->m_MousePos = mouse / std::min(scale.x, scale.y) / window->m_PixelSize;
+			input->PushMoveEvent(mouse / std::min(scale.x, scale.y) / window->m_PixelSize);
 		}
 		else
-			input->m_MousePos = mouse / window->m_PixelSize;
+			input->PushMoveEvent(mouse / window->m_PixelSize);
 	}
 
 	void PlatformGLFW3::KeyboardCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
@@ -85,10 +81,15 @@ namespace def
 		PlatformGLFW3* platform = static_cast<PlatformGLFW3*>(glfwGetWindowUserPointer(window));
 
 		if (auto input = platform->m_Input.lock())
-		{
-			uint8_t mappedKey = static_cast<uint8_t>(InputHandler::s_KeysTable[key]);
-			input->m_KeyNewState[mappedKey] = action == GLFW_PRESS || action == GLFW_REPEAT;
-		}
+			input->PushKeyEvent(InputHandler::MapKey(key), action != GLFW_RELEASE, action == GLFW_REPEAT);
+	}
+
+	void PlatformGLFW3::CharCallback(GLFWwindow* window, unsigned int codePoint)
+	{
+		PlatformGLFW3* platform = static_cast<PlatformGLFW3*>(glfwGetWindowUserPointer(window));
+
+		if (auto input = platform->m_Input.lock())
+			input->PushCharEvent(codePoint);
 	}
 
 	void PlatformGLFW3::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
@@ -96,7 +97,7 @@ namespace def
 		PlatformGLFW3* platform = static_cast<PlatformGLFW3*>(glfwGetWindowUserPointer(window));
 
 		if (auto input = platform->m_Input.lock())
-			input->m_MouseNewState[button] = action == GLFW_PRESS || action == GLFW_REPEAT;
+			input->PushButtonEvent(static_cast<Button>(button), action != GLFW_RELEASE);
 	}
 
 	void PlatformGLFW3::FramebufferSizeCallback(GLFWwindow* window, int width, int height)
@@ -158,6 +159,11 @@ namespace def
 		glfwPollEvents();
 	}
 
+	void PlatformGLFW3::WaitEvents(float timeout) const
+	{
+		glfwWaitEventsTimeout((double)timeout);
+	}
+
 	bool PlatformGLFW3::ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool vsync, bool fullscreen, bool dirtypixel)
 	{
 		m_Monitor = glfwGetPrimaryMonitor();
@@ -225,6 +231,7 @@ namespace def
 		glfwSetCursorPosCallback(m_NativeWindow, MousePosCallback);
 		glfwSetMouseButtonCallback(m_NativeWindow, MouseButtonCallback);
 		glfwSetKeyCallback(m_NativeWindow, KeyboardCallback);
+		glfwSetCharCallback(m_NativeWindow, CharCallback);
 		glfwSetFramebufferSizeCallback(m_NativeWindow, FramebufferSizeCallback);
 		glfwSetWindowPosCallback(m_NativeWindow, WindowPosCallback);
 
@@ -233,13 +240,21 @@ namespace def
 
 	void PlatformGLFW3::SetIcon(Sprite& icon) const
 	{
+		// GLFW needs the rows one after another
+		Sprite packed(icon.GetView());
+
 		GLFWimage img;
-		img.width = icon.size.x;
-		img.height = icon.size.y;
-		img.pixels = (uint8_t*)icon.pixels.data();
+		img.width = packed.size.x;
+		img.height = packed.size.y;
+		img.pixels = (uint8_t*)packed.pixels.data();
 		glfwSetWindowIcon(m_NativeWindow, 1, &img);
 	}
 
+	void* PlatformGLFW3::LoadFunction(const char* name) const
+	{
+		return (void*)glfwGetProcAddress(name);
+	}
+
 	void PlatformGLFW3::EnableVSync(bool enable)
 	{
 		glfwSwapInterval(enable ? 1 : 0);
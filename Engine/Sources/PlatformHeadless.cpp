@@ -0,0 +1,335 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+
+#ifdef DGE_PLATFORM_HEADLESS
+
+#include "PlatformHeadless.hpp"
+#include "defGameEngine.hpp"
+#include "RenderTarget.hpp"
+#include "DrawList.hpp"
+
+namespace def
+{
+	uint32_t PlatformHeadless::s_TexturesCount = 0;
+	std::unordered_map<uint32_t, Sprite> PlatformHeadless::s_Textures;
+
+	PlatformHeadless::PlatformHeadless(GameEngine* engine) : Platform(engine)
+	{
+	}
+
+	void PlatformHeadless::Destroy() const {}
+	void PlatformHeadless::SetTitle(const std::string_view) const {}
+
+	bool PlatformHeadless::IsWindowClose() const
+	{
+		// The application is stopped by OnUserUpdate or by the end of a replay
+		return false;
+	}
+
+	bool PlatformHeadless::IsWindowFocused() const
+	{
+		return true;
+	}
+
+	void PlatformHeadless::ClearBuffer(const Pixel&) const {}
+
+	void PlatformHeadless::OnBeforeDraw() {}
+	void PlatformHeadless::OnAfterDraw() {}
+
+	void PlatformHeadless::FlushScreen(bool) const {}
+	void PlatformHeadless::PollEvents() const {}
+	void PlatformHeadless::WaitEvents(float) const {}
+
+	// Nothing is drawn but the submissions are still counted, a draw call per texture.
+	// PlatformGL merges the neighbouring batches of filled polygons so it can report fewer draw calls
+
+	void PlatformHeadless::DrawQuad(const Pixel&) const
+	{
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += 4;
+	}
+
+	void PlatformHeadless::DrawTexture(const TextureInstance& texInst) const
+	{
+		if (texInst.drawList)
+		{
+			DrawTextureList(texInst);
+			return;
+		}
+
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += texInst.points;
+	}
+
+	void PlatformHeadless::DrawTextureList(const TextureInstance& texInst) const
+	{
+		for (const auto& batch : texInst.drawList->GetBatches())
+		{
+			m_RenderStats.drawCalls++;
+			m_RenderStats.vertices += batch.count;
+		}
+	}
+
+	void PlatformHeadless::DestroyDrawList(DrawList&)
+	{
+	}
+
+	void PlatformHeadless::BindTexture(int) const {}
+
+	bool PlatformHeadless::ConstructWindow(Vector2i& screenSize, const Vector2i& pixelSize, Vector2i& windowSize, bool, bool, bool)
+	{
+		windowSize = screenSize * pixelSize;
+		return true;
+	}
+
+	void PlatformHeadless::SetIcon(Sprite&) const {}
+	void PlatformHeadless::EnableVSync(bool) {}
+	void PlatformHeadless::EnableFullscreen(bool) {}
+
+	void PlatformHeadless::CreateRenderTarget(RenderTarget& target)
+	{
+		// The pixels of the texture are the framebuffer
+		target.m_Framebuffer = target.GetTexture()->id;
+	}
+
+	void PlatformHeadless::DestroyRenderTarget(RenderTarget& target)
+	{
+		target.m_Framebuffer = 0;
+	}
+
+	void PlatformHeadless::DrawRenderTarget(RenderTarget& target)
+	{
+		auto pixels = s_Textures.find(target.m_Framebuffer);
+
+		if (pixels == s_Textures.end())
+			return;
+
+		if (target.m_IsClearPending)
+			pixels->second.SetPixelData(target.m_ClearColour);
+
+		for (const auto& texInst : target.m_Textures)
+			RasteriseTexture(&pixels->second, texInst);
+	}
+
+	void PlatformHeadless::BeginReadback(RenderTarget&)
+	{
+	}
+
+	void PlatformHeadless::FinishReadback(RenderTarget& target)
+	{
+		auto pixels = s_Textures.find(target.m_Framebuffer);
+
+		if (pixels != s_Textures.end())
+		{
+			Sprite* sprite = target.m_Graphic.sprite;
+
+			for (int y = 0; y < sprite->size.y; y++)
+				std::copy(pixels->second.GetRow(y), pixels->second.GetRow(y) + sprite->size.x, sprite->GetRow(y));
+		}
+	}
+
+	uint32_t PlatformHeadless::CreateTexture(const ConstSpriteView& view)
+	{
+		uint32_t id = ++s_TexturesCount;
+		s_Textures[id] = Sprite(view);
+
+		return id;
+	}
+
+	void PlatformHeadless::UpdateTexture(uint32_t id, const ConstSpriteView& view)
+	{
+		s_Textures[id] = Sprite(view);
+	}
+
+	void PlatformHeadless::UpdateTextureRegion(uint32_t id, const ConstSpriteView& view, const Vector2i& offset)
+	{
+		auto texture = s_Textures.find(id);
+
+		if (texture == s_Textures.end())
+			return;
+
+		SpriteView region = texture->second.GetView(offset, view.size);
+
+		for (int y = 0; y < region.size.y; y++)
+			std::copy(view.GetRow(y), view.GetRow(y) + region.size.x, region.GetRow(y));
+	}
+
+	void PlatformHeadless::RasteriseTexture(Sprite* target, const TextureInstance& texInst) const
+	{
+		// Each batch of the list is drawn as a separate texture
+		if (texInst.drawList)
+		{
+			const DrawList& list = *texInst.drawList;
+
+			bool changed;
+			const auto& vertices = list.Bake(texInst.listOffset, texInst.listScale, texInst.tint.empty() ? WHITE : texInst.tint[0], changed);
+
+			for (const auto& batch : list.GetBatches())
+			{
+				TextureInstance part;
+
+				part.texture = batch.texture;
+				part.structure = batch.lines ? Texture::Structure::LINES : Texture::Structure::DEFAULT;
+				part.points = batch.count;
+
+				for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+				{
+					part.vertices.push_back(vertices[i].pos);
+					part.uv.push_back(vertices[i].uv);
+					part.tint.push_back(vertices[i].col);
+				}
+
+				RasteriseTexture(target, part);
+			}
+
+			return;
+		}
+
+		m_RenderStats.drawCalls++;
+		m_RenderStats.vertices += texInst.points;
+
+		const Sprite* texture = nullptr;
+
+		if (texInst.texture)
+		{
+			auto pixels = s_Textures.find(texInst.texture->id);
+
+			if (pixels != s_Textures.end())
+				texture = &pixels->second;
+		}
+
+		auto ToPixels = [target](const Vector2f& vertex)
+			{
+				return Vector2i(((vertex + 1.0f) * 0.5f * Vector2f(target->size)).Floor());
+			};
+
+		// The lines aren't textured and take the colour of their first vertex
+		auto Line = [&](uint32_t i1, uint32_t i2)
+			{
+				Vector2i p1 = ToPixels(texInst.vertices[i1]);
+				Vector2i p2 = ToPixels(texInst.vertices[i2]);
+
+				const Pixel& col = texInst.tint[i1];
+
+				Rasteriser::Line(p1.x, p1.y, p2.x, p2.y, [&](int x, int y)
+					{
+						Pixel dst = target->GetPixel(x, y);
+						target->SetPixel(x, y, dst.Lerp(col, (float)col.a / 255.0f));
+					});
+			};
+
+		uint32_t points = texInst.points;
+
+		switch (texInst.structure)
+		{
+		case Texture::Structure::DEFAULT:
+		{
+			for (uint32_t i = 0; i + 2 < points; i += 3)
+				RasteriseTriangle(target, texture, texInst, i, i + 1, i + 2);
+		}
+		break;
+
+		case Texture::Structure::TRIANGLE_FAN:
+		{
+			for (uint32_t i = 1; i + 1 < points; i++)
+				RasteriseTriangle(target, texture, texInst, 0, i, i + 1);
+		}
+		break;
+
+		case Texture::Structure::TRIANGLE_STRIP:
+		{
+			for (uint32_t i = 0; i + 2 < points; i++)
+				RasteriseTriangle(target, texture, texInst, i, i + 1, i + 2);
+		}
+		break;
+
+		case Texture::Structure::LINES:
+		{
+			for (uint32_t i = 0; i + 1 < points; i += 2)
+				Line(i, i + 1);
+		}
+		break;
+
+		case Texture::Structure::LINE_STRIP:
+		case Texture::Structure::WIREFRAME:
+		{
+			for (uint32_t i = 0; i + 1 < points; i++)
+				Line(i, i + 1);
+
+			if (texInst.structure == Texture::Structure::WIREFRAME && points > 2)
+				Line(points - 1, 0);
+		}
+		break;
+
+		}
+	}
+
+	void PlatformHeadless::RasteriseTriangle(Sprite* target, const Sprite* texture, const TextureInstance& texInst, uint32_t i1, uint32_t i2, uint32_t i3) const
+	{
+		Vector2f size = target->size;
+
+		Vector2f p1 = (texInst.vertices[i1] + 1.0f) * 0.5f * size;
+		Vector2f p2 = (texInst.vertices[i2] + 1.0f) * 0.5f * size;
+		Vector2f p3 = (texInst.vertices[i3] + 1.0f) * 0.5f * size;
+
+		float area = (p2 - p1).CrossProduct(p3 - p1);
+
+		if (area == 0.0f)
+			return;
+
+		int minX = std::max(0, (int)std::floor(std::min({ p1.x, p2.x, p3.x })));
+		int minY = std::max(0, (int)std::floor(std::min({ p1.y, p2.y, p3.y })));
+		int maxX = std::min(target->size.x - 1, (int)std::ceil(std::max({ p1.x, p2.x, p3.x })));
+		int maxY = std::min(target->size.y - 1, (int)std::ceil(std::max({ p1.y, p2.y, p3.y })));
+
+		bool isTextured = texture && !texInst.uv.empty();
+
+		for (int y = minY; y <= maxY; y++)
+			for (int x = minX; x <= maxX; x++)
+			{
+				// Pixels are sampled at their centres like on the GPU
+				Vector2f p(x + 0.5f, y + 0.5f);
+
+				float w1 = (p3 - p2).CrossProduct(p - p2) / area;
+				float w2 = (p1 - p3).CrossProduct(p - p3) / area;
+				float w3 = 1.0f - w1 - w2;
+
+				if (w1 < 0.0f || w2 < 0.0f || w3 < 0.0f)
+					continue;
+
+				const Pixel& t1 = texInst.tint[i1];
+				const Pixel& t2 = texInst.tint[i2];
+				const Pixel& t3 = texInst.tint[i3];
+
+				float col[4];
+
+				for (int i = 0; i < 4; i++)
+					col[i] = (float)t1.rgba_v[i] * w1 + (float)t2.rgba_v[i] * w2 + (float)t3.rgba_v[i] * w3;
+
+				if (isTextured)
+				{
+					Vector2f uv = texInst.uv[i1] * w1 + texInst.uv[i2] * w2 + texInst.uv[i3] * w3;
+					Pixel texel = texture->Sample(uv, m_SampleMethod, m_WrapMethod);
+
+					for (int i = 0; i < 4; i++)
+						col[i] *= (float)texel.rgba_v[i] / 255.0f;
+				}
+
+				Pixel src(uint8_t(col[0] + 0.5f), uint8_t(col[1] + 0.5f), uint8_t(col[2] + 0.5f), uint8_t(col[3] + 0.5f));
+				Pixel& dst = target->GetRow(y)[x];
+
+				// Same as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+				float alpha = (float)src.a / 255.0f;
+
+				for (int i = 0; i < 4; i++)
+					dst.rgba_v[i] = uint8_t((float)src.rgba_v[i] * alpha + (float)dst.rgba_v[i] * (1.0f - alpha) + 0.5f);
+			}
+	}
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "RenderTarget.hpp"
+#include "Platform.hpp"
+
+namespace def
+{
+	RenderTarget::RenderTarget(Platform* platform, const Vector2i& size) : m_Platform(platform), m_Graphic(size)
+	{
+		m_ClearColour = NONE;
+		m_IsClearPending = true;
+
+		m_IsChanged = false;
+
+		m_IsReadbackRequested = false;
+		m_IsReadbackStarted = false;
+
+		m_Framebuffer = 0;
+		m_PixelBuffer = 0;
+
+		m_Platform->CreateRenderTarget(*this);
+	}
+
+	RenderTarget::~RenderTarget()
+	{
+		m_Platform->DestroyRenderTarget(*this);
+	}
+
+	bool RenderTarget::IsValid() const
+	{
+		return m_Framebuffer != 0;
+	}
+
+	const Vector2i& RenderTarget::GetSize() const
+	{
+		return m_Graphic.sprite->size;
+	}
+
+	const Texture* RenderTarget::GetTexture() const
+	{
+		return m_Graphic.texture;
+	}
+
+	void RenderTarget::Submit(TextureInstance&& texInst)
+	{
+		m_Textures.push_back(std::move(texInst));
+	}
+
+	void RenderTarget::Clear(const Pixel& col)
+	{
+		// Everything queued before would be cleared anyway
+		m_Textures.clear();
+
+		m_ClearColour = col;
+		m_IsClearPending = true;
+	}
+
+	bool RenderTarget::HasPendingWork() const
+	{
+		return m_IsClearPending || !m_Textures.empty();
+	}
+
+	void RenderTarget::RequestReadback()
+	{
+		m_IsReadbackRequested = true;
+	}
+
+	void RenderTarget::Render()
+	{
+		if (!IsValid())
+			return;
+
+		m_Platform->DrawRenderTarget(*this);
+
+		m_Textures.clear();
+		m_IsClearPending = false;
+
+		// A readback that was started before is outdated now
+		m_IsChanged = true;
+		m_IsReadbackStarted = false;
+
+		if (m_IsReadbackRequested)
+		{
+			m_Platform->BeginReadback(*this);
+
+			m_IsReadbackRequested = false;
+			m_IsReadbackStarted = true;
+		}
+	}
+
+	const Sprite* RenderTarget::GetSprite()
+	{
+		if (m_IsChanged && IsValid())
+		{
+			if (!m_IsReadbackStarted)
+				m_Platform->BeginReadback(*this);
+
+			m_Platform->FinishReadback(*this);
+
+			m_IsReadbackStarted = false;
+			m_IsChanged = false;
+		}
+
+		return m_Graphic.sprite;
+	}
+}
@@ -23,19 +23,19 @@ namespace def
 		Load(fileName);
 	}
 
-	Sprite::~Sprite()
+	Sprite::Sprite(const ConstSpriteView& view) : Image(view)
 	{
+
 	}
 
-	void Sprite::Create(const Vector2i& size)
+	Sprite::~Sprite()
 	{
-		Assert(size.x > 0 && size.y > 0, "[Sprite.Create Error] Width and height should be > 0");
-
-		pixels.clear();
-		this->size = size;
+	}
 
-		pixels.resize(size.x * size.y);
-		std::fill(pixels.begin(), pixels.end(), BLACK);
+	void Sprite::Create(const Vector2i& size, int stride)
+	{
+		Image::Create(size, stride);
+		mipmaps.clear();
 	}
 
 	void Sprite::Load(std::string_view fileName)
@@ -45,6 +45,9 @@ namespace def
 		uint8_t* data = stbi_load(fileName.data(), &size.x, &size.y, NULL, 4);
 		Assert(data, "[Sprite.Load stb_image Error] ", SAFE_STBI_FAILURE_REASON);
 
+		mipmaps.clear();
+		stride = size.x;
+
 		pixels.clear();
 		pixels.resize(size.x * size.y);
 
@@ -63,194 +66,98 @@ namespace def
 
 	void Sprite::Save(std::string_view fileName, const FileType type) const
 	{
-		int err = 0;
-
-		switch (type)
-		{
-		case FileType::BMP: err = stbi_write_bmp(fileName.data(), size.x, size.y, 4, pixels.data()); break;
-		case FileType::PNG: err = stbi_write_png(fileName.data(), size.x, size.y, 4, pixels.data(), size.x * 4); break;
-		case FileType::JPG: err = stbi_write_jpg(fileName.data(), size.x, size.y, 4, pixels.data(), 100); break;
-		case FileType::TGA: err = stbi_write_tga(fileName.data(), size.x, size.y, 4, pixels.data()); break;
-		case FileType::TGA_RLE:
-		{
-			stbi_write_tga_with_rle = 1;
-			err = stbi_write_tga(fileName.data(), size.x, size.y, 4, pixels.data());
-			stbi_write_tga_with_rle = 0;
-		}
-		break;
-
-		}
-
-		Assert(err == 1, "[Sprite.Save stb_image_write Error] Code: ", std::to_string(err).c_str());
+		Save(GetView(), fileName, type);
 	}
 
-	bool Sprite::SetPixel(int x, int y, const Pixel& col)
+	void Sprite::Save(const ConstSpriteView& view, std::string_view fileName, FileType type)
 	{
-		if (x >= 0 && y >= 0 && x < size.x && y < size.y)
-		{
-			pixels[y * size.x + x] = col;
-			return true;
-		}
+		const Vector2i& size = view.size;
 
-		return false;
-	}
+		// Only the PNG writer takes a stride, the rest need the rows one after another
+		std::vector<Pixel> packed;
+		const Pixel* pixels = view.pixels;
 
-	bool Sprite::SetPixel(const Vector2i& pos, const Pixel& col)
-	{
-		return SetPixel(pos.x, pos.y, col);
-	}
+		if (view.stride != size.x && type != FileType::PNG)
+		{
+			packed.resize((size_t)size.x * size.y);
 
-	Pixel Sprite::GetPixel(int x, int y, const WrapMethod wrap) const
-	{
-		auto GetPixel = [&](int x, int y)
-			{
-				return pixels[y * size.x + x];
-			};
+			for (int y = 0; y < size.y; y++)
+				std::copy(view.GetRow(y), view.GetRow(y) + size.x, packed.begin() + (size_t)y * size.x);
 
-		switch (wrap)
-		{
-		case WrapMethod::NONE:
-		{
-			if (x >= 0 && y >= 0 && x < size.x && y < size.y)
-				return GetPixel(x, y);
+			pixels = packed.data();
 		}
-		break;
 
-		case WrapMethod::REPEAT:
-			return GetPixel(abs(x) % size.x, abs(y) % size.y);
+		int err = 0;
 
-		case WrapMethod::MIRROR:
+		switch (type)
 		{
-			int mx = (x < 0) ? size.x - 1 - abs(x) % size.x : abs(x) % size.x;
-			int my = (y < 0) ? size.y - 1 - abs(y) % size.y : abs(y) % size.y;
-
-			return GetPixel(mx, my);
-		}
-
-		case WrapMethod::CLAMP:
+		case FileType::BMP: err = stbi_write_bmp(fileName.data(), size.x, size.y, 4, pixels); break;
+		case FileType::PNG: err = stbi_write_png(fileName.data(), size.x, size.y, 4, pixels, view.stride * 4); break;
+		case FileType::JPG: err = stbi_write_jpg(fileName.data(), size.x, size.y, 4, pixels, 100); break;
+		case FileType::TGA: err = stbi_write_tga(fileName.data(), size.x, size.y, 4, pixels); break;
+		case FileType::TGA_RLE:
 		{
-			int cx = std::clamp(x, 0, size.x - 1);
-			int cy = std::clamp(y, 0, size.y - 1);
-
-			return GetPixel(cx, cy);
+			stbi_write_tga_with_rle = 1;
+			err = stbi_write_tga(fileName.data(), size.x, size.y, 4, pixels);
+			stbi_write_tga_with_rle = 0;
 		}
+		break;
 
 		}
 
-		return BLACK;
-	}
-
-	Pixel Sprite::GetPixel(const Vector2i& pos, const WrapMethod wrap) const
-	{
-		return GetPixel(pos.x, pos.y, wrap);
-	}
-
-	void Sprite::SetPixelData(const Pixel& col)
-	{
-		std::fill(pixels.begin(), pixels.end(), col);
-	}
-
-	Pixel Sprite::Sample(float x, float y, const SampleMethod sample, const WrapMethod wrap) const
-	{
-		return Sample({ x, y }, sample, wrap);
+		Assert(err == 1, "[Sprite.Save stb_image_write Error] Code: ", std::to_string(err).c_str());
 	}
 
-	Pixel Sprite::Sample(const Vector2f& pos, const SampleMethod sample, const WrapMethod wrap) const
+	void Sprite::GenerateMipmaps()
 	{
-		// We want a position to be size invariant
-		// so lets use normalised coordinates
-		Vector2f denorm = pos * Vector2f(size);
-
-		switch (sample)
-		{
-		case SampleMethod::LINEAR:
-			return GetPixel(denorm, wrap);
-
-		case SampleMethod::BILINEAR:
-		{
-			Vector2i cell = denorm.Floor();
-			Vector2f offset = denorm - cell;
+		mipmaps.clear();
 
-			Pixel tl = GetPixel(cell + Vector2i(0, 0), wrap);
-			Pixel tr = GetPixel(cell + Vector2i(1, 0), wrap);
-			Pixel bl = GetPixel(cell + Vector2i(0, 1), wrap);
-			Pixel br = GetPixel(cell + Vector2i(1, 1), wrap);
+		int levels = 0;
+		for (Vector2i levelSize = size; levelSize.x > 1 || levelSize.y > 1; levelSize = (levelSize / 2).Max({ 1, 1 }))
+			levels++;
 
-			// Firstly interpolate along top border
-			Pixel topCol = tr * offset.x + tl * (1.0f - offset.x);
+		// The vector must not reallocate while the previous level is read
+		mipmaps.reserve(levels);
 
-			// Now interpolate along bottom border
-			Pixel bottomCol = br * offset.x + bl * (1.0f - offset.x);
-
-			// Now interpolate between top and bottom borders
-			return bottomCol * offset.y + topCol * (1.0f - offset.y);
-		}
+		const Sprite* prev = this;
 
-		case SampleMethod::TRILINEAR:
+		for (int level = 0; level < levels; level++)
 		{
-			// Using Catmull-Rom splines as the basis functions
+			Sprite& mip = mipmaps.emplace_back((prev->size / 2).Max({ 1, 1 }));
 
-			Vector2i center = (denorm - Vector2f(0.5f, 0.5f)).Floor();
-			Vector2f offset = denorm - Vector2f(0.5f, 0.5f) - Vector2f(center);
-
-			struct Pixelf
+			for (int y = 0; y < mip.size.y; y++)
 			{
-				float r = 0.0f;
-				float g = 0.0f;
-				float b = 0.0f;
-				float a = 0.0f;
-			};
-
-			Pixelf splineX[4][4];
-
-			Vector2i s;
-			for (s.y = 0; s.y < 4; s.y++)
-				for (s.x = 0; s.x < 4; s.x++)
-				{
-					Pixel p = GetPixel(center + s - 1, wrap);
-					splineX[s.y][s.x] = { (float)p.r, (float)p.g, (float)p.b, (float)p.a };
-				}
-
-			Vector2f t = offset;
-			Vector2f tt = t * t;
-			Vector2f ttt = tt * tt;
-
-			Vector2f q[4];
-			q[0] = 0.5f * (-1.0f * ttt + 2.0f * tt - t);
-			q[1] = 0.5f * (3.0f * ttt - 5.0f * tt + 2.0f);
-			q[2] = 0.5f * (-3.0f * ttt + 4.0f * tt + t);
-			q[3] = 0.5f * (ttt - tt);
+				// Odd sizes repeat the last row and column
+				int y0 = std::min(y * 2, prev->size.y - 1);
+				int y1 = std::min(y * 2 + 1, prev->size.y - 1);
 
-			Pixelf splineY[4];
-
-			for (int i = 0; i < 4; i++)
-				for (int j = 0; j < 4; j++)
+				for (int x = 0; x < mip.size.x; x++)
 				{
-					splineY[i].r += splineX[i][j].r * q[j].x;
-					splineY[i].g += splineX[i][j].g * q[j].x;
-					splineY[i].b += splineX[i][j].b * q[j].x;
-					splineY[i].a += splineX[i][j].a * q[j].x;
+					int x0 = std::min(x * 2, prev->size.x - 1);
+					int x1 = std::min(x * 2 + 1, prev->size.x - 1);
+
+					const Pixel& p00 = prev->GetRow(y0)[x0];
+					const Pixel& p10 = prev->GetRow(y0)[x1];
+					const Pixel& p01 = prev->GetRow(y1)[x0];
+					const Pixel& p11 = prev->GetRow(y1)[x1];
+
+					mip.GetRow(y)[x] = Pixel(
+						uint8_t((p00.r + p10.r + p01.r + p11.r + 2) / 4),
+						uint8_t((p00.g + p10.g + p01.g + p11.g + 2) / 4),
+						uint8_t((p00.b + p10.b + p01.b + p11.b + 2) / 4),
+						uint8_t((p00.a + p10.a + p01.a + p11.a + 2) / 4));
 				}
-
-			Pixelf pix;
-			for (int i = 0; i < 4; i++)
-			{
-				pix.r += splineY[i].r * q[i].y;
-				pix.g += splineY[i].g * q[i].y;
-				pix.b += splineY[i].b * q[i].y;
-				pix.a += splineY[i].a * q[i].y;
 			}
 
-			return Pixel(
-				ClampFloatToUint8(pix.r),
-				ClampFloatToUint8(pix.g),
-				ClampFloatToUint8(pix.b),
-				ClampFloatToUint8(pix.a)
-			);
+			prev = &mip;
 		}
+	}
 
-		}
+	const Sprite* Sprite::GetMipmap(int level) const
+	{
+		if (level <= 0 || mipmaps.empty())
+			return this;
 
-		return NONE;
+		return &mipmaps[std::min((size_t)level, mipmaps.size()) - 1];
 	}
 }
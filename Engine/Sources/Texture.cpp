@@ -12,8 +12,26 @@
 #include "PlatformGL.hpp"
 #elif defined(DGE_PLATFORM_EMSCRIPTEN)
 #include "PlatformEmscripten.hpp"
+#elif defined(DGE_PLATFORM_HEADLESS)
+#include "PlatformHeadless.hpp"
 #else
-#error Consider defining DGE_PLATFORM_GLFW3 or DGE_PLATFORM_EMSCRIPTEN
+#error Consider defining DGE_PLATFORM_GLFW3, DGE_PLATFORM_EMSCRIPTEN or DGE_PLATFORM_HEADLESS
+#endif
+
+#ifdef DGE_PLATFORM_GLFW3
+
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+
+#ifndef GL_RG8
+#define GL_RG8 0x822B
+#endif
+
+#ifndef GL_LUMINANCE32F_ARB
+#define GL_LUMINANCE32F_ARB 0x8818
+#endif
+
 #endif
 
 namespace def
@@ -28,6 +46,86 @@ namespace def
 		Construct(new Sprite(fileName), true, pos, size);
 	}
 
+#ifndef DGE_PLATFORM_HEADLESS
+	struct GLFormat
+	{
+		GLint internalFormat;
+		GLenum format;
+		GLenum type;
+	};
+
+	static GLFormat GetGLFormat(PixelFormat format)
+	{
+		switch (format)
+		{
+	#ifdef DGE_PLATFORM_EMSCRIPTEN
+		// WebGL 2 has neither wide luminance formats nor swizzles, so the formats of a single channel
+		// are sampled from the red channel. R16 is converted to R32F in UploadPixels
+		case PixelFormat::R8:
+		case PixelFormat::INDEX8: return { GL_R8, GL_RED, GL_UNSIGNED_BYTE };
+		case PixelFormat::RG8: return { GL_RG8, GL_RG, GL_UNSIGNED_BYTE };
+		case PixelFormat::R32F: return { GL_R32F, GL_RED, GL_FLOAT };
+	#else
+		// The formats of a single channel are shown in grey as PixelTraits::ToRGBA does
+		case PixelFormat::R8:
+		case PixelFormat::INDEX8: return { GL_LUMINANCE8, GL_LUMINANCE, GL_UNSIGNED_BYTE };
+		case PixelFormat::RG8: return { GL_RG8, GL_RG, GL_UNSIGNED_BYTE };
+		case PixelFormat::R16: return { GL_LUMINANCE16, GL_LUMINANCE, GL_UNSIGNED_SHORT };
+		case PixelFormat::R32F: return { GL_LUMINANCE32F_ARB, GL_LUMINANCE, GL_FLOAT };
+	#endif
+		default: return { GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE };
+		}
+	}
+#endif
+
+	template <class T>
+	static ImageView<const T> GetView(const Texture::PixelData& data)
+	{
+		return ImageView<const T>((const T*)data.pixels, data.size, data.stride);
+	}
+
+#if defined(DGE_PLATFORM_HEADLESS)
+	// The headless platform keeps the textures as sprites, so the pixels are converted as PixelTraits::ToRGBA shows them
+	static Sprite ToSprite(const Texture::PixelData& data)
+	{
+		switch (data.format)
+		{
+		case PixelFormat::R8: return Sprite(ConvertImage<Pixel>(GetView<PixelR8>(data)));
+		case PixelFormat::RG8: return Sprite(ConvertImage<Pixel>(GetView<PixelRG8>(data)));
+		case PixelFormat::R16: return Sprite(ConvertImage<Pixel>(GetView<PixelR16>(data)));
+		case PixelFormat::R32F: return Sprite(ConvertImage<Pixel>(GetView<PixelR32F>(data)));
+		case PixelFormat::INDEX8: return Sprite(ConvertImage<Pixel>(GetView<PixelIndex8>(data)));
+		default: return Sprite(GetView<Pixel>(data));
+		}
+	}
+#else
+	// Uploads the pixels to the bound texture, only the region at the offset is replaced if region is true
+	static void UploadPixels(const Texture::PixelData& data, bool region, const Vector2i& offset = { 0, 0 })
+	{
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	#ifdef DGE_PLATFORM_EMSCRIPTEN
+		// 16-bit normalised textures need an extension, R32F keeps every value of R16 exactly
+		if (data.format == PixelFormat::R16)
+		{
+			UploadPixels(ConvertImage<PixelR32F>(GetView<PixelR16>(data)).GetView(), region, offset);
+			return;
+		}
+	#endif
+
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, data.stride);
+
+		GLFormat format = GetGLFormat(data.format);
+
+		if (region)
+			glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, data.size.x, data.size.y, format.format, format.type, data.pixels);
+		else
+			glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, data.size.x, data.size.y, 0, format.format, format.type, data.pixels);
+
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+#endif
+
 	void Texture::Construct(Sprite* sprite, bool deleteSprite, const Vector2f& customPos, const Vector2f& customSize)
 	{
 		Load(sprite, customPos, customSize);
@@ -37,14 +135,23 @@ namespace def
 	}
 
 	void Texture::Load(Sprite* sprite, const Vector2f& customPos, const Vector2f& customSize)
+	{
+		LoadPixels(sprite->GetView(), customPos, customSize);
+	}
+
+	void Texture::LoadPixels(const PixelData& data, const Vector2f& customPos, const Vector2f& customSize)
 	{
 		bool isCustomSize = customSize >= Vector2f(0, 0);
 
-		imageSize = sprite->size;
-		size = isCustomSize ? customSize : Vector2f(sprite->size);
+		imageSize = data.size;
+		size = isCustomSize ? customSize : Vector2f(data.size);
 		uvScale = 1.0f / Vector2f(imageSize);
 		pos = customPos / size;
+		format = data.format;
 
+	#ifdef DGE_PLATFORM_HEADLESS
+		id = PlatformHeadless::CreateTexture(ToSprite(data));
+	#else
 		glGenTextures(1, &id);
 		glBindTexture(GL_TEXTURE_2D, id);
 
@@ -54,41 +161,46 @@ namespace def
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0, GL_RGBA,
-			imageSize.x,
-			imageSize.y,
-			0, GL_RGBA,
-			GL_UNSIGNED_BYTE,
-			sprite->pixels.data()
-		);
+		UploadPixels(data, false);
 
 		glBindTexture(GL_TEXTURE_2D, 0);
+	#endif
 	}
 
 	void Texture::Update(Sprite* sprite, const Vector2f& customPos, const Vector2f& customSize)
 	{
-		imageSize = sprite->size;
+		UpdatePixels(sprite->GetView(), customPos, customSize);
+	}
+
+	void Texture::UpdatePixels(const PixelData& data, const Vector2f& customPos, const Vector2f& customSize)
+	{
+		imageSize = data.size;
 		uvScale = 1.0f / Vector2f(imageSize);
-		size = customSize >= Vector2f(0, 0) ? customSize : Vector2f(sprite->size);
+		size = customSize >= Vector2f(0, 0) ? customSize : Vector2f(data.size);
 		pos = customPos / size;
+		format = data.format;
 
+	#ifdef DGE_PLATFORM_HEADLESS
+		PlatformHeadless::UpdateTexture(id, ToSprite(data));
+	#else
 		glBindTexture(GL_TEXTURE_2D, id);
+		UploadPixels(data, false);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	#endif
+	}
 
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0, GL_RGBA,
-			size.x,
-			size.y,
-			0, GL_RGBA,
-			GL_UNSIGNED_BYTE,
-			sprite->pixels.data()
-		);
+	void Texture::UpdatePixelsRegion(const PixelData& data, const Vector2i& offset)
+	{
+		if (!data.pixels || data.size.x <= 0 || data.size.y <= 0)
+			return;
 
+	#ifdef DGE_PLATFORM_HEADLESS
+		PlatformHeadless::UpdateTextureRegion(id, ToSprite(data), offset);
+	#else
+		glBindTexture(GL_TEXTURE_2D, id);
+		UploadPixels(data, true, offset);
 		glBindTexture(GL_TEXTURE_2D, 0);
+	#endif
 	}
 
 	TextureInstance::TextureInstance()
@@ -97,6 +209,10 @@ namespace def
 
 		structure = Texture::Structure::TRIANGLE_FAN;
 		points = 0;
+		depth = 0.0f;
+
+		drawList = nullptr;
+		listScale = { 1.0f, 1.0f };
 
 		//uv = { { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f } };
 	}
@@ -0,0 +1,107 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "Pch.hpp"
+#include "ThreadPool.hpp"
+
+namespace def
+{
+	ThreadPool::ThreadPool(size_t threads) : m_Pending(0), m_Stop(false)
+	{
+	#ifndef __EMSCRIPTEN__
+		if (threads == 0)
+		{
+			size_t hardware = std::thread::hardware_concurrency();
+			threads = hardware > 1 ? hardware - 1 : 0;
+		}
+
+		m_Threads.reserve(threads);
+
+		for (size_t i = 0; i < threads; i++)
+			m_Threads.emplace_back(&ThreadPool::Worker, this);
+	#endif
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+
+		m_WakeUp.notify_all();
+
+		for (auto& thread : m_Threads)
+			thread.join();
+	}
+
+	void ThreadPool::Submit(Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			m_Tasks.push_back(std::move(task));
+			m_Pending++;
+		}
+
+		m_WakeUp.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		while (RunPendingTask());
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Finished.wait(lock, [this] { return m_Pending == 0; });
+	}
+
+	size_t ThreadPool::GetThreadsCount() const
+	{
+		return m_Threads.size();
+	}
+
+	bool ThreadPool::RunPendingTask()
+	{
+		Task task;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (m_Tasks.empty())
+				return false;
+
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop_front();
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (--m_Pending == 0)
+				m_Finished.notify_all();
+		}
+
+		return true;
+	}
+
+	void ThreadPool::Worker()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeUp.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+
+				if (m_Stop && m_Tasks.empty())
+					return;
+			}
+
+			RunPendingTask();
+		}
+	}
+}
@@ -7,15 +7,41 @@
 #include "Pch.hpp"
 #include "Timer.hpp"
 
+#include <thread>
+
 namespace def
 {
-	Timer::Timer()
+	// We never sleep if less than this amount of time is left,
+	// it covers the cost of waking up and reading the clock
+	static constexpr float SPIN_MARGIN = 0.0002f;
+
+	// How fast the oversleep estimate follows new measurements
+	static constexpr float OVERSLEEP_SMOOTHING = 0.1f;
+
+	static float Seconds(Clock::duration duration)
 	{
-		m_TimeStart = std::chrono::system_clock::now();
-		m_TimeEnd = m_TimeStart;
+		return std::chrono::duration<float>(duration).count();
+	}
+
+	static Clock::duration Duration(float seconds)
+	{
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(seconds));
+	}
 
+	Timer::Timer()
+	{
 		m_DeltaTime = 0.0f;
 		m_TickTimer = 0.0f;
+		m_FixedDeltaTime = 0.0f;
+
+		m_TargetFrameTime = 0.0f;
+
+		// Most of the schedulers wake a thread up about 1 ms later
+		// than it was asked for, it's a good enough starting point
+		m_OversleepMean = 0.001f;
+		m_OversleepDeviation = 0.0005f;
+
+		Reset();
 	}
 
 	float Timer::GetDeltaTime() const
@@ -28,11 +54,43 @@ namespace def
 		return int(1.0f / m_DeltaTime);
 	}
 
+	void Timer::SetTargetFrameRate(float fps)
+	{
+		m_TargetFrameTime = fps > 0.0f ? 1.0f / fps : 0.0f;
+		m_PacingStats.targetFrameTime = m_TargetFrameTime;
+
+		m_Deadline = Clock::now() + Duration(m_TargetFrameTime);
+	}
+
+	float Timer::GetTargetFrameRate() const
+	{
+		return m_TargetFrameTime > 0.0f ? 1.0f / m_TargetFrameTime : 0.0f;
+	}
+
+	const FramePacingStats& Timer::GetPacingStats() const
+	{
+		return m_PacingStats;
+	}
+
+	void Timer::SetFixedDeltaTime(float deltaTime)
+	{
+		m_FixedDeltaTime = deltaTime;
+	}
+
+	float Timer::GetFixedDeltaTime() const
+	{
+		return m_FixedDeltaTime;
+	}
+
 	void Timer::Update()
 	{
-		m_TimeEnd = std::chrono::system_clock::now();
+		m_TimeEnd = Clock::now();
+
+		if (m_FixedDeltaTime > 0.0f)
+			m_DeltaTime = m_FixedDeltaTime;
+		else
+			m_DeltaTime = Seconds(m_TimeEnd - m_TimeStart);
 
-		m_DeltaTime = std::chrono::duration<float>(m_TimeEnd - m_TimeStart).count();
 		m_TimeStart = m_TimeEnd;
 
 		m_TickTimer += m_DeltaTime;
@@ -47,4 +105,70 @@ namespace def
 	{
 		m_TickTimer = 0.0f;
 	}
+
+	void Timer::Reset()
+	{
+		m_TimeStart = Clock::now();
+		m_TimeEnd = m_TimeStart;
+
+		m_Deadline = m_TimeStart + Duration(m_TargetFrameTime);
+	}
+
+	void Timer::Pace()
+	{
+		if (m_TargetFrameTime <= 0.0f || m_FixedDeltaTime > 0.0f)
+			return;
+
+		TimePoint now = Clock::now();
+
+		m_PacingStats.workTime = Seconds(now - m_TimeStart);
+		m_PacingStats.sleepTime = 0.0f;
+		m_PacingStats.spinTime = 0.0f;
+
+		if (now >= m_Deadline)
+		{
+			// We are already late so don't try to catch up
+			// by running the next frames faster, just start over
+			m_PacingStats.lateness = Seconds(now - m_Deadline);
+			m_PacingStats.missedFrames++;
+
+			m_Deadline = now + Duration(m_TargetFrameTime);
+			return;
+		}
+
+		TimePoint sleepStart = now;
+
+		while (true)
+		{
+			float oversleep = m_OversleepMean + 2.0f * m_OversleepDeviation;
+			float remaining = Seconds(m_Deadline - now) - oversleep - SPIN_MARGIN;
+
+			if (remaining <= 0.0f)
+				break;
+
+			TimePoint before = now;
+
+			std::this_thread::sleep_for(Duration(remaining));
+			now = Clock::now();
+
+			// Adapt to how precise the sleeping actually is on this machine
+			float error = std::max(Seconds(now - before) - remaining, 0.0f);
+
+			m_OversleepMean += (error - m_OversleepMean) * OVERSLEEP_SMOOTHING;
+			m_OversleepDeviation += (std::abs(error - m_OversleepMean) - m_OversleepDeviation) * OVERSLEEP_SMOOTHING;
+		}
+
+		TimePoint spinStart = now;
+
+		while (now < m_Deadline)
+			now = Clock::now();
+
+		m_PacingStats.sleepTime = Seconds(spinStart - sleepStart);
+		m_PacingStats.spinTime = Seconds(now - spinStart);
+		m_PacingStats.oversleep = m_OversleepMean + 2.0f * m_OversleepDeviation;
+		m_PacingStats.lateness = Seconds(now - m_Deadline);
+		m_PacingStats.pacedFrames++;
+
+		m_Deadline += Duration(m_TargetFrameTime);
+	}
 }
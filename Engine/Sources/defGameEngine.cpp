@@ -9,10 +9,13 @@
 
 namespace def
 {
+	GameEngine* GameEngine::s_Engine = nullptr;
 	std::vector<Vector2f> GameEngine::s_UnitCircle;
 
 	GameEngine::GameEngine()
 	{
+		s_Engine = this;
+
 		m_TabSize = 0;
 
 		m_CurrentLayer = 0;
@@ -22,10 +25,20 @@ namespace def
 
 		m_OnlyTextures = false;
 
+		m_IsIdleMode = false;
+		m_IsDirty = true;
+		m_IdleTimeout = 0.5f;
+
+		m_FrameIndex = 0;
+		m_QuitAfterReplay = false;
+		m_IsProfiling = false;
+
 	#if defined(DGE_PLATFORM_GLFW3)
 		m_Platform = std::make_shared<PlatformGLFW3>(this);
 	#elif defined(DGE_PLATFORM_EMSCRIPTEN)
 		m_Platform = std::make_shared<PlatformEmscripten>(this);
+	#elif defined(DGE_PLATFORM_HEADLESS)
+		m_Platform = std::make_shared<PlatformHeadless>(this);
 	#else
 		#error No platform has been selected
 	#endif
@@ -33,6 +46,8 @@ namespace def
 		m_Input = std::make_shared<InputHandler>(m_Platform);
 		m_Window = std::make_shared<def::Window>(m_Platform);
 		m_Console = std::make_unique<def::Console>(this);
+		m_Timer = std::make_unique<def::Timer>();
+		m_ThreadPool = std::make_unique<def::ThreadPool>();
 
 		m_Platform->SetInputHandler(m_Input);
 		m_Platform->SetWindow(m_Window);
@@ -45,13 +60,39 @@ namespace def
 
 	void GameEngine::Destroy()
 	{
+		// The framebuffers and the buffers must be deleted while the context is alive
+		m_RenderTargets.clear();
+		m_DrawLists.clear();
+
 		m_Platform->Destroy();
+		Log::Flush();
 	}
 
 	void GameEngine::MainLoop()
 	{
 		if (m_IsAppRunning)
 		{
+			if (m_Input->IsReplaying())
+			{
+				float replayDeltaTime;
+
+				// The recorded delta time is used so the replay
+				// behaves the same no matter how fast the machine is
+				if (m_Input->ReplayFrame(replayDeltaTime))
+					m_Timer->SetFixedDeltaTime(replayDeltaTime);
+				else
+				{
+					m_Input->StopReplay();
+					m_Timer->SetFixedDeltaTime(0.0f);
+
+					if (m_QuitAfterReplay)
+					{
+						m_IsAppRunning = false;
+						return;
+					}
+				}
+			}
+
 			m_Timer->Update();
 
 			if (m_Platform->IsWindowClose())
@@ -60,7 +101,10 @@ namespace def
 				return;
 			}
 
+			TimePoint frameStart = Clock::now();
+
 			m_Input->FlushBuffers();
+			m_Input->RecordFrame(m_Timer->GetDeltaTime());
 			m_Input->GrabText();
 
 			float deltaTime = m_Timer->GetDeltaTime();
@@ -71,25 +115,91 @@ namespace def
 			if (!OnUserUpdate(deltaTime))
 				m_IsAppRunning = false;
 
+			TimePoint updateEnd = Clock::now();
+
 			size_t layer = m_CurrentLayer;
 			m_CurrentLayer = 1;
 
+			// The parallel layers are started first so the others are updated meanwhile
+			for (auto iter = m_Layers.begin() + 1; iter != m_Layers.end(); ++iter)
+			{
+				if ((*iter)->parallelUpdate)
+				{
+					Layer* parallelLayer = iter->get();
+					m_ThreadPool->Submit([parallelLayer, deltaTime]() { parallelLayer->OnUpdate(deltaTime); });
+				}
+			}
+
 			for (auto iter = m_Layers.begin() + 1; iter != m_Layers.end(); ++iter, ++m_CurrentLayer)
-				(*iter)->OnUpdate(deltaTime);
+			{
+				if (!(*iter)->parallelUpdate)
+					(*iter)->OnUpdate(deltaTime);
+			}
 
 			m_CurrentLayer = layer;
 
+			// All pixels must be ready before they are uploaded
+			m_ThreadPool->Wait();
+
+			// Messages from all threads are printed by the main thread
+			Log::Drain();
+			m_Console->PrintLog();
+
 			m_Console->Draw();
 
+			for (auto iter = m_Layers.begin() + 1; iter != m_Layers.end(); ++iter)
+			{
+				if ((*iter)->update)
+				{
+					bool isIndexed = (*iter)->pixels && !(*iter)->palette.pixels.empty();
+
+					if (isIndexed && !IsPaletteOnGPU(iter->get()))
+						ImageProcessing::ResolvePalette((*iter)->indices.GetView(), (*iter)->palette.pixels, (*iter)->pixels->sprite->GetView(), m_ThreadPool.get());
+
+					ApplyPostProcess(iter->get());
+				}
+			}
+
+			TimePoint layersEnd = Clock::now();
+
 			m_Platform->ClearBuffer(def::BLACK);
 			m_Platform->OnBeforeDraw();
 
+			// The layers can use the textures of the targets on the same frame
+			for (auto& target : m_RenderTargets)
+			{
+				if (target->HasPendingWork())
+					target->Render();
+			}
+
 			auto DrawLayer = [&](std::vector<std::unique_ptr<Layer>>::iterator iter)
 			{
 				if (!m_OnlyTextures)
 				{
-					if ((*iter)->update && (*iter)->pixels)
-						(*iter)->pixels->UpdateTexture();
+					bool isPaletteOnGPU = (*iter)->pixels && !(*iter)->palette.pixels.empty() && IsPaletteOnGPU(iter->get());
+
+					if ((*iter)->update && isPaletteOnGPU)
+					{
+						// A byte per pixel is uploaded instead of four
+						if ((*iter)->indexTexture)
+							(*iter)->indexTexture->Update((*iter)->indices.GetView());
+						else
+							(*iter)->indexTexture = new Texture((*iter)->indices.GetView());
+
+						if (!(*iter)->paletteTexture)
+							(*iter)->paletteTexture = new Texture((*iter)->palette.GetView());
+						else if ((*iter)->paletteChanged)
+							(*iter)->paletteTexture->Update((*iter)->palette.GetView());
+
+						(*iter)->paletteChanged = false;
+					}
+					else if ((*iter)->update && (*iter)->pixels)
+					{
+						if ((*iter)->postProcessed)
+							(*iter)->pixels->texture->Update((*iter)->postProcessed);
+						else
+							(*iter)->pixels->UpdateTexture();
+					}
 
 					if ((*iter)->visible && (*iter)->pixels)
 					{
@@ -99,25 +209,67 @@ namespace def
 						Vector2f pos1 = (Vector2f((*iter)->offset) * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
 						Vector2f pos2 = pos1 + 2.0f * Vector2f((*iter)->size) * inv * Vector2f(1.0f, -1.0f);
 
+						bool isIndexed = isPaletteOnGPU && (*iter)->indexTexture;
+
 						TextureInstance texInst;
-						texInst.texture = (*iter)->pixels->texture;
+						texInst.texture = isIndexed ? (*iter)->indexTexture : (*iter)->pixels->texture;
 						texInst.points = 4;
 						texInst.structure = Texture::Structure::TRIANGLE_FAN;
 						texInst.tint = { (*iter)->tint, (*iter)->tint, (*iter)->tint, (*iter)->tint };
 						texInst.vertices = { pos1, { pos1.x, pos2.y }, pos2, { pos2.x, pos1.y } };
 						texInst.uv = { { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f } };
 
-						m_Platform->DrawTexture(texInst);
+						if (isIndexed)
+							m_Platform->DrawPalettedTexture(texInst, (*iter)->paletteTexture);
+						else
+							m_Platform->DrawTexture(texInst);
 					}
 				}
 
+				auto& textures = (*iter)->textures;
+
 				if ((*iter)->visible)
 				{
-					for (auto& texture : (*iter)->textures)
-						m_Platform->DrawTexture(texture);
+					auto ID = [](const TextureInstance& texInst) { return texInst.texture ? texInst.texture->id : 0; };
+
+					switch ((*iter)->sortMode)
+					{
+					case TextureInstance::SortMode::DEPTH:
+						std::stable_sort(textures.begin(), textures.end(),
+							[](const TextureInstance& lhs, const TextureInstance& rhs) { return lhs.depth < rhs.depth; });
+					break;
+
+					case TextureInstance::SortMode::TEXTURE:
+						std::stable_sort(textures.begin(), textures.end(),
+							[&ID](const TextureInstance& lhs, const TextureInstance& rhs)
+							{
+								return ID(lhs) != ID(rhs) ? ID(lhs) < ID(rhs) : lhs.depth < rhs.depth;
+							});
+					break;
+
+					case TextureInstance::SortMode::DEPTH_TEXTURE:
+						std::stable_sort(textures.begin(), textures.end(),
+							[&ID](const TextureInstance& lhs, const TextureInstance& rhs)
+							{
+								return lhs.depth != rhs.depth ? lhs.depth < rhs.depth : ID(lhs) < ID(rhs);
+							});
+					break;
+
+					default: break;
+					}
+
+					m_Platform->DrawTextures(textures);
 				}
 
-				(*iter)->textures.clear();
+				DrawContext& context = (*iter)->drawContext;
+
+				m_Platform->CountCulledTextures(context.m_CulledTextures);
+
+				(*iter)->culledTextures = context.m_CulledTextures;
+				context.m_CulledTextures = 0;
+
+				(*iter)->drawnTextures = textures.size();
+				textures.clear();
 			};
 
 			for (auto iter = m_Layers.begin() + 1; iter != m_Layers.end(); ++iter)
@@ -129,8 +281,63 @@ namespace def
 				m_IsAppRunning = false;
 
 			m_Platform->OnAfterDraw();
+
+			TimePoint drawEnd = Clock::now();
+
 			m_Window->Flush();
-			m_Input->GrabEvents();
+
+			TimePoint presentEnd = Clock::now();
+
+			auto Seconds = [](Clock::duration duration) { return std::chrono::duration<float>(duration).count(); };
+
+			m_FrameTimings.update = Seconds(updateEnd - frameStart);
+			m_FrameTimings.layers = Seconds(layersEnd - updateEnd);
+			m_FrameTimings.draw = Seconds(drawEnd - layersEnd);
+			m_FrameTimings.present = Seconds(presentEnd - drawEnd);
+			m_FrameTimings.total = Seconds(presentEnd - frameStart);
+
+			m_Platform->ResetRenderStats();
+
+			if (m_IsProfiling)
+			{
+				FrameProfile& profile = m_FrameProfile;
+
+				for (float FrameTimings::* phase : { &FrameTimings::update, &FrameTimings::layers,
+					&FrameTimings::draw, &FrameTimings::present, &FrameTimings::total })
+				{
+					float time = m_FrameTimings.*phase;
+
+					profile.min.*phase = profile.frames > 0 ? std::min(profile.min.*phase, time) : time;
+					profile.max.*phase = std::max(profile.max.*phase, time);
+					profile.sum.*phase += time;
+				}
+
+				profile.frames++;
+			}
+
+			if (m_TimingsFile.is_open())
+			{
+				m_TimingsFile << m_FrameIndex << ',' << deltaTime * 1000.0f << ','
+					<< m_FrameTimings.update * 1000.0f << ',' << m_FrameTimings.layers * 1000.0f << ','
+					<< m_FrameTimings.draw * 1000.0f << ',' << m_FrameTimings.present * 1000.0f << ','
+					<< m_FrameTimings.total * 1000.0f << '\n';
+			}
+
+			m_FrameIndex++;
+
+		#ifndef DGE_PLATFORM_EMSCRIPTEN
+			m_Timer->Pace();
+		#endif
+
+			if (m_IsIdleMode && !m_IsDirty && !m_Input->HasActivity())
+			{
+				m_Input->WaitEvents(m_IdleTimeout);
+				m_Timer->m_PacingStats.idleFrames++;
+			}
+			else
+				m_Input->GrabEvents();
+
+			m_IsDirty = false;
 
 		#ifndef DGE_PLATFORM_EMSCRIPTEN
 			m_FramesCount++;
@@ -232,12 +439,13 @@ namespace def
 
 		m_CurrentLayer = layer;
 
-		m_Timer = std::make_unique<def::Timer>();
+		m_Timer->Reset();
 
 	#ifdef DGE_PLATFORM_EMSCRIPTEN
 		m_Window->UpdateCaption(-1);
 		
-		emscripten_set_main_loop(&PlatformEmscripten::MainLoop, 0, 1);
+		// The browser paces frames by itself, 0 means using requestAnimationFrame
+		emscripten_set_main_loop(&PlatformEmscripten::MainLoop, (int)m_Timer->GetTargetFrameRate(), 1);
 	#else
 		m_Window->UpdateCaption(0);
 		m_FramesCount = 0;
@@ -247,6 +455,44 @@ namespace def
 	#endif
 	}
 
+	bool GameEngine::ParseCommandLine(int argc, char* argv[])
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string_view option = argv[i];
+
+			if (option != "--record" && option != "--replay" && option != "--timings")
+				continue;
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "[defGameEngine] Missing a file name after " << option << std::endl;
+				return false;
+			}
+
+			std::string fileName = argv[++i];
+			bool opened;
+
+			if (option == "--record")
+				opened = m_Input->StartRecording(fileName);
+			else if (option == "--replay")
+			{
+				opened = m_Input->StartReplay(fileName);
+				m_QuitAfterReplay = true;
+			}
+			else
+				opened = SetTimingsOutput(fileName);
+
+			if (!opened)
+			{
+				std::cerr << "[defGameEngine] Can't open " << fileName << " for " << option << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	bool GameEngine::OnAfterDraw()
 	{
 		return true;
@@ -264,121 +510,12 @@ namespace def
 
 	bool GameEngine::Draw(int x, int y, const Pixel& col)
 	{
-		Layer* layer = m_Layers[m_CurrentLayer].get();
-
-		if (!layer->target)
-			return false;
-
-		Sprite* target = layer->target->sprite;
-
-		switch (layer->pixelMode)
-		{
-		case Pixel::Mode::CUSTOM:
-		return target->SetPixel(x, y, layer->shader({ x, y }, target->GetPixel(x, y), col));
-
-		case Pixel::Mode::DEFAULT:
-		return target->SetPixel(x, y, col);
-
-		case Pixel::Mode::MASK:
-		{
-			if (col.a == 255)
-				return target->SetPixel(x, y, col);
-		}
-		break;
-
-		case Pixel::Mode::ALPHA:
-		{
-			Pixel d = target->GetPixel(x, y);
-
-			uint8_t r = uint8_t(std::lerp(d.r, col.r, (float)col.a / 255.0f));
-			uint8_t g = uint8_t(std::lerp(d.g, col.g, (float)col.a / 255.0f));
-			uint8_t b = uint8_t(std::lerp(d.b, col.b, (float)col.a / 255.0f));
-
-			return target->SetPixel(x, y, { r, g, b });
-		}
-
-		}
-
-		return false;
+		return m_Layers[m_CurrentLayer]->drawContext.Draw(x, y, col);
 	}
 
 	void GameEngine::DrawLine(int x1, int y1, int x2, int y2, const Pixel& col)
 	{
-		int dx = x2 - x1;
-		int dy = y2 - y1;
-
-		int dx1 = abs(dx);
-		int dy1 = abs(dy);
-
-		int px = 2 * dy1 - dx1;
-		int py = 2 * dx1 - dy1;
-
-		int x, y, xe, ye;
-
-		if (dy1 <= dx1)
-		{
-			if (dx >= 0)
-			{
-				x = x1;
-				y = y1;
-				xe = x2;
-			}
-			else
-			{
-				x = x2;
-				y = y2;
-				xe = x1;
-			}
-
-			Draw(x, y, col);
-
-			while (x < xe)
-			{
-				x++;
-
-				if (px < 0)
-					px = px + 2 * dy1;
-				else
-				{
-					y += ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) ? 1 : -1;
-					px = px + 2 * (dy1 - dx1);
-				}
-
-				Draw(x, y, col);
-			}
-		}
-		else
-		{
-			if (dy >= 0)
-			{
-				x = x1;
-				y = y1;
-				ye = y2;
-			}
-			else
-			{
-				x = x2;
-				y = y2;
-				ye = y1;
-			}
-
-			Draw(x, y, col);
-
-			while (y < ye)
-			{
-				y++;
-
-				if (py <= 0)
-					py = py + 2 * dx1;
-				else
-				{
-					x += ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) ? 1 : -1;
-					py = py + 2 * (dx1 - dy1);
-				}
-
-				Draw(x, y, col);
-			}
-		}
+		Rasteriser::Line(x1, y1, x2, y2, [&](int px, int py) { Draw(px, py, col); });
 	}
 
 	void GameEngine::DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col)
@@ -390,480 +527,53 @@ namespace def
 
 	void GameEngine::FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const Pixel& col)
 	{
-		auto draw_line = [&](int start, int end, int y)
+		Rasteriser::FillTriangle(x1, y1, x2, y2, x3, y3, [&](int start, int end, int py)
 			{
-				for (int i = start; i <= end; i++)
-					Draw(i, y, col);
-			};
-
-		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
-
-		bool changed1 = false;
-		bool changed2 = false;
-
-		int signx1, signx2, dx1, dy1, dx2, dy2;
-		int e1, e2;
-
-		if (y1 > y2)
-		{
-			std::swap(y1, y2);
-			std::swap(x1, x2);
-		}
-
-		if (y1 > y3)
-		{
-			std::swap(y1, y3);
-			std::swap(x1, x3);
-		}
-
-		if (y2 > y3)
-		{
-			std::swap(y2, y3);
-			std::swap(x2, x3);
-		}
-
-		t1x = t2x = x1;
-		y = y1;
-		dx1 = x2 - x1;
-
-		if (dx1 < 0)
-		{
-			dx1 = -dx1;
-			signx1 = -1;
-		}
-		else
-			signx1 = 1;
-
-		dy1 = y2 - y1;
-		dx2 = x3 - x1;
-
-		if (dx2 < 0)
-		{
-			dx2 = -dx2;
-			signx2 = -1;
-		}
-		else
-			signx2 = 1;
-
-		dy2 = y3 - y1;
-
-		if (dy1 > dx1)
-		{
-			std::swap(dx1, dy1);
-			changed1 = true;
-		}
-
-		if (dy2 > dx2)
-		{
-			std::swap(dy2, dx2);
-			changed2 = true;
-		}
-
-		e2 = dx2 >> 1;
-
-		if (y1 == y2)
-			goto next;
-
-		e1 = dx1 >> 1;
-
-		for (int i = 0; i < dx1;)
-		{
-			t1xp = t2xp = 0;
-
-			if (t1x < t2x)
-			{
-				minx = t1x;
-				maxx = t2x;
-			}
-			else
-			{
-				minx = t2x;
-				maxx = t1x;
-			}
-
-			while (i++ < dx1)
-			{
-				e1 += dy1;
-
-				while (e1 >= dx1)
-				{
-					e1 -= dx1;
-
-					if (changed1)
-						t1xp = signx1;
-					else
-						goto next1;
-				}
-
-				if (changed1)
-					break;
-				else
-					t1x += signx1;
-			}
-
-		next1:
-			while (1)
-			{
-				e2 += dy2;
-
-				while (e2 >= dx2)
-				{
-					e2 -= dx2;
-
-					if (changed2)
-						t2xp = signx2;
-					else
-						goto next2;
-				}
-
-				if (changed2)
-					break;
-				else
-					t2x += signx2;
-			}
-
-		next2:
-			if (minx > t1x) minx = t1x;
-			if (minx > t2x) minx = t2x;
-			if (maxx < t1x) maxx = t1x;
-			if (maxx < t2x) maxx = t2x;
-
-			draw_line(minx, maxx, y);
-
-			if (!changed1)
-				t1x += signx1;
-
-			t1x += t1xp;
-
-			if (!changed2)
-				t2x += signx2;
-
-			t2x += t2xp;
-			y++;
-
-			if (y == y2)
-				break;
-		}
-
-	next:
-		dx1 = x3 - x2;
-
-		if (dx1 < 0)
-		{
-			dx1 = -dx1;
-			signx1 = -1;
-		}
-		else
-			signx1 = 1;
-
-		dy1 = y3 - y2;
-		t1x = x2;
-
-		if (dy1 > dx1)
-		{
-			std::swap(dy1, dx1);
-			changed1 = true;
-		}
-		else
-			changed1 = false;
-
-		e1 = dx1 >> 1;
-
-		for (int i = 0; i <= dx1; i++)
-		{
-			t1xp = t2xp = 0;
-
-			if (t1x < t2x)
-			{
-				minx = t1x;
-				maxx = t2x;
-			}
-			else
-			{
-				minx = t2x;
-				maxx = t1x;
-			}
-
-			while (i < dx1)
-			{
-				e1 += dy1;
-
-				while (e1 >= dx1)
-				{
-					e1 -= dx1;
-
-					if (changed1)
-					{
-						t1xp = signx1;
-						break;
-					}
-					else
-						goto next3;
-				}
-
-				if (changed1)
-					break;
-				else
-					t1x += signx1;
-
-				if (i < dx1) i++;
-			}
-
-		next3:
-			while (t2x != x3)
-			{
-				e2 += dy2;
-
-				while (e2 >= dx2)
-				{
-					e2 -= dx2;
-
-					if (changed2)
-						t2xp = signx2;
-					else
-						goto next4;
-				}
-
-				if (changed2)
-					break;
-				else
-					t2x += signx2;
-			}
-
-		next4:
-			if (minx > t1x) minx = t1x;
-			if (minx > t2x) minx = t2x;
-			if (maxx < t1x) maxx = t1x;
-			if (maxx < t2x) maxx = t2x;
-
-			draw_line(minx, maxx, y);
-
-			if (!changed1)
-				t1x += signx1;
-
-			t1x += t1xp;
-
-			if (!changed2)
-				t2x += signx2;
-
-			t2x += t2xp;
-			y++;
-
-			if (y > y3)
-				return;
-		}
+				for (int px = start; px <= end; px++)
+					Draw(px, py, col);
+			});
 	}
 
 	void GameEngine::DrawRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col)
 	{
-		for (int i = 0; i < sizeX; i++)
-		{
-			Draw(x + i, y, col);
-			Draw(x + i, y + sizeY, col);
-		}
-
-		for (int i = 0; i < sizeY; i++)
-		{
-			Draw(x, y + i, col);
-			Draw(x + sizeX - 1, y + i, col);
-		}
+		Rasteriser::Rectangle(x, y, sizeX, sizeY, [&](int px, int py) { Draw(px, py, col); });
 	}
 
 	void GameEngine::FillRectangle(int x, int y, int sizeX, int sizeY, const Pixel& col)
 	{
-		for (int i = 0; i < sizeX; i++)
-			for (int j = 0; j < sizeY; j++)
-				Draw(x + i, y + j, col);
+		Rasteriser::FillRectangle(x, y, sizeX, sizeY, [&](int start, int end, int py)
+			{
+				for (int px = start; px <= end; px++)
+					Draw(px, py, col);
+			});
 	}
 
 	void GameEngine::DrawCircle(int x, int y, int radius, const Pixel& col)
 	{
-		int x1 = 0;
-		int y1 = radius;
-		int p1 = 3 - 2 * radius;
-
-		while (y1 >= x1)
-		{
-			Draw(x - x1, y - y1, col);
-			Draw(x - y1, y - x1, col);
-			Draw(x + y1, y - x1, col);
-			Draw(x + x1, y - y1, col);
-			Draw(x - x1, y + y1, col);
-			Draw(x - y1, y + x1, col);
-			Draw(x + y1, y + x1, col);
-			Draw(x + x1, y + y1, col);
-
-			if (p1 < 0)
-			{
-				p1 += 4 * x1 + 6;
-				x1++;
-			}
-			else
-			{
-				p1 += 4 * (x1 - y1) + 10;
-				x1++;
-				y1--;
-			}
-		}
+		Rasteriser::Circle(x, y, radius, [&](int px, int py) { Draw(px, py, col); });
 	}
 
 	void GameEngine::FillCircle(int x, int y, int radius, const Pixel& col)
 	{
-		auto draw_line = [&](int start, int end, int y)
-			{
-				for (int i = start; i <= end; i++)
-					Draw(i, y, col);
-			};
-
-		int x1 = 0;
-		int y1 = radius;
-		int p1 = 3 - 2 * radius;
-
-		while (y1 >= x1)
-		{
-			draw_line(x - x1, x + x1, y - y1);
-			draw_line(x - y1, x + y1, y - x1);
-			draw_line(x - x1, x + x1, y + y1);
-			draw_line(x - y1, x + y1, y + x1);
-
-			if (p1 < 0)
-			{
-				p1 += 4 * x1 + 6;
-				x1++;
-			}
-			else
+		Rasteriser::FillCircle(x, y, radius, [&](int start, int end, int py)
 			{
-				p1 += 4 * (x1 - y1) + 10;
-				x1++;
-				y1--;
-			}
-		}
+				for (int px = start; px <= end; px++)
+					Draw(px, py, col);
+			});
 	}
 
 	void GameEngine::DrawEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col)
 	{
-		int x1 = x + sizeX;
-		int y1 = y + sizeY;
-
-		int a = abs(x1 - x);
-		int b = abs(y1 - y);
-		int b1 = b & 1;
-
-		int dx = 4 * (1 - a) * b * b;
-		int dy = 4 * (b1 + 1) * a * a;
-
-		int err = dx + dy + b1 * a * a;
-
-		if (x > x1)
-		{
-			x = x1;
-			x1 += a;
-		}
-
-		if (y > y1)
-			y = y1;
-
-		y += (b + 1) / 2;
-		y1 = y - b1;
-
-		a *= 8 * a;
-		b1 = 8 * b * b;
-
-		do
-		{
-			Draw(x1, y, col);
-			Draw(x, y, col);
-			Draw(x, y1, col);
-			Draw(x1, y1, col);
-
-			int e2 = 2 * err;
-
-			if (e2 <= dy)
-			{
-				y++;
-				y1--;
-				err += dy += a;
-			}
-
-			if (e2 >= dx || 2 * err > dy)
-			{
-				x++;
-				x1--;
-				err += dx += b1;
-			}
-		} while (x <= x1);
-
-		while (y - y1 < b)
-		{
-			Draw(x - 1, y, col);
-			Draw(x1 + 1, y++, col);
-			Draw(x - 1, y1, col);
-			Draw(x1 + 1, y1--, col);
-		}
+		Rasteriser::Ellipse(x, y, sizeX, sizeY, [&](int px, int py) { Draw(px, py, col); });
 	}
 
 	void GameEngine::FillEllipse(int x, int y, int sizeX, int sizeY, const Pixel& col)
 	{
-		auto draw_line = [&](int start, int end, int y)
-			{
-				for (int i = start; i <= end; i++)
-					Draw(i, y, col);
-			};
-
-		int x1 = x + sizeX;
-		int y1 = y + sizeY;
-
-		int a = abs(x1 - x);
-		int b = abs(y1 - y);
-		int b1 = b & 1;
-
-		int dx = 4 * (1 - a) * b * b;
-		int dy = 4 * (b1 + 1) * a * a;
-
-		int err = dx + dy + b1 * a * a;
-
-		if (x > x1)
-		{
-			x = x1;
-			x1 += a;
-		}
-
-		if (y > y1)
-			y = y1;
-
-		y += (b + 1) / 2;
-		y1 = y - b1;
-
-		a *= 8 * a;
-		b1 = 8 * b * b;
-
-		do
-		{
-			draw_line(x, x1, y);
-			draw_line(x, x1, y1);
-
-			int e2 = 2 * err;
-
-			if (e2 <= dy)
+		Rasteriser::FillEllipse(x, y, sizeX, sizeY, [&](int start, int end, int py)
 			{
-				y++;
-				y1--;
-				err += dy += a;
-			}
-
-			if (e2 >= dx || 2 * err > dy)
-			{
-				x++;
-				x1--;
-				err += dx += b1;
-			}
-		} while (x <= x1);
-
-		while (y - y1 < b)
-		{
-			draw_line(x - 1, x1 + 1, y++);
-			draw_line(x - 1, x1 + 1, y1--);
-		}
+				for (int px = start; px <= end; px++)
+					Draw(px, py, col);
+			});
 	}
 
 	void GameEngine::DrawSprite(int x, int y, const Sprite* sprite)
@@ -880,125 +590,24 @@ namespace def
 				Draw(x + x1, y + y1, sprite->GetPixel(fileX + i, fileY + j));
 	}
 
-	void GameEngine::DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, const Pixel& col)
-	{
-		size_t verts = modelCoordinates.size();
-
-		std::vector<Vector2f> coordinates(verts);
-		float cs = cosf(rotation), sn = sinf(rotation);
-
-		for (size_t i = 0; i < verts; i++)
-		{
-			coordinates[i].x = (modelCoordinates[i].x * cs - modelCoordinates[i].y * sn) * scale + x;
-			coordinates[i].y = (modelCoordinates[i].x * sn + modelCoordinates[i].y * cs) * scale + y;
-		}
-
-		for (size_t i = 0; i <= verts; i++)
-			DrawLine(coordinates[i % verts], coordinates[(i + 1) % verts], col);
+	void GameEngine::DrawWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, const Pixel& col)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.DrawWireFrameModel(modelCoordinates, { x, y }, rotation, scale, col);
 	}
 
 	void GameEngine::FillWireFrameModel(const std::vector<Vector2f>& modelCoordinates, float x, float y, float rotation, float scale, const Pixel& col)
 	{
-		size_t verts = modelCoordinates.size();
-
-		std::vector<Vector2f> coordinates(verts);
-		float cs = cosf(rotation), sn = sinf(rotation);
-
-		for (size_t i = 0; i < verts; i++)
-		{
-			coordinates[i].x = (modelCoordinates[i].x * cs - modelCoordinates[i].y * sn) * scale + x;
-			coordinates[i].y = (modelCoordinates[i].x * sn + modelCoordinates[i].y * cs) * scale + y;
-		}
-
-		auto GetAngle = [](const Vector2f& p1, const Vector2f& p2)
-			{
-				float a = atan2(p2.y, p2.x) - atan2(p1.y, p1.x);
-				while (a > 3.14159f) a -= 3.14159f * 2.0f;
-				while (a < -3.14159f) a += 3.14159f * 2.0f;
-				return a;
-			};
-
-		auto PointInPolygon = [&](const Vector2f& p)
-			{
-				float angle = 0.0f;
-
-				for (size_t i = 0; i < verts; i++)
-					angle += GetAngle(coordinates[i] - p, coordinates[(i + 1) % verts] - p);
-
-				return std::abs(angle) >= 3.14159f;
-			};
-
-		Vector2f& min = coordinates.front();
-		Vector2f& max = coordinates.front();
-
-		for (size_t i = 1; i < verts; i++)
-		{
-			if (min.x > coordinates[i].x) min.x = coordinates[i].x;
-			if (min.y > coordinates[i].y) min.y = coordinates[i].y;
-
-			if (max.x < coordinates[i].x) max.x = coordinates[i].x;
-			if (max.y < coordinates[i].y) max.y = coordinates[i].y;
-		}
-
-		Vector2f point;
-		for (point.x = min.x; point.x < max.x; point.x++)
-			for (point.y = min.y; point.y < max.y; point.y++)
-			{
-				if (PointInPolygon(point))
-					Draw(point, col);
-			}
+		m_Layers[m_CurrentLayer]->drawContext.FillWireFrameModel(modelCoordinates, { x, y }, rotation, scale, col);
 	}
 
 	void GameEngine::DrawString(int x, int y, std::string_view s, const Pixel& col, int scaleX, int scaleY)
 	{
-		int sx = 0;
-		int sy = 0;
-
-		for (auto c : s)
-		{
-			if (c == '\n')
-			{
-				sx = 0;
-				sy += 8 * scaleY;
-			}
-			else if (c == '\t')
-				sx += 8 * m_TabSize * scaleX;
-			else
-			{
-				int ox = (c - 32) % 16;
-				int oy = (c - 32) / 16;
-
-				if (scaleX > 1 || scaleY > 1)
-				{
-					for (int i = 0; i < 8; i++)
-						for (int j = 0; j < 8; j++)
-						{
-							if (m_Font.sprite->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-							{
-								for (int is = 0; is < scaleX; is++)
-									for (int js = 0; js < scaleY; js++)
-										Draw(x + sx + i * scaleX + is, y + sy + j * scaleY + js, col);
-							}
-						}
-				}
-				else
-				{
-					for (int i = 0; i < 8; i++)
-						for (int j = 0; j < 8; j++)
-						{
-							if (m_Font.sprite->GetPixel(i + ox * 8, j + oy * 8).r > 0)
-								Draw(x + sx + i, y + sy + j, col);
-						}
-				}
-
-				sx += 8 * scaleX;
-			}
-		}
+		Rasteriser::String(x, y, s, m_Font.sprite, m_TabSize, scaleX, scaleY, [&](int px, int py) { Draw(px, py, col); });
 	}
 
 	void GameEngine::Clear(const Pixel& col)
 	{
-		m_Layers[m_CurrentLayer]->target->sprite->SetPixelData(col);
+		m_Layers[m_CurrentLayer]->drawContext.Clear(col);
 	}
 
 	bool GameEngine::Draw(const Vector2i& pos, const Pixel& p)
@@ -1078,323 +687,143 @@ namespace def
 
 	void GameEngine::DrawTexturePolygon(const std::vector<Vector2f>& verts, const std::vector<Pixel>& cols, Texture::Structure structure)
 	{
-		TextureInstance texInst;
-
-		texInst.texture = nullptr;
-		texInst.points = verts.size();
-		texInst.structure = structure;
-
-		texInst.tint.resize(verts.size());
-
-		if (cols.size() > 1)
-		{
-			std::copy(
-				cols.begin(),
-				cols.end(),
-				texInst.tint.begin());
-		}
-		else
-		{
-			std::fill(
-				texInst.tint.begin(),
-				texInst.tint.end(),
-				cols.empty() ? def::WHITE : cols[0]);
-		}
-
-		texInst.uv.resize(verts.size());
-		texInst.vertices.resize(verts.size());
-
-		const Vector2f& inv = m_Window->GetInvertedScreenSize();
+		m_Layers[m_CurrentLayer]->drawContext.DrawTexturePolygon(verts, cols, structure);
+	}
 
-		for (size_t i = 0; i < verts.size(); i++)
-		{
-			texInst.vertices[i].x = verts[i].x * inv.x * 2.0f - 1.0f;
-			texInst.vertices[i].y = 1.0f - verts[i].y * inv.y * 2.0f;
-		}
+	void GameEngine::DrawTextureTriangles(const Texture* tex, const std::vector<Vector2f>& verts, const std::vector<Vector2f>& uvs, const std::vector<Pixel>& cols)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureTriangles(tex, verts, uvs, cols);
+	}
 
-		m_Layers[m_CurrentLayer]->textures.push_back(texInst);
+	void GameEngine::DrawTextureTriangles(const Texture* tex, std::vector<Vector2f>&& verts, std::vector<Vector2f>&& uvs, std::vector<Pixel>&& cols)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureTriangles(tex, std::move(verts), std::move(uvs), std::move(cols));
 	}
 
 	void GameEngine::DrawTextureLine(const Vector2i& pos1, const Vector2i& pos2, const Pixel& col)
 	{
-		DrawTexturePolygon({ pos1, pos2 }, { col }, Texture::Structure::WIREFRAME);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureLine(pos1, pos2, col);
 	}
 
 	void GameEngine::DrawTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
 	{
-		DrawTexturePolygon({ pos1, pos2, pos3 }, { col }, Texture::Structure::WIREFRAME);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureTriangle(pos1, pos2, pos3, col);
 	}
 
 	void GameEngine::FillTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col)
 	{
-		DrawTexturePolygon({ pos1, pos2, pos3 }, { col }, Texture::Structure::TRIANGLE_FAN);
+		m_Layers[m_CurrentLayer]->drawContext.FillTextureTriangle(pos1, pos2, pos3, col);
 	}
 
 	void GameEngine::DrawTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
 	{
-		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { col }, Texture::Structure::WIREFRAME);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureRectangle(pos, size, col);
 	}
 
 	void GameEngine::FillTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& col)
 	{
-		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { col }, Texture::Structure::TRIANGLE_FAN);
+		m_Layers[m_CurrentLayer]->drawContext.FillTextureRectangle(pos, size, col);
 	}
 
 	void GameEngine::DrawTextureCircle(const Vector2i& pos, int radius, const Pixel& col)
 	{
-		std::vector<Vector2f> verts(s_UnitCircle.size());
-
-		for (size_t i = 0; i < verts.size(); i++)
-			verts[i] = s_UnitCircle[i] * (float)radius + pos;
-
-		DrawTexturePolygon(verts, { col }, Texture::Structure::WIREFRAME);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureCircle(pos, radius, col);
 	}
 
 	void GameEngine::FillTextureCircle(const Vector2i& pos, int radius, const Pixel& col)
 	{
-		std::vector<Vector2f> verts(s_UnitCircle.size());
-
-		for (size_t i = 0; i < verts.size(); i++)
-			verts[i] = s_UnitCircle[i] * (float)radius + pos;
-
-		DrawTexturePolygon(verts, { col }, Texture::Structure::TRIANGLE_FAN);
+		m_Layers[m_CurrentLayer]->drawContext.FillTextureCircle(pos, radius, col);
 	}
 
 	void GameEngine::GradientTextureTriangle(const Vector2i& pos1, const Vector2i& pos2, const Vector2i& pos3, const Pixel& col1, const Pixel& col2, const Pixel& col3)
 	{
-		DrawTexturePolygon({ pos1, pos2, pos3 }, { col1, col2, col3 }, Texture::Structure::TRIANGLE_FAN);
+		m_Layers[m_CurrentLayer]->drawContext.GradientTextureTriangle(pos1, pos2, pos3, col1, col2, col3);
 	}
 
 	void GameEngine::GradientTextureRectangle(const Vector2i& pos, const Vector2i& size, const Pixel& colTL, const Pixel& colTR, const Pixel& colBR, const Pixel& colBL)
 	{
-		DrawTexturePolygon({ pos, { float(pos.x + size.x), (float)pos.y }, pos + size, { (float)pos.x, float(pos.y + size.y) } }, { colTL, colTR, colBR, colBL }, Texture::Structure::TRIANGLE_FAN);
+		m_Layers[m_CurrentLayer]->drawContext.GradientTextureRectangle(pos, size, colTL, colTR, colBR, colBL);
 	}
 
 	void GameEngine::DrawTextureString(const Vector2i& pos, std::string_view text, const Pixel& col, const Vector2f& scale)
 	{
-		Vector2f p = { 0.0f, 0.0f };
-
-		for (auto c : text)
-		{
-			if (c == '\n')
-			{
-				p.x = 0;
-				p.y += 8.0f * scale.y;
-			}
-			else if (c == '\t')
-			{
-				p.x += 8.0f * float(m_TabSize) * scale.x;
-			}
-			else
-			{
-				Vector2f offset((c - 32) % 16, (c - 32) / 16);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureString(pos, text, col, scale);
+	}
 
-				DrawPartialTexture(pos + p, m_Font.texture, offset * 8.0f, { 8.0f, 8.0f }, scale, col);
-				p.x += 8.0f * scale.x;
-			}
-		}
+	void GameEngine::DrawTextureList(const Vector2f& pos, const DrawList* list, const Vector2f& scale, const Pixel& tint)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.DrawTextureList(pos, list, scale, tint);
 	}
 
 	void GameEngine::DrawTexture(const Vector2f& pos, const Texture* tex, const Vector2f& scale, const Pixel& tint)
 	{
-		auto layer = m_Layers[m_CurrentLayer].get();
-
-		const Vector2f& inv = m_Window->GetInvertedScreenSize();
-
-		Vector2f pos1 = (pos * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
-		Vector2f pos2 = pos1 + 2.0f * tex->size * inv * scale * Vector2f(1.0f, -1.0f);
-
-		TextureInstance texInst;
-
-		texInst.texture = tex;
-		texInst.points = 4;
-		texInst.structure = layer->textureStructure;
-		texInst.tint = { tint, tint, tint, tint };
-		texInst.vertices = { pos1, { pos1.x, pos2.y }, pos2, { pos2.x, pos1.y } };
-		texInst.ConstructUV();
-
-		layer->textures.push_back(texInst);
+		m_Layers[m_CurrentLayer]->drawContext.DrawTexture(pos, tex, scale, tint);
 	}
 
 	void GameEngine::DrawPartialTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, const Vector2f& scale, const Pixel& tint)
 	{
-		auto layer = m_Layers[m_CurrentLayer].get();
-
-		const Vector2f& inv = m_Window->GetInvertedScreenSize();
-
-		Vector2f screenPos1 = (pos * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
-		Vector2f screenPos2 = ((pos + fileSize * scale) * inv * 2.0f - 1.0f) * Vector2f(1.0f, -1.0f);
-
-		const Vector2i& size = m_Window->GetWindowSize();
-
-		Vector2f quantPos1 = (screenPos1 * Vector2f(m_Window->GetWindowSize()) + Vector2f(0.5f, 0.5f)).Floor() / Vector2f(size);
-		Vector2f quantPos2 = (screenPos2 * Vector2f(m_Window->GetWindowSize()) + Vector2f(0.5f, -0.5f)).Ceil() / Vector2f(size);
-
-		Vector2f tl = (filePos + 0.0001f) * tex->uvScale;
-		Vector2f br = (filePos + fileSize - 0.0001f) * tex->uvScale;
-
-		TextureInstance texInst;
-
-		texInst.texture = tex;
-		texInst.points = 4;
-		texInst.structure = layer->textureStructure;
-		texInst.tint = { tint, tint, tint, tint };
-		texInst.vertices = { quantPos1, { quantPos1.x, quantPos2.y }, quantPos2, { quantPos2.x, quantPos1.y } };
-		texInst.uv = { tl, { tl.x, br.y }, br, { br.x, tl.y } };
-
-		layer->textures.push_back(texInst);
+		m_Layers[m_CurrentLayer]->drawContext.DrawPartialTexture(pos, tex, filePos, fileSize, scale, tint);
 	}
 
 	void GameEngine::DrawRotatedTexture(const Vector2f& pos, const Texture* tex, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
 	{
-		auto layer = m_Layers[m_CurrentLayer].get();
-
-		TextureInstance texInst;
-
-		texInst.texture = tex;
-		texInst.points = 4;
-		texInst.structure = layer->textureStructure;
-		texInst.tint = { tint, tint, tint, tint };
-
-		Vector2f denormCenter = center * tex->size;
-
-		texInst.vertices = {
-			-denormCenter * scale,
-			(Vector2f(0.0f, tex->size.y) - denormCenter) * scale,
-			(tex->size - denormCenter) * scale,
-			(Vector2f(tex->size.x, 0.0f) - denormCenter) * scale
-		};
-
-		const Vector2f& inv = m_Window->GetInvertedScreenSize();
-
-		float c = cos(rotation), s = sin(rotation);
-		for (size_t i = 0; i < texInst.points; i++)
-		{
-			Vector2f offset =
-			{
-				texInst.vertices[i].x * c - texInst.vertices[i].y * s,
-				texInst.vertices[i].x * s + texInst.vertices[i].y * c
-			};
-
-			texInst.vertices[i] = pos + offset;
-			texInst.vertices[i] = texInst.vertices[i] * inv * 2.0f - 1.0f;
-			texInst.vertices[i].y *= -1.0f;
-		}
-
-		texInst.ConstructUV();
-
-		layer->textures.push_back(texInst);
+		m_Layers[m_CurrentLayer]->drawContext.DrawRotatedTexture(pos, tex, rotation, center, scale, tint);
 	}
 
 	void GameEngine::DrawPartialRotatedTexture(const Vector2f& pos, const Texture* tex, const Vector2f& filePos, const Vector2f& fileSize, float rotation, const Vector2f& center, const Vector2f& scale, const Pixel& tint)
 	{
-		auto layer = m_Layers[m_CurrentLayer].get();
-
-		TextureInstance texInst;
-
-		texInst.texture = tex;
-		texInst.points = 4;
-		texInst.structure = layer->textureStructure;
-		texInst.tint = { tint, tint, tint, tint };
-
-		Vector2f denormCenter = center * fileSize;
-
-		texInst.vertices = {
-			-denormCenter * scale,
-			(Vector2f(0.0f, fileSize.y) - denormCenter) * scale,
-			(fileSize - denormCenter) * scale,
-			(Vector2f(fileSize.x, 0.0f) - denormCenter) * scale
-		};
-
-		const Vector2f& inv = m_Window->GetInvertedScreenSize();
-
-		float c = cos(rotation), s = sin(rotation);
-		for (size_t i = 0; i < texInst.points; i++)
-		{
-			Vector2f offset =
-			{
-				texInst.vertices[i].x * c - texInst.vertices[i].y * s,
-				texInst.vertices[i].x * s + texInst.vertices[i].y * c
-			};
-
-			texInst.vertices[i] = pos + offset;
-			texInst.vertices[i] = texInst.vertices[i] * inv * 2.0f - 1.0f;
-			texInst.vertices[i].y *= -1.0f;
-		}
-
-		Vector2f tl = filePos * tex->uvScale;
-		Vector2f br = tl + fileSize * tex->uvScale;
-
-		texInst.uv = { tl, { tl.x, br.y }, br, { br.x, tl.y } };
-
-		layer->textures.push_back(texInst);
+		m_Layers[m_CurrentLayer]->drawContext.DrawPartialRotatedTexture(pos, tex, filePos, fileSize, rotation, center, scale, tint);
 	}
 
 	void GameEngine::DrawWarpedTexture(const std::vector<Vector2f>& points, const Texture* tex, const Pixel& tint)
 	{
-		auto& layer = m_Layers[m_CurrentLayer];
-
-		TextureInstance texInst;
-
-		texInst.texture = tex;
-		texInst.structure = layer->textureStructure;
-		texInst.points = 4;
-		texInst.tint = { tint, tint, tint, tint };
-		texInst.vertices.resize(texInst.points);
-		texInst.ConstructUV();
-
-		float rd = ((points[2].x - points[0].x) * (points[3].y - points[1].y) - (points[3].x - points[1].x) * (points[2].y - points[0].y));
-
-		if (rd != 0.0f)
-		{
-			rd = 1.0f / rd;
-
-			float rn = ((points[3].x - points[1].x) * (points[0].y - points[1].y) - (points[3].y - points[1].y) * (points[0].x - points[1].x)) * rd;
-			float sn = ((points[2].x - points[0].x) * (points[0].y - points[1].y) - (points[2].y - points[0].y) * (points[0].x - points[1].x)) * rd;
-
-			Vector2f center;
+		m_Layers[m_CurrentLayer]->drawContext.DrawWarpedTexture(points, tex, tint);
+	}
 
-			if (rn >= 0.0f && rn <= 1.0f && sn >= 0.0f && sn <= 1.0f)
-				center = points[0] + rn * (points[2] - points[0]);
+	void GameEngine::ClearTexture(const Pixel& col)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.ClearTexture(col);
+	}
 
-			float d[4];
+	void GameEngine::SetDrawTarget(Graphic* target)
+	{
+		DrawContext& context = m_Layers[m_CurrentLayer]->drawContext;
 
-			for (int i = 0; i < 4; i++)
-				d[i] = (points[i] - center).Length();
+		context.SetDrawTarget(target);
 
-			const Vector2f& inv = m_Window->GetInvertedScreenSize();
+		// There is no target in UseOnlyTextures mode
+		if (Graphic* t = context.GetDrawTarget())
+			t->UpdateTexture();
+	}
 
-			for (int i = 0; i < 4; i++)
-			{
-				float q = d[i] == 0.0f ? 1.0f : (d[i] + d[(i + 2) & 3]) / d[(i + 2) & 3];
-				texInst.uv[i] *= q;
-				texInst.vertices[i] = { points[i].x * inv.x * 2.0f - 1.0f, 1.0f - points[i].y * inv.y * 2.0f };
-			}
+	Graphic* GameEngine::GetDrawTarget()
+	{
+		return m_Layers[m_CurrentLayer]->target;
+	}
 
-			layer->textures.push_back(texInst);
-		}
+	void GameEngine::SetTextureTarget(RenderTarget* target)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.SetTextureTarget(target);
 	}
 
-	void GameEngine::ClearTexture(const Pixel& col)
+	RenderTarget* GameEngine::GetTextureTarget() const
 	{
-		Layer* layer = m_Layers[m_CurrentLayer].get();
-		FillTextureRectangle({ 0, 0 }, layer->size, col);
+		return m_Layers[m_CurrentLayer]->drawContext.GetTextureTarget();
 	}
 
-	void GameEngine::SetDrawTarget(Graphic* target)
+	void GameEngine::SetDrawList(DrawList* list)
 	{
-		m_Layers[m_CurrentLayer]->target = target ? target : m_Layers[m_CurrentLayer]->pixels;
-		m_Layers[m_CurrentLayer]->target->UpdateTexture();
+		m_Layers[m_CurrentLayer]->drawContext.SetDrawList(list);
 	}
 
-	Graphic* GameEngine::GetDrawTarget()
+	DrawList* GameEngine::GetDrawList() const
 	{
-		return m_Layers[m_CurrentLayer]->target;
+		return m_Layers[m_CurrentLayer]->drawContext.GetDrawList();
 	}
 
 	void GameEngine::SetPixelMode(Pixel::Mode pixelMode)
 	{
-		m_Layers[m_CurrentLayer]->pixelMode = pixelMode;
+		m_Layers[m_CurrentLayer]->drawContext.SetPixelMode(pixelMode);
 	}
 
 	Pixel::Mode GameEngine::GetPixelMode() const
@@ -1414,7 +843,7 @@ namespace def
 
 	void GameEngine::SetTextureStructure(Texture::Structure textureStructure)
 	{
-		m_Layers[m_CurrentLayer]->textureStructure = textureStructure;
+		m_Layers[m_CurrentLayer]->drawContext.SetTextureStructure(textureStructure);
 	}
 
 	Texture::Structure GameEngine::GetTextureStructure() const
@@ -1422,6 +851,26 @@ namespace def
 		return m_Layers[m_CurrentLayer]->textureStructure;
 	}
 
+	void GameEngine::SetTextureDepth(float depth)
+	{
+		m_Layers[m_CurrentLayer]->drawContext.SetTextureDepth(depth);
+	}
+
+	float GameEngine::GetTextureDepth() const
+	{
+		return m_Layers[m_CurrentLayer]->drawContext.GetTextureDepth();
+	}
+
+	void GameEngine::SetSortMode(TextureInstance::SortMode sortMode)
+	{
+		m_Layers[m_CurrentLayer]->sortMode = sortMode;
+	}
+
+	TextureInstance::SortMode GameEngine::GetSortMode() const
+	{
+		return m_Layers[m_CurrentLayer]->sortMode;
+	}
+
 	void GameEngine::UseOnlyTextures(bool enable)
 	{
 		m_OnlyTextures = enable;
@@ -1429,10 +878,108 @@ namespace def
 
 	void GameEngine::SetShader(Pixel(*func)(const Vector2i&, const Pixel&, const Pixel&))
 	{
-		auto& layer = m_Layers[m_CurrentLayer];
+		m_Layers[m_CurrentLayer]->drawContext.SetShader(func);
+	}
+
+	void GameEngine::AddPostProcess(DrawContext::SpanShader shader)
+	{
+		if (shader)
+			m_Layers[m_CurrentLayer]->postProcess.push_back(shader);
+	}
+
+	void GameEngine::ClearPostProcess()
+	{
+		Layer* layer = m_Layers[m_CurrentLayer].get();
+
+		layer->postProcess.clear();
+		layer->postProcessed = nullptr;
+
+		for (Sprite& buffer : layer->postProcessBuffers)
+			buffer = Sprite();
+	}
+
+	void GameEngine::SetPalette(std::span<const Pixel> colours, uint8_t first)
+	{
+		Layer* layer = m_Layers[m_CurrentLayer].get();
+
+		if (!layer->pixels)
+			return;
+
+		if (layer->palette.pixels.empty())
+		{
+			layer->palette.Create({ 256, 1 });
+			layer->palette.SetPixelData(NONE);
+		}
+
+		if (layer->indices.size != layer->pixels->sprite->size)
+			layer->indices.Create(layer->pixels->sprite->size);
+
+		size_t count = std::min(colours.size(), (size_t)256 - first);
+		std::copy_n(colours.begin(), count, layer->palette.pixels.begin() + first);
+
+		layer->paletteChanged = true;
+	}
+
+	ImageIndex8* GameEngine::GetIndices()
+	{
+		Layer* layer = m_Layers[m_CurrentLayer].get();
+		return layer->palette.pixels.empty() ? nullptr : &layer->indices;
+	}
+
+	void GameEngine::ClearPalette()
+	{
+		Layer* layer = m_Layers[m_CurrentLayer].get();
+
+		layer->indices = ImageIndex8();
+		layer->palette = Sprite();
+
+		delete layer->indexTexture;
+		delete layer->paletteTexture;
+
+		layer->indexTexture = nullptr;
+		layer->paletteTexture = nullptr;
+		layer->paletteChanged = false;
+	}
+
+	bool GameEngine::IsPaletteOnGPU(const Layer* layer) const
+	{
+		// The passes need the colours on the CPU
+		return layer->postProcess.empty() && m_Platform->IsPaletteSupported();
+	}
+
+	void GameEngine::ApplyPostProcess(Layer* layer)
+	{
+		layer->postProcessed = nullptr;
+
+		if (layer->postProcess.empty() || !layer->pixels)
+			return;
+
+		const Sprite* source = layer->pixels->sprite;
+		const Vector2i& size = source->size;
+
+		for (Sprite& buffer : layer->postProcessBuffers)
+		{
+			if (buffer.size != size)
+				buffer.Create(size);
+		}
+
+		// Enough rows per task to make the scheduling cost negligible
+		int grain = std::max(1, 16384 / std::max(size.x, 1));
 
-		layer->shader = func;
-		layer->pixelMode = func ? Pixel::Mode::CUSTOM : Pixel::Mode::DEFAULT;
+		for (size_t i = 0; i < layer->postProcess.size(); i++)
+		{
+			DrawContext::SpanShader shader = layer->postProcess[i];
+			Sprite* target = &layer->postProcessBuffers[i % 2];
+
+			m_ThreadPool->ParallelFor(0, size.y,
+				[&](int y)
+				{
+					shader(y, 0, size.x, target->GetRow(y), source->GetRow(y));
+				}, grain);
+
+			source = target;
+			layer->postProcessed = target;
+		}
 	}
 
 	void GameEngine::SetFont(std::string_view fileName)
@@ -1459,6 +1006,36 @@ namespace def
 		return m_Layers.size() - 1;
 	}
 
+	RenderTarget* GameEngine::CreateRenderTarget(const Vector2i& size)
+	{
+		m_RenderTargets.push_back(std::make_unique<RenderTarget>(m_Platform.get(), size));
+		return m_RenderTargets.back().get();
+	}
+
+	void GameEngine::DestroyRenderTarget(RenderTarget* target)
+	{
+		auto iter = std::find_if(m_RenderTargets.begin(), m_RenderTargets.end(),
+			[target](const std::unique_ptr<RenderTarget>& renderTarget) { return renderTarget.get() == target; });
+
+		if (iter != m_RenderTargets.end())
+			m_RenderTargets.erase(iter);
+	}
+
+	DrawList* GameEngine::CreateDrawList()
+	{
+		m_DrawLists.push_back(std::make_unique<DrawList>(m_Platform.get()));
+		return m_DrawLists.back().get();
+	}
+
+	void GameEngine::DestroyDrawList(DrawList* list)
+	{
+		auto iter = std::find_if(m_DrawLists.begin(), m_DrawLists.end(),
+			[list](const std::unique_ptr<DrawList>& drawList) { return drawList.get() == list; });
+
+		if (iter != m_DrawLists.end())
+			m_DrawLists.erase(iter);
+	}
+
 	size_t GameEngine::CreateLayer(Layer* layer)
 	{
 		if (!layer)
@@ -1543,4 +1120,81 @@ namespace def
 		return *m_Timer.get();
 	}
 
+	ThreadPool& GameEngine::ThreadPool()
+	{
+		return *m_ThreadPool.get();
+	}
+
+	void GameEngine::SetTargetFrameRate(float fps)
+	{
+		m_Timer->SetTargetFrameRate(fps);
+	}
+
+	float GameEngine::GetTargetFrameRate() const
+	{
+		return m_Timer->GetTargetFrameRate();
+	}
+
+	const FramePacingStats& GameEngine::GetPacingStats() const
+	{
+		return m_Timer->GetPacingStats();
+	}
+
+	void GameEngine::EnableIdleMode(bool enable, float timeout)
+	{
+		m_IsIdleMode = enable;
+		m_IdleTimeout = timeout;
+	}
+
+	bool GameEngine::IsIdleMode() const
+	{
+		return m_IsIdleMode;
+	}
+
+	void GameEngine::MarkDirty()
+	{
+		m_IsDirty = true;
+	}
+
+	const FrameTimings& GameEngine::GetFrameTimings() const
+	{
+		return m_FrameTimings;
+	}
+
+	bool GameEngine::SetTimingsOutput(const std::string& fileName)
+	{
+		m_TimingsFile.close();
+
+		if (fileName.empty())
+			return true;
+
+		m_TimingsFile.open(fileName, std::ios::trunc);
+
+		if (!m_TimingsFile.is_open())
+			return false;
+
+		m_TimingsFile << "frame,delta_ms,update_ms,layers_ms,draw_ms,present_ms,total_ms\n";
+
+		return true;
+	}
+
+	void GameEngine::EnableProfiler(bool enable)
+	{
+		m_IsProfiling = enable;
+	}
+
+	bool GameEngine::IsProfilerEnabled() const
+	{
+		return m_IsProfiling;
+	}
+
+	void GameEngine::ResetProfiler()
+	{
+		m_FrameProfile = {};
+	}
+
+	const FrameProfile& GameEngine::GetFrameProfile() const
+	{
+		return m_FrameProfile;
+	}
 }
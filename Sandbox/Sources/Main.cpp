@@ -5,6 +5,7 @@ struct CustomLayer : def::Layer
     CustomLayer(def::GameEngine* ctx) : def::Layer(ctx)
     {
         size = { 100, 100 };
+        parallelUpdate = true;
 
         pos[0] = { 20, 20 };
         pos[1] = { 100, 100 };
@@ -55,11 +56,11 @@ struct CustomLayer : def::Layer
             }
         }
 
-        context.ClearTexture(def::GREY);
-        context.GradientTextureTriangle(pos[0], pos[1], pos[2], def::RED, def::GREEN, def::BLUE);
+        drawContext.ClearTexture(def::GREY);
+        drawContext.GradientTextureTriangle(pos[0], pos[1], pos[2], def::RED, def::GREEN, def::BLUE);
 
         for (int i = 0; i < 3; i++)
-            context.FillTextureCircle(pos[i], 2, def::YELLOW);
+            drawContext.FillTextureCircle(pos[i], 2, def::YELLOW);
 
         return true;
     }
@@ -90,19 +91,23 @@ private:
 
         tex = new def::Texture("blocks.png", { 30.0f, 50.0f }, { 300.0f, 200.0f });
 
-        return true;
-    }
+        // Try help, stats, layers, memory, gl and profiler on
+        Console().RegisterCommand("rand", "rand [count] - prints random numbers",
+            [](const std::vector<std::string>& args, std::stringstream& output, def::Pixel& colour)
+            {
+                int count = args.size() > 1 ? std::max(atoi(args[1].c_str()), 1) : 1;
 
-    bool OnConsoleCommand(const std::string& command, std::stringstream& output, def::Pixel& colour) override
-    {
-        if (command == "rand")
-            output << "Hi!\n\n\nYou've got: " << rand();
+                output << "You've got:";
 
-        else if (command == "cls")
-            Console().Clear();
+                for (int i = 0; i < count; i++)
+                    output << ' ' << rand();
+            });
 
-        else if (command == "fullscreen")
-            Window().EnableFullscreen(!Window().IsFullScreen());
+        Console().RegisterCommand("fullscreen", "fullscreen - toggles the fullscreen mode",
+            [this](const std::vector<std::string>& args, std::stringstream& output, def::Pixel& colour)
+            {
+                Window().EnableFullscreen(!Window().IsFullScreen());
+            });
 
         return true;
     }
@@ -134,7 +139,8 @@ private:
 
         GradientTextureTriangle({ 100, 100 }, { 200, 200 }, { 100, 200 }, def::CYAN, def::MAGENTA, def::YELLOW);
 
-        if (Input().GetKeyState(def::Key::TAB).released)
+        // TAB completes the commands in the console so it's toggled by F1
+        if (Input().GetKeyState(def::Key::F1).released)
             Console().Show(!Console().IsShown());
 
         return true;
@@ -142,10 +148,14 @@ private:
 
 };
 
-int main()
+int main(int argc, char* argv[])
 {
     Example demo;
 
+    // Try --record input.dger and then --replay input.dger --timings timings.csv
+    if (!demo.ParseCommandLine(argc, argv))
+        return 1;
+
     if (demo.Construct(256, 200, 4, 4, false, true))
         demo.Run();
 }
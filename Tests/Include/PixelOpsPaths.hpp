@@ -0,0 +1,61 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef DGE_TESTS_PIXEL_OPS_PATHS_HPP
+#define DGE_TESTS_PIXEL_OPS_PATHS_HPP
+
+#include "Pixel.hpp"
+
+#include <span>
+
+namespace def::tests
+{
+	// PixelOps.cpp is built once per path under another class name
+	// (PixelOpsScalar.cpp, PixelOpsSSE2.cpp, PixelOpsAVX2.cpp)
+	// and every build is reached through these pointers.
+	// The pointers are null if the path isn't available on this target
+	struct PixelOpsPath
+	{
+		using LerpFunc = void(*)(std::span<const Pixel>, std::span<const Pixel>, float, std::span<Pixel>);
+		using ModulateTintFunc = void(*)(std::span<const Pixel>, const Pixel&, std::span<Pixel>);
+		using BinaryFunc = void(*)(std::span<const Pixel>, std::span<const Pixel>, std::span<Pixel>);
+		using UnaryFunc = void(*)(std::span<const Pixel>, std::span<Pixel>);
+
+		const char* name = nullptr;
+
+		LerpFunc lerp = nullptr;
+		ModulateTintFunc modulateTint = nullptr;
+		BinaryFunc modulate = nullptr;
+		BinaryFunc addSaturate = nullptr;
+		UnaryFunc grayscale = nullptr;
+		UnaryFunc premultiply = nullptr;
+		UnaryFunc unpremultiply = nullptr;
+	};
+
+	template <class Ops>
+	constexpr PixelOpsPath MakePixelOpsPath(const char* name)
+	{
+		return PixelOpsPath
+		{
+			name,
+			&Ops::Lerp,
+			static_cast<PixelOpsPath::ModulateTintFunc>(&Ops::Modulate),
+			static_cast<PixelOpsPath::BinaryFunc>(&Ops::Modulate),
+			&Ops::AddSaturate,
+			&Ops::Grayscale,
+			&Ops::Premultiply,
+			&Ops::Unpremultiply
+		};
+	}
+
+	extern const PixelOpsPath PIXEL_OPS_SCALAR;
+	extern const PixelOpsPath PIXEL_OPS_SSE2;
+	extern const PixelOpsPath PIXEL_OPS_AVX2;
+}
+
+#endif
@@ -0,0 +1,237 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+#include "PixelOps.hpp"
+#include "PixelOpsPaths.hpp"
+#include "Utils.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+using namespace def;
+using namespace def::tests;
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what, const char* path, size_t index)
+{
+	if (!condition && s_Failures++ < 20)
+		printf("FAILED: %s (%s, pixel %zu)\n", what, path, index);
+}
+
+static bool CloseTo(uint8_t lhs, uint8_t rhs, int tolerance)
+{
+	return std::abs((int)lhs - (int)rhs) <= tolerance;
+}
+
+static bool CloseToRGB(const Pixel& lhs, const Pixel& rhs, int tolerance)
+{
+	return CloseTo(lhs.r, rhs.r, tolerance) && CloseTo(lhs.g, rhs.g, tolerance) && CloseTo(lhs.b, rhs.b, tolerance);
+}
+
+// The AVX2 build can only run where the CPU and the OS support it
+static bool IsAVX2Supported()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+
+	__cpuid(info, 1);
+
+	// OSXSAVE and AVX, then the OS must save the YMM registers
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+static std::vector<Pixel> RandomPixels(std::mt19937& rng, size_t count)
+{
+	std::uniform_int_distribution<uint32_t> dist;
+	std::vector<Pixel> pixels(count);
+
+	for (Pixel& p : pixels)
+		p.rgba_n = dist(rng);
+
+	// Every alpha including 0 and 255 appears in the first 256 pixels
+	for (size_t i = 0; i < count && i < 256; i++)
+		pixels[i].a = (uint8_t)i;
+
+	return pixels;
+}
+
+// Every path must match the scalar one exactly
+static void ComparePaths(const PixelOpsPath& path, const std::vector<Pixel>& src1, const std::vector<Pixel>& src2)
+{
+	const PixelOpsPath& ref = PIXEL_OPS_SCALAR;
+
+	std::vector<Pixel> expected(src1.size());
+	std::vector<Pixel> actual(src1.size());
+
+	auto compare = [&](const char* what)
+		{
+			for (size_t i = 0; i < expected.size(); i++)
+				Check(expected[i].rgba_n == actual[i].rgba_n, what, path.name, i);
+		};
+
+	for (float factor : { 0.0f, 0.1f, 0.25f, 0.5f, 0.77f, 1.0f, -0.5f, 1.5f })
+	{
+		ref.lerp(src1, src2, factor, expected);
+		path.lerp(src1, src2, factor, actual);
+		compare("Lerp");
+	}
+
+	ref.modulateTint(src1, src2[0], expected);
+	path.modulateTint(src1, src2[0], actual);
+	compare("Modulate(src, tint)");
+
+	ref.modulate(src1, src2, expected);
+	path.modulate(src1, src2, actual);
+	compare("Modulate(src1, src2)");
+
+	ref.addSaturate(src1, src2, expected);
+	path.addSaturate(src1, src2, actual);
+	compare("AddSaturate");
+
+	ref.grayscale(src1, expected);
+	path.grayscale(src1, actual);
+	compare("Grayscale");
+
+	ref.premultiply(src1, expected);
+	path.premultiply(src1, actual);
+	compare("Premultiply");
+
+	ref.unpremultiply(src1, expected);
+	path.unpremultiply(src1, actual);
+	compare("Unpremultiply");
+
+	// In place, the output is the first input
+	actual = src1;
+	ref.modulate(src1, src2, expected);
+	path.modulate(actual, src2, actual);
+	compare("Modulate in place");
+}
+
+// The span operations against the per-pixel float operators they replace,
+// the operators truncate where PixelOps rounds so they may differ by 1
+static void CompareOperators(const PixelOpsPath& path, const std::vector<Pixel>& src1, const std::vector<Pixel>& src2)
+{
+	std::vector<Pixel> out(src1.size());
+
+	for (float factor : { 0.0f, 0.1f, 0.25f, 0.5f, 0.77f, 1.0f })
+	{
+		path.lerp(src1, src2, factor, out);
+
+		for (size_t i = 0; i < out.size(); i++)
+		{
+			Pixel expected = src1[i].Lerp(src2[i], factor);
+			Check(CloseToRGB(out[i], expected, 1) && CloseTo(out[i].a, expected.a, 1), "Lerp vs Pixel::Lerp", path.name, i);
+		}
+	}
+
+	path.modulateTint(src1, src2[0], out);
+
+	for (size_t i = 0; i < out.size(); i++)
+	{
+		const Pixel& tint = src2[0];
+
+		Pixel expected(
+			ClampFloatToUint8((float)src1[i].r * ((float)tint.r / 255.0f)),
+			ClampFloatToUint8((float)src1[i].g * ((float)tint.g / 255.0f)),
+			ClampFloatToUint8((float)src1[i].b * ((float)tint.b / 255.0f)));
+
+		Check(CloseToRGB(out[i], expected, 1), "Modulate vs operator*(float)", path.name, i);
+	}
+
+	path.addSaturate(src1, src2, out);
+
+	for (size_t i = 0; i < out.size(); i++)
+		Check(CloseToRGB(out[i], src1[i] + src2[i], 0), "AddSaturate vs operator+", path.name, i);
+
+	path.grayscale(src1, out);
+
+	// The weights are rounded to 1/256 steps too, which adds at most 1 more
+	for (size_t i = 0; i < out.size(); i++)
+	{
+		const Pixel& p = src1[i];
+		uint8_t y = ClampFloatToUint8(0.3f * (float)p.r + 0.59f * (float)p.g + 0.11f * (float)p.b);
+
+		Check(CloseToRGB(out[i], Pixel(y, y, y), 2) && out[i].a == p.a, "Grayscale vs float luma", path.name, i);
+	}
+
+	path.premultiply(src1, out);
+
+	for (size_t i = 0; i < out.size(); i++)
+	{
+		const Pixel& p = src1[i];
+		Check(CloseToRGB(out[i], p * ((float)p.a / 255.0f), 1) && out[i].a == p.a, "Premultiply vs operator*(float)", path.name, i);
+	}
+
+	path.unpremultiply(src1, out);
+
+	for (size_t i = 0; i < out.size(); i++)
+	{
+		const Pixel& p = src1[i];
+
+		if (p.a == 0)
+			Check(out[i].rgba_n == 0, "Unpremultiply of a transparent pixel", path.name, i);
+		else
+			Check(CloseToRGB(out[i], p / ((float)p.a / 255.0f), 1) && out[i].a == p.a, "Unpremultiply vs operator/(float)", path.name, i);
+	}
+}
+
+int main()
+{
+	// def::PixelOps is the engine's own build with whatever the compiler enables
+	PixelOpsPath native = MakePixelOpsPath<PixelOps>("engine");
+
+	std::vector<const PixelOpsPath*> paths = { &PIXEL_OPS_SCALAR, &native };
+
+	if (PIXEL_OPS_SSE2.lerp)
+		paths.push_back(&PIXEL_OPS_SSE2);
+
+	if (PIXEL_OPS_AVX2.lerp && IsAVX2Supported())
+		paths.push_back(&PIXEL_OPS_AVX2);
+
+	std::mt19937 rng(2026);
+
+	// Lengths that leave tails after the 8 and 4 pixel blocks
+	for (size_t count : { 1, 3, 4, 7, 8, 13, 31, 256, 1031 })
+	{
+		std::vector<Pixel> src1 = RandomPixels(rng, count);
+		std::vector<Pixel> src2 = RandomPixels(rng, count);
+
+		for (const PixelOpsPath* path : paths)
+		{
+			ComparePaths(*path, src1, src2);
+			CompareOperators(*path, src1, src2);
+		}
+	}
+
+	for (const PixelOpsPath* path : paths)
+		printf("PixelOps: tested the %s path\n", path->name);
+
+	if (s_Failures > 0)
+	{
+		printf("PixelOps: %d checks failed\n", s_Failures);
+		return 1;
+	}
+
+	printf("PixelOps: all checks passed\n");
+	return 0;
+}
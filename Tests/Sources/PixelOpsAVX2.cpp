@@ -0,0 +1,21 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+// PixelOps with AVX2, premake builds this file with -mavx2 (/arch:AVX2 on MSVC)
+#define PixelOps PixelOpsAVX2
+#include "../../Engine/Sources/PixelOps.cpp"
+#undef PixelOps
+
+#include "PixelOpsPaths.hpp"
+
+namespace def::tests
+{
+#if defined(DGE_PIXEL_OPS_AVX2)
+	const PixelOpsPath PIXEL_OPS_AVX2 = MakePixelOpsPath<PixelOpsAVX2>("avx2");
+#else
+	const PixelOpsPath PIXEL_OPS_AVX2;
+#endif
+}
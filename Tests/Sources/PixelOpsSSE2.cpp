@@ -0,0 +1,22 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+// PixelOps with SSE2 but without AVX2
+#define DGE_PIXEL_OPS_NO_AVX2
+#define PixelOps PixelOpsSSE2
+#include "../../Engine/Sources/PixelOps.cpp"
+#undef PixelOps
+
+#include "PixelOpsPaths.hpp"
+
+namespace def::tests
+{
+#if defined(DGE_PIXEL_OPS_SSE2)
+	const PixelOpsPath PIXEL_OPS_SSE2 = MakePixelOpsPath<PixelOpsSSE2>("sse2");
+#else
+	const PixelOpsPath PIXEL_OPS_SSE2;
+#endif
+}
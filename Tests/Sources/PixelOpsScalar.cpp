@@ -0,0 +1,18 @@
+/*-----------------------------------------------------------------
+ *  Copyright 2026 defini7. All rights reserved.
+ *  Licensed under the GNU General Public License v3.0.
+ *  See LICENSE file in the project root for license information.
+ *----------------------------------------------------------------*/
+
+// PixelOps without any SIMD
+#define DGE_PIXEL_OPS_NO_SIMD
+#define PixelOps PixelOpsScalar
+#include "../../Engine/Sources/PixelOps.cpp"
+#undef PixelOps
+
+#include "PixelOpsPaths.hpp"
+
+namespace def::tests
+{
+	const PixelOpsPath PIXEL_OPS_SCALAR = MakePixelOpsPath<PixelOpsScalar>("scalar");
+}
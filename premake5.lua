@@ -16,6 +16,12 @@ workspace "defGameEngine"
 
 OUTPUT_DIR = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
+newoption
+{
+    trigger = "headless",
+    description = "Build without a window and OpenGL, e.g. for replaying recorded input on CI"
+}
+
 include "Engine/Vendor/glfw"
 
 project "Engine"
@@ -60,6 +66,24 @@ project "Engine"
             "%{prj.name}/Sources/PlatformGLFW3.cpp"
         }
 
+    filter "options:not headless"
+        removefiles
+        {
+            "%{prj.name}/Include/PlatformHeadless.hpp",
+            "%{prj.name}/Sources/PlatformHeadless.cpp"
+        }
+
+    filter "options:headless"
+        defines { "DGE_PLATFORM_HEADLESS" }
+        removelinks { "GLFW3" }
+        removefiles
+        {
+            "%{prj.name}/Include/PlatformGL.hpp",
+            "%{prj.name}/Sources/PlatformGL.cpp",
+            "%{prj.name}/Include/PlatformGLFW3.hpp",
+            "%{prj.name}/Sources/PlatformGLFW3.cpp"
+        }
+
     filter {}
 
     -- Including headers for libraries
@@ -77,7 +101,7 @@ project "Engine"
     filter "system:windows"
         links { "gdi32", "user32", "kernel32", "opengl32", "glu32" }
 
-    filter "system:linux"
+    filter { "system:linux", "options:not headless" }
         links
         {
             "GL", "GLU", "glut", "GLEW", "X11",
@@ -85,6 +109,11 @@ project "Engine"
             "Xinerama", "Xcursor"
         }
 
+    -- A headless build needs neither a display nor OpenGL
+
+    filter { "system:linux", "options:headless" }
+        links { "pthread", "dl" }
+
     filter "system:macosx"
         links
         {
@@ -147,6 +176,10 @@ project "Sandbox"
     filter "system:emscripten"
         removefiles { "Engine/Include/PlatformGLFW3.hpp" }
 
+    filter "options:headless"
+        defines { "DGE_PLATFORM_HEADLESS" }
+        removelinks { "GLFW3" }
+
     filter {}
 
     -- Including headers for libraries
@@ -165,7 +198,7 @@ project "Sandbox"
     filter "system:windows"
         links { "gdi32", "user32", "kernel32", "opengl32", "GLFW3", "glu32" }
 
-    filter "system:linux"
+    filter { "system:linux", "options:not headless" }
         links
         {
             "GL", "GLU", "glut", "GLEW", "GLFW3", "X11",
@@ -173,6 +206,9 @@ project "Sandbox"
             "Xinerama", "Xcursor"
         }
 
+    filter { "system:linux", "options:headless" }
+        links { "pthread", "dl" }
+
     filter "system:macosx"
         links
         {
@@ -200,3 +236,152 @@ project "Sandbox"
         optimize "On"
 
     filter {}
+
+-- Checks the engine without opening a window, e.g. that every PixelOps path gives the same results
+
+project "Tests"
+    location "Tests"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "On"
+
+    targetdir ("%{wks.location}/Build/Target/" .. OUTPUT_DIR .. "/%{prj.name}")
+    objdir ("%{wks.location}/Build/Obj/" .. OUTPUT_DIR .. "/%{prj.name}")
+
+    links { "GLFW3", "Engine" }
+
+    files
+    {
+        "%{prj.name}/Include/*.hpp",
+        "%{prj.name}/Sources/*.cpp"
+    }
+
+    -- PixelOps.cpp is built once more per path, the AVX2 one needs the instructions enabled
+
+    filter { "files:Tests/Sources/PixelOpsAVX2.cpp", "architecture:x86_64", "toolset:msc*" }
+        buildoptions { "/arch:AVX2" }
+
+    filter { "files:Tests/Sources/PixelOpsAVX2.cpp", "architecture:x86_64", "toolset:not msc*" }
+        buildoptions { "-mavx2" }
+
+    filter "options:headless"
+        defines { "DGE_PLATFORM_HEADLESS" }
+        removelinks { "GLFW3" }
+
+    filter {}
+
+    includedirs
+    {
+        "Engine/Vendor/glfw/include",
+        "Engine/Vendor/stb",
+        "Engine/Include",
+        "%{prj.name}/Include"
+    }
+
+    libdirs { "Build/Target/" .. OUTPUT_DIR .. "/GLFW3" }
+
+    filter "system:windows"
+        links { "gdi32", "user32", "kernel32", "opengl32", "GLFW3", "glu32" }
+
+    filter { "system:linux", "options:not headless" }
+        links
+        {
+            "GL", "GLU", "glut", "GLEW", "GLFW3", "X11",
+            "Xxf86vm", "Xrandr", "pthread", "Xi", "dl",
+            "Xinerama", "Xcursor"
+        }
+
+    filter { "system:linux", "options:headless" }
+        links { "pthread", "dl" }
+
+    filter "system:macosx"
+        links
+        {
+            "Metal.framework", "QuartzCore.framework",
+            "Cocoa.framework", "OpenGL.framework",
+            "IOKit.framework", "CoreVideo.framework"
+        }
+
+    filter "system:windows"
+        warnings "Extra"
+
+    filter "configurations:Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        optimize "On"
+
+    filter {}
+
+-- Times the hot paths of the engine and the extensions,
+-- pass the names of the benchmarks to run only them
+
+project "Benchmarks"
+    location "Benchmarks"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    staticruntime "On"
+
+    targetdir ("%{wks.location}/Build/Target/" .. OUTPUT_DIR .. "/%{prj.name}")
+    objdir ("%{wks.location}/Build/Obj/" .. OUTPUT_DIR .. "/%{prj.name}")
+
+    links { "GLFW3", "Engine" }
+
+    files
+    {
+        "%{prj.name}/Include/*.hpp",
+        "%{prj.name}/Sources/*.cpp"
+    }
+
+    filter "options:headless"
+        defines { "DGE_PLATFORM_HEADLESS" }
+        removelinks { "GLFW3" }
+
+    filter {}
+
+    includedirs
+    {
+        "Engine/Vendor/glfw/include",
+        "Engine/Vendor/stb",
+        "Engine/Include",
+        "%{prj.name}/Include"
+    }
+
+    libdirs { "Build/Target/" .. OUTPUT_DIR .. "/GLFW3" }
+
+    filter "system:windows"
+        links { "gdi32", "user32", "kernel32", "opengl32", "GLFW3", "glu32" }
+
+    filter { "system:linux", "options:not headless" }
+        links
+        {
+            "GL", "GLU", "glut", "GLEW", "GLFW3", "X11",
+            "Xxf86vm", "Xrandr", "pthread", "Xi", "dl",
+            "Xinerama", "Xcursor"
+        }
+
+    filter { "system:linux", "options:headless" }
+        links { "pthread", "dl" }
+
+    filter "system:macosx"
+        links
+        {
+            "Metal.framework", "QuartzCore.framework",
+            "Cocoa.framework", "OpenGL.framework",
+            "IOKit.framework", "CoreVideo.framework"
+        }
+
+    filter "system:windows"
+        warnings "Extra"
+
+    filter "configurations:Debug"
+        symbols "On"
+
+    -- The numbers only mean something with optimisations
+
+    filter "configurations:Release"
+        optimize "On"
+
+    filter {}